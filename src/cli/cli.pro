@@ -0,0 +1,43 @@
+TEMPLATE = app
+TARGET = starc-cli
+
+CONFIG += c++1z console
+CONFIG -= app_bundle
+CONFIG += force_debug_info
+CONFIG += separate_debug_info
+QT += core gui widgets sql
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+DESTDIR = ../_build/
+
+INCLUDEPATH += ..
+
+#
+# Подключаем библиотеку corelib
+#
+mac {
+    CORELIBDIR = ../_build/starcapp.app/Contents/Frameworks
+} else {
+    CORELIBDIR = ../_build
+}
+LIBS += -L$$CORELIBDIR/ -lcorelib
+INCLUDEPATH += $$PWD/../corelib
+DEPENDPATH += $$PWD/../corelib
+#
+
+#
+# Подключаем библиотеку Webloader
+#
+LIBSDIR = ../_build/libs
+LIBS += -L$$LIBSDIR/ -lwebloader
+INCLUDEPATH += $$PWD/../3rd_party/webloader/src
+DEPENDPATH += $$PWD/../3rd_party/webloader
+#
+
+SOURCES += \
+    main.cpp \
+    project_processor.cpp
+
+HEADERS += \
+    project_processor.h
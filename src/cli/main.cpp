@@ -0,0 +1,182 @@
+#include "project_processor.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFontDatabase>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <functional>
+
+
+namespace {
+
+/**
+ * @brief Загрузить шрифты, используемые в шаблонах документов
+ * @note Встроенные шрифты берутся из ресурсов corelib, а скачанные из папки данных приложения,
+ *       так же как при запуске основного приложения
+ */
+void loadFonts()
+{
+    const auto embeddedFonts = QDir(":/fonts").entryInfoList(QDir::Files);
+    for (const auto& font : embeddedFonts) {
+        QFontDatabase::addApplicationFont(font.absoluteFilePath());
+    }
+
+    const auto fontsFolderPath
+        = QString("%1/fonts")
+              .arg(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    const auto downloadedFonts = QDir(fontsFolderPath).entryInfoList(QDir::Files);
+    for (const auto& font : downloadedFonts) {
+        QFontDatabase::addApplicationFont(font.absoluteFilePath());
+    }
+}
+
+/**
+ * @brief Обработать проекты в отдельных процессах, запуская не более заданного количества
+ *        процессов одновременно
+ * @note База данных проекта одна на процесс, поэтому для параллельной обработки каждый проект
+ *       открывается в своём процессе этой же программы
+ */
+int processInWorkers(const QStringList& _projects, const QStringList& _arguments, int _jobs)
+{
+    QStringList projectsToProcess = _projects;
+    int runningWorkers = 0;
+    int failedProjects = 0;
+
+    std::function<void()> startNextWorker;
+    auto finishWorker = [&](QProcess* _worker, const QString& _project, bool _isSucceed) {
+        if (!_isSucceed) {
+            QTextStream(stderr) << "Failed to process " << _project << Qt::endl;
+            ++failedProjects;
+        }
+        _worker->deleteLater();
+        --runningWorkers;
+
+        if (runningWorkers == 0 && projectsToProcess.isEmpty()) {
+            QApplication::quit();
+        } else {
+            startNextWorker();
+        }
+    };
+    startNextWorker = [&] {
+        while (runningWorkers < _jobs && !projectsToProcess.isEmpty()) {
+            const auto project = projectsToProcess.takeFirst();
+            auto worker = new QProcess;
+            worker->setProcessChannelMode(QProcess::ForwardedChannels);
+            QObject::connect(worker, qOverload<int, QProcess::ExitStatus>(&QProcess::finished),
+                             worker,
+                             [&, worker, project](int _exitCode, QProcess::ExitStatus _status) {
+                                 finishWorker(worker, project,
+                                              _status == QProcess::NormalExit && _exitCode == 0);
+                             });
+            //
+            // ... если процесс не удалось запустить, то сигнала о его завершении не будет
+            //
+            QObject::connect(worker, &QProcess::errorOccurred, worker,
+                             [&, worker, project](QProcess::ProcessError _error) {
+                                 if (_error == QProcess::FailedToStart) {
+                                     finishWorker(worker, project, false);
+                                 }
+                             });
+            ++runningWorkers;
+            worker->start(QApplication::applicationFilePath(), QStringList(_arguments) << project);
+        }
+    };
+    startNextWorker();
+    QApplication::exec();
+
+    return failedProjects == 0 ? 0 : 1;
+}
+
+} // namespace
+
+
+/**
+ * @brief Погнали!
+ */
+int main(int argc, char* argv[])
+{
+    //
+    // Работаем без оконной системы, если платформа не задана явно
+    //
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication application(argc, argv);
+    //
+    // ... данные приложения и настройки должны быть общими с основным приложением
+    //
+    QApplication::setApplicationName("Story Architect");
+    QApplication::setOrganizationName("Story Apps");
+    QApplication::setOrganizationDomain("storyapps.dev");
+    QApplication::setApplicationVersion("0.8.1");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Export documents and build reports of Story Architect "
+                                     "projects without the user interface.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption documentOption(
+        { "d", "document" },
+        "Name or uuid of the document to process, can be repeated. All screenplays, comic books, "
+        "audioplays, stageplays and novels are processed by default.",
+        "document");
+    const QCommandLineOption exportOption(
+        { "e", "export" },
+        "Export format (pdf, docx, fdx, fountain, md), can be repeated. Fdx is available for "
+        "screenplays only, fountain for all documents except novels and md for novels only.",
+        "format");
+    const QCommandLineOption reportOption(
+        { "r", "report" },
+        "Report to build (summary, scene, location, cast, dialogues, gender), can be repeated. "
+        "Comic books, stageplays and novels have the summary report only.",
+        "report");
+    const QCommandLineOption reportsFormatOption("report-format",
+                                                 "Reports file format (xlsx, pdf).", "format",
+                                                 "xlsx");
+    const QCommandLineOption outputOption({ "o", "output" }, "Folder to save results to.",
+                                          "folder", QDir::currentPath());
+    const QCommandLineOption jobsOption({ "j", "jobs" },
+                                        "Number of projects processed in parallel.", "number",
+                                        QString::number(QThread::idealThreadCount()));
+    parser.addOptions({ documentOption, exportOption, reportOption, reportsFormatOption,
+                        outputOption, jobsOption });
+    parser.addPositionalArgument("projects", "Projects to process.", "<project.starc...>");
+    parser.process(application);
+
+    const auto projects = parser.positionalArguments();
+    if (projects.isEmpty() || (!parser.isSet(exportOption) && !parser.isSet(reportOption))) {
+        parser.showHelp(1);
+    }
+
+    //
+    // Несколько проектов раздаём рабочим процессам, передавая им все параметры, кроме самих
+    // проектов
+    //
+    if (projects.size() > 1) {
+        QStringList arguments = application.arguments().mid(1);
+        for (const auto& project : projects) {
+            arguments.removeOne(project);
+        }
+        const auto jobs = std::max(1, parser.value(jobsOption).toInt());
+        return processInWorkers(projects, arguments, jobs);
+    }
+
+    loadFonts();
+
+    ProcessingOptions options;
+    options.documents = parser.values(documentOption);
+    options.exportFormats = parser.values(exportOption);
+    options.reports = parser.values(reportOption);
+    options.reportsFormat = parser.value(reportsFormatOption);
+    options.outputFolder = parser.value(outputOption);
+
+    ProjectProcessor processor(options);
+    return processor.process(projects.constFirst()) ? 0 : 1;
+}
@@ -0,0 +1,598 @@
+#include "project_processor.h"
+
+#include <business_layer/export/audioplay/audioplay_docx_exporter.h>
+#include <business_layer/export/audioplay/audioplay_export_options.h>
+#include <business_layer/export/audioplay/audioplay_fountain_exporter.h>
+#include <business_layer/export/audioplay/audioplay_pdf_exporter.h>
+#include <business_layer/export/comic_book/comic_book_docx_exporter.h>
+#include <business_layer/export/comic_book/comic_book_export_options.h>
+#include <business_layer/export/comic_book/comic_book_fountain_exporter.h>
+#include <business_layer/export/comic_book/comic_book_pdf_exporter.h>
+#include <business_layer/export/novel/novel_docx_exporter.h>
+#include <business_layer/export/novel/novel_export_options.h>
+#include <business_layer/export/novel/novel_markdown_exporter.h>
+#include <business_layer/export/novel/novel_pdf_exporter.h>
+#include <business_layer/export/screenplay/screenplay_docx_exporter.h>
+#include <business_layer/export/screenplay/screenplay_export_options.h>
+#include <business_layer/export/screenplay/screenplay_fdx_exporter.h>
+#include <business_layer/export/screenplay/screenplay_fountain_exporter.h>
+#include <business_layer/export/screenplay/screenplay_pdf_exporter.h>
+#include <business_layer/export/stageplay/stageplay_docx_exporter.h>
+#include <business_layer/export/stageplay/stageplay_export_options.h>
+#include <business_layer/export/stageplay/stageplay_fountain_exporter.h>
+#include <business_layer/export/stageplay/stageplay_pdf_exporter.h>
+#include <business_layer/model/audioplay/audioplay_information_model.h>
+#include <business_layer/model/audioplay/text/audioplay_text_model.h>
+#include <business_layer/model/comic_book/comic_book_information_model.h>
+#include <business_layer/model/comic_book/text/comic_book_text_model.h>
+#include <business_layer/model/novel/novel_information_model.h>
+#include <business_layer/model/novel/text/novel_text_model.h>
+#include <business_layer/model/project/project_models_facade.h>
+#include <business_layer/model/screenplay/screenplay_information_model.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model.h>
+#include <business_layer/model/stageplay/stageplay_information_model.h>
+#include <business_layer/model/stageplay/text/stageplay_text_model.h>
+#include <business_layer/model/structure/structure_model.h>
+#include <business_layer/model/structure/structure_model_item.h>
+#include <business_layer/reports/audioplay/audioplay_cast_report.h>
+#include <business_layer/reports/audioplay/audioplay_dialogues_report.h>
+#include <business_layer/reports/audioplay/audioplay_gender_report.h>
+#include <business_layer/reports/audioplay/audioplay_location_report.h>
+#include <business_layer/reports/audioplay/audioplay_scene_report.h>
+#include <business_layer/reports/audioplay/audioplay_summary_report.h>
+#include <business_layer/reports/comic_book/comic_book_summary_report.h>
+#include <business_layer/reports/novel/novel_summary_report.h>
+#include <business_layer/reports/screenplay/screenplay_cast_report.h>
+#include <business_layer/reports/screenplay/screenplay_dialogues_report.h>
+#include <business_layer/reports/screenplay/screenplay_gender_report.h>
+#include <business_layer/reports/screenplay/screenplay_location_report.h>
+#include <business_layer/reports/screenplay/screenplay_scene_report.h>
+#include <business_layer/reports/screenplay/screenplay_summary_report.h>
+#include <business_layer/reports/stageplay/stageplay_summary_report.h>
+#include <data_layer/database.h>
+#include <data_layer/storage/document_image_storage.h>
+#include <data_layer/storage/document_raw_data_storage.h>
+#include <data_layer/storage/document_storage.h>
+#include <data_layer/storage/storage_facade.h>
+#include <domain/document_object.h>
+#include <utils/helpers/extension_helper.h>
+#include <utils/helpers/platform_helper.h>
+#include <utils/tools/backup_builder.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QUuid>
+
+#include <functional>
+#include <memory>
+
+
+namespace {
+
+/**
+ * @brief Типы текстов, которые умеет обрабатывать утилита, по типам содержащих их документов
+ */
+const QHash<Domain::DocumentObjectType, Domain::DocumentObjectType> kTextTypes = {
+    { Domain::DocumentObjectType::Screenplay, Domain::DocumentObjectType::ScreenplayText },
+    { Domain::DocumentObjectType::ComicBook, Domain::DocumentObjectType::ComicBookText },
+    { Domain::DocumentObjectType::Audioplay, Domain::DocumentObjectType::AudioplayText },
+    { Domain::DocumentObjectType::Stageplay, Domain::DocumentObjectType::StageplayText },
+    { Domain::DocumentObjectType::Novel, Domain::DocumentObjectType::NovelText },
+};
+
+/**
+ * @brief Вывести сообщение об ошибке в стандартный поток ошибок
+ */
+void printError(const QString& _message)
+{
+    QTextStream(stderr) << _message << Qt::endl;
+}
+
+/**
+ * @brief Определить формат экспорта по расширению файла
+ * @return false, если формат не поддерживается
+ */
+bool exportFileFormat(const QString& _format, BusinessLayer::ExportFileFormat& _fileFormat)
+{
+    using namespace BusinessLayer;
+
+    if (_format == ExtensionHelper::pdf()) {
+        _fileFormat = ExportFileFormat::Pdf;
+    } else if (_format == ExtensionHelper::msOfficeOpenXml()) {
+        _fileFormat = ExportFileFormat::Docx;
+    } else if (_format == ExtensionHelper::finalDraft()) {
+        _fileFormat = ExportFileFormat::Fdx;
+    } else if (_format == ExtensionHelper::fountain()) {
+        _fileFormat = ExportFileFormat::Fountain;
+    } else if (_format == ExtensionHelper::markdown()) {
+        _fileFormat = ExportFileFormat::Markdown;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Создать экспортер текста заданного типа в заданный формат
+ * @return nullptr, если текст такого типа нельзя экспортировать в этот формат
+ */
+std::unique_ptr<BusinessLayer::AbstractExporter> createExporter(
+    Domain::DocumentObjectType _textType, BusinessLayer::ExportFileFormat _format)
+{
+    using namespace BusinessLayer;
+
+    switch (_textType) {
+    case Domain::DocumentObjectType::ScreenplayText: {
+        switch (_format) {
+        case ExportFileFormat::Pdf: {
+            return std::make_unique<ScreenplayPdfExporter>();
+        }
+        case ExportFileFormat::Docx: {
+            return std::make_unique<ScreenplayDocxExporter>();
+        }
+        case ExportFileFormat::Fdx: {
+            return std::make_unique<ScreenplayFdxExporter>();
+        }
+        case ExportFileFormat::Fountain: {
+            return std::make_unique<ScreenplayFountainExporter>();
+        }
+        default: {
+            return {};
+        }
+        }
+    }
+
+    case Domain::DocumentObjectType::ComicBookText: {
+        switch (_format) {
+        case ExportFileFormat::Pdf: {
+            return std::make_unique<ComicBookPdfExporter>();
+        }
+        case ExportFileFormat::Docx: {
+            return std::make_unique<ComicBookDocxExporter>();
+        }
+        case ExportFileFormat::Fountain: {
+            return std::make_unique<ComicBookFountainExporter>();
+        }
+        default: {
+            return {};
+        }
+        }
+    }
+
+    case Domain::DocumentObjectType::AudioplayText: {
+        switch (_format) {
+        case ExportFileFormat::Pdf: {
+            return std::make_unique<AudioplayPdfExporter>();
+        }
+        case ExportFileFormat::Docx: {
+            return std::make_unique<AudioplayDocxExporter>();
+        }
+        case ExportFileFormat::Fountain: {
+            return std::make_unique<AudioplayFountainExporter>();
+        }
+        default: {
+            return {};
+        }
+        }
+    }
+
+    case Domain::DocumentObjectType::StageplayText: {
+        switch (_format) {
+        case ExportFileFormat::Pdf: {
+            return std::make_unique<StageplayPdfExporter>();
+        }
+        case ExportFileFormat::Docx: {
+            return std::make_unique<StageplayDocxExporter>();
+        }
+        case ExportFileFormat::Fountain: {
+            return std::make_unique<StageplayFountainExporter>();
+        }
+        default: {
+            return {};
+        }
+        }
+    }
+
+    case Domain::DocumentObjectType::NovelText: {
+        switch (_format) {
+        case ExportFileFormat::Pdf: {
+            return std::make_unique<NovelPdfExporter>();
+        }
+        case ExportFileFormat::Docx: {
+            return std::make_unique<NovelDocxExporter>();
+        }
+        case ExportFileFormat::Markdown: {
+            return std::make_unique<NovelMarkdownExporter>();
+        }
+        default: {
+            return {};
+        }
+        }
+    }
+
+    default: {
+        return {};
+    }
+    }
+}
+
+/**
+ * @brief Создать отчёт по тексту заданного типа по названию отчёта
+ * @return nullptr, если для текста такого типа нет такого отчёта
+ */
+std::unique_ptr<BusinessLayer::AbstractReport> createReport(Domain::DocumentObjectType _textType,
+                                                            const QString& _name)
+{
+    using namespace BusinessLayer;
+
+    switch (_textType) {
+    case Domain::DocumentObjectType::ScreenplayText: {
+        if (_name == QLatin1String("summary")) {
+            return std::make_unique<ScreenplaySummaryReport>();
+        } else if (_name == QLatin1String("scene")) {
+            return std::make_unique<ScreenplaySceneReport>();
+        } else if (_name == QLatin1String("location")) {
+            return std::make_unique<ScreenplayLocationReport>();
+        } else if (_name == QLatin1String("cast")) {
+            return std::make_unique<ScreenplayCastReport>();
+        } else if (_name == QLatin1String("dialogues")) {
+            return std::make_unique<ScreenplayDialoguesReport>();
+        } else if (_name == QLatin1String("gender")) {
+            return std::make_unique<ScreenplayGenderReport>();
+        }
+        return {};
+    }
+
+    case Domain::DocumentObjectType::AudioplayText: {
+        if (_name == QLatin1String("summary")) {
+            return std::make_unique<AudioplaySummaryReport>();
+        } else if (_name == QLatin1String("scene")) {
+            return std::make_unique<AudioplaySceneReport>();
+        } else if (_name == QLatin1String("location")) {
+            return std::make_unique<AudioplayLocationReport>();
+        } else if (_name == QLatin1String("cast")) {
+            return std::make_unique<AudioplayCastReport>();
+        } else if (_name == QLatin1String("dialogues")) {
+            return std::make_unique<AudioplayDialoguesReport>();
+        } else if (_name == QLatin1String("gender")) {
+            return std::make_unique<AudioplayGenderReport>();
+        }
+        return {};
+    }
+
+    //
+    // ... для остальных типов текстов есть только сводный отчёт
+    //
+    case Domain::DocumentObjectType::ComicBookText: {
+        if (_name == QLatin1String("summary")) {
+            return std::make_unique<ComicBookSummaryReport>();
+        }
+        return {};
+    }
+
+    case Domain::DocumentObjectType::StageplayText: {
+        if (_name == QLatin1String("summary")) {
+            return std::make_unique<StageplaySummaryReport>();
+        }
+        return {};
+    }
+
+    case Domain::DocumentObjectType::NovelText: {
+        if (_name == QLatin1String("summary")) {
+            return std::make_unique<NovelSummaryReport>();
+        }
+        return {};
+    }
+
+    default: {
+        return {};
+    }
+    }
+}
+
+/**
+ * @brief Заполнить параметры документа из его информационной модели так же, как это делается при
+ *        экспорте в приложении
+ */
+template<typename InformationModel>
+void fillDocumentOptions(const InformationModel* _information,
+                         BusinessLayer::ExportOptions& _exportOptions)
+{
+    _exportOptions.templateId = _information->templateId();
+    _exportOptions.header = _information->header();
+    _exportOptions.printHeaderOnTitlePage = _information->printHeaderOnTitlePage();
+    _exportOptions.footer = _information->footer();
+    _exportOptions.printFooterOnTitlePage = _information->printFooterOnTitlePage();
+}
+
+} // namespace
+
+class ProjectProcessor::Implementation
+{
+public:
+    explicit Implementation(const ProcessingOptions& _options);
+
+    /**
+     * @brief Найти в структуре тексты документов, которые нужно обработать
+     */
+    QVector<BusinessLayer::StructureModelItem*> textsToProcess(
+        BusinessLayer::StructureModel* _structureModel) const;
+
+    /**
+     * @brief Экспортировать текст в заданный формат
+     */
+    bool exportText(BusinessLayer::AbstractModel* _model, Domain::DocumentObjectType _textType,
+                    const QString& _format, const QString& _filePath) const;
+
+    /**
+     * @brief Построить по тексту заданный отчёт
+     */
+    bool buildReport(BusinessLayer::AbstractModel* _model, Domain::DocumentObjectType _textType,
+                     const QString& _report, const QString& _filePath) const;
+
+
+    const ProcessingOptions options;
+};
+
+ProjectProcessor::Implementation::Implementation(const ProcessingOptions& _options)
+    : options(_options)
+{
+}
+
+QVector<BusinessLayer::StructureModelItem*> ProjectProcessor::Implementation::textsToProcess(
+    BusinessLayer::StructureModel* _structureModel) const
+{
+    using namespace BusinessLayer;
+
+    //
+    // Документ можно задать как по идентификатору, так и по названию в навигаторе
+    //
+    auto isRequested = [this](StructureModelItem* _document, StructureModelItem* _text) {
+        if (options.documents.isEmpty()) {
+            return true;
+        }
+
+        for (const auto& document : options.documents) {
+            const auto uuid = QUuid::fromString(document);
+            if (!uuid.isNull() && (uuid == _document->uuid() || uuid == _text->uuid())) {
+                return true;
+            }
+            if (document.compare(_document->name(), Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    //
+    // Обходим структуру, пропуская корзину, и собираем тексты найденных документов
+    //
+    QVector<StructureModelItem*> texts;
+    std::function<void(StructureModelItem*)> collect;
+    collect = [&collect, &texts, isRequested](StructureModelItem* _item) {
+        for (int row = 0; row < _item->childCount(); ++row) {
+            auto child = _item->childAt(row);
+            if (child->type() == Domain::DocumentObjectType::RecycleBin) {
+                continue;
+            }
+
+            if (kTextTypes.contains(child->type())) {
+                const auto textType = kTextTypes.value(child->type());
+                for (int textRow = 0; textRow < child->childCount(); ++textRow) {
+                    auto text = child->childAt(textRow);
+                    if (text->type() == textType && isRequested(child, text)) {
+                        texts.append(text);
+                    }
+                }
+                continue;
+            }
+
+            collect(child);
+        }
+    };
+    collect(_structureModel->itemForIndex({}));
+
+    return texts;
+}
+
+bool ProjectProcessor::Implementation::exportText(BusinessLayer::AbstractModel* _model,
+                                                  Domain::DocumentObjectType _textType,
+                                                  const QString& _format,
+                                                  const QString& _filePath) const
+{
+    using namespace BusinessLayer;
+
+    ExportFileFormat fileFormat = ExportFileFormat::Pdf;
+    if (!exportFileFormat(_format, fileFormat)) {
+        printError(QString("Unsupported export format: %1").arg(_format));
+        return false;
+    }
+    const auto exporter = createExporter(_textType, fileFormat);
+    if (exporter == nullptr) {
+        printError(QString("Export to %1 isn't supported for %2").arg(_format, _filePath));
+        return false;
+    }
+
+    //
+    // Каждый экспортер ожидает параметры своего типа, поэтому собираем их по типу текста
+    //
+    auto exportTo = [&](ExportOptions& _exportOptions) {
+        _exportOptions.filePath = _filePath;
+        _exportOptions.fileFormat = fileFormat;
+        exporter->exportTo(_model, _exportOptions);
+    };
+    switch (_textType) {
+    case Domain::DocumentObjectType::ScreenplayText: {
+        const auto information = qobject_cast<ScreenplayTextModel*>(_model)->informationModel();
+        ScreenplayExportOptions exportOptions;
+        fillDocumentOptions(information, exportOptions);
+        exportOptions.showScenesNumbers = information->showSceneNumbers();
+        exportOptions.showScenesNumbersOnLeft = information->showSceneNumbersOnLeft();
+        exportOptions.showScenesNumbersOnRight = information->showSceneNumbersOnRight();
+        exportOptions.showDialoguesNumbers = information->showDialoguesNumbers();
+        exportTo(exportOptions);
+        break;
+    }
+
+    case Domain::DocumentObjectType::ComicBookText: {
+        ComicBookExportOptions exportOptions;
+        fillDocumentOptions(qobject_cast<ComicBookTextModel*>(_model)->informationModel(),
+                            exportOptions);
+        exportTo(exportOptions);
+        break;
+    }
+
+    case Domain::DocumentObjectType::AudioplayText: {
+        const auto information = qobject_cast<AudioplayTextModel*>(_model)->informationModel();
+        AudioplayExportOptions exportOptions;
+        fillDocumentOptions(information, exportOptions);
+        exportOptions.showBlockNumbers = information->showBlockNumbers();
+        exportTo(exportOptions);
+        break;
+    }
+
+    case Domain::DocumentObjectType::StageplayText: {
+        StageplayExportOptions exportOptions;
+        fillDocumentOptions(qobject_cast<StageplayTextModel*>(_model)->informationModel(),
+                            exportOptions);
+        exportTo(exportOptions);
+        break;
+    }
+
+    case Domain::DocumentObjectType::NovelText: {
+        NovelExportOptions exportOptions;
+        fillDocumentOptions(qobject_cast<NovelTextModel*>(_model)->informationModel(),
+                            exportOptions);
+        exportTo(exportOptions);
+        break;
+    }
+
+    default: {
+        Q_ASSERT(false);
+        return false;
+    }
+    }
+
+    return QFileInfo::exists(_filePath);
+}
+
+bool ProjectProcessor::Implementation::buildReport(BusinessLayer::AbstractModel* _model,
+                                                   Domain::DocumentObjectType _textType,
+                                                   const QString& _report,
+                                                   const QString& _filePath) const
+{
+    const auto report = createReport(_textType, _report);
+    if (report == nullptr) {
+        printError(QString("Report %1 isn't supported for %2").arg(_report, _filePath));
+        return false;
+    }
+
+    report->build(_model);
+    report->saveToFile(_filePath);
+    return QFileInfo::exists(_filePath);
+}
+
+
+// ****
+
+
+ProjectProcessor::ProjectProcessor(const ProcessingOptions& _options)
+    : d(new Implementation(_options))
+{
+}
+
+ProjectProcessor::~ProjectProcessor() = default;
+
+bool ProjectProcessor::process(const QString& _projectPath)
+{
+    using namespace BusinessLayer;
+
+    const QFileInfo projectFileInfo(_projectPath);
+    if (!projectFileInfo.exists()) {
+        printError(QString("Project %1 isn't found").arg(_projectPath));
+        return false;
+    }
+
+    //
+    // Работаем со снимком проекта, т.к. при открытии база данных может быть обновлена до текущей
+    // версии, а исходный файл должен остаться нетронутым. Снимок снимается средствами SQLite,
+    // поэтому он согласован, даже если проект сейчас открыт в приложении и часть изменений лежит
+    // в журнале
+    //
+    QTemporaryDir projectCopyFolder;
+    if (!projectCopyFolder.isValid()) {
+        printError(QString("Can't create temporary folder for %1").arg(_projectPath));
+        return false;
+    }
+    const auto projectCopyPath = projectCopyFolder.filePath(projectFileInfo.fileName());
+    if (!BackupBuilder::snapshot(projectFileInfo.absoluteFilePath(), projectCopyPath)) {
+        printError(QString("Can't read project %1").arg(_projectPath));
+        return false;
+    }
+
+    if (!DatabaseLayer::Database::canOpenFile(projectCopyPath)) {
+        printError(QString("Can't open project %1: %2")
+                       .arg(_projectPath, DatabaseLayer::Database::openFileError()));
+        return false;
+    }
+    DatabaseLayer::Database::setCurrentFile(projectCopyPath);
+
+    bool isSucceed = true;
+    {
+        DataStorageLayer::DocumentImageStorage documentImageStorage;
+        DataStorageLayer::DocumentRawDataStorage documentRawDataStorage;
+        StructureModel structureModel;
+        structureModel.setDocument(DataStorageLayer::StorageFacade::documentStorage()->document(
+            Domain::DocumentObjectType::Structure));
+        ProjectModelsFacade modelsFacade(&structureModel, &documentImageStorage,
+                                         &documentRawDataStorage);
+
+        const auto texts = d->textsToProcess(&structureModel);
+        if (texts.isEmpty()) {
+            printError(QString("No documents to process in %1").arg(_projectPath));
+            isSucceed = false;
+        }
+
+        QDir().mkpath(d->options.outputFolder);
+        const QDir outputFolder(d->options.outputFolder);
+        for (const auto text : texts) {
+            auto model = modelsFacade.modelFor(text->uuid());
+            if (model == nullptr) {
+                printError(QString("Can't load document %1 from %2")
+                               .arg(text->uuid().toString(), _projectPath));
+                isSucceed = false;
+                continue;
+            }
+
+            const auto baseName = PlatformHelper::systemSavebleFileName(
+                QString("%1 - %2").arg(projectFileInfo.completeBaseName(), text->parent()->name()));
+            for (const auto& format : d->options.exportFormats) {
+                const auto filePath
+                    = outputFolder.absoluteFilePath(QString("%1.%2").arg(baseName, format));
+                if (!d->exportText(model, text->type(), format, filePath)) {
+                    printError(QString("Can't export %1").arg(filePath));
+                    isSucceed = false;
+                }
+            }
+            for (const auto& report : d->options.reports) {
+                const auto filePath = outputFolder.absoluteFilePath(
+                    QString("%1 - %2.%3").arg(baseName, report, d->options.reportsFormat));
+                if (!d->buildReport(model, text->type(), report, filePath)) {
+                    printError(QString("Can't build report %1").arg(filePath));
+                    isSucceed = false;
+                }
+            }
+        }
+
+        modelsFacade.clear();
+        structureModel.clear();
+    }
+
+    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
+
+    return isSucceed;
+}
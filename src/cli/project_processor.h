@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QScopedPointer>
+#include <QStringList>
+
+
+/**
+ * @brief Параметры обработки проектов
+ */
+struct ProcessingOptions {
+    /**
+     * @brief Названия, или идентификаторы документов для обработки
+     * @note Если не заданы, то обрабатываются все сценарии, комиксы, аудиопьесы, пьесы и романы
+     *       проекта
+     */
+    QStringList documents;
+
+    /**
+     * @brief Форматы, в которые нужно экспортировать документы (pdf, docx, fdx, fountain, md)
+     * @note Набор доступных форматов зависит от типа документа, как и при экспорте в приложении
+     */
+    QStringList exportFormats;
+
+    /**
+     * @brief Отчёты, которые нужно построить по документам
+     *        (summary, scene, location, cast, dialogues, gender)
+     * @note Для комиксов, пьес и романов доступен только сводный отчёт (summary)
+     */
+    QStringList reports;
+
+    /**
+     * @brief Формат файлов отчётов (xlsx, pdf)
+     */
+    QString reportsFormat;
+
+    /**
+     * @brief Папка, в которую складываются результаты
+     */
+    QString outputFolder;
+};
+
+/**
+ * @brief Обработчик проекта: открывает его на чтение и выгружает документы и отчёты
+ * @note База данных проекта одна на процесс, поэтому в одном процессе проекты обрабатываются
+ *       строго по очереди
+ */
+class ProjectProcessor
+{
+public:
+    explicit ProjectProcessor(const ProcessingOptions& _options);
+    ~ProjectProcessor();
+
+    /**
+     * @brief Обработать заданный проект
+     * @return false, если проект не удалось открыть, либо обработать хотя бы один из документов
+     */
+    bool process(const QString& _projectPath);
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
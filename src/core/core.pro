@@ -55,7 +55,6 @@ SOURCES += \
     management_layer/content/notifications/notifications_manager.cpp \
     management_layer/content/onboarding/onboarding_manager.cpp \
     management_layer/content/project/project_manager.cpp \
-    management_layer/content/project/project_models_facade.cpp \
     management_layer/content/projects/projects_manager.cpp \
     management_layer/content/projects/projects_model.cpp \
     management_layer/content/projects/projects_model_item.cpp \
@@ -153,7 +152,6 @@ HEADERS += \
     management_layer/content/notifications/notifications_manager.h \
     management_layer/content/onboarding/onboarding_manager.h \
     management_layer/content/project/project_manager.h \
-    management_layer/content/project/project_models_facade.h \
     management_layer/content/projects/projects_manager.h \
     management_layer/content/projects/projects_model.h \
     management_layer/content/projects/projects_model_item.h \
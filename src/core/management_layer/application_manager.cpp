@@ -233,6 +233,12 @@ public:
      */
     void saveChanges();
 
+    /**
+     * @brief Обработать завершение записи изменений проекта
+     * @param _changesGeneration - поколение изменений, которые были отправлены на запись
+     */
+    void handleChangesSaved(int _changesGeneration);
+
     /**
      * @brief Если проект был изменён, но не сохранён предложить пользователю сохранить его
      * @param _callback - метод, который будет вызван, если пользователь хочет (Да),
@@ -342,6 +348,18 @@ public:
     Ui::ConnectionStatusToolBar* connectionStatus = nullptr;
     QPointer<Dialog> saveChangesDialog;
 
+    /**
+     * @brief Поколение изменений проекта, увеличивается при каждой правке пользователя
+     * @note Проект считается сохранённым только когда записано последнее поколение изменений,
+     *       а правки, сделанные пока предыдущее поколение пишется в фоне, оставляют его изменённым
+     */
+    int changesGeneration = 0;
+
+    /**
+     * @brief Поколение изменений, которое последним было отправлено на запись
+     */
+    int queuedChangesGeneration = -1;
+
     /**
      * @brief Построитель плагинов редакторов
      */
@@ -1284,27 +1302,46 @@ void ApplicationManager::Implementation::saveChanges()
     }
 
     //
-    // Сохраняем только, если есть какие-либо изменения
+    // Сохраняем только, если есть какие-либо изменения, которые ещё не отправлены на запись
     //
-    if (!applicationView->isWindowModified()) {
+    if (!applicationView->isWindowModified() || queuedChangesGeneration == changesGeneration) {
         return;
     }
 
     Log::info("Save changes triggered");
 
     //
-    // Управляющие должны сохранить все изменения
+    // Управляющие должны сохранить все изменения, при этом сама запись в базу данных выполняется
+    // в фоновом потоке одной транзакцией, а здесь лишь формируется снимок изменённых данных
     //
-    DatabaseLayer::Database::transaction();
+    DatabaseLayer::Database::beginAsyncWriting();
     projectsManager->saveChanges();
     projectManager->saveChanges();
-    DatabaseLayer::Database::commit();
+    //
+    // ... проект будет помечен сохранённым, только когда фоновый поток зафиксирует транзакцию
+    //
+    queuedChangesGeneration = changesGeneration;
+    DatabaseLayer::Database::endAsyncWriting(
+        [this, changesGeneration = changesGeneration] { handleChangesSaved(changesGeneration); });
+}
+
+void ApplicationManager::Implementation::handleChangesSaved(int _changesGeneration)
+{
+    if (projectsManager->currentProject() == nullptr) {
+        return;
+    }
 
     //
     // Если произошла ошибка сохранения, то делаем дополнительные проверки и работаем с
     // пользователем
     //
     if (DatabaseLayer::Database::hasError()) {
+        //
+        // Изменения не записаны, поэтому проект остаётся изменённым, а при следующем сохранении
+        // они будут отправлены на запись снова
+        //
+        queuedChangesGeneration = -1;
+
         //
         // Если файл, в который мы пробуем сохранять изменения существует
         //
@@ -1356,6 +1393,13 @@ void ApplicationManager::Implementation::saveChanges()
         return;
     }
 
+    //
+    // Если пока шла запись пользователь ничего не изменил, то все изменения сохранены
+    //
+    if (_changesGeneration == changesGeneration) {
+        markChangesSaved(true);
+    }
+
     //
     // Если работает с теневым проектом, то экспортируем его при сохранении
     //
@@ -1365,11 +1409,6 @@ void ApplicationManager::Implementation::saveChanges()
                                       projectsManager->currentProject()->path());
     }
 
-    //
-    // Если изменения сохранились без ошибок, то изменим статус окна на сохранение изменений
-    //
-    markChangesSaved(true);
-
     //
     // Обновляем информацию в списке проектов
     //
@@ -1423,6 +1462,7 @@ void ApplicationManager::Implementation::saveIfNeeded(std::function<void()> _cal
     //
     if (projectsManager->currentProject()->isRemote()) {
         saveChanges();
+        DatabaseLayer::Database::waitForAsyncWriting();
         _callback();
         return;
     }
@@ -1458,6 +1498,7 @@ void ApplicationManager::Implementation::saveIfNeeded(std::function<void()> _cal
             //
             else {
                 saveChanges();
+                DatabaseLayer::Database::waitForAsyncWriting();
             }
 
             _callback();
@@ -1743,6 +1784,30 @@ bool ApplicationManager::Implementation::openProject(const QString& _path)
         return false;
     }
 
+    //
+    // Резервную копию, сохранённую в виде разности, сначала восстанавливаем в полноценный файл
+    // проекта в отдельной папке рядом с копиями, чтобы он не смешивался с ними, и открываем его
+    //
+    if (_path.endsWith(QString(".%1").arg(ExtensionHelper::starcBackupDelta()),
+                       Qt::CaseInsensitive)) {
+        const QFileInfo backupInfo(_path);
+        const QDir restoredBackupsFolder(QString("%1/restored").arg(backupInfo.absolutePath()));
+        restoredBackupsFolder.mkpath(".");
+        const auto restoredPath
+            = restoredBackupsFolder.absoluteFilePath(backupInfo.completeBaseName());
+        if (projectsManager->currentProject() != nullptr
+            && projectsManager->currentProject()->path() == restoredPath) {
+            closeCurrentProject();
+        }
+        if (!BackupBuilder::restore(_path, restoredPath)) {
+            StandardDialog::information(applicationView, {},
+                                        tr("Backup can't be restored. Please check, if newer "
+                                           "backups of this project are still in place."));
+            return false;
+        }
+        return openProject(restoredPath);
+    }
+
     if (projectsManager->project(_path) != nullptr && projectsManager->project(_path)->isLocal()
         && !QFileInfo::exists(_path)) {
         projectsManager->hideProject(_path);
@@ -2091,6 +2156,11 @@ void ApplicationManager::Implementation::closeCurrentProject()
         return;
     }
 
+    //
+    // Дожидаемся записи всех сохранённых изменений, пока проект ещё открыт
+    //
+    DatabaseLayer::Database::waitForAsyncWriting();
+
     Q_ASSERT(!lockFile.isNull());
     Q_ASSERT(lockFile->isLocked());
 
@@ -2334,7 +2404,7 @@ ApplicationManager::ApplicationManager(QObject* _parent)
 #endif
     Log::init(loggingLevel, logFilePath);
 
-    QString applicationVersion = "0.8.0";
+    QString applicationVersion = "0.8.1";
 #if defined(DEV_BUILD) && DEV_BUILD > 0
     applicationVersion += QString(" dev %1").arg(DEV_BUILD);
 #endif
@@ -2852,8 +2922,10 @@ void ApplicationManager::initConnections()
             d->accountManager.data(), &AccountManager::upgradeAccountToCloud);
     connect(d->projectManager.data(), &ProjectManager::buyCreditsRequested,
             d->accountManager.data(), &AccountManager::buyCredits);
-    connect(d->projectManager.data(), &ProjectManager::contentsChanged, this,
-            [this] { d->markChangesSaved(false); });
+    connect(d->projectManager.data(), &ProjectManager::contentsChanged, this, [this] {
+        ++d->changesGeneration;
+        d->markChangesSaved(false);
+    });
     connect(d->projectManager.data(), &ProjectManager::projectUuidChanged,
             d->projectsManager.data(), &ProjectsManager::setCurrentProjectUuid);
     connect(d->projectManager.data(), &ProjectManager::projectNameChanged, this,
@@ -1,7 +1,6 @@
 #include "project_manager.h"
 
 #include "include/custom_events.h"
-#include "project_models_facade.h"
 
 #include <business_layer/model/audioplay/audioplay_information_model.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model.h>
@@ -14,6 +13,7 @@
 #include <business_layer/model/locations/locations_model.h>
 #include <business_layer/model/presentation/presentation_model.h>
 #include <business_layer/model/project/project_information_model.h>
+#include <business_layer/model/project/project_models_facade.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
 #include <business_layer/model/stageplay/stageplay_information_model.h>
@@ -22,6 +22,7 @@
 #include <business_layer/model/structure/structure_model_item.h>
 #include <business_layer/model/structure/structure_proxy_model.h>
 #include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/model/text/text_model_xml.h>
 #include <business_layer/model/worlds/world_model.h>
 #include <business_layer/model/worlds/worlds_model.h>
 #include <business_layer/templates/text_template.h>
@@ -30,6 +31,7 @@
 #include <data_layer/storage/document_image_storage.h>
 #include <data_layer/storage/document_raw_data_storage.h>
 #include <data_layer/storage/document_storage.h>
+#include <data_layer/storage/search_index_storage.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
 #include <domain/document_change_object.h>
@@ -53,6 +55,7 @@
 #include <ui/widgets/dialog/dialog.h>
 #include <ui/widgets/dialog/standard_dialog.h>
 #include <ui/widgets/splitter/splitter.h>
+#include <utils/helpers/text_helper.h>
 #include <utils/logging.h>
 #include <utils/shugar.h>
 #include <utils/tools/debouncer.h>
@@ -60,12 +63,19 @@
 #include <QAction>
 #include <QApplication>
 #include <QDateTime>
+#include <QFutureWatcher>
 #include <QHBoxLayout>
 #include <QSet>
 #include <QShortcut>
 #include <QTimer>
 #include <QUuid>
 #include <QVariantAnimation>
+#include <QXmlStreamReader>
+#include <QtConcurrent>
+
+#include <limits>
+
+using BusinessLayer::ProjectModelsFacade;
 
 
 namespace ManagementLayer {
@@ -75,6 +85,8 @@ namespace {
 const QLatin1String kCurrentViewMimeTypeKey("view-mime-type");
 const QLatin1String kCurrentVersionKey("current-version");
 constexpr int kCollaboratorsUpdateTimeoutMs = 60 * 1000;
+constexpr int kSearchIndexUpdateTimeoutMs = 1000;
+constexpr int kSearchIndexBuildIntervalMs = 50;
 
 /**
  * @brief Является ли заданный элемент текстовым
@@ -104,6 +116,47 @@ bool isTextItem(BusinessLayer::StructureModelItem* _item)
     return textItems.contains(_item->type());
 }
 
+/**
+ * @brief Нужно ли добавлять документ заданного элемента в полнотекстовый индекс
+ * @note Алиасы не индексируем, т.к. их модели работают с документом текста
+ */
+bool isSearchIndexedItem(BusinessLayer::StructureModelItem* _item)
+{
+    if (_item->type() == Domain::DocumentObjectType::ScreenplayTreatment
+        || _item->type() == Domain::DocumentObjectType::NovelOutline) {
+        return false;
+    }
+
+    return _item->type() == Domain::DocumentObjectType::Folder || isTextItem(_item);
+}
+
+/**
+ * @brief Извлечь абзацы для полнотекстового индекса из сохранённого содержимого документа
+ * @note Выполняется в фоновом потоке, поэтому работает с xml напрямую, не строя модель. Берётся
+ *       только текст абзацев, т.к. заголовки папок и групп это текст их первых абзацев
+ */
+QVector<QString> searchIndexParagraphs(const QByteArray& _content)
+{
+    QVector<QString> paragraphs;
+    QXmlStreamReader contentReader(_content);
+    while (!contentReader.atEnd()) {
+        contentReader.readNext();
+        if (!contentReader.isStartElement()
+            || contentReader.name() != BusinessLayer::xml::kValueTag) {
+            continue;
+        }
+
+        auto text = TextHelper::fromHtmlEscaped(contentReader.readElementText());
+        if (text.isEmpty()) {
+            continue;
+        }
+
+        text.replace(QChar::LineFeed, QChar::LineSeparator);
+        paragraphs.append(text);
+    }
+    return paragraphs;
+}
+
 /**
  * @brief Сформировать ключ настроек проекта
  */
@@ -284,6 +337,40 @@ public:
      */
     void updateViewsEditingMode();
 
+    /**
+     * @brief Поставить в очередь полнотекстового индекса документы, изменённые с момента
+     *        последнего обновления
+     */
+    void updateSearchIndex();
+
+    /**
+     * @brief Сразу записать в полнотекстовый индекс изменённые документы и прервать индексацию
+     *        остальных
+     * @note Используется при закрытии проекта
+     */
+    void flushSearchIndex();
+
+    /**
+     * @brief Получить сохранённое содержимое документа для полнотекстового индекса
+     * @note Если содержимое документа не было загружено, то оно не остаётся в памяти
+     */
+    QByteArray searchIndexContent(const QUuid& _documentUuid) const;
+
+    /**
+     * @brief Записать в полнотекстовый индекс абзацы документа, извлечённые в фоновом потоке
+     */
+    void applyIndexedParagraphs();
+
+    /**
+     * @brief Собрать документы проекта, ещё не попавшие в полнотекстовый индекс
+     */
+    void collectNotIndexedDocuments(BusinessLayer::StructureModelItem* _item);
+
+    /**
+     * @brief Извлечь в фоновом потоке абзацы очередного документа из очереди индексации
+     */
+    void indexNextDocument();
+
     //
     // Данные
     //
@@ -309,6 +396,7 @@ public:
         struct Window {
             Ui::IDocumentView* view = nullptr;
             QModelIndex itemIndex = {};
+            QPointer<BusinessLayer::AbstractModel> model = {};
         };
         QVector<Window> windows = {};
 
@@ -453,6 +541,25 @@ public:
      * @brief Возможность экспортирования для текущего документа
      */
     bool isCurrentDocumentExportAvailable = false;
+
+    /**
+     * @brief Документы, изменённые с момента последнего обновления полнотекстового индекса
+     */
+    QSet<QUuid> documentsToReindex;
+    QTimer searchIndexUpdateTimer;
+
+    /**
+     * @brief Очередь документов для полнотекстового индекса: изменённые и ещё ни разу не
+     *        попадавшие в индекс, они индексируются по одному, чтобы не нагружать базу данных
+     */
+    QVector<QUuid> documentsToIndex;
+    QTimer searchIndexBuildTimer;
+
+    /**
+     * @brief Документ, абзацы которого извлекаются в фоновом потоке, и наблюдатель за этим
+     */
+    QUuid indexingDocumentUuid;
+    QFutureWatcher<QVector<QString>> searchIndexWatcher;
 };
 
 ProjectManager::Implementation::Implementation(ProjectManager* _q, QWidget* _parent,
@@ -478,6 +585,25 @@ ProjectManager::Implementation::Implementation(ProjectManager* _q, QWidget* _par
     toolBar->hide();
     navigator->hide();
     view.left->installEventFilter(_q);
+
+    //
+    // Не выгружаем модели, которые отображаются в редакторах или ожидают синхронизации
+    //
+    modelsFacade.setModelInUseChecker([this](BusinessLayer::AbstractModel* _model) {
+        if (_model == view.activeModel || _model == view.inactiveModel) {
+            return true;
+        }
+        for (const auto& window : std::as_const(view.windows)) {
+            if (_model == window.model) {
+                return true;
+            }
+        }
+        if (_model->document() == nullptr) {
+            return true;
+        }
+        const auto documentUuid = _model->document()->uuid();
+        return documentToSyncTimer.contains(documentUuid) || changesForSync.contains(documentUuid);
+    });
     view.right->hide();
     view.container->setWidgets(view.left, view.right);
     view.container->setSizes({ 1, 0 });
@@ -494,6 +620,19 @@ ProjectManager::Implementation::Implementation(ProjectManager* _q, QWidget* _par
     toolBar->setOptions({ splitScreenAction }, AppBarOptionsLevel::View);
     splitScreenShortcut->setKey(QKeySequence("F2"));
     splitScreenShortcut->setContext(Qt::ApplicationShortcut);
+
+    searchIndexUpdateTimer.setSingleShot(true);
+    searchIndexUpdateTimer.setInterval(kSearchIndexUpdateTimeoutMs);
+    QObject::connect(&searchIndexUpdateTimer, &QTimer::timeout, q, [this] { updateSearchIndex(); });
+    searchIndexBuildTimer.setSingleShot(true);
+    searchIndexBuildTimer.setInterval(kSearchIndexBuildIntervalMs);
+    QObject::connect(&searchIndexBuildTimer, &QTimer::timeout, q, [this] { indexNextDocument(); });
+    QObject::connect(&searchIndexWatcher, &QFutureWatcherBase::finished, q, [this] {
+        applyIndexedParagraphs();
+        if (!documentsToIndex.isEmpty()) {
+            searchIndexBuildTimer.start();
+        }
+    });
 }
 
 void ProjectManager::Implementation::updateOptionsText()
@@ -814,7 +953,7 @@ void ProjectManager::Implementation::openCurrentDocumentInNewWindow()
         //
         windowWidget->setWindowTitle(view.activeModel->documentName());
 
-        view.windows.append({ windowView, view.activeIndex });
+        view.windows.append({ windowView, view.activeIndex, view.activeModel });
 
         const auto item = projectStructureModel->itemForIndex(view.activeIndex);
         windowView->setEditingMode(documentEditingMode(item));
@@ -1836,6 +1975,103 @@ void ProjectManager::Implementation::updateViewsEditingMode()
     }
 }
 
+void ProjectManager::Implementation::updateSearchIndex()
+{
+    searchIndexUpdateTimer.stop();
+
+    //
+    // Изменённые документы индексируем раньше тех, что ещё ни разу не попадали в индекс
+    //
+    for (const auto& documentUuid : std::as_const(documentsToReindex)) {
+        documentsToIndex.removeOne(documentUuid);
+        documentsToIndex.prepend(documentUuid);
+    }
+    documentsToReindex.clear();
+
+    if (!searchIndexWatcher.isRunning()) {
+        indexNextDocument();
+    }
+}
+
+void ProjectManager::Implementation::flushSearchIndex()
+{
+    searchIndexUpdateTimer.stop();
+    searchIndexBuildTimer.stop();
+    documentsToIndex.clear();
+
+    searchIndexWatcher.waitForFinished();
+    applyIndexedParagraphs();
+
+    for (const auto& documentUuid : std::as_const(documentsToReindex)) {
+        DataStorageLayer::StorageFacade::searchIndexStorage()->updateDocument(
+            documentUuid, searchIndexParagraphs(searchIndexContent(documentUuid)));
+    }
+    documentsToReindex.clear();
+}
+
+QByteArray ProjectManager::Implementation::searchIndexContent(const QUuid& _documentUuid) const
+{
+    const auto document
+        = DataStorageLayer::StorageFacade::documentStorage()->document(_documentUuid);
+    if (document == nullptr) {
+        return {};
+    }
+
+    const auto isContentLoaded = document->isContentLoaded();
+    const auto content = document->content();
+    if (!isContentLoaded) {
+        document->unloadContent();
+    }
+    return content;
+}
+
+void ProjectManager::Implementation::applyIndexedParagraphs()
+{
+    //
+    // Результат прерванной индексации уже не нужен
+    //
+    if (indexingDocumentUuid.isNull()) {
+        return;
+    }
+
+    DataStorageLayer::StorageFacade::searchIndexStorage()->updateDocument(
+        indexingDocumentUuid, searchIndexWatcher.result());
+    indexingDocumentUuid = {};
+}
+
+void ProjectManager::Implementation::collectNotIndexedDocuments(
+    BusinessLayer::StructureModelItem* _item)
+{
+    if (_item == nullptr) {
+        return;
+    }
+
+    if (isSearchIndexedItem(_item)
+        && !DataStorageLayer::StorageFacade::searchIndexStorage()->isDocumentIndexed(
+            _item->uuid())) {
+        documentsToIndex.append(_item->uuid());
+    }
+
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        collectNotIndexedDocuments(_item->childAt(childIndex));
+    }
+}
+
+void ProjectManager::Implementation::indexNextDocument()
+{
+    if (documentsToIndex.isEmpty() || searchIndexWatcher.isRunning()) {
+        return;
+    }
+
+    //
+    // Содержимое документа читаем из базы здесь, а абзацы из него извлекаем в фоновом потоке.
+    // Документ индексируется, даже если у него нет содержимого, например у пустой папки, чтобы
+    // он не попадал в очередь при каждом открытии проекта
+    //
+    indexingDocumentUuid = documentsToIndex.takeFirst();
+    searchIndexWatcher.setFuture(
+        QtConcurrent::run(searchIndexParagraphs, searchIndexContent(indexingDocumentUuid)));
+}
 
 // ****
 
@@ -3147,6 +3383,13 @@ void ProjectManager::checkAvailabilityToEdit()
 
 void ProjectManager::loadCurrentProject(BusinessLayer::ProjectsModelProjectItem* _project)
 {
+    //
+    // Задаём лимит памяти для загруженных моделей документов
+    //
+    d->modelsFacade.setMemoryLimit(
+        settingsValue(DataStorageLayer::kApplicationLoadedDocumentsMemoryLimitKey).toLongLong()
+        * 1024 * 1024);
+
     //
     // Загружаем структуру
     //
@@ -3203,6 +3446,15 @@ void ProjectManager::loadCurrentProject(BusinessLayer::ProjectsModelProjectItem*
     // Обновляем режим редактирования для всех вьюх
     //
     d->updateViewsEditingMode();
+
+    //
+    // Добавляем в полнотекстовый индекс документы, которые в него ещё не попадали
+    //
+    d->documentsToIndex.clear();
+    d->collectNotIndexedDocuments(d->projectStructureModel->itemForIndex({}));
+    if (!d->documentsToIndex.isEmpty()) {
+        d->searchIndexBuildTimer.start();
+    }
 }
 
 void ProjectManager::updateCurrentProject(BusinessLayer::ProjectsModelProjectItem* _project)
@@ -3254,6 +3506,16 @@ void ProjectManager::restoreCurrentProjectState(const QString& _path)
 
 void ProjectManager::closeCurrentProject(const QString& _path)
 {
+    //
+    // Дописываем в полнотекстовый индекс последние правки и прерываем индексацию документов
+    //
+    d->flushSearchIndex();
+
+    //
+    // Сжимаем историю изменений документов проекта
+    //
+    compactChangesHistory();
+
     //
     // Сохранить состояние дерева
     //
@@ -3336,6 +3598,79 @@ void ProjectManager::clearChangesHistory()
     DataStorageLayer::StorageFacade::documentChangeStorage()->removeAll();
 }
 
+void ProjectManager::compactChangesHistory()
+{
+    const auto compactionAge
+        = settingsValue(DataStorageLayer::kApplicationChangesHistoryCompactionAgeKey).toInt();
+    if (compactionAge <= 0) {
+        return;
+    }
+
+    //
+    // Объединяем изменения только за полные дни, чтобы день изменений попадал под сжатие целиком
+    //
+    const QDateTime before(QDateTime::currentDateTimeUtc().date().addDays(-compactionAge),
+                           QTime(0, 0), Qt::UTC);
+    //
+    // Восстановление содержимого документа по истории изменений обходится недёшево, поэтому
+    // сжимаем историю, только когда объединение избавит от заметного количества изменений
+    //
+    constexpr int kMinCompactableChanges = 100;
+    auto documentChangeStorage = DataStorageLayer::StorageFacade::documentChangeStorage();
+    const auto documentsUuids
+        = documentChangeStorage->compactableDocuments(before, kMinCompactableChanges);
+    //
+    // ... содержимое документов, модели которых ещё не перенесли в них свои изменения, не
+    //     соответствует сохранённой истории
+    //
+    QSet<Domain::DocumentObject*> documentsWithPendingChanges;
+    for (auto model : d->modelsFacade.loadedModels()) {
+        if (model->document() != nullptr && model->hasPendingChanges()) {
+            documentsWithPendingChanges.insert(model->document());
+        }
+    }
+    const auto structureDocument = d->projectStructureModel->document();
+    bool isCompacted = false;
+    for (const auto& documentUuid : documentsUuids) {
+        //
+        // Модель документа для этого не нужна, патчи накладываются моделью без документа, а
+        // содержимое документа, загруженное только ради сжатия, сразу выгружается
+        //
+        auto document = structureDocument != nullptr && structureDocument->uuid() == documentUuid
+            ? structureDocument
+            : DataStorageLayer::StorageFacade::documentStorage()->document(documentUuid);
+        if (document == nullptr || documentsWithPendingChanges.contains(document)) {
+            continue;
+        }
+        const auto model = document == structureDocument
+            ? d->projectStructureModel
+            : d->modelsFacade.historyModelFor(document->type());
+        if (model == nullptr) {
+            continue;
+        }
+
+        const auto isContentLoaded = document->isContentLoaded();
+        isCompacted |= documentChangeStorage->compactDocumentChanges(
+            documentUuid, document->content(), before,
+            [model](const QByteArray& _content, const QVector<QByteArray>& _patches) {
+                return model->revertDocumentChanges(_content, _patches);
+            },
+            [model](const QByteArray& _from, const QByteArray& _to) {
+                return model->makeDocumentPatch(_from, _to);
+            });
+        if (!isContentLoaded) {
+            document->unloadContent();
+        }
+    }
+
+    //
+    // Возвращаем освободившееся место
+    //
+    if (isCompacted) {
+        DatabaseLayer::Database::incrementalVacuum();
+    }
+}
+
 void ProjectManager::saveChanges()
 {
     //
@@ -4660,6 +4995,14 @@ void ProjectManager::handleModelChange(BusinessLayer::AbstractModel* _model,
         StorageFacade::settingsStorage()->accountName(),
         StorageFacade::settingsStorage()->accountEmail());
 
+    //
+    // Абзацы документа в полнотекстовом индексе обновим, когда пользователь сделает паузу в работе
+    //
+    if (qobject_cast<BusinessLayer::TextModel*>(_model) != nullptr) {
+        d->documentsToReindex.insert(_model->document()->uuid());
+        d->searchIndexUpdateTimer.start();
+    }
+
     emit contentsChanged(_model);
 }
 
@@ -5277,6 +5620,11 @@ void ProjectManager::updateCurrentDocument(BusinessLayer::AbstractModel* _model,
     d->view.activeViewMimeType = _viewMimeType;
 
     emit currentModelChanged(d->view.activeModel);
+
+    //
+    // После смены документа выгружаем давно не использовавшиеся модели, если их стало много
+    //
+    d->modelsFacade.evictIdleModels();
 }
 
 } // namespace ManagementLayer
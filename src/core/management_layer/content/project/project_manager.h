@@ -90,6 +90,11 @@ public:
      */
     void clearChangesHistory();
 
+    /**
+     * @brief Объединить по дням старые синхронизированные изменения документов проекта
+     */
+    void compactChangesHistory();
+
     /**
      * @brief Сохранить изменения проекта
      */
@@ -1347,14 +1347,14 @@ void ProjectsManager::setCurrentProjectCanBeSynced(bool _can)
 void ProjectsManager::closeCurrentProject()
 {
     //
-    // Закрываем сам файл с базой данных
+    // Очищаем хранилища, вместе с ними освобождаются и подготовленные в рамках соединения запросы
     //
-    DatabaseLayer::Database::closeCurrentFile();
+    DataStorageLayer::StorageFacade::clearStorages();
 
     //
-    // Очищаем хранилища
+    // Закрываем сам файл с базой данных
     //
-    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
 
     //
     // Для теневого проекта, удаляем временный файл
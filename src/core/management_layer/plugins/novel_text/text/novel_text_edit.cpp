@@ -242,6 +242,10 @@ NovelTextEdit::NovelTextEdit(QWidget* _parent)
 
     setDocument(&d->document);
     setCapitalizeWords(false);
+    //
+    // Романы бывают очень длинными, поэтому ошибки подсвечиваем начиная с видимой области
+    //
+    setLazySpellCheckHighlighting(true);
 
 
     connect(document(), &QTextDocument::contentsChange, this,
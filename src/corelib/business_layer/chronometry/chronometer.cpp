@@ -8,6 +8,9 @@
 #include <utils/helpers/measurement_helper.h>
 #include <utils/helpers/text_helper.h>
 
+#include <QCache>
+#include <QHash>
+#include <QPageSize>
 #include <QTextBlock>
 #include <QtMath>
 
@@ -34,6 +37,47 @@ protected:
     const ChronometerOptions& m_options;
 };
 
+/**
+ * @brief Геометрия блока заданного типа на странице шаблона
+ */
+struct BlockGeometry {
+    //
+    // Параметры шаблона, из которых рассчитана геометрия
+    //
+    QPageSize::PageSizeId pageSizeId = QPageSize::A4;
+    QMarginsF pageMargins;
+    QMarginsF blockMargins;
+    QFont font;
+    int linesBefore = 0;
+    int linesAfter = 0;
+
+    //
+    // Рассчитанные значения в пикселях
+    //
+    qreal pageHeight = 0.0;
+    qreal textWidth = 0.0;
+    qreal additionalHeight = 0.0;
+};
+
+/**
+ * @brief Ключ кэша высот текста
+ */
+struct TextHeightKey {
+    QString fontKey;
+    qreal width = 0.0;
+    QString text;
+};
+
+bool operator==(const TextHeightKey& _lhs, const TextHeightKey& _rhs)
+{
+    return _lhs.width == _rhs.width && _lhs.fontKey == _rhs.fontKey && _lhs.text == _rhs.text;
+}
+
+uint qHash(const TextHeightKey& _key, uint _seed = 0)
+{
+    return ::qHash(_key.text, _seed) ^ ::qHash(_key.fontKey) ^ ::qHash(_key.width);
+}
+
 /**
  * @brief Расчёт хронометража по количеству страниц
  */
@@ -49,37 +93,89 @@ public:
     {
         const auto milliseconds = m_options.page.seconds * 1000;
 
-        const auto mmPageSize
-            = QPageSize(_textTemplate.pageSizeId()).rect(QPageSize::Millimeter).size();
+        const auto& geometry = blockGeometry(_type, _textTemplate);
+        const auto blockHeight = textHeight(_text, geometry) + geometry.additionalHeight;
+
+        //
+        // Добавляем небольшую дельту, т.к. из-за приблизительности рассчётов не удаётся попадать
+        // точно в минуты
+        //
+        return std::chrono::milliseconds{ qCeil(blockHeight / geometry.pageHeight * milliseconds
+                                                * 1.01) };
+    }
+
+private:
+    /**
+     * @brief Получить геометрию блока, пересчитав её, только если изменился шаблон
+     */
+    static const BlockGeometry& blockGeometry(TextParagraphType _type,
+                                              const TextTemplate& _textTemplate)
+    {
+        static QHash<QPair<QString, TextParagraphType>, BlockGeometry> s_geometries;
+
+        const auto& blockStyle = _textTemplate.paragraphStyle(_type);
+        auto& geometry = s_geometries[{ _textTemplate.id(), _type }];
+        if (geometry.pageHeight > 0.0 && geometry.pageSizeId == _textTemplate.pageSizeId()
+            && geometry.pageMargins == _textTemplate.pageMargins()
+            && geometry.blockMargins == blockStyle.margins() && geometry.font == blockStyle.font()
+            && geometry.linesBefore == blockStyle.linesBefore()
+            && geometry.linesAfter == blockStyle.linesAfter()) {
+            return geometry;
+        }
+
+        geometry.pageSizeId = _textTemplate.pageSizeId();
+        geometry.pageMargins = _textTemplate.pageMargins();
+        geometry.blockMargins = blockStyle.margins();
+        geometry.font = blockStyle.font();
+        geometry.linesBefore = blockStyle.linesBefore();
+        geometry.linesAfter = blockStyle.linesAfter();
+
+        const auto mmPageSize = QPageSize(geometry.pageSizeId).rect(QPageSize::Millimeter).size();
         const bool x = true, y = false;
         const auto pxPageSize = QSizeF(MeasurementHelper::mmToPx(mmPageSize.width(), x),
                                        MeasurementHelper::mmToPx(mmPageSize.height(), y));
-        const auto mmPageMargins = _textTemplate.pageMargins();
+        const auto& mmPageMargins = geometry.pageMargins;
         const auto pxPageMargins = QMarginsF(MeasurementHelper::mmToPx(mmPageMargins.left(), x),
                                              MeasurementHelper::mmToPx(mmPageMargins.top(), y),
                                              MeasurementHelper::mmToPx(mmPageMargins.right(), x),
                                              MeasurementHelper::mmToPx(mmPageMargins.bottom(), y));
-        const auto pageHeight = pxPageSize.height() - pxPageMargins.top() - pxPageMargins.bottom();
+        geometry.pageHeight = pxPageSize.height() - pxPageMargins.top() - pxPageMargins.bottom();
 
-        const auto& blockStyle = _textTemplate.paragraphStyle(_type);
-        const auto mmBlockMargins = blockStyle.margins();
+        const auto& mmBlockMargins = geometry.blockMargins;
         const auto pxBlockMargins
             = QMarginsF(MeasurementHelper::mmToPx(mmBlockMargins.left(), x),
                         MeasurementHelper::mmToPx(mmBlockMargins.top(), y),
                         MeasurementHelper::mmToPx(mmBlockMargins.right(), x),
                         MeasurementHelper::mmToPx(mmBlockMargins.bottom(), y));
-        const auto textWidth = pxPageSize.width() - pxPageMargins.left() - pxPageMargins.right()
+        geometry.textWidth = pxPageSize.width() - pxPageMargins.left() - pxPageMargins.right()
             - pxBlockMargins.left() - pxBlockMargins.right();
-        const auto textLineHeight = TextHelper::fineLineSpacing(blockStyle.font());
-        const auto textHeight = TextHelper::heightForWidth(_text, blockStyle.font(), textWidth)
-            + pxBlockMargins.top() + pxBlockMargins.bottom()
-            + blockStyle.linesBefore() * textLineHeight + blockStyle.linesAfter() * textLineHeight;
+        const auto textLineHeight = TextHelper::fineLineSpacing(geometry.font);
+        geometry.additionalHeight = pxBlockMargins.top() + pxBlockMargins.bottom()
+            + geometry.linesBefore * textLineHeight + geometry.linesAfter * textLineHeight;
+
+        return geometry;
+    }
 
+    /**
+     * @brief Получить высоту текста, раскладывая его на строки, только если такой текст с
+     *        заданными шрифтом и шириной ещё не раскладывался
+     */
+    static qreal textHeight(const QString& _text, const BlockGeometry& _geometry)
+    {
         //
-        // Добавляем небольшую дельту, т.к. из-за приблизительности рассчётов не удаётся попадать
-        // точно в минуты
+        // Ограничиваем кэш количеством абзацев, заведомо большим, чем в одном сценарии
         //
-        return std::chrono::milliseconds{ qCeil(textHeight / pageHeight * milliseconds * 1.01) };
+        const int kMaximumCachedHeights = 50000;
+        static QCache<TextHeightKey, qreal> s_heights(kMaximumCachedHeights);
+
+        TextHeightKey key{ _geometry.font.key(), _geometry.textWidth, _text };
+        if (const auto height = s_heights.object(key)) {
+            return *height;
+        }
+
+        const auto height = TextHelper::heightForWidth(_text, _geometry.font, _geometry.textWidth);
+        s_heights.insert(key, new qreal(height));
+        return height;
     }
 };
 
@@ -0,0 +1,374 @@
+#include "pagination_service.h"
+
+#include "text_document.h"
+
+#include <business_layer/document/audioplay/text/audioplay_text_document.h>
+#include <business_layer/document/comic_book/text/comic_book_text_document.h>
+#include <business_layer/document/novel/text/novel_text_document.h>
+#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/document/simple_text/simple_text_document.h>
+#include <business_layer/document/stageplay/text/stageplay_text_document.h>
+#include <business_layer/model/audioplay/text/audioplay_text_model.h>
+#include <business_layer/model/comic_book/text/comic_book_text_model.h>
+#include <business_layer/model/novel/text/novel_text_model.h>
+#include <business_layer/model/screenplay/text/screenplay_text_model.h>
+#include <business_layer/model/simple_text/simple_text_model.h>
+#include <business_layer/model/stageplay/text/stageplay_text_model.h>
+#include <business_layer/model/text/text_model_group_item.h>
+#include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/templates/templates_facade.h>
+#include <business_layer/templates/text_template.h>
+#include <ui/widgets/text_edit/page/page_metrics.h>
+
+#include <QAbstractTextDocumentLayout>
+#include <QHash>
+#include <QTextBlock>
+#include <QTextFrame>
+#include <QTextLayout>
+#include <QThread>
+
+#include <algorithm>
+#include <functional>
+
+
+namespace BusinessLayer {
+
+class PaginationService::Implementation
+{
+public:
+    Implementation(TextModel* _model, TextDocument* _document);
+
+    /**
+     * @brief Актуализировать раскладку документа перед обращением к страницам
+     */
+    void updateLayout();
+
+    /**
+     * @brief Настроить размер страницы и поля документа, как это делает редактор в постраничном
+     *        режиме
+     */
+    void updatePageGeometry();
+
+    /**
+     * @brief Номер страницы, на которую попадает заданная позиция документа
+     */
+    int pageForPosition(int _position) const;
+
+    /**
+     * @brief Сбросить все закешированные номера страниц
+     */
+    void invalidatePages();
+
+    /**
+     * @brief Сбросить закешированные номера страниц, начиная со страницы изменённого элемента
+     */
+    void invalidatePagesFrom(TextModelItem* _item);
+
+
+    /**
+     * @brief Модель, которую раскладываем по страницам
+     */
+    TextModel* model = nullptr;
+
+    /**
+     * @brief Документ, который раскладывается по страницам
+     */
+    QScopedPointer<TextDocument> document;
+
+    /**
+     * @brief Параметры шаблона, с которыми был разложен документ
+     */
+    QString templateId;
+    QPageSize::PageSizeId pageSizeId = QPageSize::A4;
+    QMarginsF pageMargins;
+
+    /**
+     * @brief Закешированные страницы элементов
+     */
+    QHash<const TextModelItem*, int> itemsPages;
+
+    /**
+     * @brief Количество страниц, запомненное при заморозке сервиса
+     * @note Используется только замороженным сервисом, у которого уже нет своего документа
+     */
+    int frozenPageCount = 0;
+};
+
+PaginationService::Implementation::Implementation(TextModel* _model, TextDocument* _document)
+    : model(_model)
+    , document(_document)
+{
+    //
+    // Переносим строки так же, как это делает редактор
+    //
+    auto textOption = document->defaultTextOption();
+    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    document->setDefaultTextOption(textOption);
+}
+
+void PaginationService::Implementation::updateLayout()
+{
+    if (document.isNull()) {
+        return;
+    }
+
+    const auto& textTemplate = TemplatesFacade::textTemplate(model);
+    if (document->model() == nullptr || templateId != textTemplate.id()
+        || pageSizeId != textTemplate.pageSizeId()
+        || pageMargins != textTemplate.pageMargins()) {
+        templateId = textTemplate.id();
+        pageSizeId = textTemplate.pageSizeId();
+        pageMargins = textTemplate.pageMargins();
+        updatePageGeometry();
+
+        //
+        // Стили блоков берутся из шаблона при установке модели, поэтому для смены шаблона
+        // документ нужно собрать заново
+        //
+        const bool kCanChangeModel = false;
+        document->setModel(nullptr);
+        document->setModel(model, kCanChangeModel);
+
+        invalidatePages();
+        return;
+    }
+
+    //
+    // Корректировки после изменения модели выполняются отложенно, поэтому применяем их сразу,
+    // чтобы страницы совпадали с тем, что получится при полной раскладке
+    //
+    document->applyPendingCorrections();
+}
+
+void PaginationService::Implementation::updatePageGeometry()
+{
+    const PageMetrics pageMetrics(pageSizeId, pageMargins);
+    document->setPageSize(pageMetrics.pxPageSize());
+    document->setDocumentMargin(0.0);
+
+    const auto& margins = pageMetrics.pxPageMargins();
+    auto rootFrameFormat = document->rootFrame()->frameFormat();
+    rootFrameFormat.setLeftMargin(margins.left());
+    rootFrameFormat.setTopMargin(margins.top());
+    rootFrameFormat.setRightMargin(margins.right());
+    rootFrameFormat.setBottomMargin(margins.bottom());
+    document->rootFrame()->setFrameFormat(rootFrameFormat);
+}
+
+int PaginationService::Implementation::pageForPosition(int _position) const
+{
+    const auto block = document->findBlock(_position);
+    auto top = document->documentLayout()->blockBoundingRect(block).top();
+    if (block.layout() != nullptr) {
+        const auto line = block.layout()->lineForTextPosition(_position - block.position());
+        if (line.isValid()) {
+            top += line.y();
+        }
+    }
+    return static_cast<int>(top / document->pageSize().height()) + 1;
+}
+
+void PaginationService::Implementation::invalidatePages()
+{
+    itemsPages.clear();
+}
+
+void PaginationService::Implementation::invalidatePagesFrom(TextModelItem* _item)
+{
+    if (itemsPages.isEmpty()) {
+        return;
+    }
+
+    //
+    // Изменение не сдвигает элементы, которые идут перед ним, поэтому ищем ближайший
+    // предшествующий элемент с известной страницей, начиная с самого изменённого
+    //
+    int changedPage = 0;
+    auto item = _item;
+    while (item != nullptr) {
+        if (const auto iter = itemsPages.constFind(item); iter != itemsPages.constEnd()) {
+            changedPage = iter.value();
+            break;
+        }
+
+        auto parent = item->parent();
+        if (parent == nullptr) {
+            break;
+        }
+        const auto row = parent->rowOfChild(item);
+        if (row <= 0) {
+            item = parent;
+            continue;
+        }
+        item = parent->childAt(row - 1);
+        while (item->hasChildren()) {
+            item = item->childAt(item->childCount() - 1);
+        }
+    }
+    if (changedPage == 0) {
+        invalidatePages();
+        return;
+    }
+
+    //
+    // ... корректор может перенести на следующую страницу и блоки, предшествующие изменённому,
+    //     например имя персонажа перед репликой, поэтому сбрасываем и предыдущую страницу
+    //
+    const auto firstInvalidPage = changedPage - 1;
+    for (auto iter = itemsPages.begin(); iter != itemsPages.end();) {
+        if (iter.value() >= firstInvalidPage) {
+            iter = itemsPages.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+
+// ****
+
+
+PaginationService* PaginationService::forModel(TextModel* _model)
+{
+    if (_model == nullptr) {
+        return nullptr;
+    }
+
+    if (auto service = _model->findChild<PaginationService*>({}, Qt::FindDirectChildrenOnly)) {
+        return service;
+    }
+
+    //
+    // Сервис живёт вместе с моделью, поэтому создать его можно только в её потоке
+    //
+    Q_ASSERT(QThread::currentThread() == _model->thread());
+
+    TextDocument* document = nullptr;
+    if (qobject_cast<ScreenplayTextModel*>(_model)) {
+        document = new ScreenplayTextDocument;
+    } else if (qobject_cast<ComicBookTextModel*>(_model)) {
+        document = new ComicBookTextDocument;
+    } else if (qobject_cast<AudioplayTextModel*>(_model)) {
+        document = new AudioplayTextDocument;
+    } else if (qobject_cast<StageplayTextModel*>(_model)) {
+        document = new StageplayTextDocument;
+    } else if (qobject_cast<NovelTextModel*>(_model)) {
+        document = new NovelTextDocument;
+    } else if (qobject_cast<SimpleTextModel*>(_model)) {
+        document = new SimpleTextDocument;
+    } else {
+        return nullptr;
+    }
+
+    return new PaginationService(_model, document);
+}
+
+PaginationService::PaginationService(TextModel* _model, TextDocument* _document)
+    : QObject(_model)
+    , d(new Implementation(_model, _document))
+{
+    //
+    // Документ сам перекладывает изменившиеся блоки, а вот элементы после места изменения могут
+    // сместиться на другие страницы, поэтому сбрасываем закешированные страницы начиная с него
+    //
+    connect(_model, &TextModel::rowsInserted, this,
+            [this](const QModelIndex& _parent, int _first) {
+                d->invalidatePagesFrom(d->model->itemForIndex(d->model->index(_first, 0, _parent)));
+            });
+    //
+    // ... удаляемые элементы лежат после места изменения, поэтому тоже будут убраны из кеша
+    //
+    connect(_model, &TextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                d->invalidatePagesFrom(d->model->itemForIndex(d->model->index(_first, 0, _parent)));
+            });
+    connect(_model, &TextModel::rowsMoved, this, [this] { d->invalidatePages(); });
+    connect(_model, &TextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight,
+                   const QVector<int>& _roles) {
+                Q_UNUSED(_bottomRight)
+
+                if (_roles.size() == 1
+                    && (_roles.constFirst() == TextModelGroupItem::GroupNumberRole
+                        || _roles.constFirst() == TextModelTextItem::TextNumberRole)) {
+                    return;
+                }
+
+                d->invalidatePagesFrom(d->model->itemForIndex(_topLeft));
+            });
+    //
+    // При сбросе модели документ переустанавливает её с возможностью изменения, поэтому
+    // отключаем его заранее, а заново модель будет установлена при следующем обращении
+    //
+    connect(_model, &TextModel::modelAboutToBeReset, this, [this] {
+        d->document->setModel(nullptr);
+        d->invalidatePages();
+    });
+}
+
+PaginationService::~PaginationService() = default;
+
+void PaginationService::freeze()
+{
+    if (d->document.isNull()) {
+        return;
+    }
+
+    d->model->disconnect(this);
+    d->frozenPageCount = pageCount();
+
+    std::function<void(TextModelItem*)> collectItemsPages;
+    collectItemsPages = [this, &collectItemsPages](TextModelItem* _item) {
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            auto child = _item->childAt(childIndex);
+            if (child->type() == TextModelItemType::Text) {
+                pageForItem(child);
+            } else if (child->hasChildren()) {
+                collectItemsPages(child);
+            }
+        }
+    };
+    collectItemsPages(d->model->itemForIndex({}));
+
+    d->document.reset();
+}
+
+int PaginationService::pageCount()
+{
+    if (d->document.isNull()) {
+        return d->frozenPageCount;
+    }
+
+    d->updateLayout();
+    return d->document->pageCount();
+}
+
+int PaginationService::pageForItem(TextModelItem* _item)
+{
+    const int invalidPage = 0;
+    if (_item == nullptr) {
+        return invalidPage;
+    }
+
+    if (d->document.isNull()) {
+        return d->itemsPages.value(_item, invalidPage);
+    }
+
+    d->updateLayout();
+
+    const auto iter = d->itemsPages.constFind(_item);
+    if (iter != d->itemsPages.constEnd()) {
+        return iter.value();
+    }
+
+    const auto position = d->document->itemPosition(d->model->indexForItem(_item), true);
+    if (position < 0) {
+        return invalidPage;
+    }
+
+    const auto page = d->pageForPosition(position);
+    d->itemsPages.insert(_item, page);
+    return page;
+}
+
+} // namespace BusinessLayer
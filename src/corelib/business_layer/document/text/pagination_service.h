@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QObject>
+
+#include <corelib_global.h>
+
+
+namespace BusinessLayer {
+class TextDocument;
+class TextModel;
+class TextModelItem;
+
+/**
+ * @brief Сервис постраничной раскладки текстовой модели
+ * @note Один экземпляр на модель, разделяется между отчётами, графиками и прочими потребителями,
+ *       которым нужно знать страницы элементов модели. Документ сервиса живёт вместе с моделью и
+ *       перекладывается при её изменении только в изменённых местах, а закешированные страницы
+ *       элементов сбрасываются только начиная со страницы изменения
+ */
+class CORE_LIBRARY_EXPORT PaginationService : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Получить сервис для заданной модели, создав его при первом обращении
+     * @return nullptr, если для модели данного типа нельзя построить документ
+     */
+    static PaginationService* forModel(TextModel* _model);
+
+    ~PaginationService() override;
+
+    /**
+     * @brief Разложить документ целиком, запомнить страницы всех элементов и освободить документ
+     * @note После этого сервис отвечает только по запомненным страницам и не следит за моделью,
+     *       поэтому его можно читать из нескольких потоков одновременно. Используется для
+     *       неизменяемых копий моделей, по которым строятся отчёты
+     */
+    void freeze();
+
+    /**
+     * @brief Количество страниц в документе
+     */
+    int pageCount();
+
+    /**
+     * @brief Номер страницы, на которой начинается заданный элемент
+     * @return Номер страницы начиная с единицы, либо 0, если элемент не удалось найти
+     */
+    int pageForItem(TextModelItem* _item);
+
+private:
+    PaginationService(TextModel* _model, TextDocument* _document);
+
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
@@ -18,6 +18,7 @@
 #include <utils/helpers/text_helper.h>
 #include <utils/shugar.h>
 #include <utils/tools/debouncer.h>
+#include <utils/tools/shiftable_map.h>
 
 #include <QDateTime>
 #include <QPointer>
@@ -90,7 +91,6 @@ public:
     /**
      * @brief Скорректировать позиции элементов на заданную дистанцию
      */
-    void correctPositionsToItems(std::map<int, TextModelItem*>::iterator _from, int _distance);
     void correctPositionsToItems(int _fromPosition, int _distance);
 
     /**
@@ -129,7 +129,7 @@ public:
     DocumentState state = DocumentState::Undefined;
     QPointer<BusinessLayer::TextModel> model;
     bool canChangeModel = true;
-    std::map<int, TextModelItem*> positionsToItems;
+    ShiftableMap<TextModelItem*> positionsToItems;
     QScopedPointer<AbstractTextCorrector> corrector;
 
     /**
@@ -171,76 +171,9 @@ TextModelItem* TextDocument::Implementation::itemFor(const TextCursor& _cursor)
     return itemFor(_cursor.block());
 }
 
-void TextDocument::Implementation::correctPositionsToItems(
-    std::map<int, TextModelItem*>::iterator _from, int _distance)
-{
-    //
-    // В режиме отладки на Windows тут происходит инвалидация итератора, когда обновляем элементы за
-    // один цикл. Спишем это на баг компилятора и будем обновлять элементы более безопасно.
-    //
-#if defined(Q_OS_WIN) && defined(QT_DEBUG)
-
-    if (_from == positionsToItems.end()) {
-        return;
-    }
-
-    //
-    // Собираем элементы, которые нужно обновить
-    //
-    std::vector<std::pair<int, TextModelItem*>> updates;
-    if (_distance > 0) {
-        for (auto iter = positionsToItems.rbegin(); iter != std::make_reverse_iterator(_from);
-             ++iter) {
-            updates.emplace_back(iter->first + _distance, iter->second);
-        }
-    } else if (_distance < 0) {
-        for (auto iter = _from; iter != positionsToItems.end(); ++iter) {
-            updates.emplace_back(iter->first + _distance, iter->second);
-        }
-    }
-
-    //
-    // Удаляем старые ключи
-    //
-    for (const auto& [newKey, _] : updates) {
-        const auto oldKey = newKey - _distance;
-        positionsToItems.erase(oldKey);
-    }
-
-    //
-    // Вставляем обновлённые элементы
-    //
-    for (const auto& [newKey, value] : updates) {
-        positionsToItems.emplace(newKey, value);
-    }
-#else
-    if (_from == positionsToItems.end()) {
-        return;
-    }
-
-    if (_distance > 0) {
-        auto reversed = [](std::map<int, TextModelItem*>::iterator iter) {
-            return std::prev(std::make_reverse_iterator(iter));
-        };
-        for (auto iter = positionsToItems.rbegin(); iter != std::make_reverse_iterator(_from);
-             ++iter) {
-            auto itemToUpdate = positionsToItems.extract(iter->first);
-            itemToUpdate.key() = itemToUpdate.key() + _distance;
-            iter = reversed(positionsToItems.insert(std::move(itemToUpdate)).position);
-        }
-    } else if (_distance < 0) {
-        for (auto iter = _from; iter != positionsToItems.end(); ++iter) {
-            auto itemToUpdate = positionsToItems.extract(iter->first);
-            itemToUpdate.key() = itemToUpdate.key() + _distance;
-            iter = positionsToItems.insert(std::move(itemToUpdate)).position;
-        }
-    }
-#endif
-}
-
 void TextDocument::Implementation::correctPositionsToItems(int _fromPosition, int _distance)
 {
-    correctPositionsToItems(positionsToItems.lower_bound(_fromPosition), _distance);
+    positionsToItems.shift(_fromPosition, _distance);
 }
 
 void TextDocument::Implementation::readModelItemContent(int _itemRow, const QModelIndex& _parent,
@@ -565,6 +498,11 @@ bool TextDocument::isEditTransactionActive()
     return d->isEditTransactionActive;
 }
 
+void TextDocument::applyPendingCorrections()
+{
+    d->modelChangeCorrectionDebouncer.forceWork();
+}
+
 void TextDocument::setModel(BusinessLayer::TextModel* _model, bool _canChangeModel)
 {
     d->state = DocumentState::Loading;
@@ -1362,16 +1300,12 @@ int TextDocument::itemPosition(const QModelIndex& _index, bool _fromStart)
     while (item->childCount() > 0) {
         item = item->childAt(_fromStart ? 0 : item->childCount() - 1);
     }
-    //
-    // FIXME: оптимизировать это место
-    //
-    for (const auto& [key, value] : d->positionsToItems) {
-        if (value == item) {
-            return key;
-        }
+    const auto iter = d->positionsToItems.findValue(item);
+    if (iter == d->positionsToItems.end()) {
+        return -1;
     }
 
-    return -1;
+    return iter->first;
 }
 
 int TextDocument::itemStartPosition(const QModelIndex& _index)
@@ -1831,7 +1765,7 @@ void TextDocument::splitParagraph(const TextCursor& _cursor)
     {
         auto block = findBlock(cursor.selectionStart());
         while (block.isValid() && block.position() < cursor.selectionEnd()) {
-            auto item = d->positionsToItems[block.position()];
+            auto item = d->positionsToItems.value(block.position());
             if (item->type() == TextModelItemType::Text) {
                 auto textItem = static_cast<TextModelTextItem*>(item);
                 textItem->setInFirstColumn(true);
@@ -1940,7 +1874,7 @@ int TextDocument::mergeParagraph(const TextCursor& _cursor)
         auto updateCursor = cursor;
         updateCursor.movePosition(QTextCursor::NextBlock);
         while (!updateCursor.atEnd() && updateCursor.inTable()) {
-            auto item = d->positionsToItems[updateCursor.position()];
+            auto item = d->positionsToItems.value(updateCursor.position());
             if (item->type() == TextModelItemType::Text) {
                 auto textItem = static_cast<TextModelTextItem*>(item);
                 textItem->setInFirstColumn({});
@@ -2200,28 +2134,9 @@ void TextDocument::updateModelOnContentChange(int _position, int _charsRemoved,
             //
             // Корректируем позиции элементов идущих за изменёнными блоками
             //
-
-            auto itemToUpdateIter = itemsToDeleteIter;
-
-            //
-            // Формируем мапу элементов со скорректированными позициями
-            //
-            std::map<int, TextModelItem*> correctedItems;
-            for (auto itemIter = itemToUpdateIter; itemIter != d->positionsToItems.end();
-                 ++itemIter) {
-                correctedItems.emplace(itemIter->first - _charsRemoved + _charsAdded,
-                                       itemIter->second);
+            if (itemsToDeleteIter != d->positionsToItems.end()) {
+                d->correctPositionsToItems(itemsToDeleteIter->first, _charsAdded - _charsRemoved);
             }
-
-            //
-            // Удаляем элементы со старыми позициями
-            //
-            d->positionsToItems.erase(itemToUpdateIter, d->positionsToItems.end());
-
-            //
-            // И записываем на их место новые элементы
-            //
-            d->positionsToItems.merge(correctedItems);
         }
 
         //
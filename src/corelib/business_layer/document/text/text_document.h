@@ -34,6 +34,11 @@ public:
      */
     bool isEditTransactionActive();
 
+    /**
+     * @brief Применить отложенные корректировки текста, не дожидаясь цикла событий
+     */
+    void applyPendingCorrections();
+
     /**
      * @brief Модель текста
      */
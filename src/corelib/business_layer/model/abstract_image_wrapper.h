@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <QPixmap>
 
 #include <corelib_global.h>
 
@@ -15,6 +16,12 @@ class CORE_LIBRARY_EXPORT AbstractImageWrapper : public QObject
     Q_OBJECT
 
 public:
+    /**
+     * @brief Размер уменьшенных копий, в которых изображения показываются в галереях, карточках
+     *        и на обложках
+     */
+    static const int kPreviewSize = 1024;
+
     explicit AbstractImageWrapper(QObject* _parent = nullptr)
         : QObject(_parent)
     {
@@ -25,6 +32,22 @@ public:
      */
     virtual QPixmap load(const QUuid& _uuid) const = 0;
 
+    /**
+     * @brief Получить уменьшенную копию изображения, большая сторона которой не превышает
+     *        заданный размер
+     * @note Если копия ещё не готова, то вернётся пустое изображение, а когда она будет
+     *       подготовлена, будет испущен сигнал thumbnailLoaded
+     */
+    virtual QPixmap loadThumbnail(const QUuid& _uuid, int _size) const = 0;
+
+    /**
+     * @brief Получить уменьшенную копию изображения для показа в галерее, карточке, или обложке
+     */
+    QPixmap loadPreview(const QUuid& _uuid) const
+    {
+        return loadThumbnail(_uuid, kPreviewSize);
+    }
+
     /**
      * @brief Установить изображение
      */
@@ -57,6 +80,11 @@ signals:
      */
     void imageUpdated(const QUuid& _uuid, const QPixmap& _image);
 
+    /**
+     * @brief Подготовлена уменьшенная копия изображения запрошенного размера
+     */
+    void thumbnailLoaded(const QUuid& _uuid, int _size, const QPixmap& _thumbnail);
+
     /**
      * @brief Изображение было удалено
      */
@@ -190,14 +190,23 @@ void AbstractModel::saveChanges()
         return;
     }
 
-    const auto content = toXml();
+    const auto change = xmlChange();
+    const auto& content = change.content;
     //
-    const QByteArray undoPatch = d->dmpController.makePatch(content, d->document->content());
+    // Если модель определила изменённый фрагмент, то формируем патчи только по нему,
+    // а в противном случае сравниваем документы целиком
+    //
+    const auto isFragmentChange = change.patchPosition >= 0;
+    const QByteArray undoPatch = isFragmentChange
+        ? d->dmpController.makePatch(change.newFragment, change.oldFragment, change.patchPosition)
+        : d->dmpController.makePatch(content, d->document->content());
     if (undoPatch.isEmpty()) {
         return;
     }
     //
-    const QByteArray redoPatch = d->dmpController.makePatch(d->document->content(), content);
+    const QByteArray redoPatch = isFragmentChange
+        ? d->dmpController.makePatch(change.oldFragment, change.newFragment, change.patchPosition)
+        : d->dmpController.makePatch(d->document->content(), content);
     if (redoPatch.isEmpty()) {
         return;
     }
@@ -210,6 +219,7 @@ void AbstractModel::saveChanges()
     const auto needToNotifyAboutContentChanged = !d->document->content().isEmpty();
     d->document->setContent(content);
     if (needToNotifyAboutContentChanged) {
+        handleChangeSaved(undoPatch, redoPatch);
         emit contentsChanged(undoPatch, redoPatch);
     }
 }
@@ -353,6 +363,40 @@ bool AbstractModel::isChangesApplyingInProcess() const
     return d->isChangesApplyingInProgress;
 }
 
+bool AbstractModel::hasPendingChanges() const
+{
+    return d->updateDocumentContentDebouncer.hasPendingWork();
+}
+
+void AbstractModel::savePendingChanges()
+{
+    d->updateDocumentContentDebouncer.forceWork();
+}
+
+QByteArray AbstractModel::revertDocumentChanges(const QByteArray& _content,
+                                                const QVector<QByteArray>& _undoPatches) const
+{
+    auto content = _content;
+    for (const auto& patch : _undoPatches) {
+        auto revertedContent = d->dmpController.applyPatch(content, patch);
+
+        //
+        // Если патч не наложился, значит история изменений не соответствует содержимому
+        //
+        if (revertedContent.size() == content.size() && revertedContent == content) {
+            return {};
+        }
+
+        content.swap(revertedContent);
+    }
+    return content;
+}
+
+QByteArray AbstractModel::makeDocumentPatch(const QByteArray& _from, const QByteArray& _to) const
+{
+    return d->dmpController.makePatch(_from, _to);
+}
+
 QModelIndex AbstractModel::index(int _row, int _column, const QModelIndex& _parent) const
 {
     Q_UNUSED(_row)
@@ -427,6 +471,17 @@ void AbstractModel::initRawDataWrapper()
 {
 }
 
+void AbstractModel::handleChangeSaved(const QByteArray& _undoPatch, const QByteArray& _redoPatch)
+{
+    Q_UNUSED(_undoPatch)
+    Q_UNUSED(_redoPatch)
+}
+
+AbstractModel::XmlChange AbstractModel::xmlChange() const
+{
+    return { toXml() };
+}
+
 ChangeCursor AbstractModel::applyPatch(const QByteArray& _patch)
 {
     const auto newContent = d->dmpController.applyPatch(toXml(), _patch);
@@ -130,6 +130,31 @@ public:
      */
     bool isChangesApplyingInProcess() const;
 
+    /**
+     * @brief Есть ли изменения модели, ещё не перенесённые в документ
+     */
+    bool hasPendingChanges() const;
+
+    /**
+     * @brief Сразу перенести в документ изменения модели, ожидающие отложенного сохранения
+     * @note Если таких изменений нет, то ничего не делает
+     */
+    void savePendingChanges();
+
+    /**
+     * @brief Откатить содержимое документа на заданные изменения
+     * @param _undoPatches Патчи отмены изменений, начиная с последнего
+     * @return Содержимое документа до первого из изменений, либо пустой массив, если какое-то из
+     *         изменений не удалось откатить
+     */
+    QByteArray revertDocumentChanges(const QByteArray& _content,
+                                     const QVector<QByteArray>& _undoPatches) const;
+
+    /**
+     * @brief Сформировать патч для перехода между заданными версиями документа
+     */
+    QByteArray makeDocumentPatch(const QByteArray& _from, const QByteArray& _to) const;
+
     /**
      * @brief Реализация базовых вещей для древовидной модели
      */
@@ -221,6 +246,41 @@ protected:
      */
     virtual QByteArray toXml() const = 0;
 
+    /**
+     * @brief Изменение xml-содержимого документа относительно сохранённого в документе
+     */
+    struct XmlChange {
+        /**
+         * @brief Новое содержимое документа целиком
+         */
+        QByteArray content;
+
+        /**
+         * @brief Изменённые фрагменты сохранённого и нового содержимого
+         */
+        QByteArray oldFragment;
+        QByteArray newFragment;
+
+        /**
+         * @brief Позиция фрагментов в документе в координатах патча
+         * @note Если позиция не определена, то изменённым считается весь документ
+         */
+        int patchPosition = -1;
+    };
+
+    /**
+     * @brief Сформировать xml-содержимое документа с изменённым с момента сохранения фрагментом
+     * @note По умолчанию изменённым считается весь документ
+     */
+    virtual XmlChange xmlChange() const;
+
+    /**
+     * @brief Обработать сохранение изменения с заданными патчами отмены и повтора
+     * @note Позволяет модели запомнить изменение, чтобы в дальнейшем отменять и повторять его,
+     *       не накладывая патч на весь документ
+     */
+    virtual void handleChangeSaved(const QByteArray& _undoPatch, const QByteArray& _redoPatch);
+
     /**
      * @brief Применить заданное изменение для модели
      * @return Положение курсора внутри документа в конце изменения
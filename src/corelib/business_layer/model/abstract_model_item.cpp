@@ -1,20 +1,38 @@
 #include "abstract_model_item.h"
 
 #include <utils/shugar.h>
+#include <utils/tools/memory_pool.h>
 
 #include <QVector>
 
 
 namespace BusinessLayer {
 
-class AbstractModelItem::Implementation
+class AbstractModelItem::Implementation : public PoolAllocated
 {
 public:
     ~Implementation();
 
+    /**
+     * @brief Отметить, что строки детей, начиная с заданной, нужно пересчитать
+     */
+    void invalidateRows(int _fromRow);
+
+
     AbstractModelItem* parent = nullptr;
     QVector<AbstractModelItem*> children;
     bool changed = false;
+
+    /**
+     * @brief Закешированный номер строки элемента в списке детей родителя
+     */
+    int row = -1;
+
+    /**
+     * @brief Номер первой строки детей, у которых закешированный номер может быть устаревшим,
+     *        строки пересчитываются лениво, только до запрошенного элемента
+     */
+    mutable int firstInvalidRow = 0;
 };
 
 AbstractModelItem::Implementation::~Implementation()
@@ -22,6 +40,11 @@ AbstractModelItem::Implementation::~Implementation()
     qDeleteAll(children);
 }
 
+void AbstractModelItem::Implementation::invalidateRows(int _fromRow)
+{
+    firstInvalidRow = std::min(firstInvalidRow, std::max(_fromRow, 0));
+}
+
 
 // ****
 
@@ -44,6 +67,7 @@ void AbstractModelItem::prependItem(AbstractModelItem* _item)
 
 void AbstractModelItem::prependItems(const QVector<AbstractModelItem*>& _items)
 {
+    d->invalidateRows(0);
     for (auto item : reversed(_items)) {
         if (item->parent() == this) {
             continue;
@@ -63,6 +87,7 @@ void AbstractModelItem::appendItem(AbstractModelItem* _item)
 
 void AbstractModelItem::appendItems(const QVector<AbstractModelItem*>& _items)
 {
+    d->invalidateRows(d->children.size());
     for (auto item : _items) {
         if (item->parent() == this) {
             continue;
@@ -82,6 +107,7 @@ void AbstractModelItem::insertItem(int _index, AbstractModelItem* _item)
 
 void AbstractModelItem::insertItems(int _index, const QVector<AbstractModelItem*>& _items)
 {
+    d->invalidateRows(_index);
     for (auto item : reversed(_items)) {
         if (item->parent() == this) {
             continue;
@@ -103,6 +129,7 @@ void AbstractModelItem::removeItem(AbstractModelItem* _item)
 
 void AbstractModelItem::removeItems(int _fromIndex, int _toIndex)
 {
+    d->invalidateRows(_fromIndex);
     for (int index = _toIndex; index >= _fromIndex; --index) {
         if (d->children[index]->parent() != this) {
             continue;
@@ -125,6 +152,7 @@ void AbstractModelItem::takeItem(AbstractModelItem* _item)
 
 void AbstractModelItem::takeItems(int _fromIndex, int _toIndex)
 {
+    d->invalidateRows(_fromIndex);
     for (int index = _toIndex; index >= _fromIndex; --index) {
         if (d->children[index]->parent() != this) {
             continue;
@@ -200,6 +228,33 @@ bool AbstractModelItem::hasChild(AbstractModelItem* _child, bool _recursively) c
 
 int AbstractModelItem::rowOfChild(AbstractModelItem* _child) const
 {
+    if (_child == nullptr || _child->d->parent != this) {
+        return d->children.indexOf(_child);
+    }
+
+    //
+    // Если строка элемента была посчитана после последнего изменения списка детей, то она
+    // актуальна и искать элемент не нужно
+    //
+    const auto cachedRow = _child->d->row;
+    if (cachedRow >= 0 && cachedRow < d->firstInvalidRow && cachedRow < d->children.size()
+        && d->children.at(cachedRow) == _child) {
+        return cachedRow;
+    }
+
+    //
+    // В противном случае пересчитываем строки детей, начиная с первой устаревшей и до самого
+    // элемента, так что при последовательных обращениях каждая строка пересчитывается один раз
+    //
+    for (int row = d->firstInvalidRow; row < d->children.size(); ++row) {
+        auto child = d->children.at(row);
+        child->d->row = row;
+        d->firstInvalidRow = row + 1;
+        if (child == _child) {
+            return row;
+        }
+    }
+
     return d->children.indexOf(_child);
 }
 
@@ -207,6 +262,7 @@ void AbstractModelItem::sortChildren(
     const std::function<bool(AbstractModelItem*, AbstractModelItem*)>& _sorter)
 {
     std::sort(d->children.begin(), d->children.end(), _sorter);
+    d->invalidateRows(0);
 }
 
 AbstractModelItem* AbstractModelItem::childAt(int _index) const
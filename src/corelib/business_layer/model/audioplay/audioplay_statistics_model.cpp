@@ -3,6 +3,8 @@
 #include "audioplay_information_model.h"
 #include "text/audioplay_text_model.h"
 
+#include <business_layer/document/text/pagination_service.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/plots/audioplay/audioplay_characters_activity_plot.h>
 #include <business_layer/plots/audioplay/audioplay_structure_analysis_plot.h>
 #include <business_layer/reports/audioplay/audioplay_cast_report.h>
@@ -11,6 +13,7 @@
 #include <business_layer/reports/audioplay/audioplay_location_report.h>
 #include <business_layer/reports/audioplay/audioplay_scene_report.h>
 #include <business_layer/reports/audioplay/audioplay_summary_report.h>
+#include <business_layer/reports/reports_builder.h>
 
 
 namespace BusinessLayer {
@@ -18,23 +21,127 @@ namespace BusinessLayer {
 class AudioplayStatisticsModel::Implementation
 {
 public:
+    /**
+     * @brief Скопировать в снимок модель текста и связанные с ней модели и подготовить копию к
+     *        чтению из фоновых потоков
+     */
+    void copyTextModel(const std::shared_ptr<ReportsSnapshot>& _snapshot) const;
+
+    /**
+     * @brief Построить заданные отчёты в фоне
+     */
+    template<typename... Reports>
+    void buildReports(Reports&... _reports);
+
+    /**
+     * @brief Перестроить все отчёты
+     */
+    void buildAllReports();
+
+    /**
+     * @brief Перестроить отчёт после изменения его параметров
+     * @note Если идёт построение всех отчётов, то оно будет отменено, поэтому перезапускаем его
+     */
+    template<typename Report>
+    void rebuildReport(Report& _report);
+
+    /**
+     * @brief Получить отчёт, дождавшись завершения идущего построения
+     */
+    template<typename Report>
+    const Report& actualReport(const SnapshotReport<Report>& _report);
+
+
     AudioplayTextModel* textModel = nullptr;
 
-    AudioplaySummaryReport summaryReport;
-    AudioplaySceneReport sceneReport;
-    AudioplayLocationReport locationReport;
-    AudioplayCastReport castReport;
-    AudioplayDialoguesReport dialoguesReport;
-    AudioplayGenderReport genderReport;
+    SnapshotReport<AudioplaySummaryReport> summaryReport;
+    SnapshotReport<AudioplaySceneReport> sceneReport;
+    SnapshotReport<AudioplayLocationReport> locationReport;
+    SnapshotReport<AudioplayCastReport> castReport;
+    SnapshotReport<AudioplayDialoguesReport> dialoguesReport;
+    SnapshotReport<AudioplayGenderReport> genderReport;
     //
-    AudioplayStructureAnalysisPlot structureAnalysisPlot;
-    AudioplayCharactersActivityPlot charactersActivityPlot;
+    SnapshotReport<AudioplayStructureAnalysisPlot> structureAnalysisPlot;
+    SnapshotReport<AudioplayCharactersActivityPlot> charactersActivityPlot;
+
+    /**
+     * @brief Построитель отчётов
+     * @note Задачи построителя пишут в отчёты, поэтому он объявлен после них и удаляется первым
+     */
+    ReportsBuilder builder;
 };
 
+void AudioplayStatisticsModel::Implementation::copyTextModel(
+    const std::shared_ptr<ReportsSnapshot>& _snapshot) const
+{
+    const auto informationModel = _snapshot->copy(textModel->informationModel());
+    const auto charactersModel = _snapshot->copyCharacters(textModel->charactersModel());
+    const auto locationsModel = _snapshot->copyLocations(textModel->locationsModel());
+    const auto model = _snapshot->copy<AudioplayTextModel>(
+        textModel, [informationModel, charactersModel, locationsModel](AudioplayTextModel* _model) {
+            _model->setInformationModel(informationModel);
+            _model->setCharactersModel(charactersModel);
+            _model->setLocationsModel(locationsModel);
+        });
+
+    //
+    // Снимок текста читается задачами одновременно, поэтому раскладываем копию по страницам,
+    // строим справочники и снимок заранее, пока она ещё в основном потоке
+    //
+    PaginationService::forModel(model)->freeze();
+    model->updateRuntimeDictionariesIfNeeded();
+    model->snapshot();
+
+    _snapshot->setModel(model);
+}
+
+template<typename... Reports>
+void AudioplayStatisticsModel::Implementation::buildReports(Reports&... _reports)
+{
+    if (textModel == nullptr) {
+        return;
+    }
+
+    const auto snapshot = ReportsSnapshot::create();
+    copyTextModel(snapshot);
+    builder.build({ _reports.buildTask(snapshot)... });
+}
+
+void AudioplayStatisticsModel::Implementation::buildAllReports()
+{
+    buildReports(summaryReport, sceneReport, castReport, dialoguesReport, locationReport,
+                 genderReport, structureAnalysisPlot, charactersActivityPlot);
+}
+
+template<typename Report>
+void AudioplayStatisticsModel::Implementation::rebuildReport(Report& _report)
+{
+    if (builder.isBuilding()) {
+        buildAllReports();
+    } else {
+        buildReports(_report);
+    }
+}
+
+template<typename Report>
+const Report& AudioplayStatisticsModel::Implementation::actualReport(
+    const SnapshotReport<Report>& _report)
+{
+    builder.waitForFinished();
+    return *_report.report;
+}
+
+
+// ****
+
+
 AudioplayStatisticsModel::AudioplayStatisticsModel(QObject* _parent)
     : AbstractModel({}, _parent)
     , d(new Implementation)
 {
+    connect(&d->builder, &ReportsBuilder::progressChanged, this,
+            &AudioplayStatisticsModel::reportsProgressChanged);
+    connect(&d->builder, &ReportsBuilder::built, this, &AudioplayStatisticsModel::reportsUpdated);
 }
 
 AudioplayStatisticsModel::~AudioplayStatisticsModel() = default;
@@ -53,83 +160,72 @@ void AudioplayStatisticsModel::setAudioplayTextModel(AudioplayTextModel* _model)
 {
     d->textModel = _model;
 
-    d->summaryReport.build(d->textModel);
+    d->buildReports(d->summaryReport);
 }
 
 void AudioplayStatisticsModel::updateReports()
 {
-    if (d->textModel == nullptr) {
-        return;
-    }
-
-    d->summaryReport.build(d->textModel);
-    d->sceneReport.build(d->textModel);
-    d->castReport.build(d->textModel);
-    d->dialoguesReport.build(d->textModel);
-    d->locationReport.build(d->textModel);
-    d->genderReport.build(d->textModel);
-    d->structureAnalysisPlot.build(d->textModel);
-    d->charactersActivityPlot.build(d->textModel);
+    d->buildAllReports();
 }
 
 const AudioplaySummaryReport& AudioplayStatisticsModel::summaryReport() const
 {
-    return d->summaryReport;
+    return d->actualReport(d->summaryReport);
 }
 
 const AudioplaySceneReport& AudioplayStatisticsModel::sceneReport() const
 {
-    return d->sceneReport;
+    return d->actualReport(d->sceneReport);
 }
 
 void AudioplayStatisticsModel::setSceneReportParameters(bool _showCharacters, int _sortBy)
 {
-    d->sceneReport.setParameters(_showCharacters, _sortBy);
-    d->sceneReport.build(d->textModel);
+    d->sceneReport.setup = [=](auto& _report) { _report.setParameters(_showCharacters, _sortBy); };
+    d->rebuildReport(d->sceneReport);
 }
 
 const AudioplayLocationReport& AudioplayStatisticsModel::locationReport() const
 {
-    return d->locationReport;
+    return d->actualReport(d->locationReport);
 }
 
 void AudioplayStatisticsModel::setLocationReportParameters(bool _extendedView, int _sortBy)
 {
-    d->locationReport.setParameters(_extendedView, _sortBy);
-    d->locationReport.build(d->textModel);
+    d->locationReport.setup = [=](auto& _report) { _report.setParameters(_extendedView, _sortBy); };
+    d->rebuildReport(d->locationReport);
 }
 
 const AudioplayCastReport& AudioplayStatisticsModel::castReport() const
 {
-    return d->castReport;
+    return d->actualReport(d->castReport);
 }
 
 void AudioplayStatisticsModel::setCastReportParameters(int _sortBy)
 {
-    d->castReport.setParameters(_sortBy);
-    d->castReport.build(d->textModel);
+    d->castReport.setup = [=](auto& _report) { _report.setParameters(_sortBy); };
+    d->rebuildReport(d->castReport);
 }
 
 const AudioplayDialoguesReport& AudioplayStatisticsModel::dialoguesReport() const
 {
-    return d->dialoguesReport;
+    return d->actualReport(d->dialoguesReport);
 }
 
 void AudioplayStatisticsModel::setDialoguesReportParameters(
     const QVector<QString>& _visibleCharacters)
 {
-    d->dialoguesReport.setParameters(_visibleCharacters);
-    d->dialoguesReport.build(d->textModel);
+    d->dialoguesReport.setup = [=](auto& _report) { _report.setParameters(_visibleCharacters); };
+    d->rebuildReport(d->dialoguesReport);
 }
 
 const AudioplayGenderReport& AudioplayStatisticsModel::genderReport() const
 {
-    return d->genderReport;
+    return d->actualReport(d->genderReport);
 }
 
 const AudioplayStructureAnalysisPlot& AudioplayStatisticsModel::structureAnalysisPlot() const
 {
-    return d->structureAnalysisPlot;
+    return d->actualReport(d->structureAnalysisPlot);
 }
 
 void AudioplayStatisticsModel::setStructureAnalysisPlotParameters(bool _sceneDuration,
@@ -138,21 +234,25 @@ void AudioplayStatisticsModel::setStructureAnalysisPlotParameters(bool _sceneDur
                                                                   bool _charactersCount,
                                                                   bool _dialoguesCount)
 {
-    d->structureAnalysisPlot.setParameters(_sceneDuration, _actionDuration, _dialoguesDuration,
-                                           _charactersCount, _dialoguesCount);
-    d->structureAnalysisPlot.build(d->textModel);
+    d->structureAnalysisPlot.setup = [=](auto& _report) {
+        _report.setParameters(_sceneDuration, _actionDuration, _dialoguesDuration, _charactersCount,
+                              _dialoguesCount);
+    };
+    d->rebuildReport(d->structureAnalysisPlot);
 }
 
 const AudioplayCharactersActivityPlot& AudioplayStatisticsModel::charactersActivityPlot() const
 {
-    return d->charactersActivityPlot;
+    return d->actualReport(d->charactersActivityPlot);
 }
 
 void AudioplayStatisticsModel::setCharactersActivityPlotParameters(
     const QVector<QString>& _visibleCharacters)
 {
-    d->charactersActivityPlot.setParameters(_visibleCharacters);
-    d->charactersActivityPlot.build(d->textModel);
+    d->charactersActivityPlot.setup = [=](auto& _report) {
+        _report.setParameters(_visibleCharacters);
+    };
+    d->rebuildReport(d->charactersActivityPlot);
 }
 
 void AudioplayStatisticsModel::initDocument()
@@ -41,6 +41,7 @@ public:
 
     /**
      * @brief Перестроить отчёты
+     * @note Отчёты строятся в фоне по копии моделей, незавершённое построение отменяется
      */
     void updateReports();
 
@@ -93,6 +94,19 @@ public:
     void setCharactersActivityPlotParameters(const QVector<QString>& _visibleCharacters);
 
 
+signals:
+    /**
+     * @brief Изменился прогресс построения отчётов (от 0.0 до 1.0)
+     */
+    void reportsProgressChanged(qreal _progress);
+
+    /**
+     * @brief Отчёты построены
+     * @note Обращение к отчёту до этого сигнала дожидается завершения построения в основном
+     *       потоке, поэтому отображающим отчёты лучше обновляться по нему
+     */
+    void reportsUpdated();
+
 protected:
     /**
      * @brief Реализация модели для работы с документами
@@ -8,6 +8,7 @@
 #include <business_layer/model/audioplay/text/audioplay_text_block_parser.h>
 #include <business_layer/model/characters/character_model.h>
 #include <business_layer/model/characters/characters_model.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/audioplay_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
@@ -303,105 +304,91 @@ AudioplayInformationModel* AudioplayTextModel::informationModel() const
 void AudioplayTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
 {
     const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<AudioplayTextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::Character
-                    && AudioplayCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(
-                        QString("\\b(%1)\\b").arg(TextHelper::toRxEscaped(oldName)),
-                        QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
-
-                    textItem->setText(text);
-                    updateItem(textItem);
-                }
-                break;
-            }
 
-            default:
-                break;
+    //
+    // Отбираем абзацы, в которых вообще встречается имя, по снимку модели, а сами изменения
+    // вносим уже после того, как снимок будет отпущен, чтобы не копировать его при каждой правке
+    //
+    QVector<AudioplayTextModelTextItem*> textItems;
+    {
+        const auto snapshot = this->snapshot();
+        for (int index = 0; index < snapshot.size(); ++index) {
+            if (snapshot.type(index) == TextModelItemType::Text
+                && snapshot.text(index).contains(oldName, Qt::CaseInsensitive)) {
+                textItems.append(static_cast<AudioplayTextModelTextItem*>(snapshot.item(index)));
             }
         }
-    };
+    }
 
     beginChangeRows();
-    updateCharacterBlock(d->rootItem());
+    for (auto textItem : std::as_const(textItems)) {
+        if (textItem->paragraphType() == TextParagraphType::Character
+            && AudioplayCharacterParser::name(textItem->text()) == oldName) {
+            auto text = textItem->text();
+            text.remove(0, oldName.length());
+            text.prepend(_newName);
+            textItem->setText(text);
+            updateItem(textItem);
+        } else {
+            auto text = textItem->text();
+            const QRegularExpression nameMatcher(
+                QString("\\b(%1)\\b").arg(TextHelper::toRxEscaped(oldName)),
+                QRegularExpression::CaseInsensitiveOption);
+            auto match = nameMatcher.match(text);
+            while (match.hasMatch()) {
+                text.remove(match.capturedStart(), match.capturedLength());
+                const auto capturedName = match.captured();
+                const auto capitalizeEveryWord = true;
+                const auto newName = capturedName == oldName
+                    ? TextHelper::smartToUpper(_newName)
+                    : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
+                text.insert(match.capturedStart(), newName);
+
+                match = nameMatcher.match(text, match.capturedStart() + _newName.length());
+            }
+
+            textItem->setText(text);
+            updateItem(textItem);
+        }
+    }
     endChangeRows();
 }
 
 QVector<QModelIndex> AudioplayTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
     QString lastCharacter;
     QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = AudioplayCharacterParser::name(textItem->text());
-                break;
-            }
+    const auto snapshot = this->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
 
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
+        switch (snapshot.paragraphType(index)) {
+        case TextParagraphType::Character: {
+            lastCharacter = AudioplayCharacterParser::name(snapshot.text(index));
+            break;
+        }
 
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
+        case TextParagraphType::Parenthetical: {
+            //
+            // Не очищаем имя персонажа, идём до реплики
+            //
+            break;
+        }
 
-            default: {
-                lastCharacter.clear();
-                break;
-            }
+        case TextParagraphType::Dialogue:
+        case TextParagraphType::Lyrics: {
+            if (lastCharacter == _name) {
+                dialoguesIndexes.append(indexForItem(snapshot.item(index)));
             }
+            break;
         }
 
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
+        default: {
+            lastCharacter.clear();
+            break;
+        }
         }
     }
 
@@ -412,38 +399,20 @@ QVector<QString> AudioplayTextModel::findCharactersFromText() const
 {
     QVector<QString> characters;
     QHash<QString, int> charactersDialogues;
-    std::function<void(const TextModelItem*)> findCharacters;
-    findCharacters
-        = [&characters, &charactersDialogues, &findCharacters](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      findCharacters(childItem);
-                      break;
-                  }
-
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<TextModelTextItem*>(childItem);
-                      if (textItem->paragraphType() == TextParagraphType::Character) {
-                          const auto character = AudioplayCharacterParser::name(textItem->text());
-                          if (charactersDialogues.contains(character)) {
-                              ++charactersDialogues[character];
-                          } else {
-                              characters.append(character);
-                              charactersDialogues.insert(character, 1);
-                          }
-                      }
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
-    findCharacters(d->rootItem());
+    const auto snapshot = this->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.paragraphType(index) != TextParagraphType::Character) {
+            continue;
+        }
+
+        const auto character = AudioplayCharacterParser::name(snapshot.text(index));
+        if (charactersDialogues.contains(character)) {
+            ++charactersDialogues[character];
+        } else {
+            characters.append(character);
+            charactersDialogues.insert(character, 1);
+        }
+    }
     std::sort(characters.begin(), characters.end(),
               [&charactersDialogues](const QString& _lhs, const QString& _rhs) {
                   return charactersDialogues.value(_lhs) > charactersDialogues.value(_rhs);
@@ -474,6 +443,31 @@ std::chrono::milliseconds AudioplayTextModel::duration() const
     return static_cast<AudioplayTextModelFolderItem*>(d->rootItem())->duration();
 }
 
+std::chrono::milliseconds AudioplayTextModel::itemDuration(const TextModelItem* _item) const
+{
+    if (_item == nullptr) {
+        return {};
+    }
+
+    switch (_item->type()) {
+    case TextModelItemType::Folder: {
+        return static_cast<const AudioplayTextModelFolderItem*>(_item)->duration();
+    }
+
+    case TextModelItemType::Group: {
+        return static_cast<const AudioplayTextModelSceneItem*>(_item)->duration();
+    }
+
+    case TextModelItemType::Text: {
+        return static_cast<const AudioplayTextModelTextItem*>(_item)->duration();
+    }
+
+    default: {
+        return {};
+    }
+    }
+}
+
 std::map<std::chrono::milliseconds, QColor> AudioplayTextModel::itemsColors() const
 {
     std::chrono::milliseconds lastItemDuration{ 0 };
@@ -66,6 +66,11 @@ public:
      */
     std::chrono::milliseconds duration() const;
 
+    /**
+     * @brief Хронометраж заданного элемента
+     */
+    std::chrono::milliseconds itemDuration(const TextModelItem* _item) const override;
+
     /**
      * @brief Получить цвета элементов сценария
      */
@@ -11,7 +11,7 @@
 
 namespace BusinessLayer {
 
-class AudioplayTextModelTextItem::Implementation
+class AudioplayTextModelTextItem::Implementation : public PoolAllocated
 {
 public:
     /**
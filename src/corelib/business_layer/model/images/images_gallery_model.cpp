@@ -128,14 +128,27 @@ void ImagesGalleryModel::removePhoto(const QUuid& _photoUuid)
 
 void ImagesGalleryModel::initImageWrapper()
 {
+    //
+    // Фотографии показываем в виде уменьшенных копий, которые подгружаются в фоне, либо
+    // обновляются при получении изображения из облака
+    //
+    auto updatePhoto = [this](const QUuid& _uuid, const QPixmap& _image) {
+        for (auto& photo : d->photos) {
+            if (photo.uuid == _uuid) {
+                photo.image = _image;
+                emit photosChanged(d->photos);
+                break;
+            }
+        }
+    };
     connect(imageWrapper(), &AbstractImageWrapper::imageUpdated, this,
-            [this](const QUuid& _uuid, const QPixmap& _image) {
-                for (auto& photo : d->photos) {
-                    if (photo.uuid == _uuid) {
-                        photo.image = _image;
-                        emit photosChanged(d->photos);
-                        break;
-                    }
+            [this, updatePhoto](const QUuid& _uuid) {
+                updatePhoto(_uuid, imageWrapper()->loadPreview(_uuid));
+            });
+    connect(imageWrapper(), &AbstractImageWrapper::thumbnailLoaded, this,
+            [updatePhoto](const QUuid& _uuid, int _size, const QPixmap& _thumbnail) {
+                if (_size == AbstractImageWrapper::kPreviewSize) {
+                    updatePhoto(_uuid, _thumbnail);
                 }
             });
 }
@@ -160,7 +173,7 @@ void ImagesGalleryModel::initDocument()
         while (!photoNode.isNull()) {
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                d->photos.append({ uuid, imageWrapper()->load(uuid) });
+                d->photos.append({ uuid, imageWrapper()->loadPreview(uuid) });
             }
 
             photoNode = photoNode.nextSiblingElement();
@@ -259,8 +272,7 @@ ChangeCursor ImagesGalleryModel::applyPatch(const QByteArray& _patch)
     // ... добавляем новые фотографии к персонажу
     //
     for (const auto& photoUuid : newPhotosUuids) {
-        addPhoto({ photoUuid });
-        imageWrapper()->load(photoUuid);
+        addPhoto({ photoUuid, imageWrapper()->loadPreview(photoUuid) });
     }
 
     return {};
@@ -564,19 +564,32 @@ void LocationModel::updateDialogues()
 
 void LocationModel::initImageWrapper()
 {
+    //
+    // Фотографии показываем в виде уменьшенных копий, которые подгружаются в фоне, либо
+    // обновляются при получении изображения из облака
+    //
+    auto updatePhoto = [this](const QUuid& _uuid, const QPixmap& _image) {
+        for (auto& photo : d->photos) {
+            if (photo.uuid == _uuid) {
+                photo.image = _image;
+
+                if (photo.uuid == d->photos.constFirst().uuid) {
+                    emit mainPhotoChanged(photo);
+                }
+                emit photosChanged(d->photos);
+
+                break;
+            }
+        }
+    };
     connect(imageWrapper(), &AbstractImageWrapper::imageUpdated, this,
-            [this](const QUuid& _uuid, const QPixmap& _image) {
-                for (auto& photo : d->photos) {
-                    if (photo.uuid == _uuid) {
-                        photo.image = _image;
-
-                        if (photo.uuid == d->photos.constFirst().uuid) {
-                            emit mainPhotoChanged(photo);
-                        }
-                        emit photosChanged(d->photos);
-
-                        break;
-                    }
+            [this, updatePhoto](const QUuid& _uuid) {
+                updatePhoto(_uuid, imageWrapper()->loadPreview(_uuid));
+            });
+    connect(imageWrapper(), &AbstractImageWrapper::thumbnailLoaded, this,
+            [updatePhoto](const QUuid& _uuid, int _size, const QPixmap& _thumbnail) {
+                if (_size == AbstractImageWrapper::kPreviewSize) {
+                    updatePhoto(_uuid, _thumbnail);
                 }
             });
 }
@@ -611,7 +624,7 @@ void LocationModel::initDocument()
         while (!photoNode.isNull()) {
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                d->photos.append({ uuid, imageWrapper()->load(uuid) });
+                d->photos.append({ uuid, imageWrapper()->loadPreview(uuid) });
             }
 
             photoNode = photoNode.nextSiblingElement();
@@ -775,8 +788,7 @@ ChangeCursor LocationModel::applyPatch(const QByteArray& _patch)
     // ... добавляем новые фотографии к персонажу
     //
     for (const auto& photoUuid : newPhotosUuids) {
-        addPhoto({ photoUuid });
-        imageWrapper()->load(photoUuid);
+        addPhoto({ photoUuid, imageWrapper()->loadPreview(photoUuid) });
     }
     //
     // Cчитываем отношения
@@ -182,13 +182,24 @@ void ProjectInformationModel::setTeammates(const QVector<Domain::TeamMemberInfo>
 
 void ProjectInformationModel::initImageWrapper()
 {
-    connect(imageWrapper(), &AbstractImageWrapper::imageUpdated, this,
-            [this](const QUuid& _uuid, const QPixmap& _image) {
-                if (_uuid != d->cover.uuid) {
+    //
+    // Обложку показываем в виде уменьшенной копии, которая подгружается в фоне, либо обновляется
+    // при получении изображения из облака
+    //
+    connect(imageWrapper(), &AbstractImageWrapper::imageUpdated, this, [this](const QUuid& _uuid) {
+        if (_uuid != d->cover.uuid) {
+            return;
+        }
+
+        setCover(_uuid, imageWrapper()->loadPreview(_uuid));
+    });
+    connect(imageWrapper(), &AbstractImageWrapper::thumbnailLoaded, this,
+            [this](const QUuid& _uuid, int _size, const QPixmap& _thumbnail) {
+                if (_uuid != d->cover.uuid || _size != AbstractImageWrapper::kPreviewSize) {
                     return;
                 }
 
-                setCover(_uuid, _image);
+                setCover(_uuid, _thumbnail);
             });
 }
 
@@ -204,7 +215,7 @@ void ProjectInformationModel::initDocument()
     d->name = documentNode.firstChildElement(kNameKey).text();
     d->logline = documentNode.firstChildElement(kLoglineKey).text();
     d->cover.uuid = QUuid::fromString(documentNode.firstChildElement(kCoverKey).text());
-    d->cover.image = imageWrapper()->load(d->cover.uuid);
+    d->cover.image = imageWrapper()->loadPreview(d->cover.uuid);
 }
 
 void ProjectInformationModel::clearDocument()
@@ -260,7 +271,7 @@ ChangeCursor ProjectInformationModel::applyPatch(const QByteArray& _patch)
     }
     if (auto coverNode = documentNode.firstChildElement(kCoverKey); !coverNode.isNull()) {
         const auto coverUuid = QUuid(coverNode.text());
-        setCover(coverUuid, imageWrapper()->load(coverUuid));
+        setCover(coverUuid, imageWrapper()->loadPreview(coverUuid));
     }
 
     return {};
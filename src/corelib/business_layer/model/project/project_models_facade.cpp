@@ -49,10 +49,14 @@
 #include <data_layer/storage/storage_facade.h>
 #include <domain/document_object.h>
 
+#include <QHash>
+#include <QScopeGuard>
 #include <QSet>
 
+#include <list>
 
-namespace ManagementLayer {
+
+namespace BusinessLayer {
 
 class ProjectModelsFacade::Implementation
 {
@@ -62,10 +66,90 @@ public:
                             BusinessLayer::AbstractRawDataWrapper* _rawDataWrapper);
 
 
+    /**
+     * @brief Можно ли выгружать модель документа заданного типа
+     * @note Модели, на которые ссылаются другие модели, выгружаются только вместе с ними
+     */
+    bool isEvictable(Domain::DocumentObjectType _type) const;
+
+    /**
+     * @brief Запомнить, что модель документа использовалась последней
+     */
+    void touch(Domain::DocumentObject* _document);
+
+    /**
+     * @brief Обновить учтённый объём содержимого документа
+     */
+    void updateContentSize(Domain::DocumentObject* _document);
+
+    /**
+     * @brief Забыть о документе, модель которого удаляется
+     */
+    void forget(Domain::DocumentObject* _document);
+
+    /**
+     * @brief Документы загруженных моделей, которые ссылаются на модель заданного документа
+     */
+    QVector<Domain::DocumentObject*> dependantsOf(Domain::DocumentObject* _document) const;
+
+    /**
+     * @brief Документы, модели которых нужно выгрузить вместе с моделью заданного документа
+     * @note Пустой список, если хотя бы одну из этих моделей выгрузить сейчас нельзя
+     */
+    QVector<Domain::DocumentObject*> evictionGroup(Domain::DocumentObject* _document) const;
+
+
     BusinessLayer::StructureModel* projectStructureModel = nullptr;
     BusinessLayer::AbstractImageWrapper* imageWrapper = nullptr;
     BusinessLayer::AbstractRawDataWrapper* rawDataWrapper = nullptr;
     QHash<Domain::DocumentObject*, BusinessLayer::AbstractModel*> documentsToModels;
+
+    /**
+     * @brief Документы загруженных моделей по их идентификаторам
+     * @note Идентификатор документа может смениться при синхронизации, поэтому при поиске
+     *       он сверяется с текущим идентификатором документа
+     */
+    QHash<QUuid, Domain::DocumentObject*> loadedDocumentsByUuid;
+
+    /**
+     * @brief Документы выгружаемых моделей в порядке использования, последним идёт
+     *        использованный позже всех, и их позиции в этом списке
+     */
+    std::list<Domain::DocumentObject*> documentsUsage;
+    QHash<Domain::DocumentObject*, std::list<Domain::DocumentObject*>::iterator>
+        documentsUsagePositions;
+
+    /**
+     * @brief Учтённые объёмы содержимого документов загруженных моделей и их сумма
+     */
+    QHash<Domain::DocumentObject*, qint64> contentSizes;
+    qint64 loadedContentSize = 0;
+
+    /**
+     * @brief Документы, модели которых создаются в данный момент, последним идёт создаваемая
+     *        позже всех
+     */
+    QVector<Domain::DocumentObject*> loadingDocuments;
+
+    /**
+     * @brief Документы, модели которых при создании сослались на модель документа
+     */
+    QHash<Domain::DocumentObject*, QSet<Domain::DocumentObject*>> dependantDocuments;
+
+    /**
+     * @brief Лимит объёма содержимого загруженных документов
+     */
+    qint64 memoryLimit = 0;
+
+    /**
+     * @brief Проверка использования модели
+     */
+    std::function<bool(BusinessLayer::AbstractModel*)> isModelInUse;
+
+    /**
+     * @brief Модели без документов для работы с историей изменений по типам документов
+     */
+    QHash<Domain::DocumentObjectType, BusinessLayer::AbstractModel*> historyModels;
 };
 
 ProjectModelsFacade::Implementation::Implementation(
@@ -78,6 +162,179 @@ ProjectModelsFacade::Implementation::Implementation(
 {
 }
 
+bool ProjectModelsFacade::Implementation::isEvictable(Domain::DocumentObjectType _type) const
+{
+    switch (_type) {
+    case Domain::DocumentObjectType::ScreenplayTreatment:
+    case Domain::DocumentObjectType::ScreenplayText:
+    case Domain::DocumentObjectType::ScreenplayStatistics:
+    case Domain::DocumentObjectType::ComicBookText:
+    case Domain::DocumentObjectType::ComicBookStatistics:
+    case Domain::DocumentObjectType::AudioplayText:
+    case Domain::DocumentObjectType::AudioplayStatistics:
+    case Domain::DocumentObjectType::StageplayText:
+    case Domain::DocumentObjectType::StageplayStatistics:
+    case Domain::DocumentObjectType::NovelOutline:
+    case Domain::DocumentObjectType::NovelText:
+    case Domain::DocumentObjectType::NovelStatistics:
+    case Domain::DocumentObjectType::Characters:
+    case Domain::DocumentObjectType::Character:
+    case Domain::DocumentObjectType::Locations:
+    case Domain::DocumentObjectType::Location:
+    case Domain::DocumentObjectType::Worlds:
+    case Domain::DocumentObjectType::World:
+    case Domain::DocumentObjectType::Folder:
+    case Domain::DocumentObjectType::SimpleText:
+    case Domain::DocumentObjectType::MindMap:
+    case Domain::DocumentObjectType::ImagesGallery:
+    case Domain::DocumentObjectType::Presentation: {
+        return true;
+    }
+
+    default: {
+        return false;
+    }
+    }
+}
+
+void ProjectModelsFacade::Implementation::touch(Domain::DocumentObject* _document)
+{
+    if (!isEvictable(_document->type())) {
+        return;
+    }
+
+    const auto position = documentsUsagePositions.constFind(_document);
+    if (position != documentsUsagePositions.cend()) {
+        documentsUsage.splice(documentsUsage.end(), documentsUsage, position.value());
+        return;
+    }
+
+    documentsUsagePositions.insert(_document,
+                                   documentsUsage.insert(documentsUsage.end(), _document));
+}
+
+void ProjectModelsFacade::Implementation::updateContentSize(Domain::DocumentObject* _document)
+{
+    const qint64 size = _document->isContentLoaded() ? _document->content().size() : 0;
+    auto& knownSize = contentSizes[_document];
+    loadedContentSize += size - knownSize;
+    knownSize = size;
+}
+
+void ProjectModelsFacade::Implementation::forget(Domain::DocumentObject* _document)
+{
+    const auto position = documentsUsagePositions.find(_document);
+    if (position != documentsUsagePositions.end()) {
+        documentsUsage.erase(position.value());
+        documentsUsagePositions.erase(position);
+    }
+    loadedContentSize -= contentSizes.take(_document);
+    dependantDocuments.remove(_document);
+    if (loadedDocumentsByUuid.value(_document->uuid()) == _document) {
+        loadedDocumentsByUuid.remove(_document->uuid());
+        return;
+    }
+    //
+    // ... документ мог быть загружен ещё под старым идентификатором, поэтому ищем по значению
+    //
+    for (auto iter = loadedDocumentsByUuid.begin(); iter != loadedDocumentsByUuid.end();) {
+        if (iter.value() == _document) {
+            iter = loadedDocumentsByUuid.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+QVector<Domain::DocumentObject*> ProjectModelsFacade::Implementation::dependantsOf(
+    Domain::DocumentObject* _document) const
+{
+    QVector<Domain::DocumentObject*> dependants;
+    for (auto dependant : dependantDocuments.value(_document)) {
+        if (documentsToModels.contains(dependant)) {
+            dependants.append(dependant);
+        }
+    }
+
+    //
+    // Кроме моделей, сославшихся на модель документа при создании, учитываем ссылки, которые
+    // добавляются уже после загрузки: модели персонажей, локаций и миров добавляются в модели
+    // их списков при создании новых элементов, а модели текстов эпизодов сериала собираются
+    // моделью эпизодов при каждом изменении структуры проекта
+    //
+    auto appendLoaded = [this, &dependants](Domain::DocumentObject* _dependant) {
+        if (_dependant != nullptr && documentsToModels.contains(_dependant)
+            && !dependants.contains(_dependant)) {
+            dependants.append(_dependant);
+        }
+    };
+    switch (_document->type()) {
+    case Domain::DocumentObjectType::Character: {
+        appendLoaded(DataStorageLayer::StorageFacade::documentStorage()->document(
+            Domain::DocumentObjectType::Characters));
+        break;
+    }
+
+    case Domain::DocumentObjectType::Location: {
+        appendLoaded(DataStorageLayer::StorageFacade::documentStorage()->document(
+            Domain::DocumentObjectType::Locations));
+        break;
+    }
+
+    case Domain::DocumentObjectType::World: {
+        appendLoaded(DataStorageLayer::StorageFacade::documentStorage()->document(
+            Domain::DocumentObjectType::Worlds));
+        break;
+    }
+
+    case Domain::DocumentObjectType::ScreenplayText: {
+        const auto screenplayTextItem = projectStructureModel->itemForUuid(_document->uuid());
+        if (screenplayTextItem == nullptr || screenplayTextItem->parent() == nullptr
+            || screenplayTextItem->parent()->parent() == nullptr) {
+            break;
+        }
+
+        const auto episodesItem = screenplayTextItem->parent()->parent();
+        if (episodesItem->type() == Domain::DocumentObjectType::ScreenplaySeriesEpisodes) {
+            appendLoaded(loadedDocumentsByUuid.value(episodesItem->uuid()));
+        }
+        break;
+    }
+
+    default: {
+        break;
+    }
+    }
+
+    return dependants;
+}
+
+QVector<Domain::DocumentObject*> ProjectModelsFacade::Implementation::evictionGroup(
+    Domain::DocumentObject* _document) const
+{
+    QVector<Domain::DocumentObject*> group = { _document };
+    for (int index = 0; index < group.size(); ++index) {
+        const auto document = group.at(index);
+
+        //
+        // Модели, которые отображаются, либо имеют изменения, ещё не сохранённые в базу данных,
+        // не трогаем, а вместе с ними и модели, на которые они ссылаются
+        //
+        const auto model = documentsToModels.value(document);
+        if (!isEvictable(document->type()) || model == nullptr || model->hasPendingChanges()
+            || !document->isChangesStored() || (isModelInUse && isModelInUse(model))) {
+            return {};
+        }
+
+        for (auto dependant : dependantsOf(document)) {
+            if (!group.contains(dependant)) {
+                group.append(dependant);
+            }
+        }
+    }
+    return group;
+}
+
 
 // ****
 
@@ -94,6 +351,7 @@ ProjectModelsFacade::ProjectModelsFacade(BusinessLayer::StructureModel* _project
 ProjectModelsFacade::~ProjectModelsFacade()
 {
     clear();
+    qDeleteAll(d->historyModels);
 }
 
 void ProjectModelsFacade::clear()
@@ -122,10 +380,28 @@ void ProjectModelsFacade::clear()
     // И очищаем список загруженных моделей
     //
     d->documentsToModels.clear();
+    d->loadedDocumentsByUuid.clear();
+    d->documentsUsage.clear();
+    d->documentsUsagePositions.clear();
+    d->contentSizes.clear();
+    d->loadedContentSize = 0;
+    d->dependantDocuments.clear();
 }
 
 BusinessLayer::AbstractModel* ProjectModelsFacade::modelFor(const QUuid& _uuid)
 {
+    //
+    // Модели, которые уже загружены, находим без обращения к хранилищу документов
+    //
+    const auto loadedDocument = d->loadedDocumentsByUuid.value(_uuid);
+    if (loadedDocument != nullptr) {
+        if (loadedDocument->uuid() == _uuid) {
+            return modelFor(loadedDocument);
+        }
+
+        d->loadedDocumentsByUuid.remove(_uuid);
+    }
+
     return modelFor(DataStorageLayer::StorageFacade::documentStorage()->document(_uuid));
 }
 
@@ -150,6 +426,13 @@ BusinessLayer::AbstractModel* ProjectModelsFacade::modelFor(Domain::DocumentObje
         bool isDocumentAlias = false;
 
         if (!d->documentsToModels.contains(documentToLoad)) {
+            //
+            // Пока модель создаётся, запоминаем её документ, чтобы связать его с документами
+            // моделей, на которые создаваемая модель будет ссылаться
+            //
+            d->loadingDocuments.append(documentToLoad);
+            const auto loadingGuard = qScopeGuard([this] { d->loadingDocuments.removeLast(); });
+
             BusinessLayer::AbstractModel* model = nullptr;
             switch (documentToLoad->type()) {
             case Domain::DocumentObjectType::Project: {
@@ -1408,6 +1691,7 @@ BusinessLayer::AbstractModel* ProjectModelsFacade::modelFor(Domain::DocumentObje
                     [this, model](const QColor& _color) { emit modelColorChanged(model, _color); });
                 connect(model, &BusinessLayer::AbstractModel::contentsChanged, this,
                         [this, model](const QByteArray& _undo, const QByteArray& _redo) {
+                            d->updateContentSize(model->document());
                             emit modelContentChanged(model, _undo, _redo);
                         });
                 connect(
@@ -1418,10 +1702,29 @@ BusinessLayer::AbstractModel* ProjectModelsFacade::modelFor(Domain::DocumentObje
             }
 
             d->documentsToModels.insert(documentToLoad, model);
+            d->loadedDocumentsByUuid.insert(documentToLoad->uuid(), documentToLoad);
+            d->updateContentSize(documentToLoad);
         }
     }
 
-    return d->documentsToModels.value(_document);
+    const auto model = d->documentsToModels.value(_document);
+    if (model == nullptr) {
+        return nullptr;
+    }
+
+    //
+    // Если модель запрошена при создании другой модели, то запоминаем, что та ссылается на неё
+    //
+    if (!d->loadingDocuments.isEmpty() && d->loadingDocuments.constLast() != _document) {
+        d->dependantDocuments[_document].insert(d->loadingDocuments.constLast());
+    }
+
+    //
+    // Запоминаем, что модель документа использовалась последней
+    //
+    d->touch(_document);
+
+    return model;
 }
 
 QVector<BusinessLayer::AbstractModel*> ProjectModelsFacade::modelsFor(
@@ -1446,6 +1749,7 @@ void ProjectModelsFacade::removeModelFor(Domain::DocumentObject* _document)
         return;
     }
 
+    d->forget(_document);
     auto model = d->documentsToModels.take(_document);
     model->disconnect();
     model->clear();
@@ -1482,4 +1786,260 @@ QVector<Domain::DocumentObject*> ProjectModelsFacade::loadedDocuments() const
     return documents;
 }
 
-} // namespace ManagementLayer
+BusinessLayer::AbstractModel* ProjectModelsFacade::historyModelFor(
+    Domain::DocumentObjectType _type)
+{
+    if (auto model = d->historyModels.value(_type); model != nullptr) {
+        return model;
+    }
+
+    //
+    // Патчи зависят только от набора тегов модели, поэтому достаточно создать модель нужного
+    // типа, не загружая в неё документ
+    //
+    BusinessLayer::AbstractModel* model = nullptr;
+    switch (_type) {
+    case Domain::DocumentObjectType::Project: {
+        model = new BusinessLayer::ProjectInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::RecycleBin: {
+        model = new BusinessLayer::RecycleBinModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Screenplay: {
+        model = new BusinessLayer::ScreenplayInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplayTitlePage: {
+        model = new BusinessLayer::ScreenplayTitlePageModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplaySynopsis: {
+        model = new BusinessLayer::ScreenplaySynopsisModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplayText: {
+        model = new BusinessLayer::ScreenplayTextModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplayDictionaries: {
+        model = new BusinessLayer::ScreenplayDictionariesModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplayStatistics: {
+        model = new BusinessLayer::ScreenplayStatisticsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplaySeries: {
+        model = new BusinessLayer::ScreenplaySeriesInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplaySeriesEpisodes: {
+        model = new BusinessLayer::ScreenplaySeriesEpisodesModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ScreenplaySeriesStatistics: {
+        model = new BusinessLayer::ScreenplaySeriesStatisticsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ComicBook: {
+        model = new BusinessLayer::ComicBookInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ComicBookTitlePage: {
+        model = new BusinessLayer::ComicBookTitlePageModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ComicBookSynopsis: {
+        model = new BusinessLayer::ComicBookSynopsisModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ComicBookText: {
+        model = new BusinessLayer::ComicBookTextModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ComicBookDictionaries: {
+        model = new BusinessLayer::ComicBookDictionariesModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ComicBookStatistics: {
+        model = new BusinessLayer::ComicBookStatisticsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Audioplay: {
+        model = new BusinessLayer::AudioplayInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::AudioplayTitlePage: {
+        model = new BusinessLayer::AudioplayTitlePageModel;
+        break;
+    }
+    case Domain::DocumentObjectType::AudioplaySynopsis: {
+        model = new BusinessLayer::AudioplaySynopsisModel;
+        break;
+    }
+    case Domain::DocumentObjectType::AudioplayText: {
+        model = new BusinessLayer::AudioplayTextModel;
+        break;
+    }
+    case Domain::DocumentObjectType::AudioplayStatistics: {
+        model = new BusinessLayer::AudioplayStatisticsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Stageplay: {
+        model = new BusinessLayer::StageplayInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::StageplayTitlePage: {
+        model = new BusinessLayer::StageplayTitlePageModel;
+        break;
+    }
+    case Domain::DocumentObjectType::StageplaySynopsis: {
+        model = new BusinessLayer::StageplaySynopsisModel;
+        break;
+    }
+    case Domain::DocumentObjectType::StageplayText: {
+        model = new BusinessLayer::StageplayTextModel;
+        break;
+    }
+    case Domain::DocumentObjectType::StageplayStatistics: {
+        model = new BusinessLayer::StageplayStatisticsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Novel: {
+        model = new BusinessLayer::NovelInformationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::NovelTitlePage: {
+        model = new BusinessLayer::NovelTitlePageModel;
+        break;
+    }
+    case Domain::DocumentObjectType::NovelSynopsis: {
+        model = new BusinessLayer::NovelSynopsisModel;
+        break;
+    }
+    case Domain::DocumentObjectType::NovelText: {
+        model = new BusinessLayer::NovelTextModel;
+        break;
+    }
+    case Domain::DocumentObjectType::NovelDictionaries: {
+        model = new BusinessLayer::NovelDictionariesModel;
+        break;
+    }
+    case Domain::DocumentObjectType::NovelStatistics: {
+        model = new BusinessLayer::NovelStatisticsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Characters: {
+        model = new BusinessLayer::CharactersModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Character: {
+        model = new BusinessLayer::CharacterModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Locations: {
+        model = new BusinessLayer::LocationsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Location: {
+        model = new BusinessLayer::LocationModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Worlds: {
+        model = new BusinessLayer::WorldsModel;
+        break;
+    }
+    case Domain::DocumentObjectType::World: {
+        model = new BusinessLayer::WorldModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Folder:
+    case Domain::DocumentObjectType::SimpleText: {
+        model = new BusinessLayer::SimpleTextModel;
+        break;
+    }
+    case Domain::DocumentObjectType::MindMap: {
+        model = new BusinessLayer::MindMapModel;
+        break;
+    }
+    case Domain::DocumentObjectType::ImagesGallery: {
+        model = new BusinessLayer::ImagesGalleryModel;
+        break;
+    }
+    case Domain::DocumentObjectType::Presentation: {
+        model = new BusinessLayer::PresentationModel;
+        break;
+    }
+
+    //
+    // Алиасы используют содержимое других документов, а структура загружена всегда
+    //
+    default: {
+        return nullptr;
+    }
+    }
+
+    d->historyModels.insert(_type, model);
+    return model;
+}
+
+void ProjectModelsFacade::setMemoryLimit(qint64 _bytes)
+{
+    d->memoryLimit = _bytes;
+}
+
+void ProjectModelsFacade::setModelInUseChecker(
+    const std::function<bool(BusinessLayer::AbstractModel*)>& _checker)
+{
+    d->isModelInUse = _checker;
+}
+
+void ProjectModelsFacade::evictIdleModels()
+{
+    if (d->memoryLimit <= 0) {
+        return;
+    }
+
+    //
+    // Выгружаем модели начиная с давно не использовавшихся, вместе с моделями, которые на них
+    // ссылаются, пока объём содержимого загруженных документов превышает лимит
+    //
+    auto iter = d->documentsUsage.cbegin();
+    while (iter != d->documentsUsage.cend() && d->loadedContentSize > d->memoryLimit) {
+        const auto group = d->evictionGroup(*iter);
+        ++iter;
+        if (group.isEmpty()) {
+            continue;
+        }
+
+        //
+        // ... следующий документ в списке может выгружаться вместе с текущим, пропускаем такие,
+        //     чтобы не остаться с итератором на удалённый элемент
+        //
+        while (iter != d->documentsUsage.cend() && group.contains(*iter)) {
+            ++iter;
+        }
+
+        //
+        // ... модель алиаса совпадает с моделью документа, на который он ссылается, поэтому
+        //     удаляем каждую модель только один раз
+        //
+        QSet<BusinessLayer::AbstractModel*> modelsToDelete;
+        for (auto document : group) {
+            d->forget(document);
+            modelsToDelete.insert(d->documentsToModels.take(document));
+        }
+        for (auto model : std::as_const(modelsToDelete)) {
+            model->disconnect();
+            model->clear();
+            model->deleteLater();
+        }
+        for (auto document : group) {
+            document->unloadContent();
+        }
+    }
+}
+
+} // namespace BusinessLayer
@@ -1,14 +1,11 @@
 #pragma once
 
+#include <corelib_global.h>
+
 #include <QObject>
 #include <QUuid>
 
-namespace BusinessLayer {
-class AbstractImageWrapper;
-class AbstractRawDataWrapper;
-class AbstractModel;
-class StructureModel;
-} // namespace BusinessLayer
+#include <functional>
 
 namespace Domain {
 class DocumentObject;
@@ -16,12 +13,17 @@ enum class DocumentObjectType;
 } // namespace Domain
 
 
-namespace ManagementLayer {
+namespace BusinessLayer {
+
+class AbstractImageWrapper;
+class AbstractRawDataWrapper;
+class AbstractModel;
+class StructureModel;
 
 /**
  * @brief Фасад для работы с моделями документов проекта
  */
-class ProjectModelsFacade : public QObject
+class CORE_LIBRARY_EXPORT ProjectModelsFacade : public QObject
 {
     Q_OBJECT
 
@@ -65,6 +67,31 @@ public:
      */
     QVector<Domain::DocumentObject*> loadedDocuments() const;
 
+    /**
+     * @brief Получить модель без документа, через которую накладываются и формируются патчи
+     *        истории изменений документов заданного типа
+     * @note Позволяет работать с историей документов, модели которых не загружены
+     */
+    BusinessLayer::AbstractModel* historyModelFor(Domain::DocumentObjectType _type);
+
+    /**
+     * @brief Задать объём содержимого загруженных документов в байтах, при превышении которого
+     *        давно не использовавшиеся модели выгружаются, ноль - без ограничения
+     */
+    void setMemoryLimit(qint64 _bytes);
+
+    /**
+     * @brief Задать проверку того, используется ли модель в данный момент и не может быть выгружена
+     */
+    void setModelInUseChecker(const std::function<bool(BusinessLayer::AbstractModel*)>& _checker);
+
+    /**
+     * @brief Выгрузить давно не использовавшиеся модели без несохранённых изменений, пока объём
+     *        содержимого загруженных документов превышает лимит
+     * @note Модель выгружается вместе со всеми загруженными моделями, которые на неё ссылаются
+     */
+    void evictIdleModels();
+
 signals:
     /**
      * @brief Изменилось название модели
@@ -235,4 +262,4 @@ private:
     QScopedPointer<Implementation> d;
 };
 
-} // namespace ManagementLayer
+} // namespace BusinessLayer
@@ -1,10 +1,14 @@
 #include "screenplay_statistics_model.h"
 
+#include "screenplay_dictionaries_model.h"
 #include "screenplay_information_model.h"
 #include "text/screenplay_text_model.h"
 
+#include <business_layer/document/text/pagination_service.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/plots/screenplay/screenplay_characters_activity_plot.h>
 #include <business_layer/plots/screenplay/screenplay_structure_analysis_plot.h>
+#include <business_layer/reports/reports_builder.h>
 #include <business_layer/reports/screenplay/screenplay_cast_report.h>
 #include <business_layer/reports/screenplay/screenplay_dialogues_report.h>
 #include <business_layer/reports/screenplay/screenplay_gender_report.h>
@@ -18,23 +22,130 @@ namespace BusinessLayer {
 class ScreenplayStatisticsModel::Implementation
 {
 public:
+    /**
+     * @brief Скопировать в снимок модель текста и связанные с ней модели и подготовить копию к
+     *        чтению из фоновых потоков
+     */
+    void copyTextModel(const std::shared_ptr<ReportsSnapshot>& _snapshot) const;
+
+    /**
+     * @brief Построить заданные отчёты в фоне
+     */
+    template<typename... Reports>
+    void buildReports(Reports&... _reports);
+
+    /**
+     * @brief Перестроить все отчёты
+     */
+    void buildAllReports();
+
+    /**
+     * @brief Перестроить отчёт после изменения его параметров
+     * @note Если идёт построение всех отчётов, то оно будет отменено, поэтому перезапускаем его
+     */
+    template<typename Report>
+    void rebuildReport(Report& _report);
+
+    /**
+     * @brief Получить отчёт, дождавшись завершения идущего построения
+     */
+    template<typename Report>
+    const Report& actualReport(const SnapshotReport<Report>& _report);
+
+
     ScreenplayTextModel* textModel = nullptr;
 
-    ScreenplaySummaryReport summaryReport;
-    ScreenplaySceneReport sceneReport;
-    ScreenplayLocationReport locationReport;
-    ScreenplayCastReport castReport;
-    ScreenplayDialoguesReport dialoguesReport;
-    ScreenplayGenderReport genderReport;
+    SnapshotReport<ScreenplaySummaryReport> summaryReport;
+    SnapshotReport<ScreenplaySceneReport> sceneReport;
+    SnapshotReport<ScreenplayLocationReport> locationReport;
+    SnapshotReport<ScreenplayCastReport> castReport;
+    SnapshotReport<ScreenplayDialoguesReport> dialoguesReport;
+    SnapshotReport<ScreenplayGenderReport> genderReport;
     //
-    ScreenplayStructureAnalysisPlot structureAnalysisPlot;
-    ScreenplayCharactersActivityPlot charactersActivityPlot;
+    SnapshotReport<ScreenplayStructureAnalysisPlot> structureAnalysisPlot;
+    SnapshotReport<ScreenplayCharactersActivityPlot> charactersActivityPlot;
+
+    /**
+     * @brief Построитель отчётов
+     * @note Задачи построителя пишут в отчёты, поэтому он объявлен после них и удаляется первым
+     */
+    ReportsBuilder builder;
 };
 
+void ScreenplayStatisticsModel::Implementation::copyTextModel(
+    const std::shared_ptr<ReportsSnapshot>& _snapshot) const
+{
+    const auto informationModel = _snapshot->copy(textModel->informationModel());
+    const auto dictionariesModel = _snapshot->copy(textModel->dictionariesModel());
+    const auto charactersModel = _snapshot->copyCharacters(textModel->charactersModel());
+    const auto locationsModel = _snapshot->copyLocations(textModel->locationsModel());
+    const auto model = _snapshot->copy<ScreenplayTextModel>(
+        textModel, [informationModel, dictionariesModel, charactersModel,
+                    locationsModel](ScreenplayTextModel* _model) {
+            _model->setInformationModel(informationModel);
+            _model->setDictionariesModel(dictionariesModel);
+            _model->setCharactersModel(charactersModel);
+            _model->setLocationsModel(locationsModel);
+        });
+
+    //
+    // Снимок текста читается задачами одновременно, поэтому раскладываем копию по страницам,
+    // строим справочники и снимок заранее, пока она ещё в основном потоке
+    //
+    PaginationService::forModel(model)->freeze();
+    model->updateRuntimeDictionariesIfNeeded();
+    model->snapshot();
+
+    _snapshot->setModel(model);
+}
+
+template<typename... Reports>
+void ScreenplayStatisticsModel::Implementation::buildReports(Reports&... _reports)
+{
+    if (textModel == nullptr) {
+        return;
+    }
+
+    const auto snapshot = ReportsSnapshot::create();
+    copyTextModel(snapshot);
+    builder.build({ _reports.buildTask(snapshot)... });
+}
+
+void ScreenplayStatisticsModel::Implementation::buildAllReports()
+{
+    buildReports(summaryReport, sceneReport, castReport, dialoguesReport, locationReport,
+                 genderReport, structureAnalysisPlot, charactersActivityPlot);
+}
+
+template<typename Report>
+void ScreenplayStatisticsModel::Implementation::rebuildReport(Report& _report)
+{
+    if (builder.isBuilding()) {
+        buildAllReports();
+    } else {
+        buildReports(_report);
+    }
+}
+
+template<typename Report>
+const Report& ScreenplayStatisticsModel::Implementation::actualReport(
+    const SnapshotReport<Report>& _report)
+{
+    builder.waitForFinished();
+    return *_report.report;
+}
+
+
+// ****
+
+
 ScreenplayStatisticsModel::ScreenplayStatisticsModel(QObject* _parent)
     : AbstractModel({}, _parent)
     , d(new Implementation)
 {
+    connect(&d->builder, &ReportsBuilder::progressChanged, this,
+            &ScreenplayStatisticsModel::reportsProgressChanged);
+    connect(&d->builder, &ReportsBuilder::built, this, &ScreenplayStatisticsModel::reportsUpdated);
 }
 
 ScreenplayStatisticsModel::~ScreenplayStatisticsModel() = default;
@@ -53,84 +164,75 @@ void ScreenplayStatisticsModel::setScreenplayTextModel(ScreenplayTextModel* _mod
 {
     d->textModel = _model;
 
-    d->summaryReport.build(d->textModel);
+    d->buildReports(d->summaryReport);
 }
 
 void ScreenplayStatisticsModel::updateReports()
 {
-    if (d->textModel == nullptr) {
-        return;
-    }
-
-    d->summaryReport.build(d->textModel);
-    d->sceneReport.build(d->textModel);
-    d->castReport.build(d->textModel);
-    d->dialoguesReport.build(d->textModel);
-    d->locationReport.build(d->textModel);
-    d->genderReport.build(d->textModel);
-    d->structureAnalysisPlot.build(d->textModel);
-    d->charactersActivityPlot.build(d->textModel);
+    d->buildAllReports();
 }
 
 const ScreenplaySummaryReport& ScreenplayStatisticsModel::summaryReport() const
 {
-    return d->summaryReport;
+    return d->actualReport(d->summaryReport);
 }
 
 const ScreenplaySceneReport& ScreenplayStatisticsModel::sceneReport() const
 {
-    return d->sceneReport;
+    return d->actualReport(d->sceneReport);
 }
 
 void ScreenplayStatisticsModel::setSceneReportParameters(bool _showCharacters, int _sortBy)
 {
-    d->sceneReport.setParameters(_showCharacters, _sortBy);
-    d->sceneReport.build(d->textModel);
+    d->sceneReport.setup = [=](auto& _report) { _report.setParameters(_showCharacters, _sortBy); };
+    d->rebuildReport(d->sceneReport);
 }
 
 const ScreenplayLocationReport& ScreenplayStatisticsModel::locationReport() const
 {
-    return d->locationReport;
+    return d->actualReport(d->locationReport);
 }
 
 void ScreenplayStatisticsModel::setLocationReportParameters(bool _extendedView, int _sortBy)
 {
-    d->locationReport.setParameters(_extendedView, _sortBy);
-    d->locationReport.build(d->textModel);
+    d->locationReport.setup = [=](auto& _report) { _report.setParameters(_extendedView, _sortBy); };
+    d->rebuildReport(d->locationReport);
 }
 
 const ScreenplayCastReport& ScreenplayStatisticsModel::castReport() const
 {
-    return d->castReport;
+    return d->actualReport(d->castReport);
 }
 
 void ScreenplayStatisticsModel::setCastReportParameters(bool _showDetails, bool _showWords,
                                                         int _sortBy)
 {
-    d->castReport.setParameters(_showDetails, _showWords, _sortBy);
-    d->castReport.build(d->textModel);
+    d->castReport.setup = [=](auto& _report) {
+        _report.setParameters(_showDetails, _showWords, _sortBy);
+    };
+    d->rebuildReport(d->castReport);
 }
 
 const ScreenplayDialoguesReport& ScreenplayStatisticsModel::dialoguesReport() const
 {
-    return d->dialoguesReport;
+    return d->actualReport(d->dialoguesReport);
 }
 
 void ScreenplayStatisticsModel::setDialoguesReportParameters(
     const QVector<QString>& _visibleCharacters)
 {
-    d->dialoguesReport.setParameters(_visibleCharacters);
-    d->dialoguesReport.build(d->textModel);
+    d->dialoguesReport.setup = [=](auto& _report) { _report.setParameters(_visibleCharacters); };
+    d->rebuildReport(d->dialoguesReport);
 }
 
 const ScreenplayGenderReport& ScreenplayStatisticsModel::genderReport() const
 {
-    return d->genderReport;
+    return d->actualReport(d->genderReport);
 }
 
 const ScreenplayStructureAnalysisPlot& ScreenplayStatisticsModel::structureAnalysisPlot() const
 {
-    return d->structureAnalysisPlot;
+    return d->actualReport(d->structureAnalysisPlot);
 }
 
 void ScreenplayStatisticsModel::setStructureAnalysisPlotParameters(bool _sceneDuration,
@@ -139,21 +241,25 @@ void ScreenplayStatisticsModel::setStructureAnalysisPlotParameters(bool _sceneDu
                                                                    bool _charactersCount,
                                                                    bool _dialoguesCount)
 {
-    d->structureAnalysisPlot.setParameters(_sceneDuration, _actionDuration, _dialoguesDuration,
-                                           _charactersCount, _dialoguesCount);
-    d->structureAnalysisPlot.build(d->textModel);
+    d->structureAnalysisPlot.setup = [=](auto& _report) {
+        _report.setParameters(_sceneDuration, _actionDuration, _dialoguesDuration, _charactersCount,
+                              _dialoguesCount);
+    };
+    d->rebuildReport(d->structureAnalysisPlot);
 }
 
 const ScreenplayCharactersActivityPlot& ScreenplayStatisticsModel::charactersActivityPlot() const
 {
-    return d->charactersActivityPlot;
+    return d->actualReport(d->charactersActivityPlot);
 }
 
 void ScreenplayStatisticsModel::setCharactersActivityPlotParameters(
     const QVector<QString>& _visibleCharacters)
 {
-    d->charactersActivityPlot.setParameters(_visibleCharacters);
-    d->charactersActivityPlot.build(d->textModel);
+    d->charactersActivityPlot.setup = [=](auto& _report) {
+        _report.setParameters(_visibleCharacters);
+    };
+    d->rebuildReport(d->charactersActivityPlot);
 }
 
 void ScreenplayStatisticsModel::initDocument()
@@ -1,9 +1,15 @@
 #include "screenplay_series_statistics_model.h"
 
+#include "../screenplay_dictionaries_model.h"
+#include "../screenplay_information_model.h"
+#include "../text/screenplay_text_model.h"
 #include "screenplay_series_episodes_model.h"
 #include "screenplay_series_information_model.h"
 
+#include <business_layer/document/text/pagination_service.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/plots/screenplay/series/screenplay_series_characters_activity_plot.h>
+#include <business_layer/reports/reports_builder.h>
 #include <business_layer/reports/screenplay/series/screenplay_series_cast_report.h>
 #include <business_layer/reports/screenplay/series/screenplay_series_dialogues_report.h>
 #include <business_layer/reports/screenplay/series/screenplay_series_location_report.h>
@@ -16,22 +22,148 @@ namespace BusinessLayer {
 class ScreenplaySeriesStatisticsModel::Implementation
 {
 public:
+    /**
+     * @brief Скопировать в снимок модель серий, все эпизоды и связанные с ними модели и
+     *        подготовить копии к чтению из фоновых потоков
+     */
+    void copyEpisodesModel(const std::shared_ptr<ReportsSnapshot>& _snapshot) const;
+
+    /**
+     * @brief Построить заданные отчёты в фоне
+     */
+    template<typename... Reports>
+    void buildReports(Reports&... _reports);
+
+    /**
+     * @brief Перестроить все отчёты
+     */
+    void buildAllReports();
+
+    /**
+     * @brief Перестроить отчёт после изменения его параметров
+     * @note Если идёт построение всех отчётов, то оно будет отменено, поэтому перезапускаем его
+     */
+    template<typename Report>
+    void rebuildReport(Report& _report);
+
+    /**
+     * @brief Получить отчёт, дождавшись завершения идущего построения
+     */
+    template<typename Report>
+    const Report& actualReport(const SnapshotReport<Report>& _report);
+
+
     ScreenplaySeriesEpisodesModel* episodesModel = nullptr;
 
-    ScreenplaySeriesSummaryReport summaryReport;
-    ScreenplaySeriesSceneReport sceneReport;
-    ScreenplaySeriesLocationReport locationReport;
-    ScreenplaySeriesCastReport castReport;
-    ScreenplaySeriesDialoguesReport dialoguesReport;
+    SnapshotReport<ScreenplaySeriesSummaryReport> summaryReport;
+    SnapshotReport<ScreenplaySeriesSceneReport> sceneReport;
+    SnapshotReport<ScreenplaySeriesLocationReport> locationReport;
+    SnapshotReport<ScreenplaySeriesCastReport> castReport;
+    SnapshotReport<ScreenplaySeriesDialoguesReport> dialoguesReport;
     //
-    ScreenplaySeriesCharactersActivityPlot charactersActivityPlot;
+    SnapshotReport<ScreenplaySeriesCharactersActivityPlot> charactersActivityPlot;
+
+    /**
+     * @brief Построитель отчётов
+     * @note Задачи построителя пишут в отчёты, поэтому он объявлен после них и удаляется первым
+     */
+    ReportsBuilder builder;
 };
 
+void ScreenplaySeriesStatisticsModel::Implementation::copyEpisodesModel(
+    const std::shared_ptr<ReportsSnapshot>& _snapshot) const
+{
+    //
+    // Справочники, персонажи и локации у всех серий общие, поэтому копируем их один раз
+    //
+    const auto sourceEpisodes = episodesModel->episodes();
+    ScreenplayDictionariesModel* dictionariesModel = nullptr;
+    CharactersModel* charactersModel = nullptr;
+    LocationsModel* locationsModel = nullptr;
+    if (!sourceEpisodes.isEmpty()) {
+        const auto firstEpisode = sourceEpisodes.constFirst();
+        dictionariesModel = _snapshot->copy(firstEpisode->dictionariesModel());
+        charactersModel = _snapshot->copyCharacters(firstEpisode->charactersModel());
+        locationsModel = _snapshot->copyLocations(firstEpisode->locationsModel());
+    }
+
+    QVector<ScreenplayTextModel*> episodes;
+    for (auto episode : sourceEpisodes) {
+        const auto informationModel = _snapshot->copy(episode->informationModel());
+        auto episodeCopy = _snapshot->copy<ScreenplayTextModel>(
+            episode, [informationModel, dictionariesModel, charactersModel,
+                      locationsModel](ScreenplayTextModel* _model) {
+                _model->setInformationModel(informationModel);
+                _model->setDictionariesModel(dictionariesModel);
+                _model->setCharactersModel(charactersModel);
+                _model->setLocationsModel(locationsModel);
+            });
+
+        //
+        // Снимок текста читается задачами одновременно, поэтому раскладываем копию по страницам,
+        // строим справочники и снимок заранее, пока она ещё в основном потоке
+        //
+        PaginationService::forModel(episodeCopy)->freeze();
+        episodeCopy->updateRuntimeDictionariesIfNeeded();
+        episodeCopy->snapshot();
+
+        episodes.append(episodeCopy);
+    }
+
+    auto model = _snapshot->create<ScreenplaySeriesEpisodesModel>();
+    model->setInformationModel(_snapshot->copy(episodesModel->informationModel()));
+    model->setEpisodes(episodes);
+    _snapshot->setModel(model);
+}
+
+template<typename... Reports>
+void ScreenplaySeriesStatisticsModel::Implementation::buildReports(Reports&... _reports)
+{
+    if (episodesModel == nullptr) {
+        return;
+    }
+
+    const auto snapshot = ReportsSnapshot::create();
+    copyEpisodesModel(snapshot);
+    builder.build({ _reports.buildTask(snapshot)... });
+}
+
+void ScreenplaySeriesStatisticsModel::Implementation::buildAllReports()
+{
+    buildReports(summaryReport, sceneReport, locationReport, castReport, dialoguesReport,
+                 charactersActivityPlot);
+}
+
+template<typename Report>
+void ScreenplaySeriesStatisticsModel::Implementation::rebuildReport(Report& _report)
+{
+    if (builder.isBuilding()) {
+        buildAllReports();
+    } else {
+        buildReports(_report);
+    }
+}
+
+template<typename Report>
+const Report& ScreenplaySeriesStatisticsModel::Implementation::actualReport(
+    const SnapshotReport<Report>& _report)
+{
+    builder.waitForFinished();
+    return *_report.report;
+}
+
+
+// ****
+
 
 ScreenplaySeriesStatisticsModel::ScreenplaySeriesStatisticsModel(QObject* _parent)
     : AbstractModel({}, _parent)
     , d(new Implementation)
 {
+    connect(&d->builder, &ReportsBuilder::progressChanged, this,
+            &ScreenplaySeriesStatisticsModel::reportsProgressChanged);
+    connect(&d->builder, &ReportsBuilder::built, this,
+            &ScreenplaySeriesStatisticsModel::reportsUpdated);
 }
 
 ScreenplaySeriesStatisticsModel::~ScreenplaySeriesStatisticsModel()
@@ -52,85 +184,80 @@ void ScreenplaySeriesStatisticsModel::setEpisodesModel(ScreenplaySeriesEpisodesM
 {
     d->episodesModel = _model;
 
-    d->summaryReport.build(d->episodesModel);
+    d->buildReports(d->summaryReport);
 }
 
 void ScreenplaySeriesStatisticsModel::updateReports()
 {
-    if (d->episodesModel == nullptr) {
-        return;
-    }
-
-    d->summaryReport.build(d->episodesModel);
-    d->sceneReport.build(d->episodesModel);
-    d->locationReport.build(d->episodesModel);
-    d->castReport.build(d->episodesModel);
-    d->dialoguesReport.build(d->episodesModel);
-    d->charactersActivityPlot.build(d->episodesModel);
+    d->buildAllReports();
 }
 
 const ScreenplaySeriesSummaryReport& ScreenplaySeriesStatisticsModel::summaryReport() const
 {
-    return d->summaryReport;
+    return d->actualReport(d->summaryReport);
 }
 
 const ScreenplaySeriesSceneReport& ScreenplaySeriesStatisticsModel::sceneReport() const
 {
-    return d->sceneReport;
+    return d->actualReport(d->sceneReport);
 }
 
 void ScreenplaySeriesStatisticsModel::setSceneReportParameters(bool _showCharacters, int _sortBy)
 {
-    d->sceneReport.setParameters(_showCharacters, _sortBy);
-    d->sceneReport.build(d->episodesModel);
+    d->sceneReport.setup = [=](auto& _report) { _report.setParameters(_showCharacters, _sortBy); };
+    d->rebuildReport(d->sceneReport);
 }
 
 const ScreenplaySeriesLocationReport& ScreenplaySeriesStatisticsModel::locationReport() const
 {
-    return d->locationReport;
+    return d->actualReport(d->locationReport);
 }
 
 void ScreenplaySeriesStatisticsModel::setLocationReportParameters(bool _extendedView, int _sortBy)
 {
-    d->locationReport.setParameters(_extendedView, _sortBy);
-    d->locationReport.build(d->episodesModel);
+    d->locationReport.setup = [=](auto& _report) { _report.setParameters(_extendedView, _sortBy); };
+    d->rebuildReport(d->locationReport);
 }
 
 const ScreenplaySeriesCastReport& ScreenplaySeriesStatisticsModel::castReport() const
 {
-    return d->castReport;
+    return d->actualReport(d->castReport);
 }
 
 void ScreenplaySeriesStatisticsModel::setCastReportParameters(bool _showDetails, bool _showWords,
                                                               int _sortBy)
 {
-    d->castReport.setParameters(_showDetails, _showWords, _sortBy);
-    d->castReport.build(d->episodesModel);
+    d->castReport.setup = [=](auto& _report) {
+        _report.setParameters(_showDetails, _showWords, _sortBy);
+    };
+    d->rebuildReport(d->castReport);
 }
 
 const ScreenplaySeriesDialoguesReport& ScreenplaySeriesStatisticsModel::dialoguesReport() const
 {
-    return d->dialoguesReport;
+    return d->actualReport(d->dialoguesReport);
 }
 
 void ScreenplaySeriesStatisticsModel::setDialoguesReportParameters(
     const QVector<QString>& _visibleCharacters)
 {
-    d->dialoguesReport.setParameters(_visibleCharacters);
-    d->dialoguesReport.build(d->episodesModel);
+    d->dialoguesReport.setup = [=](auto& _report) { _report.setParameters(_visibleCharacters); };
+    d->rebuildReport(d->dialoguesReport);
 }
 
 const ScreenplaySeriesCharactersActivityPlot& ScreenplaySeriesStatisticsModel::
     charactersActivityPlot() const
 {
-    return d->charactersActivityPlot;
+    return d->actualReport(d->charactersActivityPlot);
 }
 
 void ScreenplaySeriesStatisticsModel::setCharactersActivityPlotParameters(
     const QVector<QString>& _visibleCharacters)
 {
-    d->charactersActivityPlot.setParameters(_visibleCharacters);
-    d->charactersActivityPlot.build(d->episodesModel);
+    d->charactersActivityPlot.setup = [=](auto& _report) {
+        _report.setParameters(_visibleCharacters);
+    };
+    d->rebuildReport(d->charactersActivityPlot);
 }
 
 void ScreenplaySeriesStatisticsModel::initDocument()
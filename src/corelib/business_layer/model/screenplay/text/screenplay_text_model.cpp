@@ -11,6 +11,7 @@
 #include <business_layer/model/locations/location_model.h>
 #include <business_layer/model/locations/locations_model.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/screenplay_template.h>
 #include <data_layer/storage/settings_storage.h>
 #include <data_layer/storage/storage_facade.h>
@@ -18,6 +19,7 @@
 #include <utils/logging.h>
 
 #include <QRegularExpression>
+#include <QScopedValueRollback>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
@@ -26,7 +28,16 @@ namespace BusinessLayer {
 
 namespace {
 const char* kMimeType = "application/x-starc/screenplay/text/item";
+
+/**
+ * @brief Является ли элемент сценой
+ */
+bool isScene(const TextModelItem* _item)
+{
+    return _item->type() == TextModelItemType::Group
+        && static_cast<const TextModelGroupItem*>(_item)->groupType() == TextGroupType::Scene;
 }
+} // namespace
 
 class ScreenplayTextModel::Implementation
 {
@@ -43,6 +54,60 @@ public:
      */
     void updateChildrenCounters(const TextModelItem* _item, bool _force = false);
 
+    /**
+     * @brief Следующий элемент при обходе дерева в глубину
+     * @param _skipChildren - перейти сразу за последнего потомка элемента
+     */
+    TextModelItem* nextItem(TextModelItem* _item, bool _skipChildren) const;
+
+    /**
+     * @brief Предыдущий элемент при обходе дерева в глубину
+     */
+    TextModelItem* previousItem(TextModelItem* _item) const;
+
+    /**
+     * @brief Состояние нумерации перед очередной сценой
+     */
+    struct NumberingState {
+        bool operator==(const NumberingState& _other) const;
+
+        int sceneNumber = 0;
+        int dialogueNumber = 0;
+        QString lastLockedSceneFullNumber;
+    };
+
+    /**
+     * @brief Состояние нумерации в начале документа
+     */
+    NumberingState initialNumberingState() const;
+
+    /**
+     * @brief Пронумеровать элемент (сцену, либо реплику) и сдвинуть состояние нумерации
+     */
+    void updateItemNumber(TextModelItem* _item, NumberingState& _state);
+
+    /**
+     * @brief Перенумеровать документ от ближайшей к заданному элементу сцены
+     * @param _previousItem - элемент, перед которым ещё ничего не изменилось, nullptr, если
+     *        изменения начинаются с начала документа
+     * @param _untilItem - первый элемент за изменённым фрагментом, nullptr, если изменения идут
+     *        до конца документа
+     * @note Обход прекращается на первой же сцене за изменённым фрагментом, если состояние
+     *       нумерации перед ней не изменилось
+     */
+    void updateNumbering(TextModelItem* _previousItem, TextModelItem* _untilItem);
+
+    /**
+     * @brief Перенумеровать документ после изменений данных элементов, накопленных с прошлого
+     *        обновления нумерации
+     */
+    void updateChangedItemsNumbering();
+
+    /**
+     * @brief Забыть о состоянии нумерации элемента и всех его детей
+     */
+    void forgetItems(TextModelItem* _item);
+
 
     /**
      * @brief Родительский элемент
@@ -66,21 +131,34 @@ public:
     int scriptPageCount = 0;
 
     /**
-     * @brief Количество сцен
+     * @brief Состояния нумерации перед каждой из сцен документа
+     * @note Количество записей совпадает с количеством сцен в документе
      */
-    int scenesCount = 0;
+    QHash<const TextModelItem*, NumberingState> numberingStates;
 
     /**
-     * @brief Последний сохранённый хэш документа
+     * @brief Элементы, данные которых изменились с прошлого обновления нумерации
      */
-    QByteArray lastContentHash;
+    QSet<TextModelItem*> numberingChangedItems;
 
     /**
      * @brief Запланировано ли обновление нумерации
      */
     bool isUpdateNumberingPlanned = false;
+
+    /**
+     * @brief Выполняется ли в данный момент обновление нумерации
+     */
+    bool isUpdateNumberingInProgress = false;
 };
 
+bool ScreenplayTextModel::Implementation::NumberingState::operator==(
+    const NumberingState& _other) const
+{
+    return sceneNumber == _other.sceneNumber && dialogueNumber == _other.dialogueNumber
+        && lastLockedSceneFullNumber == _other.lastLockedSceneFullNumber;
+}
+
 ScreenplayTextModel::Implementation::Implementation(ScreenplayTextModel* _q)
     : q(_q)
 {
@@ -119,6 +197,197 @@ void ScreenplayTextModel::Implementation::updateChildrenCounters(const TextModel
     }
 }
 
+TextModelItem* ScreenplayTextModel::Implementation::nextItem(TextModelItem* _item,
+                                                             bool _skipChildren) const
+{
+    if (!_skipChildren && _item->hasChildren()) {
+        return _item->childAt(0);
+    }
+
+    auto item = _item;
+    while (item->parent() != nullptr) {
+        auto parentItem = item->parent();
+        const auto nextRow = parentItem->rowOfChild(item) + 1;
+        if (nextRow < parentItem->childCount()) {
+            return parentItem->childAt(nextRow);
+        }
+        item = parentItem;
+    }
+    return nullptr;
+}
+
+TextModelItem* ScreenplayTextModel::Implementation::previousItem(TextModelItem* _item) const
+{
+    auto parentItem = _item->parent();
+    const auto row = parentItem->rowOfChild(_item);
+    if (row == 0) {
+        return parentItem == rootItem() ? nullptr : parentItem;
+    }
+
+    auto item = parentItem->childAt(row - 1);
+    while (item->hasChildren()) {
+        item = item->childAt(item->childCount() - 1);
+    }
+    return item;
+}
+
+ScreenplayTextModel::Implementation::NumberingState ScreenplayTextModel::Implementation::
+    initialNumberingState() const
+{
+    NumberingState state;
+    state.sceneNumber = informationModel->scenesNumberingStartAt();
+    return state;
+}
+
+void ScreenplayTextModel::Implementation::updateItemNumber(TextModelItem* _item,
+                                                           NumberingState& _state)
+{
+    switch (_item->type()) {
+    case TextModelItemType::Group: {
+        if (!isScene(_item)) {
+            break;
+        }
+
+        auto groupItem = static_cast<TextModelGroupItem*>(_item);
+        numberingStates.insert(groupItem, _state);
+
+        //
+        // Если у сцены номер заблокирован, то запоминаем последний заблокированный для работы с
+        // номерами незаблокированных сцен и сбрасываем счётчик номеров
+        //
+        if (groupItem->number().has_value() && groupItem->number()->isLocked) {
+            _state.lastLockedSceneFullNumber
+                = groupItem->number()->followNumber + groupItem->number()->value;
+            _state.sceneNumber = 0;
+        }
+        //
+        // Если у сцены задан кастомный номер, то не меняем его
+        //
+        else if (groupItem->number().has_value() && groupItem->number()->isCustom) {
+            //
+            // ... но при необходимости переводим счётчик номеров сцен
+            //
+            if (!groupItem->number()->isEatNumber) {
+                ++_state.sceneNumber;
+            }
+        }
+        //
+        // А если номера назначаются автоматически, то задаём очередной номер
+        //
+        else {
+            if (groupItem->setNumber(_state.sceneNumber, _state.lastLockedSceneFullNumber)) {
+                q->updateItemForRoles(groupItem, { TextModelGroupItem::GroupNumberRole });
+            }
+            ++_state.sceneNumber;
+        }
+
+        //
+        // После того, как номер сформирован, декорируем его
+        //
+        groupItem->prepareNumberText(informationModel->scenesNumbersTemplate());
+        break;
+    }
+
+    case TextModelItemType::Text: {
+        auto textItem = static_cast<ScreenplayTextModelTextItem*>(_item);
+        if (textItem->isCorrection()) {
+            break;
+        }
+
+        switch (textItem->paragraphType()) {
+        case TextParagraphType::Character: {
+            ++_state.dialogueNumber;
+            Q_FALLTHROUGH();
+        }
+
+        case TextParagraphType::Dialogue:
+        case TextParagraphType::Lyrics: {
+            if (textItem->setNumber(_state.dialogueNumber)) {
+                q->updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
+            }
+            break;
+        }
+
+        default: {
+            break;
+        }
+        }
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void ScreenplayTextModel::Implementation::updateNumbering(TextModelItem* _previousItem,
+                                                          TextModelItem* _untilItem)
+{
+    if (isUpdateNumberingPlanned) {
+        return;
+    }
+
+    QScopedValueRollback isUpdateNumberingInProgressRollback(isUpdateNumberingInProgress, true);
+
+    //
+    // Ищем ближайшую сцену, перед которой ничего не изменилось, чтобы продолжить нумерацию с
+    // сохранённого для неё состояния, а если такой нет, то нумеруем с начала документа
+    //
+    auto item = _previousItem;
+    while (item != nullptr && !(isScene(item) && numberingStates.contains(item))) {
+        item = previousItem(item);
+    }
+    auto state = initialNumberingState();
+    if (item != nullptr) {
+        state = numberingStates.value(item);
+    } else {
+        item = rootItem()->childAt(0);
+    }
+
+    bool isUntilItemReached = false;
+    for (; item != nullptr; item = nextItem(item, false)) {
+        if (item == _untilItem) {
+            isUntilItemReached = true;
+        }
+
+        //
+        // За изменённым фрагментом останавливаемся на первой же сцене, состояние нумерации перед
+        // которой не изменилось, т.к. дальше номера останутся прежними
+        //
+        if (isUntilItemReached && isScene(item)) {
+            const auto savedState = numberingStates.constFind(item);
+            if (savedState != numberingStates.cend() && savedState.value() == state) {
+                break;
+            }
+        }
+
+        updateItemNumber(item, state);
+    }
+}
+
+void ScreenplayTextModel::Implementation::updateChangedItemsNumbering()
+{
+    if (isUpdateNumberingPlanned) {
+        return;
+    }
+
+    const auto changedItems = numberingChangedItems;
+    numberingChangedItems.clear();
+    for (auto item : changedItems) {
+        updateNumbering(previousItem(item), nextItem(item, true));
+    }
+}
+
+void ScreenplayTextModel::Implementation::forgetItems(TextModelItem* _item)
+{
+    numberingStates.remove(_item);
+    numberingChangedItems.remove(_item);
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        forgetItems(_item->childAt(childIndex));
+    }
+}
+
 
 // ****
 
@@ -126,22 +395,74 @@ ScreenplayTextModel::ScreenplayTextModel(QObject* _parent)
     : ScriptTextModel(_parent, ScreenplayTextModel::createFolderItem(TextFolderType::Root))
     , d(new Implementation(this))
 {
-    auto updateCounters = [this](const QModelIndex& _index = {}) {
-        if (const auto hash = contentHash(); d->lastContentHash != hash) {
-            updateNumbering();
-            d->lastContentHash = hash;
-        }
-
-        d->updateChildrenCounters(itemForIndex(_index));
-    };
     //
-    // Обновляем счётчики после того, как операции вставки и удаления будут обработаны клиентами
-    // модели (главным образом внутри прокси-моделей), т.к. обновление элемента модели может
-    // приводить к падению внутри них
+    // Обновляем нумерацию и счётчики после того, как операции вставки и удаления будут обработаны
+    // клиентами модели (главным образом внутри прокси-моделей), т.к. обновление элемента модели
+    // может приводить к падению внутри них
+    //
+    // ... нумерацию обновляем только начиная с ближайшей к изменению сцены, а счётчики
+    //     пересчитываем только у вставленных элементов, т.к. изменение счётчиков элемента само
+    //     поднимается вверх по цепочке его родителей
+    //
+    connect(this, &ScreenplayTextModel::afterRowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                d->updateChangedItemsNumbering();
+                d->updateNumbering(d->previousItem(parentItem->childAt(_first)),
+                                   d->nextItem(parentItem->childAt(_last), true));
+
+                for (int row = _first; row <= _last; ++row) {
+                    auto item = parentItem->childAt(row);
+                    if (item->type() == TextModelItemType::Text) {
+                        static_cast<ScreenplayTextModelTextItem*>(item)->updateCounters();
+                    } else {
+                        d->updateChildrenCounters(item);
+                    }
+                }
+            });
+    connect(this, &ScreenplayTextModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->forgetItems(parentItem->childAt(row));
+                }
+            });
+    connect(this, &ScreenplayTextModel::afterRowsRemoved, this,
+            [this](const QModelIndex& _parent, int _first) {
+                auto parentItem = itemForIndex(_parent);
+                TextModelItem* previousItem = nullptr;
+                if (_first > 0) {
+                    previousItem = parentItem->childAt(_first - 1);
+                    while (previousItem->hasChildren()) {
+                        previousItem = previousItem->childAt(previousItem->childCount() - 1);
+                    }
+                } else if (parentItem != d->rootItem()) {
+                    previousItem = parentItem;
+                }
+                auto untilItem = _first < parentItem->childCount()
+                    ? parentItem->childAt(_first)
+                    : d->nextItem(parentItem, true);
+                d->updateChangedItemsNumbering();
+                d->updateNumbering(previousItem, untilItem);
+            });
+    connect(this, &ScreenplayTextModel::modelReset, this, [this] {
+        updateNumbering();
+        d->updateChildrenCounters(d->rootItem());
+    });
     //
-    connect(this, &ScreenplayTextModel::afterRowsInserted, this, updateCounters);
-    connect(this, &ScreenplayTextModel::afterRowsRemoved, this, updateCounters);
-    connect(this, &ScreenplayTextModel::modelReset, this, updateCounters);
+    // Запоминаем элементы, изменения которых могут повлиять на нумерацию, чтобы перенумеровать
+    // документ начиная с них при следующей вставке или удалении
+    //
+    connect(this, &ScreenplayTextModel::dataChanged, this, [this](const QModelIndex& _topLeft) {
+        if (d->isUpdateNumberingInProgress || !_topLeft.isValid()) {
+            return;
+        }
+
+        auto item = itemForIndex(_topLeft);
+        if (item->type() == TextModelItemType::Text || isScene(item)) {
+            d->numberingChangedItems.insert(item);
+        }
+    });
     //
     // Если модель планируем большое изменение, то планируем отложенное обновление нумерации
     //
@@ -240,134 +561,118 @@ ScreenplayDictionariesModel* ScreenplayTextModel::dictionariesModel() const
 void ScreenplayTextModel::updateCharacterName(const QString& _oldName, const QString& _newName)
 {
     const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateCharacterBlock;
-    updateCharacterBlock = [this, oldName, _newName,
-                            &updateCharacterBlock](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                updateCharacterBlock(childItem);
-                break;
-            }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::SceneCharacters
-                    && ScreenplaySceneCharactersParser::characters(textItem->text())
-                           .contains(oldName)) {
-                    auto text = textItem->text();
-                    auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
-                    while (nameIndex != -1) {
-                        //
-                        // Убедимся, что выделено именно имя, а не часть другого имени
-                        //
-                        const auto nameEndIndex = nameIndex + oldName.length();
-                        const bool atLeftAllOk = nameIndex == 0 || text.at(nameIndex - 1) == ','
-                            || (nameIndex > 2 && text.mid(nameIndex - 2, 2) == ", ");
-                        const bool atRightAllOk = nameEndIndex == text.length()
-                            || text.at(nameEndIndex) == ','
-                            || (text.length() > nameEndIndex + 1
-                                && (text.mid(nameEndIndex, 2) == " ,"
-                                    || text.mid(nameEndIndex, 2) == " ("));
-                        if (!atLeftAllOk || !atRightAllOk) {
-                            nameIndex
-                                = TextHelper::smartToUpper(text).indexOf(oldName, nameEndIndex);
-                            continue;
-                        }
-
-                        text.remove(nameIndex, oldName.length());
-                        text.insert(nameIndex, _newName);
-                        textItem->setText(text);
-                        updateItem(textItem);
-                        break;
-                    }
-                } else if (textItem->paragraphType() == TextParagraphType::Character
-                           && ScreenplayCharacterParser::name(textItem->text()) == oldName) {
-                    auto text = textItem->text();
-                    text.remove(0, oldName.length());
-                    text.prepend(_newName);
-                    textItem->setText(text);
-                    updateItem(textItem);
-                } else if (textItem->text().contains(oldName, Qt::CaseInsensitive)) {
-                    auto text = textItem->text();
-                    const QRegularExpression nameMatcher(
-                        QString("\\b(%1)\\b").arg(TextHelper::toRxEscaped(oldName)),
-                        QRegularExpression::CaseInsensitiveOption);
-                    auto match = nameMatcher.match(text);
-                    while (match.hasMatch()) {
-                        text.remove(match.capturedStart(), match.capturedLength());
-                        const auto capturedName = match.captured();
-                        const auto capitalizeEveryWord = true;
-                        const auto newName = capturedName == oldName
-                            ? TextHelper::smartToUpper(_newName)
-                            : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
-                        text.insert(match.capturedStart(), newName);
-
-                        match = nameMatcher.match(text, match.capturedStart() + _newName.length());
-                    }
+    //
+    // Отбираем абзацы, в которых вообще встречается имя, по снимку модели, а сами изменения
+    // вносим уже после того, как снимок будет отпущен, чтобы не копировать его при каждой правке
+    //
+    QVector<ScreenplayTextModelTextItem*> textItems;
+    {
+        const auto snapshot = this->snapshot();
+        for (int index = 0; index < snapshot.size(); ++index) {
+            if (snapshot.type(index) == TextModelItemType::Text
+                && snapshot.text(index).contains(oldName, Qt::CaseInsensitive)) {
+                textItems.append(static_cast<ScreenplayTextModelTextItem*>(snapshot.item(index)));
+            }
+        }
+    }
 
-                    textItem->setText(text);
-                    updateItem(textItem);
+    beginChangeRows();
+    for (auto textItem : std::as_const(textItems)) {
+        if (textItem->paragraphType() == TextParagraphType::SceneCharacters
+            && ScreenplaySceneCharactersParser::characters(textItem->text()).contains(oldName)) {
+            auto text = textItem->text();
+            auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
+            while (nameIndex != -1) {
+                //
+                // Убедимся, что выделено именно имя, а не часть другого имени
+                //
+                const auto nameEndIndex = nameIndex + oldName.length();
+                const bool atLeftAllOk = nameIndex == 0 || text.at(nameIndex - 1) == ','
+                    || (nameIndex > 2 && text.mid(nameIndex - 2, 2) == ", ");
+                const bool atRightAllOk = nameEndIndex == text.length()
+                    || text.at(nameEndIndex) == ','
+                    || (text.length() > nameEndIndex + 1
+                        && (text.mid(nameEndIndex, 2) == " ,"
+                            || text.mid(nameEndIndex, 2) == " ("));
+                if (!atLeftAllOk || !atRightAllOk) {
+                    nameIndex = TextHelper::smartToUpper(text).indexOf(oldName, nameEndIndex);
+                    continue;
                 }
-                break;
-            }
 
-            default:
+                text.remove(nameIndex, oldName.length());
+                text.insert(nameIndex, _newName);
+                textItem->setText(text);
+                updateItem(textItem);
                 break;
             }
-        }
-    };
+        } else if (textItem->paragraphType() == TextParagraphType::Character
+                   && ScreenplayCharacterParser::name(textItem->text()) == oldName) {
+            auto text = textItem->text();
+            text.remove(0, oldName.length());
+            text.prepend(_newName);
+            textItem->setText(text);
+            updateItem(textItem);
+        } else {
+            auto text = textItem->text();
+            const QRegularExpression nameMatcher(
+                QString("\\b(%1)\\b").arg(TextHelper::toRxEscaped(oldName)),
+                QRegularExpression::CaseInsensitiveOption);
+            auto match = nameMatcher.match(text);
+            while (match.hasMatch()) {
+                text.remove(match.capturedStart(), match.capturedLength());
+                const auto capturedName = match.captured();
+                const auto capitalizeEveryWord = true;
+                const auto newName = capturedName == oldName
+                    ? TextHelper::smartToUpper(_newName)
+                    : TextHelper::toSentenceCase(_newName, capitalizeEveryWord);
+                text.insert(match.capturedStart(), newName);
+
+                match = nameMatcher.match(text, match.capturedStart() + _newName.length());
+            }
 
-    beginChangeRows();
-    updateCharacterBlock(d->rootItem());
+            textItem->setText(text);
+            updateItem(textItem);
+        }
+    }
     endChangeRows();
 }
 
 QVector<QModelIndex> ScreenplayTextModel::characterDialogues(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
     QString lastCharacter;
     QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Text) {
-            const auto textItem = static_cast<TextModelTextItem*>(item);
-            switch (textItem->paragraphType()) {
-            case TextParagraphType::Character: {
-                lastCharacter = ScreenplayCharacterParser::name(textItem->text());
-                break;
-            }
+    const auto snapshot = this->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
 
-            case TextParagraphType::Parenthetical: {
-                //
-                // Не очищаем имя персонажа, идём до реплики
-                //
-                break;
-            }
+        switch (snapshot.paragraphType(index)) {
+        case TextParagraphType::Character: {
+            lastCharacter = ScreenplayCharacterParser::name(snapshot.text(index));
+            break;
+        }
 
-            case TextParagraphType::Dialogue:
-            case TextParagraphType::Lyrics: {
-                if (lastCharacter == _name) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
+        case TextParagraphType::Parenthetical: {
+            //
+            // Не очищаем имя персонажа, идём до реплики
+            //
+            break;
+        }
 
-            default: {
-                lastCharacter.clear();
-                break;
-            }
+        case TextParagraphType::Dialogue:
+        case TextParagraphType::Lyrics: {
+            if (lastCharacter == _name) {
+                dialoguesIndexes.append(indexForItem(snapshot.item(index)));
             }
+            break;
         }
 
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
+        default: {
+            lastCharacter.clear();
+            break;
+        }
         }
     }
 
@@ -378,47 +683,27 @@ QVector<QString> ScreenplayTextModel::findCharactersFromText() const
 {
     QVector<QString> characters;
     QHash<QString, int> charactersDialogues;
-    std::function<void(const TextModelItem*)> findCharacters;
-    findCharacters
-        = [&characters, &charactersDialogues, &findCharacters](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      findCharacters(childItem);
-                      break;
-                  }
-
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                      if (textItem->paragraphType() == TextParagraphType::SceneCharacters) {
-                          const auto textCharacters
-                              = ScreenplaySceneCharactersParser::characters(textItem->text());
-                          for (const auto& character : textCharacters) {
-                              if (!charactersDialogues.contains(character)) {
-                                  characters.append(character);
-                                  charactersDialogues.insert(character, 0);
-                              }
-                          }
-                      } else if (textItem->paragraphType() == TextParagraphType::Character) {
-                          const auto character = ScreenplayCharacterParser::name(textItem->text());
-                          if (charactersDialogues.contains(character)) {
-                              ++charactersDialogues[character];
-                          } else {
-                              characters.append(character);
-                              charactersDialogues.insert(character, 1);
-                          }
-                      }
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
-    findCharacters(d->rootItem());
+    const auto snapshot = this->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.paragraphType(index) == TextParagraphType::SceneCharacters) {
+            const auto textCharacters
+                = ScreenplaySceneCharactersParser::characters(snapshot.text(index));
+            for (const auto& character : textCharacters) {
+                if (!charactersDialogues.contains(character)) {
+                    characters.append(character);
+                    charactersDialogues.insert(character, 0);
+                }
+            }
+        } else if (snapshot.paragraphType(index) == TextParagraphType::Character) {
+            const auto character = ScreenplayCharacterParser::name(snapshot.text(index));
+            if (charactersDialogues.contains(character)) {
+                ++charactersDialogues[character];
+            } else {
+                characters.append(character);
+                charactersDialogues.insert(character, 1);
+            }
+        }
+    }
     std::sort(characters.begin(), characters.end(),
               [&charactersDialogues](const QString& _lhs, const QString& _rhs) {
                   return charactersDialogues.value(_lhs) > charactersDialogues.value(_rhs);
@@ -429,73 +714,36 @@ QVector<QString> ScreenplayTextModel::findCharactersFromText() const
 
 QVector<QModelIndex> ScreenplayTextModel::locationScenes(const QString& _name) const
 {
-    QVector<QModelIndex> modelIndexes;
-    for (int row = 0; row < rowCount(); ++row) {
-        modelIndexes.append(index(row, 0));
-    }
-    QVector<QModelIndex> dialoguesIndexes;
-    while (!modelIndexes.isEmpty()) {
-        const auto itemIndex = modelIndexes.takeFirst();
-        const auto item = itemForIndex(itemIndex);
-        if (item->type() == TextModelItemType::Group) {
-            const auto groupItem = static_cast<TextModelGroupItem*>(item);
-            switch (groupItem->groupType()) {
-            case TextGroupType::Scene: {
-                if (_name == ScreenplaySceneHeadingParser::location(groupItem->heading())) {
-                    dialoguesIndexes.append(itemIndex);
-                }
-                break;
-            }
-
-            default: {
-                break;
-            }
-            }
-        }
-
-        for (int childRow = 0; childRow < rowCount(itemIndex); ++childRow) {
-            modelIndexes.append(index(childRow, 0, itemIndex));
+    QVector<QModelIndex> scenesIndexes;
+    const auto snapshot = this->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.groupType(index) == TextGroupType::Scene
+            && _name == ScreenplaySceneHeadingParser::location(snapshot.text(index))) {
+            scenesIndexes.append(indexForItem(snapshot.item(index)));
         }
     }
 
-    return dialoguesIndexes;
+    return scenesIndexes;
 }
 
 QVector<QString> ScreenplayTextModel::findLocationsFromText() const
 {
     QVector<QString> locations;
     QHash<QString, int> locationsCount;
-    std::function<void(const TextModelItem*)> findLocations;
-    findLocations = [&locations, &locationsCount, &findLocations](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                findLocations(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                if (textItem->paragraphType() == TextParagraphType::SceneHeading) {
-                    const auto location = ScreenplaySceneHeadingParser::location(textItem->text());
-                    if (locationsCount.contains(location)) {
-                        ++locationsCount[location];
-                    } else {
-                        locations.append(location);
-                        locationsCount.insert(location, 1);
-                    }
-                }
-                break;
-            }
+    const auto snapshot = this->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.paragraphType(index) != TextParagraphType::SceneHeading) {
+            continue;
+        }
 
-            default:
-                break;
-            }
+        const auto location = ScreenplaySceneHeadingParser::location(snapshot.text(index));
+        if (locationsCount.contains(location)) {
+            ++locationsCount[location];
+        } else {
+            locations.append(location);
+            locationsCount.insert(location, 1);
         }
-    };
-    findLocations(d->rootItem());
+    }
     std::sort(locations.begin(), locations.end(),
               [&locationsCount](const QString& _lhs, const QString& _rhs) {
                   return locationsCount.value(_lhs) > locationsCount.value(_rhs);
@@ -507,40 +755,27 @@ QVector<QString> ScreenplayTextModel::findLocationsFromText() const
 void ScreenplayTextModel::updateLocationName(const QString& _oldName, const QString& _newName)
 {
     const auto oldName = TextHelper::smartToUpper(_oldName);
-    std::function<void(const TextModelItem*)> updateLocationBlock;
-    updateLocationBlock
-        = [this, oldName, _newName, &updateLocationBlock](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      updateLocationBlock(childItem);
-                      break;
-                  }
 
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                      if (textItem->paragraphType() == TextParagraphType::SceneHeading
-                          && ScreenplaySceneHeadingParser::location(textItem->text()) == oldName) {
-                          auto text = textItem->text();
-                          const auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
-                          text.remove(nameIndex, oldName.length());
-                          text.insert(nameIndex, _newName);
-                          textItem->setText(text);
-                          updateItem(textItem);
-                      }
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
+    QVector<ScreenplayTextModelTextItem*> textItems;
+    {
+        const auto snapshot = this->snapshot();
+        for (int index = 0; index < snapshot.size(); ++index) {
+            if (snapshot.paragraphType(index) == TextParagraphType::SceneHeading
+                && ScreenplaySceneHeadingParser::location(snapshot.text(index)) == oldName) {
+                textItems.append(static_cast<ScreenplayTextModelTextItem*>(snapshot.item(index)));
+            }
+        }
+    }
 
     beginChangeRows();
-    updateLocationBlock(d->rootItem());
+    for (auto textItem : std::as_const(textItems)) {
+        auto text = textItem->text();
+        const auto nameIndex = TextHelper::smartToUpper(text).indexOf(oldName);
+        text.remove(nameIndex, oldName.length());
+        text.insert(nameIndex, _newName);
+        textItem->setText(text);
+        updateItem(textItem);
+    }
     endChangeRows();
 }
 
@@ -584,7 +819,7 @@ void ScreenplayTextModel::setScriptPageCount(int _count)
 
 int ScreenplayTextModel::scenesCount() const
 {
-    return d->scenesCount;
+    return d->numberingStates.size();
 }
 
 int ScreenplayTextModel::wordsCount() const
@@ -602,6 +837,44 @@ std::chrono::milliseconds ScreenplayTextModel::duration() const
     return static_cast<ScreenplayTextModelFolderItem*>(d->rootItem())->duration();
 }
 
+std::chrono::milliseconds ScreenplayTextModel::itemDuration(const TextModelItem* _item) const
+{
+    if (_item == nullptr) {
+        return {};
+    }
+
+    switch (_item->type()) {
+    case TextModelItemType::Folder: {
+        return static_cast<const ScreenplayTextModelFolderItem*>(_item)->duration();
+    }
+
+    case TextModelItemType::Group: {
+        const auto groupItem = static_cast<const TextModelGroupItem*>(_item);
+        switch (groupItem->groupType()) {
+        case TextGroupType::Scene: {
+            return static_cast<const ScreenplayTextModelSceneItem*>(_item)->duration();
+        }
+
+        case TextGroupType::Beat: {
+            return static_cast<const ScreenplayTextModelBeatItem*>(_item)->duration();
+        }
+
+        default: {
+            return {};
+        }
+        }
+    }
+
+    case TextModelItemType::Text: {
+        return static_cast<const ScreenplayTextModelTextItem*>(_item)->duration();
+    }
+
+    default: {
+        return {};
+    }
+    }
+}
+
 std::map<std::chrono::milliseconds, QColor> ScreenplayTextModel::itemsColors() const
 {
     std::chrono::milliseconds lastItemDuration{ 0 };
@@ -677,96 +950,20 @@ void ScreenplayTextModel::updateNumbering()
         return;
     }
 
-    d->scenesCount = 0;
-    int sceneNumber = d->informationModel->scenesNumberingStartAt();
-    int dialogueNumber = 0;
-    QString lastLockedSceneFullNumber;
-    std::function<void(const TextModelItem*)> updateChildNumbering;
-    updateChildNumbering = [this, &sceneNumber, &dialogueNumber, &lastLockedSceneFullNumber,
-                            &updateChildNumbering](const TextModelItem* _item) {
+    QScopedValueRollback isUpdateNumberingInProgressRollback(d->isUpdateNumberingInProgress, true);
+
+    //
+    // Нумеруем весь документ заново, запоминая состояние нумерации перед каждой из сцен
+    //
+    d->numberingStates.clear();
+    d->numberingChangedItems.clear();
+    auto state = d->initialNumberingState();
+    std::function<void(TextModelItem*)> updateChildNumbering;
+    updateChildNumbering = [this, &state, &updateChildNumbering](TextModelItem* _item) {
         for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
             auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder: {
-                updateChildNumbering(childItem);
-                break;
-            }
-
-            case TextModelItemType::Group: {
-                updateChildNumbering(childItem);
-                auto groupItem = static_cast<TextModelGroupItem*>(childItem);
-                if (groupItem->groupType() == TextGroupType::Scene) {
-                    ++d->scenesCount;
-
-                    //
-                    // Если у сцены номер заблокирован, то запоминаем последний заблокированный для
-                    // работы с номерами незаблокированных сцен и сбрасываем счётчик номеров
-                    //
-                    if (groupItem->number().has_value() && groupItem->number()->isLocked) {
-                        lastLockedSceneFullNumber
-                            = groupItem->number()->followNumber + groupItem->number()->value;
-                        sceneNumber = 0;
-                    }
-                    //
-                    // Если у сцены задан кастомный номер, то не меняем его
-                    //
-                    else if (groupItem->number().has_value() && groupItem->number()->isCustom) {
-                        //
-                        // ... но при необходимости переводим счётчик номеров сцен
-                        //
-                        if (!groupItem->number()->isEatNumber) {
-                            ++sceneNumber;
-                        }
-                    }
-                    //
-                    // А если номера назначаются автоматически, то задаём очередной номер
-                    //
-                    else {
-                        if (groupItem->setNumber(sceneNumber, lastLockedSceneFullNumber)) {
-                            updateItemForRoles(groupItem, { TextModelGroupItem::GroupNumberRole });
-                        }
-                        ++sceneNumber;
-                    }
-
-                    //
-                    // После того, как номер сформирован, декорируем его
-                    //
-                    groupItem->prepareNumberText(d->informationModel->scenesNumbersTemplate());
-                }
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                if (textItem->isCorrection()) {
-                    break;
-                }
-
-                switch (textItem->paragraphType()) {
-                case TextParagraphType::Character: {
-                    ++dialogueNumber;
-                    Q_FALLTHROUGH();
-                }
-
-                case TextParagraphType::Dialogue:
-                case TextParagraphType::Lyrics: {
-                    if (textItem->setNumber(dialogueNumber)) {
-                        updateItemForRoles(textItem, { TextModelTextItem::TextNumberRole });
-                    }
-                    break;
-                }
-
-                default: {
-                    break;
-                }
-                }
-
-                break;
-            }
-
-            default:
-                break;
-            }
+            d->updateItemNumber(childItem, state);
+            updateChildNumbering(childItem);
         }
     };
     updateChildNumbering(d->rootItem());
@@ -806,11 +1003,10 @@ void ScreenplayTextModel::setScenesNumbersLocked(bool _locked)
     setSceneNumbersLockedImpl(d->rootItem());
 
     //
-    // Если номера были разблокированы, то нужно сформировать их заново
+    // Если номера были разблокированы, то нужно сформировать их заново, а если заблокированы, то
+    // нужно обновить сохранённые состояния нумерации сцен
     //
-    if (!_locked) {
-        updateNumbering();
-    }
+    updateNumbering();
 }
 
 void ScreenplayTextModel::recalculateCounters()
@@ -13,7 +13,7 @@
 
 namespace BusinessLayer {
 
-class ScreenplayTextModelTextItem::Implementation
+class ScreenplayTextModelTextItem::Implementation : public PoolAllocated
 {
 public:
     //
@@ -15,6 +15,7 @@
 #include <QColor>
 #include <QDataStream>
 #include <QDomDocument>
+#include <QHash>
 #include <QIODevice>
 #include <QMimeData>
 #include <QSet>
@@ -59,6 +60,31 @@ public:
      */
     QByteArray toXml(Domain::DocumentObject* _structure) const;
 
+    /**
+     * @brief Добавить в индекс элемент вместе с его версиями и всеми вложенными элементами
+     */
+    void indexItem(StructureModelItem* _item) const;
+
+    /**
+     * @brief Добавить в индекс элемент вместе с его версиями, но без вложенных элементов
+     */
+    void indexItemWithVersions(StructureModelItem* _item) const;
+
+    /**
+     * @brief Убрать из индекса элемент вместе с его версиями и всеми вложенными элементами
+     */
+    void unindexItem(StructureModelItem* _item) const;
+
+    /**
+     * @brief Убрать из индекса только сам элемент, без версий и вложенных элементов
+     */
+    void unindexSingleItem(StructureModelItem* _item) const;
+
+    /**
+     * @brief Построить индекс элементов, если он ещё не построен
+     */
+    void buildItemsIndex() const;
+
 
     /**
      * @brief Является ли проект вновь созданным
@@ -84,6 +110,22 @@ public:
      * @brief Список индексов для которых доступен навигатор
      */
     QSet<QModelIndex> navigatorAvailableIndexes;
+
+    /**
+     * @brief Построен ли индекс элементов
+     */
+    mutable bool isItemsIndexBuilt = false;
+
+    /**
+     * @brief Индекс элементов и версий по их идентификаторам
+     */
+    mutable QHash<QUuid, StructureModelItem*> itemsIndex;
+
+    /**
+     * @brief Идентификаторы, под которыми элементы лежат в индексе
+     * @note Нужны, чтобы убирать из индекса элементы, у которых сменился идентификатор
+     */
+    mutable QHash<const StructureModelItem*, QUuid> indexedUuids;
 };
 
 StructureModel::Implementation::Implementation()
@@ -210,6 +252,79 @@ QByteArray StructureModel::Implementation::toXml(Domain::DocumentObject* _struct
     return xml;
 }
 
+void StructureModel::Implementation::indexItem(StructureModelItem* _item) const
+{
+    if (!isItemsIndexBuilt) {
+        return;
+    }
+
+    indexItemWithVersions(_item);
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        indexItem(_item->childAt(childIndex));
+    }
+}
+
+void StructureModel::Implementation::indexItemWithVersions(StructureModelItem* _item) const
+{
+    if (!isItemsIndexBuilt) {
+        return;
+    }
+
+    auto indexSingleItem = [this](StructureModelItem* _indexedItem) {
+        const auto indexedUuid = indexedUuids.value(_indexedItem);
+        if (!indexedUuid.isNull() && indexedUuid != _indexedItem->uuid()
+            && itemsIndex.value(indexedUuid) == _indexedItem) {
+            itemsIndex.remove(indexedUuid);
+        }
+        itemsIndex.insert(_indexedItem->uuid(), _indexedItem);
+        indexedUuids.insert(_indexedItem, _indexedItem->uuid());
+    };
+
+    indexSingleItem(_item);
+    for (auto version : _item->versions()) {
+        indexSingleItem(version);
+    }
+}
+
+void StructureModel::Implementation::unindexItem(StructureModelItem* _item) const
+{
+    if (!isItemsIndexBuilt) {
+        return;
+    }
+
+    unindexSingleItem(_item);
+    for (auto version : _item->versions()) {
+        unindexSingleItem(version);
+    }
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        unindexItem(_item->childAt(childIndex));
+    }
+}
+
+void StructureModel::Implementation::unindexSingleItem(StructureModelItem* _item) const
+{
+    if (!isItemsIndexBuilt) {
+        return;
+    }
+
+    const auto indexedUuid = indexedUuids.take(_item);
+    if (itemsIndex.value(indexedUuid) == _item) {
+        itemsIndex.remove(indexedUuid);
+    }
+}
+
+void StructureModel::Implementation::buildItemsIndex() const
+{
+    if (isItemsIndexBuilt) {
+        return;
+    }
+
+    isItemsIndexBuilt = true;
+    for (int childIndex = 0; childIndex < rootItem->childCount(); ++childIndex) {
+        indexItem(rootItem->childAt(childIndex));
+    }
+}
+
 
 // ****
 
@@ -218,6 +333,45 @@ StructureModel::StructureModel(QObject* _parent)
     : AbstractModel({}, _parent)
     , d(new Implementation)
 {
+    //
+    // Индекс элементов обновляем вслед за изменениями структуры, а при сбросе модели просто
+    // выкидываем, он будет построен заново при первом поиске
+    //
+    connect(this, &StructureModel::rowsInserted, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                const auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->indexItem(parentItem->childAt(row));
+                }
+            });
+    connect(this, &StructureModel::rowsAboutToBeRemoved, this,
+            [this](const QModelIndex& _parent, int _first, int _last) {
+                const auto parentItem = itemForIndex(_parent);
+                for (int row = _first; row <= _last; ++row) {
+                    d->unindexItem(parentItem->childAt(row));
+                }
+            });
+    connect(this, &StructureModel::modelAboutToBeReset, this, [this] {
+        d->isItemsIndexBuilt = false;
+        d->itemsIndex.clear();
+        d->indexedUuids.clear();
+    });
+    //
+    // ... при наложении изменений у элемента может смениться идентификатор и пересоздаться версии
+    //
+    connect(this, &StructureModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                if (_topLeft.parent() != _bottomRight.parent()) {
+                    return;
+                }
+
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    const auto item = itemForIndex(index(row, 0, _topLeft.parent()));
+                    if (item != d->rootItem) {
+                        d->indexItemWithVersions(item);
+                    }
+                }
+            });
 }
 
 StructureModel::~StructureModel() = default;
@@ -1130,30 +1284,8 @@ StructureModelItem* StructureModel::itemForIndex(const QModelIndex& _index) cons
 
 StructureModelItem* StructureModel::itemForUuid(const QUuid& _uuid) const
 {
-    std::function<StructureModelItem*(StructureModelItem*)> search;
-    search = [&search, _uuid](StructureModelItem* _parent) -> StructureModelItem* {
-        for (int itemRow = 0; itemRow < _parent->childCount(); ++itemRow) {
-            auto item = _parent->childAt(itemRow);
-            if (item->uuid() == _uuid) {
-                return item;
-            }
-
-            const auto versions = item->versions();
-            for (auto version : versions) {
-                if (version->uuid() == _uuid) {
-                    return version;
-                }
-            }
-
-            auto childItem = search(item);
-            if (childItem != nullptr) {
-                return childItem;
-            }
-        }
-        return nullptr;
-    };
-
-    return search(d->rootItem);
+    d->buildItemsIndex();
+    return d->itemsIndex.value(_uuid);
 }
 
 StructureModelItem* StructureModel::itemForType(Domain::DocumentObjectType _type) const
@@ -1273,6 +1405,7 @@ void StructureModel::removeItemVersion(StructureModelItem* _item, int _versionIn
     }
 
     const auto itemIndex = indexForItem(_item);
+    d->unindexSingleItem(_item->versions().at(_versionIndex));
     _item->removeVersion(_versionIndex);
     emit dataChanged(itemIndex, itemIndex);
     emit versionRemoved(_item->uuid());
@@ -1574,6 +1707,12 @@ ChangeCursor StructureModel::applyPatch(const QByteArray& _patch)
             // Обновляем элемент
             //
             if (!modelItem->isEqual(newItem)) {
+                //
+                // ... версии элемента будут пересозданы, поэтому убираем старые из индекса
+                //
+                for (auto version : modelItem->versions()) {
+                    d->unindexSingleItem(version);
+                }
                 modelItem->copyFrom(newItem);
                 updateItem(modelItem);
                 //
@@ -2,6 +2,7 @@
 
 #include "text_model_folder_item.h"
 #include "text_model_group_item.h"
+#include "text_model_snapshot.h"
 #include "text_model_splitter_item.h"
 #include "text_model_text_item.h"
 #include "text_model_xml.h"
@@ -25,9 +26,14 @@
 #include <QDateTime>
 #include <QDomDocument>
 #include <QMimeData>
+#include <QQueue>
+#include <QSet>
 #include <QStringListModel>
 #include <QXmlStreamReader>
 
+#include <functional>
+#include <optional>
+
 #ifdef QT_DEBUG
 #define XML_CHECKS
 #endif
@@ -50,6 +56,87 @@ public:
      */
     QByteArray toXml(Domain::DocumentObject* _document) const;
 
+    /**
+     * @brief Сформировать xml из данных модели, определив изменённый с момента сохранения фрагмент
+     */
+    XmlChange xmlChange(Domain::DocumentObject* _document) const;
+
+    /**
+     * @brief Фрагмент xml документа
+     * @note Папки без разорванных абзацев раскладываются на заголовок, фрагменты детей и
+     *       завершение, а остальные элементы составляют фрагмент целиком. Так правка сцены внутри
+     *       акта формирует заново только xml этой сцены, а не всего акта
+     */
+    struct XmlChunkPlace {
+        enum class Kind {
+            Item,
+            FolderHeader,
+            FolderFooter,
+        };
+
+        const TextModelItem* item = nullptr;
+        Kind kind = Kind::Item;
+    };
+
+    /**
+     * @brief Собрать фрагменты xml детей заданного элемента
+     */
+    void collectXmlChunkPlaces(const TextModelItem* _parentItem,
+                               QVector<XmlChunkPlace>& _places) const;
+
+    /**
+     * @brief Можно ли разложить папку на отдельные фрагменты
+     * @note Разорванные абзацы сохраняются папкой склеенными, а корректирующие пропускаются,
+     *       поэтому такие папки формируются целиком
+     */
+    bool canSplitFolderXml(const TextModelItem* _folderItem) const;
+
+    /**
+     * @brief Получить xml фрагмента и его длину в координатах патча
+     */
+    QByteArray xmlChunk(const XmlChunkPlace& _place, int& _plainLength) const;
+
+    /**
+     * @brief Пометить изменённым элемент и всех его родителей, т.к. xml любого из них может
+     *        оказаться отдельным фрагментом
+     */
+    void markXmlChanged(TextModelItem* _item);
+
+    /**
+     * @brief Удалить закешированный xml заданных детей элемента
+     */
+    void removeXmlChunks(TextModelItem* _parentItem, int _fromRow, int _toRow);
+
+    /**
+     * @brief Удалить закешированный xml заданного элемента и его детей
+     */
+    void removeXmlChunks(const TextModelItem* _item);
+
+    /**
+     * @brief Получить закешированный xml заданного элемента
+     */
+    const QByteArray& xmlChunk(const TextModelItem* _item) const;
+
+    /**
+     * @brief Считать элементы верхнего уровня из заданного xml
+     */
+    QVector<TextModelItem*> readItems(const QString& _xml) const;
+
+    /**
+     * @brief Применить запомненное структурное изменение, соответствующее заданному патчу
+     * @return Положение курсора после изменения, или пустое значение, если изменение не найдено,
+     *         либо не может быть применено к текущему состоянию модели
+     */
+    std::optional<ChangeCursor> applyStructuralChange(const QByteArray& _patch);
+
+    /**
+     * @brief Привести заданный диапазон детей элемента к заданному списку элементов
+     * @note Совпадающие элементы остаются нетронутыми, элементы того же типа обновляются на месте,
+     *       а остальные удаляются и вставляются элементы из списка
+     */
+    void reconcileItems(TextModelItem* _parentItem, int _fromRow, int _count,
+                        const QVector<TextModelItem*>& _targetItems, ChangeCursor& _cursor);
+
     /**
      * @brief Обновить значение хеша документа, если оно не задано
      */
@@ -89,6 +176,95 @@ public:
      * @brief MD5-хэш текущего состояния контента
      */
     mutable QByteArray contentHash;
+
+    /**
+     * @brief Закешированный xml элементов, составляющих фрагменты целиком, по их идентификаторам
+     * @note Адреса удалённых элементов переиспользуются для новых, поэтому кеш привязан к
+     *       идентификаторам, которые не повторяются
+     */
+    struct XmlChunk {
+        QByteArray xml;
+        int plainLength = 0;
+    };
+    mutable QHash<quint64, XmlChunk> xmlChunks;
+
+    /**
+     * @brief Идентификаторы элементов, изменённых с момента формирования их xml
+     * @note Пометка снимается только при формировании xml самого элемента, т.к. элемент, вложенный
+     *       в сохраняемую целиком папку, может позже снова стать отдельным фрагментом
+     */
+    mutable QSet<quint64> xmlChangedItems;
+
+    /**
+     * @brief Последнее сформированное содержимое документа, его фрагменты и признаки того, что
+     *        фрагмент составляет элемент целиком
+     */
+    mutable QByteArray savedContent;
+    mutable QVector<QByteArray> savedChunks;
+    mutable QVector<bool> savedItemChunks;
+
+    /**
+     * @brief Структурное изменение элементов, идущих подряд у одного родителя
+     */
+    struct StructuralChange {
+        /**
+         * @brief Количество неизменённых фрагментов до и после изменённого диапазона
+         */
+        int headSize = 0;
+        int tailSize = 0;
+
+        /**
+         * @brief Xml элементов изменённого диапазона до и после изменения
+         */
+        QVector<QByteArray> fromChunks;
+        QVector<QByteArray> toChunks;
+
+        /**
+         * @brief Порядковый номер запоминания изменения
+         * @note Один и тот же патч может быть запомнен повторно, поэтому при вытеснении старых
+         *       записей удаляется только та, что была запомнена под вытесняемым номером
+         */
+        quint64 generation = 0;
+    };
+
+    /**
+     * @brief Изменение, определённое при последнем формировании xml
+     */
+    mutable std::optional<StructuralChange> lastStructuralChange;
+
+    /**
+     * @brief Изменения сохранённые в текущей сессии, для быстрой отмены и повтора, по их патчам
+     */
+    QHash<QByteArray, StructuralChange> structuralChanges;
+
+    /**
+     * @brief Запомненные патчи в порядке запоминания
+     */
+    struct StructuralChangePatch {
+        QByteArray patch;
+        quint64 generation = 0;
+
+        /**
+         * @brief Объём данных, занимаемый записью
+         * @note Фрагменты отмены и повтора разделяют одни и те же данные, поэтому их объём
+         *       учитывается только у записи повтора
+         */
+        qint64 size = 0;
+    };
+    QQueue<StructuralChangePatch> structuralChangesPatches;
+    quint64 structuralChangesGeneration = 0;
+
+    /**
+     * @brief Суммарный объём данных запомненных изменений
+     */
+    qint64 structuralChangesSize = 0;
+
+    /**
+     * @brief Плоский снимок модели
+     * @note Данные элементов обновляются на месте, а после изменения структуры снимок строится
+     *       заново при следующем запросе
+     */
+    mutable std::optional<TextModelSnapshot> snapshot;
 };
 
 TextModel::Implementation::Implementation(TextModel* _q, TextModelFolderItem* _rootItem)
@@ -152,6 +328,500 @@ QByteArray TextModel::Implementation::toXml(Domain::DocumentObject* _document) c
     return xmlData;
 }
 
+AbstractModel::XmlChange TextModel::Implementation::xmlChange(
+    Domain::DocumentObject* _document) const
+{
+    if (_document == nullptr) {
+        return {};
+    }
+
+    //
+    // Собираем xml модели, формируя заново только xml изменённых фрагментов
+    //
+    const QByteArray header = "<?xml version=\"1.0\"?>\n<document mime-type=\""
+        + Domain::mimeTypeFor(_document->type()) + "\" version=\"1.0\">\n";
+    const QByteArray footer = "</document>";
+    QVector<XmlChunkPlace> places;
+    collectXmlChunkPlaces(rootItem, places);
+    QVector<QByteArray> chunks;
+    chunks.reserve(places.size());
+    QVector<int> chunksPlainLengths;
+    chunksPlainLengths.reserve(places.size());
+    QVector<bool> itemChunks;
+    itemChunks.reserve(places.size());
+    int contentSize = header.size() + footer.size();
+    for (const auto& place : std::as_const(places)) {
+        int plainLength = 0;
+        chunks.append(xmlChunk(place, plainLength));
+        chunksPlainLengths.append(plainLength);
+        itemChunks.append(place.kind == XmlChunkPlace::Kind::Item);
+        contentSize += chunks.constLast().size();
+    }
+
+    QByteArray content;
+    content.reserve(contentSize);
+    content += header;
+    for (const auto& chunk : std::as_const(chunks)) {
+        content += chunk;
+    }
+    content += footer;
+
+#ifdef XML_CHECKS
+    Q_ASSERT(content == toXml(_document));
+#endif
+
+    //
+    // Обновляем хэш, если он был сброшен
+    //
+    updateContentHash(content);
+
+    XmlChange change;
+    change.content = content;
+
+    //
+    // Если в документе хранится последнее сформированное моделью содержимое, то определяем
+    // изменённый диапазон фрагментов, в противном случае будет сравниваться документ целиком
+    //
+    const auto& documentContent = _document->content();
+    if (!savedContent.isNull() && savedContent.constData() == documentContent.constData()
+        && savedContent.size() == documentContent.size()) {
+        //
+        // Неизменённые элементы используют закешированный xml, поэтому в большинстве случаев
+        // достаточно сравнить указатели на данные
+        //
+        auto isSameChunk = [](const QByteArray& _lhs, const QByteArray& _rhs) {
+            return (_lhs.constData() == _rhs.constData() && _lhs.size() == _rhs.size())
+                || _lhs == _rhs;
+        };
+        const int maximumSameChunks = std::min(savedChunks.size(), chunks.size());
+        int headSize = 0;
+        while (headSize < maximumSameChunks
+               && isSameChunk(savedChunks.at(headSize), chunks.at(headSize))) {
+            ++headSize;
+        }
+        int tailSize = 0;
+        while (tailSize < maximumSameChunks - headSize
+               && isSameChunk(savedChunks.at(savedChunks.size() - tailSize - 1),
+                              chunks.at(chunks.size() - tailSize - 1))) {
+            ++tailSize;
+        }
+
+        //
+        // Изменение можно будет применять напрямую к элементам, только если по обе его стороны
+        // изменённые фрагменты составляют элементы целиком, т.е. это дети одного родителя
+        //
+        const auto isItemsRange = [headSize, tailSize](const QVector<bool>& _itemChunks) {
+            for (int index = headSize; index < _itemChunks.size() - tailSize; ++index) {
+                if (!_itemChunks.at(index)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        if (isItemsRange(savedItemChunks) && isItemsRange(itemChunks)) {
+            lastStructuralChange = StructuralChange{
+                headSize,
+                tailSize,
+                savedChunks.mid(headSize, savedChunks.size() - headSize - tailSize),
+                chunks.mid(headSize, chunks.size() - headSize - tailSize),
+            };
+        } else {
+            lastStructuralChange.reset();
+        }
+
+        //
+        // Захватываем по одному соседнему фрагменту, чтобы в патчах был контекст для наложения
+        //
+        headSize = std::max(0, headSize - 1);
+        tailSize = std::max(0, tailSize - 1);
+
+        int fragmentPosition = header.size();
+        int patchPosition = q->dmpController().plainLength(header);
+        for (int index = 0; index < headSize; ++index) {
+            fragmentPosition += chunks.at(index).size();
+            patchPosition += chunksPlainLengths.at(index);
+        }
+        int oldFragmentSize = 0;
+        for (int index = headSize; index < savedChunks.size() - tailSize; ++index) {
+            oldFragmentSize += savedChunks.at(index).size();
+        }
+        int newFragmentSize = 0;
+        for (int index = headSize; index < chunks.size() - tailSize; ++index) {
+            newFragmentSize += chunks.at(index).size();
+        }
+        change.oldFragment = savedContent.mid(fragmentPosition, oldFragmentSize);
+        change.newFragment = content.mid(fragmentPosition, newFragmentSize);
+        change.patchPosition = patchPosition;
+    } else {
+        lastStructuralChange.reset();
+    }
+
+    savedContent = content;
+    savedChunks.swap(chunks);
+    savedItemChunks.swap(itemChunks);
+
+    return change;
+}
+
+void TextModel::Implementation::collectXmlChunkPlaces(const TextModelItem* _parentItem,
+                                                      QVector<XmlChunkPlace>& _places) const
+{
+    for (int childIndex = 0; childIndex < _parentItem->childCount(); ++childIndex) {
+        const auto child = _parentItem->childAt(childIndex);
+        if (child->type() == TextModelItemType::Folder && canSplitFolderXml(child)) {
+            _places.append({ child, XmlChunkPlace::Kind::FolderHeader });
+            collectXmlChunkPlaces(child, _places);
+            _places.append({ child, XmlChunkPlace::Kind::FolderFooter });
+        } else {
+            _places.append({ child, XmlChunkPlace::Kind::Item });
+        }
+    }
+}
+
+bool TextModel::Implementation::canSplitFolderXml(const TextModelItem* _folderItem) const
+{
+    for (int childIndex = 0; childIndex < _folderItem->childCount(); ++childIndex) {
+        const auto child = _folderItem->childAt(childIndex);
+        if (child->type() != TextModelItemType::Text) {
+            continue;
+        }
+
+        const auto textItem = static_cast<const TextModelTextItem*>(child);
+        if (textItem->isCorrection() || textItem->isBreakCorrectionStart()
+            || textItem->isBreakCorrectionEnd()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QByteArray TextModel::Implementation::xmlChunk(const XmlChunkPlace& _place,
+                                               int& _plainLength) const
+{
+    switch (_place.kind) {
+    case XmlChunkPlace::Kind::Item: {
+        const auto& chunk = xmlChunk(_place.item);
+        _plainLength = xmlChunks.value(_place.item->id()).plainLength;
+        return chunk;
+    }
+
+    case XmlChunkPlace::Kind::FolderHeader: {
+        const auto chunk = static_cast<const TextModelFolderItem*>(_place.item)->xmlHeader();
+        _plainLength = q->dmpController().plainLength(chunk);
+        return chunk;
+    }
+
+    case XmlChunkPlace::Kind::FolderFooter: {
+        const auto folderItem = static_cast<const TextModelFolderItem*>(_place.item);
+        const auto chunk = QString("</%1>\n</%2>\n")
+                               .arg(xml::kContentTag, toString(folderItem->folderType()))
+                               .toUtf8();
+        _plainLength = q->dmpController().plainLength(chunk);
+        return chunk;
+    }
+    }
+
+    Q_ASSERT(false);
+    return {};
+}
+
+void TextModel::Implementation::markXmlChanged(TextModelItem* _item)
+{
+    for (auto item = _item; item != nullptr && item != rootItem; item = item->parent()) {
+        xmlChangedItems.insert(item->id());
+    }
+}
+
+void TextModel::Implementation::removeXmlChunks(TextModelItem* _parentItem, int _fromRow,
+                                                int _toRow)
+{
+    markXmlChanged(_parentItem);
+
+    for (int row = _fromRow; row <= _toRow; ++row) {
+        removeXmlChunks(_parentItem->childAt(row));
+    }
+}
+
+void TextModel::Implementation::removeXmlChunks(const TextModelItem* _item)
+{
+    xmlChunks.remove(_item->id());
+    xmlChangedItems.remove(_item->id());
+
+    //
+    // ... отдельными фрагментами могут быть только дети папок
+    //
+    if (_item->type() != TextModelItemType::Folder) {
+        return;
+    }
+    for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+        removeXmlChunks(_item->childAt(childIndex));
+    }
+}
+
+const QByteArray& TextModel::Implementation::xmlChunk(const TextModelItem* _item) const
+{
+    const auto itemId = _item->id();
+    auto chunkIter = xmlChunks.find(itemId);
+    if (chunkIter == xmlChunks.end() || xmlChangedItems.contains(itemId)) {
+        const auto xml = _item->toXml();
+        chunkIter = xmlChunks.insert(itemId, { xml, q->dmpController().plainLength(xml) });
+        xmlChangedItems.remove(itemId);
+    }
+    return chunkIter->xml;
+}
+
+QVector<TextModelItem*> TextModel::Implementation::readItems(const QString& _xml) const
+{
+    QXmlStreamReader reader(_xml);
+    xml::readNextElement(reader); // document
+    xml::readNextElement(reader);
+
+    //
+    // Если попался пустой документ
+    //
+    if (reader.name() == xml::kDocumentTag) {
+        return {};
+    }
+
+    QVector<TextModelItem*> items;
+    while (!reader.atEnd()) {
+        const auto currentTag = reader.name().toString();
+        TextModelItem* item = nullptr;
+        if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
+            item = q->createFolderItem(reader);
+        } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
+            item = q->createGroupItem(reader);
+        } else if (currentTag == xml::kSplitterTag) {
+            item = q->createSplitterItem(reader);
+        } else {
+            item = q->createTextItem(reader);
+        }
+        items.append(item);
+
+        //
+        // Считываем контент до конца
+        //
+        if (reader.name() == xml::kDocumentTag) {
+            reader.readNext();
+        }
+    }
+
+    return items;
+}
+
+std::optional<ChangeCursor> TextModel::Implementation::applyStructuralChange(
+    const QByteArray& _patch)
+{
+    const auto changeIter = structuralChanges.constFind(_patch);
+    if (changeIter == structuralChanges.constEnd()) {
+        return {};
+    }
+
+    //
+    // Убедимся, что модель находится в том же состоянии, в котором было сделано изменение
+    //
+    const auto change = changeIter.value();
+    QVector<XmlChunkPlace> places;
+    collectXmlChunkPlaces(rootItem, places);
+    if (places.size() != change.headSize + change.fromChunks.size() + change.tailSize) {
+        return {};
+    }
+    //
+    // ... и что в изменяемом диапазоне нет декораций разрывов страниц, т.к. они не сохраняются
+    //     в xml и склеиваются с соседними элементами, то такие изменения накладываем через патч
+    //
+    std::function<bool(const TextModelItem*)> hasCorrections;
+    hasCorrections = [&hasCorrections](const TextModelItem* _item) {
+        if (_item->type() == TextModelItemType::Text) {
+            const auto textItem = static_cast<const TextModelTextItem*>(_item);
+            return textItem->isCorrection() || textItem->isBreakCorrectionStart()
+                || textItem->isBreakCorrectionEnd();
+        }
+
+        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
+            if (hasCorrections(_item->childAt(childIndex))) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (int index = 0; index < change.fromChunks.size(); ++index) {
+        const auto& place = places.at(change.headSize + index);
+        if (place.kind != XmlChunkPlace::Kind::Item
+            || xmlChunk(place.item) != change.fromChunks.at(index) || hasCorrections(place.item)) {
+            return {};
+        }
+    }
+
+    //
+    // Определяем родителя и строку, с которой начинается изменённый диапазон
+    //
+    TextModelItem* parentItem = rootItem;
+    int fromRow = 0;
+    if (!change.fromChunks.isEmpty()) {
+        const auto item = const_cast<TextModelItem*>(places.at(change.headSize).item);
+        parentItem = item->parent();
+        fromRow = parentItem->rowOfChild(item);
+    }
+    //
+    // ... если элементы только добавлялись, то ориентируемся на фрагмент перед ними
+    //
+    else if (change.headSize > 0) {
+        const auto& place = places.at(change.headSize - 1);
+        const auto item = const_cast<TextModelItem*>(place.item);
+        if (place.kind == XmlChunkPlace::Kind::FolderHeader) {
+            parentItem = item;
+            fromRow = 0;
+        } else {
+            parentItem = item->parent();
+            fromRow = parentItem->rowOfChild(item) + 1;
+        }
+    }
+
+    //
+    // Считываем элементы, к которым нужно привести изменённый диапазон
+    //
+    QByteArray xml = "<?xml version=\"1.0\"?>\n<document>\n";
+    for (const auto& chunk : change.toChunks) {
+        xml += chunk;
+    }
+    xml += "</document>";
+    const auto targetItems = readItems(xml);
+
+    //
+    // Применяем изменения напрямую к элементам модели
+    //
+    ChangeCursor cursor;
+    q->beginChangeRows();
+    reconcileItems(parentItem, fromRow, change.fromChunks.size(), targetItems, cursor);
+    q->endChangeRows();
+
+    //
+    // Удаляем элементы, которые не были перенесены в модель
+    //
+    for (auto item : targetItems) {
+        if (!item->hasParent()) {
+            delete item;
+        }
+    }
+
+#ifdef XML_CHECKS
+    for (int index = 0; index < change.toChunks.size(); ++index) {
+        Q_ASSERT(xmlChunk(parentItem->childAt(fromRow + index)) == change.toChunks.at(index));
+    }
+#endif
+
+    return cursor;
+}
+
+void TextModel::Implementation::reconcileItems(TextModelItem* _parentItem, int _fromRow, int _count,
+                                               const QVector<TextModelItem*>& _targetItems,
+                                               ChangeCursor& _cursor)
+{
+    //
+    // Пропускаем совпадающие элементы в начале и в конце диапазона
+    //
+    auto isSameItem = [](TextModelItem* _lhs, TextModelItem* _rhs) {
+        return _lhs->type() == _rhs->type() && _lhs->subtype() == _rhs->subtype()
+            && _lhs->toXml() == _rhs->toXml();
+    };
+    const int targetsCount = _targetItems.size();
+    int headSize = 0;
+    while (headSize < _count && headSize < targetsCount
+           && isSameItem(_parentItem->childAt(_fromRow + headSize), _targetItems.at(headSize))) {
+        ++headSize;
+    }
+    int tailSize = 0;
+    while (tailSize < _count - headSize && tailSize < targetsCount - headSize
+           && isSameItem(_parentItem->childAt(_fromRow + _count - tailSize - 1),
+                         _targetItems.at(targetsCount - tailSize - 1))) {
+        ++tailSize;
+    }
+    const int changedRow = _fromRow + headSize;
+    const int changedCount = _count - headSize - tailSize;
+    const auto changedTargetItems = _targetItems.mid(headSize, targetsCount - headSize - tailSize);
+    if (changedCount == 0 && changedTargetItems.isEmpty()) {
+        return;
+    }
+
+    //
+    // Если элементы соответствуют друг другу по типам, то обновляем их на месте
+    //
+    bool canUpdateInPlace = changedCount == changedTargetItems.size();
+    for (int index = 0; canUpdateInPlace && index < changedCount; ++index) {
+        const auto item = _parentItem->childAt(changedRow + index);
+        const auto targetItem = changedTargetItems.at(index);
+        canUpdateInPlace
+            = item->type() == targetItem->type() && item->subtype() == targetItem->subtype();
+    }
+    if (canUpdateInPlace) {
+        for (int index = 0; index < changedCount; ++index) {
+            const auto item = _parentItem->childAt(changedRow + index);
+            const auto targetItem = changedTargetItems.at(index);
+            switch (item->type()) {
+            case TextModelItemType::Text: {
+                const auto textItem = static_cast<TextModelTextItem*>(item);
+                const auto targetTextItem = static_cast<TextModelTextItem*>(targetItem);
+                const auto position = q->dmpController().changeEndPosition(
+                    textItem->text(), targetTextItem->text());
+                textItem->copyFrom(targetTextItem);
+                q->updateItem(textItem);
+                _cursor = { textItem, position };
+                break;
+            }
+
+            case TextModelItemType::Splitter: {
+                item->copyFrom(targetItem);
+                item->setChanged(true);
+                q->updateItem(item);
+                break;
+            }
+
+            case TextModelItemType::Folder:
+            case TextModelItemType::Group: {
+                if (!item->isEqual(targetItem)) {
+                    item->copyFrom(targetItem);
+                    item->setChanged(true);
+                    q->updateItem(item);
+                    _cursor = { item, -1 };
+                }
+
+                QVector<TextModelItem*> targetChildren;
+                for (int childIndex = 0; childIndex < targetItem->childCount(); ++childIndex) {
+                    targetChildren.append(targetItem->childAt(childIndex));
+                }
+                reconcileItems(item, 0, item->childCount(), targetChildren, _cursor);
+                break;
+            }
+            }
+        }
+        return;
+    }
+
+    //
+    // В противном случае заменяем изменённые элементы целиком
+    //
+    QVector<TextModelItem*> itemsToInsert;
+    for (auto targetItem : changedTargetItems) {
+        if (targetItem->hasParent()) {
+            targetItem->parent()->takeItem(targetItem);
+        }
+        itemsToInsert.append(targetItem);
+    }
+    if (changedCount > 0) {
+        q->removeItems(_parentItem->childAt(changedRow),
+                       _parentItem->childAt(changedRow + changedCount - 1));
+    }
+    if (!itemsToInsert.isEmpty()) {
+        if (changedRow == 0) {
+            q->prependItems(itemsToInsert, _parentItem);
+        } else {
+            q->insertItems(itemsToInsert, _parentItem->childAt(changedRow - 1));
+        }
+        _cursor = { itemsToInsert.constLast(), -1 };
+    }
+}
+
 void TextModel::Implementation::updateContentHash(const QByteArray& _xml) const
 {
     if (!contentHash.isEmpty()) {
@@ -227,6 +897,28 @@ TextModel::TextModel(QObject* _parent, TextModelFolderItem* _rootItem)
         _parent)
     , d(new Implementation(this, _rootItem))
 {
+    auto resetSnapshot = [this] { d->snapshot.reset(); };
+    connect(this, &TextModel::rowsInserted, this, resetSnapshot);
+    connect(this, &TextModel::rowsRemoved, this, resetSnapshot);
+    connect(this, &TextModel::rowsMoved, this, resetSnapshot);
+    connect(this, &TextModel::modelReset, this, resetSnapshot);
+    connect(this, &TextModel::dataChanged, this,
+            [this](const QModelIndex& _topLeft, const QModelIndex& _bottomRight) {
+                //
+                // Корневой элемент в снимок не входит
+                //
+                if (!d->snapshot.has_value() || !_topLeft.isValid()) {
+                    return;
+                }
+
+                for (int row = _topLeft.row(); row <= _bottomRight.row(); ++row) {
+                    const auto item = itemForIndex(index(row, 0, _topLeft.parent()));
+                    if (!d->snapshot->update(this, item)) {
+                        d->snapshot.reset();
+                        return;
+                    }
+                }
+            });
 }
 
 TextModel::~TextModel() = default;
@@ -287,6 +979,9 @@ void TextModel::appendItems(const QVector<TextModelItem*>& _items, TextModelItem
     beginInsertRows(parentIndex, fromItemRow, toItemRow);
     _parentItem->appendItems({ _items.begin(), _items.end() });
     endInsertRows();
+    for (auto item : _items) {
+        d->markXmlChanged(item);
+    }
     emit afterRowsInserted(parentIndex, fromItemRow, toItemRow);
 
     updateItem(_parentItem);
@@ -313,6 +1008,9 @@ void TextModel::prependItems(const QVector<TextModelItem*>& _items, TextModelIte
     beginInsertRows(parentIndex, 0, _items.size() - 1);
     _parentItem->prependItems({ _items.begin(), _items.end() });
     endInsertRows();
+    for (auto item : _items) {
+        d->markXmlChanged(item);
+    }
     emit afterRowsInserted(parentIndex, 0, _items.size() - 1);
 
     updateItem(_parentItem);
@@ -342,6 +1040,9 @@ void TextModel::insertItems(const QVector<TextModelItem*>& _items, TextModelItem
     beginInsertRows(parentIndex, fromItemRow, toItemRow);
     parentItem->insertItems(fromItemRow, { _items.begin(), _items.end() });
     endInsertRows();
+    for (auto item : _items) {
+        d->markXmlChanged(item);
+    }
     emit afterRowsInserted(parentIndex, fromItemRow, toItemRow);
 
     updateItem(parentItem);
@@ -373,6 +1074,7 @@ void TextModel::takeItems(TextModelItem* _fromItem, TextModelItem* _toItem,
     const int fromItemRow = _parentItem->rowOfChild(_fromItem);
     const int toItemRow = _parentItem->rowOfChild(_toItem);
     Q_ASSERT(fromItemRow <= toItemRow);
+    d->removeXmlChunks(_parentItem, fromItemRow, toItemRow);
     beginRemoveRows(parentIndex, fromItemRow, toItemRow);
     _parentItem->takeItems(fromItemRow, toItemRow);
     endRemoveRows();
@@ -400,6 +1102,7 @@ void TextModel::removeItems(TextModelItem* _fromItem, TextModelItem* _toItem)
     const int fromItemRow = parentItem->rowOfChild(_fromItem);
     const int toItemRow = parentItem->rowOfChild(_toItem);
     Q_ASSERT(fromItemRow <= toItemRow);
+    d->removeXmlChunks(parentItem, fromItemRow, toItemRow);
     beginRemoveRows(parentIndex, fromItemRow, toItemRow);
     parentItem->removeItems(fromItemRow, toItemRow);
     endRemoveRows();
@@ -485,6 +1188,8 @@ void TextModel::updateItemForRoles(TextModelItem* _item, const QVector<int>& _ro
         return;
     }
 
+    d->markXmlChanged(_item);
+
     d->contentHash.clear();
 
     const QModelIndex indexForUpdate = indexForItem(_item);
@@ -1772,6 +2477,20 @@ QModelIndex TextModel::indexForItem(TextModelItem* _item) const
     return index(row, 0, parent);
 }
 
+TextModelSnapshot TextModel::snapshot() const
+{
+    if (!d->snapshot.has_value()) {
+        d->snapshot = TextModelSnapshot::build(this);
+    }
+    return *d->snapshot;
+}
+
+std::chrono::milliseconds TextModel::itemDuration(const TextModelItem* _item) const
+{
+    Q_UNUSED(_item)
+    return {};
+}
+
 void TextModel::setTitlePageModel(SimpleTextModel* _model)
 {
     d->titlePageModel = _model;
@@ -1825,6 +2544,16 @@ void TextModel::initDocument()
 
 void TextModel::clearDocument()
 {
+    d->xmlChunks.clear();
+    d->xmlChangedItems.clear();
+    d->savedContent.clear();
+    d->savedChunks.clear();
+    d->savedItemChunks.clear();
+    d->lastStructuralChange.reset();
+    d->structuralChanges.clear();
+    d->structuralChangesPatches.clear();
+    d->structuralChangesSize = 0;
+
     if (!d->rootItem->hasChildren()) {
         return;
     }
@@ -1850,10 +2579,74 @@ QByteArray TextModel::toXml() const
     return d->toXml(document());
 }
 
+AbstractModel::XmlChange TextModel::xmlChange() const
+{
+    return d->xmlChange(document());
+}
+
+void TextModel::handleChangeSaved(const QByteArray& _undoPatch, const QByteArray& _redoPatch)
+{
+    if (!d->lastStructuralChange.has_value()) {
+        return;
+    }
+
+    auto change = *d->lastStructuralChange;
+    d->lastStructuralChange.reset();
+
+    //
+    // Фрагменты составляют элементы целиком, так что чаще всего это xml нескольких сцен
+    //
+    qint64 chunksSize = 0;
+    for (const auto& chunk : std::as_const(change.fromChunks)) {
+        chunksSize += chunk.size();
+    }
+    for (const auto& chunk : std::as_const(change.toChunks)) {
+        chunksSize += chunk.size();
+    }
+    const qint64 redoSize = chunksSize + _redoPatch.size();
+    const qint64 undoSize = _undoPatch.size();
+    //
+    // ... а слишком большие изменения не запоминаем вовсе, их дешевле применить через патч,
+    //     чем вытеснять ради них всю историю
+    //
+    const qint64 maximumChangesSize = 8 * 1024 * 1024;
+    if (redoSize + undoSize > maximumChangesSize / 4) {
+        return;
+    }
+
+    //
+    // Запоминаем изменение в обе стороны, ограничивая суммарный объём запомненных изменений
+    //
+    change.generation = ++d->structuralChangesGeneration;
+    d->structuralChanges.insert(_redoPatch, change);
+    d->structuralChanges.insert(_undoPatch,
+                                { change.headSize, change.tailSize, change.toChunks,
+                                  change.fromChunks, change.generation });
+    d->structuralChangesPatches.enqueue({ _redoPatch, change.generation, redoSize });
+    d->structuralChangesPatches.enqueue({ _undoPatch, change.generation, undoSize });
+    d->structuralChangesSize += redoSize + undoSize;
+    while (d->structuralChangesSize > maximumChangesSize) {
+        const auto patch = d->structuralChangesPatches.dequeue();
+        d->structuralChangesSize -= patch.size;
+        const auto changeIter = d->structuralChanges.find(patch.patch);
+        if (changeIter != d->structuralChanges.end()
+            && changeIter->generation == patch.generation) {
+            d->structuralChanges.erase(changeIter);
+        }
+    }
+}
+
 ChangeCursor TextModel::applyPatch(const QByteArray& _patch)
 {
     Q_ASSERT(document());
 
+    //
+    // Если изменение было сделано в текущей сессии, то применяем его напрямую к элементам модели
+    //
+    if (const auto cursor = d->applyStructuralChange(_patch); cursor.has_value()) {
+        return *cursor;
+    }
+
 #ifdef XML_CHECKS
     const auto newContent = dmpController().applyPatch(toXml(), _patch);
     qDebug(QString("Before applying patch xml is\n\n%1\n\n").arg(toXml().constData()).toUtf8());
@@ -1886,45 +2679,8 @@ ChangeCursor TextModel::applyPatch(const QByteArray& _patch)
     //
     // Считываем элементы из обоих изменений для дальнейшего определения необходимых изменений
     //
-    auto readItems = [this](const QString& _xml) -> QVector<TextModelItem*> {
-        QXmlStreamReader _reader(_xml);
-        xml::readNextElement(_reader); // document
-        xml::readNextElement(_reader);
-
-        //
-        // Если попался пустой документ
-        //
-        if (_reader.name() == xml::kDocumentTag) {
-            return {};
-        }
-
-        QVector<TextModelItem*> items;
-        while (!_reader.atEnd()) {
-            const auto currentTag = _reader.name().toString();
-            TextModelItem* item = nullptr;
-            if (textFolderTypeFromString(currentTag) != TextFolderType::Undefined) {
-                item = createFolderItem(_reader);
-            } else if (textGroupTypeFromString(currentTag) != TextGroupType::Undefined) {
-                item = createGroupItem(_reader);
-            } else if (currentTag == xml::kSplitterTag) {
-                item = createSplitterItem(_reader);
-            } else {
-                item = createTextItem(_reader);
-            }
-            items.append(item);
-
-            //
-            // Считываем контент до конца
-            //
-            if (_reader.name() == xml::kDocumentTag) {
-                _reader.readNext();
-            }
-        }
-
-        return items;
-    };
-    const auto oldItems = readItems(changes.first.xml);
-    const auto newItems = readItems(changes.second.xml);
+    const auto oldItems = d->readItems(changes.first.xml);
+    const auto newItems = d->readItems(changes.second.xml);
 
     //
     // Раскладываем элементы в плоские списки для сравнения
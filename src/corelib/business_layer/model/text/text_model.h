@@ -2,6 +2,8 @@
 
 #include <business_layer/model/abstract_model.h>
 
+#include <chrono>
+
 class QXmlStreamReader;
 
 
@@ -14,6 +16,7 @@ class TextModelItem;
 class TextModelGroupItem;
 class TextModelFolderItem;
 class TextModelSplitterItem;
+class TextModelSnapshot;
 class TextModelTextItem;
 
 /**
@@ -126,6 +129,17 @@ public:
      */
     QModelIndex indexForItem(TextModelItem* _item) const;
 
+    /**
+     * @brief Плоский снимок текущего состояния модели
+     * @note Снимок запрашивается в потоке модели, а читать его можно из любого потока
+     */
+    TextModelSnapshot snapshot() const;
+
+    /**
+     * @brief Хронометраж заданного элемента, если модель его считает
+     */
+    virtual std::chrono::milliseconds itemDuration(const TextModelItem* _item) const;
+
     /**
      * @brief Задать модель титульной страницы
      */
@@ -151,6 +165,8 @@ protected:
     void initDocument() override;
     void clearDocument() override;
     QByteArray toXml() const override;
+    XmlChange xmlChange() const override;
+    void handleChangeSaved(const QByteArray& _undoPatch, const QByteArray& _redoPatch) override;
     ChangeCursor applyPatch(const QByteArray& _patch) override;
     /** @} */
 
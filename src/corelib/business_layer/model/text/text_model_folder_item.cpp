@@ -17,7 +17,7 @@
 
 namespace BusinessLayer {
 
-class TextModelFolderItem::Implementation
+class TextModelFolderItem::Implementation : public PoolAllocated
 {
 public:
     /**
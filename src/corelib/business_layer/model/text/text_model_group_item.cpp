@@ -18,7 +18,7 @@
 
 namespace BusinessLayer {
 
-class TextModelGroupItem::Implementation
+class TextModelGroupItem::Implementation : public PoolAllocated
 {
 public:
     /**
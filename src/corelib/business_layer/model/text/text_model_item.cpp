@@ -3,14 +3,17 @@
 #include <QVariant>
 #include <QXmlStreamReader>
 
+#include <atomic>
+
 
 namespace BusinessLayer {
 
-class TextModelItem::Implementation
+class TextModelItem::Implementation : public PoolAllocated
 {
 public:
     Implementation(TextModelItemType _type, const TextModel* _model);
 
+    const quint64 id;
     const TextModelItemType type;
     QString icon;
     const TextModel* model = nullptr;
@@ -31,7 +34,11 @@ public:
 };
 
 TextModelItem::Implementation::Implementation(TextModelItemType _type, const TextModel* _model)
-    : type(_type)
+    : id([] {
+        static std::atomic<quint64> lastId{ 0 };
+        return ++lastId;
+    }())
+    , type(_type)
     , model(_model)
 {
 }
@@ -48,6 +55,11 @@ TextModelItem::TextModelItem(TextModelItemType _type, const TextModel* _model)
 
 TextModelItem::~TextModelItem() = default;
 
+quint64 TextModelItem::id() const
+{
+    return d->id;
+}
+
 const TextModelItemType& TextModelItem::type() const
 {
     return d->type;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <business_layer/model/abstract_model_item.h>
+#include <utils/tools/memory_pool.h>
 
 #include <QtContainerFwd>
 
@@ -41,13 +42,21 @@ enum class CORE_LIBRARY_EXPORT TextModelItemType {
 
 /**
  * @brief Базовый класс элемента модели текста
+ * @note Элементы создаются и удаляются десятками тысяч при загрузке и изменении документа,
+ *       поэтому память под них выделяется в пуле
  */
-class CORE_LIBRARY_EXPORT TextModelItem : public AbstractModelItem
+class CORE_LIBRARY_EXPORT TextModelItem : public AbstractModelItem, public PoolAllocated
 {
 public:
     TextModelItem(TextModelItemType _type, const TextModel* _model);
     ~TextModelItem() override;
 
+    /**
+     * @brief Идентификатор элемента, уникальный в рамках сеанса работы приложения
+     * @note В отличие от адреса элемента, идентификатор не переиспользуется после удаления
+     */
+    quint64 id() const;
+
     /**
      * @brief Получить тип элемента
      */
@@ -0,0 +1,207 @@
+#include "text_model_snapshot.h"
+
+#include "text_model.h"
+#include "text_model_folder_item.h"
+#include "text_model_group_item.h"
+#include "text_model_text_item.h"
+
+#include <business_layer/templates/text_template.h>
+
+#include <QHash>
+#include <QVector>
+
+
+namespace BusinessLayer {
+
+struct TextModelSnapshot::Data {
+    /**
+     * @brief Добавить запись для заданного элемента
+     */
+    void append(const TextModel* _model, TextModelItem* _item, int _parent);
+
+    /**
+     * @brief Записать в снимок данные элемента
+     */
+    void fill(const TextModel* _model, const TextModelItem* _item, int _index);
+
+
+    QVector<TextModelItemType> types;
+    QVector<int> subtypes;
+    QVector<int> parents;
+    QVector<int> subtreeEnds;
+    QVector<QString> texts;
+    QVector<std::chrono::milliseconds> durations;
+    QVector<TextModelItem*> items;
+
+    /**
+     * @brief Индексы записей элементов, для обновления снимка на месте
+     */
+    QHash<const TextModelItem*, int> itemsIndexes;
+};
+
+void TextModelSnapshot::Data::append(const TextModel* _model, TextModelItem* _item, int _parent)
+{
+    const auto index = items.size();
+    types.append(_item->type());
+    subtypes.append(0);
+    parents.append(_parent);
+    subtreeEnds.append(index + 1);
+    texts.append({});
+    durations.append({});
+    items.append(_item);
+    itemsIndexes.insert(_item, index);
+    fill(_model, _item, index);
+}
+
+void TextModelSnapshot::Data::fill(const TextModel* _model, const TextModelItem* _item, int _index)
+{
+    subtypes[_index] = _item->subtype();
+    switch (_item->type()) {
+    case TextModelItemType::Folder: {
+        texts[_index] = static_cast<const TextModelFolderItem*>(_item)->heading();
+        break;
+    }
+
+    case TextModelItemType::Group: {
+        texts[_index] = static_cast<const TextModelGroupItem*>(_item)->heading();
+        break;
+    }
+
+    case TextModelItemType::Text: {
+        texts[_index] = static_cast<const TextModelTextItem*>(_item)->text();
+        break;
+    }
+
+    default: {
+        texts[_index].clear();
+        break;
+    }
+    }
+    durations[_index] = _model->itemDuration(_item);
+}
+
+
+// ****
+
+
+TextModelSnapshot::TextModelSnapshot()
+    : d(std::make_shared<Data>())
+{
+}
+
+TextModelSnapshot::~TextModelSnapshot() = default;
+
+int TextModelSnapshot::size() const
+{
+    return d->items.size();
+}
+
+TextModelItemType TextModelSnapshot::type(int _index) const
+{
+    return d->types.at(_index);
+}
+
+int TextModelSnapshot::subtype(int _index) const
+{
+    return d->subtypes.at(_index);
+}
+
+TextParagraphType TextModelSnapshot::paragraphType(int _index) const
+{
+    return d->types.at(_index) == TextModelItemType::Text
+        ? static_cast<TextParagraphType>(d->subtypes.at(_index))
+        : TextParagraphType::Undefined;
+}
+
+TextGroupType TextModelSnapshot::groupType(int _index) const
+{
+    return d->types.at(_index) == TextModelItemType::Group
+        ? static_cast<TextGroupType>(d->subtypes.at(_index))
+        : TextGroupType::Undefined;
+}
+
+int TextModelSnapshot::parent(int _index) const
+{
+    return d->parents.at(_index);
+}
+
+int TextModelSnapshot::subtreeEnd(int _index) const
+{
+    return d->subtreeEnds.at(_index);
+}
+
+const QString& TextModelSnapshot::text(int _index) const
+{
+    return d->texts.at(_index);
+}
+
+std::chrono::milliseconds TextModelSnapshot::duration(int _index) const
+{
+    return d->durations.at(_index);
+}
+
+TextModelItem* TextModelSnapshot::item(int _index) const
+{
+    return d->items.at(_index);
+}
+
+int TextModelSnapshot::indexOf(const TextModelItem* _item) const
+{
+    return d->itemsIndexes.value(_item, -1);
+}
+
+TextModelSnapshot TextModelSnapshot::build(const TextModel* _model)
+{
+    TextModelSnapshot snapshot;
+    auto& data = *snapshot.d;
+
+    //
+    // Обходим дерево в глубину без рекурсии, закрывая диапазоны потомков, когда поднимаемся
+    // обратно к родителю
+    //
+    struct Level {
+        TextModelItem* item = nullptr;
+        int index = -1;
+        int nextChild = 0;
+    };
+    QVector<Level> levels = { { _model->itemForIndex({}), -1, 0 } };
+    while (!levels.isEmpty()) {
+        auto& level = levels.last();
+        if (level.nextChild == level.item->childCount()) {
+            if (level.index != -1) {
+                data.subtreeEnds[level.index] = data.items.size();
+            }
+            levels.removeLast();
+            continue;
+        }
+
+        auto child = level.item->childAt(level.nextChild++);
+        const auto parentIndex = level.index;
+        data.append(_model, child, parentIndex);
+        if (child->hasChildren()) {
+            levels.append({ child, data.items.size() - 1, 0 });
+        }
+    }
+
+    return snapshot;
+}
+
+bool TextModelSnapshot::update(const TextModel* _model, const TextModelItem* _item)
+{
+    const auto index = d->itemsIndexes.value(_item, -1);
+    if (index == -1 || d->types.at(index) != _item->type()) {
+        return false;
+    }
+
+    //
+    // Данные могут читаться из других потоков, поэтому на месте меняем их, только если снимком
+    // больше никто не пользуется
+    //
+    if (d.use_count() > 1) {
+        d = std::make_shared<Data>(*d);
+    }
+    d->fill(_model, _item, index);
+    return true;
+}
+
+} // namespace BusinessLayer
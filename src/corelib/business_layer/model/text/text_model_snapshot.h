@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QString>
+
+#include <corelib_global.h>
+
+#include <chrono>
+#include <memory>
+
+
+namespace BusinessLayer {
+
+enum class TextGroupType;
+enum class TextModelItemType;
+enum class TextParagraphType;
+class TextModel;
+class TextModelItem;
+
+/**
+ * @brief Плоский снимок дерева текстовой модели для аналитических проходов
+ * @note Элементы лежат в параллельных массивах в порядке обхода дерева в глубину, поэтому проходы
+ *       по всему тексту, по сцене или по папке становятся линейными. Снимок неизменяем, его можно
+ *       передать в фоновый поток и читать оттуда, пока модель продолжает меняться
+ */
+class CORE_LIBRARY_EXPORT TextModelSnapshot
+{
+public:
+    TextModelSnapshot();
+    ~TextModelSnapshot();
+
+    /**
+     * @brief Количество элементов в снимке
+     */
+    int size() const;
+
+    /**
+     * @brief Тип элемента и его подтип (тип папки, группы, или абзаца)
+     */
+    TextModelItemType type(int _index) const;
+    int subtype(int _index) const;
+
+    /**
+     * @brief Тип абзаца текстового элемента, либо Undefined для остальных элементов
+     */
+    TextParagraphType paragraphType(int _index) const;
+
+    /**
+     * @brief Тип группы, либо Undefined для элементов, не являющихся группой
+     */
+    TextGroupType groupType(int _index) const;
+
+    /**
+     * @brief Индекс родителя, либо -1 для элементов верхнего уровня
+     */
+    int parent(int _index) const;
+
+    /**
+     * @brief Индекс, следующий за последним потомком элемента
+     * @note Потомки элемента занимают диапазон (_index, subtreeEnd(_index))
+     */
+    int subtreeEnd(int _index) const;
+
+    /**
+     * @brief Текст абзаца, либо заголовок папки или группы
+     */
+    const QString& text(int _index) const;
+
+    /**
+     * @brief Хронометраж элемента
+     */
+    std::chrono::milliseconds duration(int _index) const;
+
+    /**
+     * @brief Элемент модели, по которому снята данная запись
+     * @note Разыменовывать можно только в потоке модели и только пока снимок актуален
+     */
+    TextModelItem* item(int _index) const;
+
+    /**
+     * @brief Индекс записи заданного элемента, либо -1, если элемента в снимке нет
+     */
+    int indexOf(const TextModelItem* _item) const;
+
+private:
+    friend class TextModel;
+
+    /**
+     * @brief Снять снимок со всей модели
+     */
+    static TextModelSnapshot build(const TextModel* _model);
+
+    /**
+     * @brief Обновить данные заданного элемента, не меняя структуры
+     * @return false, если элемента в снимке нет и снимок нужно построить заново
+     */
+    bool update(const TextModel* _model, const TextModelItem* _item);
+
+    struct Data;
+    std::shared_ptr<Data> d;
+};
+
+} // namespace BusinessLayer
@@ -16,7 +16,7 @@ const QHash<TextModelSplitterItemType, QString> kSplitterTypeToString = {
 };
 }
 
-class TextModelSplitterItem::Implementation
+class TextModelSplitterItem::Implementation : public PoolAllocated
 {
 public:
     Implementation() = default;
@@ -21,7 +21,60 @@
 
 namespace BusinessLayer {
 
-class TextModelTextItem::Implementation
+namespace {
+
+/**
+ * @brief Перенести позицию в тексте на её место после замены заданных фрагментов
+ * @note Позиция, попавшая внутрь заменяемого фрагмента, прижимается к началу, или к концу
+ *       вставленного текста, в зависимости от того, начало это, или конец размеченной части
+ */
+int positionAfterReplace(int _position, bool _isPartEnd,
+                         const QVector<TextModelTextItem::TextPart>& _replacedParts,
+                         int _replacementLength)
+{
+    int delta = 0;
+    for (const auto& replacedPart : _replacedParts) {
+        if (_position <= replacedPart.from) {
+            break;
+        }
+
+        if (_position < replacedPart.end()) {
+            return replacedPart.from + delta + (_isPartEnd ? _replacementLength : 0);
+        }
+
+        delta += _replacementLength - replacedPart.length;
+    }
+    return _position + delta;
+}
+
+/**
+ * @brief Скорректировать границы размеченных частей текста после замены заданных фрагментов
+ */
+template<typename Part>
+void correctPartsAfterReplace(QVector<Part>& _parts,
+                              const QVector<TextModelTextItem::TextPart>& _replacedParts,
+                              int _replacementLength)
+{
+    for (int index = 0; index < _parts.size(); ++index) {
+        auto& part = _parts[index];
+        const auto from
+            = positionAfterReplace(part.from, false, _replacedParts, _replacementLength);
+        const auto end
+            = positionAfterReplace(part.end(), true, _replacedParts, _replacementLength);
+        if (end <= from) {
+            _parts.remove(index);
+            --index;
+            continue;
+        }
+
+        part.from = from;
+        part.length = end - from;
+    }
+}
+
+} // namespace
+
+class TextModelTextItem::Implementation : public PoolAllocated
 {
 public:
     explicit Implementation(TextModelTextItem* _q);
@@ -1056,6 +1109,38 @@ void TextModelTextItem::removeText(int _from, int _length)
     markChanged();
 }
 
+void TextModelTextItem::replaceText(const QVector<TextPart>& _parts, const QString& _text)
+{
+    if (_parts.isEmpty()) {
+        return;
+    }
+
+    //
+    // Собираем новый текст за один проход по заменяемым фрагментам
+    //
+    QString text;
+    text.reserve(d->text.length() + _parts.size() * _text.length());
+    int lastPosition = 0;
+    for (const auto& part : _parts) {
+        Q_ASSERT(part.from >= lastPosition && part.end() <= d->text.length());
+        text.append(d->text.constData() + lastPosition, part.from - lastPosition);
+        text.append(_text);
+        lastPosition = part.end();
+    }
+    text.append(d->text.constData() + lastPosition, d->text.length() - lastPosition);
+    d->text = text;
+
+    //
+    // Корректируем форматирование, редакторские заметки и ресурсы
+    //
+    correctPartsAfterReplace(d->formats, _parts, _text.length());
+    correctPartsAfterReplace(d->reviewMarks, _parts, _text.length());
+    correctPartsAfterReplace(d->resourceMarks, _parts, _text.length());
+
+    d->updateXml();
+    markChanged();
+}
+
 const QVector<TextModelTextItem::TextFormat>& TextModelTextItem::formats() const
 {
     return d->formats;
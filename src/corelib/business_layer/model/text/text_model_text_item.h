@@ -176,6 +176,13 @@ public:
      */
     void removeText(int _from, int _length = -1);
 
+    /**
+     * @brief Заменить заданные фрагменты текста на новый текст, при этом корректируется и
+     *        остальной контент блока
+     * @note Фрагменты должны идти по возрастанию позиции и не пересекаться
+     */
+    void replaceText(const QVector<TextPart>& _parts, const QString& _text);
+
     /**
      * @brief Форматирование в блоке
      */
@@ -1394,19 +1394,63 @@ void WorldModel::setMagicTypes(const QVector<WorldItem>& _items)
 
 void WorldModel::initImageWrapper()
 {
+    //
+    // Фотографии мира и его элементов показываем в виде уменьшенных копий, которые подгружаются
+    // в фоне, либо обновляются при получении изображения из облака
+    //
+    auto updatePhoto = [this](const QUuid& _uuid, const QPixmap& _image) {
+        for (auto& photo : d->photos) {
+            if (photo.uuid == _uuid) {
+                photo.image = _image;
+
+                if (photo.uuid == d->photos.constFirst().uuid) {
+                    emit mainPhotoChanged(photo);
+                }
+                emit photosChanged(d->photos);
+
+                return;
+            }
+        }
+
+        auto updateItemPhoto = [&_uuid, &_image](QVector<WorldItem>& _items) {
+            for (auto& item : _items) {
+                if (item.photo.uuid == _uuid) {
+                    item.photo.image = _image;
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (updateItemPhoto(d->races)) {
+            emit racesChanged(d->races);
+        } else if (updateItemPhoto(d->floras)) {
+            emit florasChanged(d->floras);
+        } else if (updateItemPhoto(d->animals)) {
+            emit animalsChanged(d->animals);
+        } else if (updateItemPhoto(d->naturalResources)) {
+            emit naturalResourcesChanged(d->naturalResources);
+        } else if (updateItemPhoto(d->climates)) {
+            emit climatesChanged(d->climates);
+        } else if (updateItemPhoto(d->religions)) {
+            emit religionsChanged(d->religions);
+        } else if (updateItemPhoto(d->ethics)) {
+            emit ethicsChanged(d->ethics);
+        } else if (updateItemPhoto(d->languages)) {
+            emit languagesChanged(d->languages);
+        } else if (updateItemPhoto(d->castes)) {
+            emit castesChanged(d->castes);
+        } else if (updateItemPhoto(d->magicTypes)) {
+            emit magicTypesChanged(d->magicTypes);
+        }
+    };
     connect(imageWrapper(), &AbstractImageWrapper::imageUpdated, this,
-            [this](const QUuid& _uuid, const QPixmap& _image) {
-                for (auto& photo : d->photos) {
-                    if (photo.uuid == _uuid) {
-                        photo.image = _image;
-
-                        if (photo.uuid == d->photos.constFirst().uuid) {
-                            emit mainPhotoChanged(photo);
-                        }
-                        emit photosChanged(d->photos);
-
-                        break;
-                    }
+            [this, updatePhoto](const QUuid& _uuid) {
+                updatePhoto(_uuid, imageWrapper()->loadPreview(_uuid));
+            });
+    connect(imageWrapper(), &AbstractImageWrapper::thumbnailLoaded, this,
+            [updatePhoto](const QUuid& _uuid, int _size, const QPixmap& _thumbnail) {
+                if (_size == AbstractImageWrapper::kPreviewSize) {
+                    updatePhoto(_uuid, _thumbnail);
                 }
             });
 }
@@ -1432,7 +1476,7 @@ void WorldModel::initDocument()
         while (!photoNode.isNull()) {
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                d->photos.append({ uuid, imageWrapper()->load(uuid) });
+                d->photos.append({ uuid, imageWrapper()->loadPreview(uuid) });
             }
 
             photoNode = photoNode.nextSiblingElement();
@@ -1471,7 +1515,7 @@ void WorldModel::initDocument()
             const auto photoNode = raceNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                race.photo = { uuid, imageWrapper()->load(uuid) };
+                race.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             race.name = TextHelper::fromHtmlEscaped(raceNode.firstChildElement(kNameKey).text());
             race.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -1492,7 +1536,7 @@ void WorldModel::initDocument()
             const auto photoNode = floraNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                flora.photo = { uuid, imageWrapper()->load(uuid) };
+                flora.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             flora.name = TextHelper::fromHtmlEscaped(floraNode.firstChildElement(kNameKey).text());
             flora.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -1513,7 +1557,7 @@ void WorldModel::initDocument()
             const auto photoNode = animalNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                animal.photo = { uuid, imageWrapper()->load(uuid) };
+                animal.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             animal.name
                 = TextHelper::fromHtmlEscaped(animalNode.firstChildElement(kNameKey).text());
@@ -1535,7 +1579,7 @@ void WorldModel::initDocument()
             const auto photoNode = naturalResourceNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                naturalResource.photo = { uuid, imageWrapper()->load(uuid) };
+                naturalResource.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             naturalResource.name = TextHelper::fromHtmlEscaped(
                 naturalResourceNode.firstChildElement(kNameKey).text());
@@ -1557,7 +1601,7 @@ void WorldModel::initDocument()
             const auto photoNode = climateNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                climate.photo = { uuid, imageWrapper()->load(uuid) };
+                climate.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             climate.name
                 = TextHelper::fromHtmlEscaped(climateNode.firstChildElement(kNameKey).text());
@@ -1579,7 +1623,7 @@ void WorldModel::initDocument()
             const auto photoNode = religionNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                religion.photo = { uuid, imageWrapper()->load(uuid) };
+                religion.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             religion.name
                 = TextHelper::fromHtmlEscaped(religionNode.firstChildElement(kNameKey).text());
@@ -1601,7 +1645,7 @@ void WorldModel::initDocument()
             const auto photoNode = ethicNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                ethic.photo = { uuid, imageWrapper()->load(uuid) };
+                ethic.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             ethic.name = TextHelper::fromHtmlEscaped(ethicNode.firstChildElement(kNameKey).text());
             ethic.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -1622,7 +1666,7 @@ void WorldModel::initDocument()
             const auto photoNode = languageNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                language.photo = { uuid, imageWrapper()->load(uuid) };
+                language.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             language.name
                 = TextHelper::fromHtmlEscaped(languageNode.firstChildElement(kNameKey).text());
@@ -1644,7 +1688,7 @@ void WorldModel::initDocument()
             const auto photoNode = casteNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                caste.photo = { uuid, imageWrapper()->load(uuid) };
+                caste.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             caste.name = TextHelper::fromHtmlEscaped(casteNode.firstChildElement(kNameKey).text());
             caste.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -1692,7 +1736,7 @@ void WorldModel::initDocument()
             const auto photoNode = magicTypeNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                magicType.photo = { uuid, imageWrapper()->load(uuid) };
+                magicType.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             magicType.name
                 = TextHelper::fromHtmlEscaped(magicTypeNode.firstChildElement(kNameKey).text());
@@ -1990,8 +2034,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
     // ... добавляем новые фотографии к персонажу
     //
     for (const auto& photoUuid : newPhotosUuids) {
-        addPhoto({ photoUuid });
-        imageWrapper()->load(photoUuid);
+        addPhoto({ photoUuid, imageWrapper()->loadPreview(photoUuid) });
     }
     //
     // Cчитываем отношения
@@ -2058,7 +2101,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = raceNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                race.photo = { uuid, imageWrapper()->load(uuid) };
+                race.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             race.name = TextHelper::fromHtmlEscaped(raceNode.firstChildElement(kNameKey).text());
             race.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -2081,7 +2124,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = floraNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                flora.photo = { uuid, imageWrapper()->load(uuid) };
+                flora.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             flora.name = TextHelper::fromHtmlEscaped(floraNode.firstChildElement(kNameKey).text());
             flora.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -2104,7 +2147,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = animalNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                animal.photo = { uuid, imageWrapper()->load(uuid) };
+                animal.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             animal.name
                 = TextHelper::fromHtmlEscaped(animalNode.firstChildElement(kNameKey).text());
@@ -2128,7 +2171,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = naturalResourceNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                naturalResource.photo = { uuid, imageWrapper()->load(uuid) };
+                naturalResource.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             naturalResource.name = TextHelper::fromHtmlEscaped(
                 naturalResourceNode.firstChildElement(kNameKey).text());
@@ -2152,7 +2195,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = climateNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                climate.photo = { uuid, imageWrapper()->load(uuid) };
+                climate.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             climate.name
                 = TextHelper::fromHtmlEscaped(climateNode.firstChildElement(kNameKey).text());
@@ -2176,7 +2219,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = religionNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                religion.photo = { uuid, imageWrapper()->load(uuid) };
+                religion.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             religion.name
                 = TextHelper::fromHtmlEscaped(religionNode.firstChildElement(kNameKey).text());
@@ -2200,7 +2243,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = ethicNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                ethic.photo = { uuid, imageWrapper()->load(uuid) };
+                ethic.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             ethic.name = TextHelper::fromHtmlEscaped(ethicNode.firstChildElement(kNameKey).text());
             ethic.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -2223,7 +2266,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = languageNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                language.photo = { uuid, imageWrapper()->load(uuid) };
+                language.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             language.name
                 = TextHelper::fromHtmlEscaped(languageNode.firstChildElement(kNameKey).text());
@@ -2247,7 +2290,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = casteNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                caste.photo = { uuid, imageWrapper()->load(uuid) };
+                caste.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             caste.name = TextHelper::fromHtmlEscaped(casteNode.firstChildElement(kNameKey).text());
             caste.oneSentenceDescription = TextHelper::fromHtmlEscaped(
@@ -2299,7 +2342,7 @@ ChangeCursor WorldModel::applyPatch(const QByteArray& _patch)
             const auto photoNode = magicTypeNode.firstChildElement(kPhotoKey);
             const auto uuid = QUuid::fromString(TextHelper::fromHtmlEscaped(photoNode.text()));
             if (!uuid.isNull()) {
-                magicType.photo = { uuid, imageWrapper()->load(uuid) };
+                magicType.photo = { uuid, imageWrapper()->loadPreview(uuid) };
             }
             magicType.name
                 = TextHelper::fromHtmlEscaped(magicTypeNode.firstChildElement(kNameKey).text());
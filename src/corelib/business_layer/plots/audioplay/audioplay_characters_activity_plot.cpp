@@ -1,15 +1,12 @@
 #include "audioplay_characters_activity_plot.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/audioplay/text/audioplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/audioplay/audioplay_information_model.h>
 #include <business_layer/model/audioplay/text/audioplay_text_block_parser.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model_scene_item.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model_text_item.h>
-#include <business_layer/templates/audioplay_template.h>
-#include <business_layer/templates/templates_facade.h>
-#include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
@@ -89,25 +86,11 @@ void AudioplayCharactersActivityPlot::build(QAbstractItemModel* _model) const
         QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption);
 
     //
-    // Подготовим текстовый документ, для определения страниц сцен
+    // Подготовим постраничную раскладку, для определения страниц сцен
     //
-    const auto& audioplayTemplate
-        = TemplatesFacade::audioplayTemplate(audioplayModel->informationModel()->templateId());
-    PageTextEdit audioplayTextEdit;
-    audioplayTextEdit.setUsePageMode(true);
-    audioplayTextEdit.setPageSpacing(0);
-    audioplayTextEdit.setPageFormat(audioplayTemplate.pageSizeId());
-    audioplayTextEdit.setPageMarginsMm(audioplayTemplate.pageMargins());
-    AudioplayTextDocument audioplayDocument;
-    audioplayTextEdit.setDocument(&audioplayDocument);
-    const bool kCanChangeModel = false;
-    audioplayDocument.setModel(audioplayModel, kCanChangeModel);
-    QTextCursor audioplayCursor(&audioplayDocument);
-    auto textItemPage = [&audioplayTextEdit, &audioplayDocument,
-                         &audioplayCursor](TextModelTextItem* _item) {
-        audioplayCursor.setPosition(
-            audioplayDocument.itemPosition(audioplayDocument.model()->indexForItem(_item), true));
-        return audioplayTextEdit.cursorPage(audioplayCursor);
+    auto pagination = PaginationService::forModel(audioplayModel);
+    auto textItemPage = [pagination](TextModelTextItem* _item) {
+        return pagination->pageForItem(_item);
     };
 
     //
@@ -1,15 +1,12 @@
 #include "screenplay_characters_activity_plot.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_block_parser.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model_scene_item.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model_text_item.h>
-#include <business_layer/templates/screenplay_template.h>
-#include <business_layer/templates/templates_facade.h>
-#include <ui/widgets/text_edit/page/page_text_edit.h>
 #include <utils/helpers/color_helper.h>
 #include <utils/helpers/text_helper.h>
 #include <utils/helpers/time_helper.h>
@@ -89,25 +86,11 @@ void ScreenplayCharactersActivityPlot::build(QAbstractItemModel* _model) const
         QRegularExpression::CaseInsensitiveOption | QRegularExpression::UseUnicodePropertiesOption);
 
     //
-    // Подготовим текстовый документ, для определения страниц сцен
+    // Подготовим постраничную раскладку, для определения страниц сцен
     //
-    const auto& screenplayTemplate
-        = TemplatesFacade::screenplayTemplate(screenplayModel->informationModel()->templateId());
-    PageTextEdit screenplayTextEdit;
-    screenplayTextEdit.setUsePageMode(true);
-    screenplayTextEdit.setPageSpacing(0);
-    screenplayTextEdit.setPageFormat(screenplayTemplate.pageSizeId());
-    screenplayTextEdit.setPageMarginsMm(screenplayTemplate.pageMargins());
-    ScreenplayTextDocument screenplayDocument;
-    screenplayTextEdit.setDocument(&screenplayDocument);
-    const bool kCanChangeModel = false;
-    screenplayDocument.setModel(screenplayModel, kCanChangeModel);
-    QTextCursor screenplayCursor(&screenplayDocument);
-    auto textItemPage = [&screenplayTextEdit, &screenplayDocument,
-                         &screenplayCursor](TextModelTextItem* _item) {
-        screenplayCursor.setPosition(
-            screenplayDocument.itemPosition(screenplayDocument.model()->indexForItem(_item), true));
-        return screenplayTextEdit.cursorPage(screenplayCursor);
+    auto pagination = PaginationService::forModel(screenplayModel);
+    auto textItemPage = [pagination](TextModelTextItem* _item) {
+        return pagination->pageForItem(_item);
     };
 
     //
@@ -2,7 +2,10 @@
 
 #include <utils/helpers/extension_helper.h>
 
+#include <QCoreApplication>
+#include <QStandardItemModel>
 #include <QString>
+#include <QThread>
 
 
 namespace BusinessLayer {
@@ -16,4 +19,14 @@ void AbstractReport::saveToFile(const QString& _filename) const
     }
 }
 
+QStandardItemModel* AbstractReport::createModel()
+{
+    auto model = new QStandardItemModel;
+    if (QCoreApplication::instance() != nullptr
+        && model->thread() != QCoreApplication::instance()->thread()) {
+        model->moveToThread(QCoreApplication::instance()->thread());
+    }
+    return model;
+}
+
 } // namespace BusinessLayer
@@ -3,6 +3,7 @@
 #include <corelib_global.h>
 
 class QAbstractItemModel;
+class QStandardItemModel;
 
 namespace BusinessLayer {
 
@@ -33,6 +34,13 @@ public:
     void saveToFile(const QString& _filename) const;
 
 protected:
+    /**
+     * @brief Создать модель для данных отчёта
+     * @note Отчёт может строиться в фоновом потоке, а его модели отображаются в основном, поэтому
+     *       модель сразу передаётся в основной поток приложения
+     */
+    static QStandardItemModel* createModel();
+
     /**
      * @brief Сохранить отчёт в файл конкретного формата
      */
@@ -5,7 +5,8 @@
 #include <business_layer/model/audioplay/audioplay_information_model.h>
 #include <business_layer/model/audioplay/text/audioplay_text_block_parser.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model.h>
-#include <business_layer/model/audioplay/text/audioplay_text_model_text_item.h>
+#include <business_layer/model/text/text_model_item.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/audioplay_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
@@ -110,95 +111,80 @@ void AudioplayCastReport::build(QAbstractItemModel* _model)
     //
     // Собираем статистику
     //
-    std::function<void(const TextModelItem*)> includeInReport;
-    includeInReport = [&includeInReport, &charactersData, &lastSceneNonspeakingCharacters,
-                       &lastSceneSpeakingCharacters, &charactersOrder, &lastSpeakingCharacter,
-                       &rxCharacterFinder](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                includeInReport(childItem);
-                break;
-            }
-
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<AudioplayTextModelTextItem*>(childItem);
-                //
-                // ... стата по объектам
-                //
-                switch (textItem->paragraphType()) {
-                case TextParagraphType::SceneHeading: {
-                    //
-                    // Началась новая сцена
-                    //
-                    lastSceneNonspeakingCharacters.clear();
-                    lastSceneSpeakingCharacters.clear();
-                    break;
-                }
-
-                case TextParagraphType::Character: {
-                    const auto character = AudioplayCharacterParser::name(textItem->text());
-                    if (character.isEmpty()) {
-                        break;
-                    }
-
-                    if (!charactersData.contains(character)) {
-                        charactersData.insert(character, { 1, 1, 1, 0 });
-                        charactersOrder.append(character);
-                        lastSceneSpeakingCharacters.insert(character);
-                    } else {
-                        auto& characterData = charactersData[character];
-                        if (lastSceneNonspeakingCharacters.contains(character)) {
-                            lastSceneNonspeakingCharacters.remove(character);
-                            lastSceneSpeakingCharacters.insert(character);
-                            ++characterData.speakingScenesCount;
-                        } else if (!lastSceneSpeakingCharacters.contains(character)) {
-                            lastSceneSpeakingCharacters.insert(character);
-                            ++characterData.speakingScenesCount;
-                        }
-                        ++characterData.totalDialogues;
-                    }
-                    lastSpeakingCharacter = character;
-                    break;
-                }
-
-                case TextParagraphType::Dialogue:
-                case TextParagraphType::Lyrics: {
-                    if (lastSpeakingCharacter.isEmpty()) {
-                        break;
-                    }
+    const auto snapshot = d->audioplayModel->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
 
-                    auto& characterData = charactersData[lastSpeakingCharacter];
-                    characterData.totalWords += TextHelper::wordsCount(textItem->text());
-                    break;
-                }
+        const auto paragraphType = snapshot.paragraphType(index);
+        const auto& text = snapshot.text(index);
+
+        //
+        // ... стата по объектам
+        //
+        switch (paragraphType) {
+        case TextParagraphType::SceneHeading: {
+            //
+            // Началась новая сцена
+            //
+            lastSceneNonspeakingCharacters.clear();
+            lastSceneSpeakingCharacters.clear();
+            break;
+        }
 
-                default:
-                    break;
-                }
+        case TextParagraphType::Character: {
+            const auto character = AudioplayCharacterParser::name(text);
+            if (character.isEmpty()) {
+                break;
+            }
 
-                //
-                // Очищаем последнего говорящего персонажа, если ушли из реплики
-                //
-                if (!lastSpeakingCharacter.isEmpty()
-                    && textItem->paragraphType() != TextParagraphType::Character
-                    && textItem->paragraphType() != TextParagraphType::Parenthetical
-                    && textItem->paragraphType() != TextParagraphType::Dialogue
-                    && textItem->paragraphType() != TextParagraphType::Lyrics) {
-                    lastSpeakingCharacter.clear();
+            if (!charactersData.contains(character)) {
+                charactersData.insert(character, { 1, 1, 1, 0 });
+                charactersOrder.append(character);
+                lastSceneSpeakingCharacters.insert(character);
+            } else {
+                auto& characterData = charactersData[character];
+                if (lastSceneNonspeakingCharacters.contains(character)) {
+                    lastSceneNonspeakingCharacters.remove(character);
+                    lastSceneSpeakingCharacters.insert(character);
+                    ++characterData.speakingScenesCount;
+                } else if (!lastSceneSpeakingCharacters.contains(character)) {
+                    lastSceneSpeakingCharacters.insert(character);
+                    ++characterData.speakingScenesCount;
                 }
-
-                break;
+                ++characterData.totalDialogues;
             }
+            lastSpeakingCharacter = character;
+            break;
+        }
 
-            default:
+        case TextParagraphType::Dialogue:
+        case TextParagraphType::Lyrics: {
+            if (lastSpeakingCharacter.isEmpty()) {
                 break;
             }
+
+            auto& characterData = charactersData[lastSpeakingCharacter];
+            characterData.totalWords += TextHelper::wordsCount(text);
+            break;
         }
-    };
-    includeInReport(d->audioplayModel->itemForIndex({}));
+
+        default:
+            break;
+        }
+
+        //
+        // Очищаем последнего говорящего персонажа, если ушли из реплики
+        //
+        if (!lastSpeakingCharacter.isEmpty()
+            && paragraphType != TextParagraphType::Character
+            && paragraphType != TextParagraphType::Parenthetical
+            && paragraphType != TextParagraphType::Dialogue
+            && paragraphType != TextParagraphType::Lyrics) {
+            lastSpeakingCharacter.clear();
+        }
+    }
 
     //
     // Формируем отчёт
@@ -271,7 +257,7 @@ void AudioplayCastReport::build(QAbstractItemModel* _model)
     // Формируем таблицу
     //
     if (d->castModel.isNull()) {
-        d->castModel.reset(new QStandardItemModel);
+        d->castModel.reset(createModel());
     } else {
         d->castModel->clear();
     }
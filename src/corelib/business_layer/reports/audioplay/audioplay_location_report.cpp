@@ -1,7 +1,7 @@
 #include "audioplay_location_report.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/audioplay/text/audioplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/audioplay/audioplay_information_model.h>
 #include <business_layer/model/audioplay/text/audioplay_text_block_parser.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model.h>
@@ -80,7 +80,7 @@ void AudioplayLocationReport::build(QAbstractItemModel* _model)
     // Подготовим модель к наполнению
     //
     if (d->locationModel.isNull()) {
-        d->locationModel.reset(new QStandardItemModel);
+        d->locationModel.reset(createModel());
     } else {
         d->locationModel->clear();
     }
@@ -133,25 +133,11 @@ void AudioplayLocationReport::build(QAbstractItemModel* _model)
     QVector<QString> locationsOrder;
 
     //
-    // Подготовим текстовый документ, для определения страниц сцен
+    // Подготовим постраничную раскладку, для определения страниц сцен
     //
-    const auto& audioplayTemplate
-        = TemplatesFacade::audioplayTemplate(d->audioplayModel->informationModel()->templateId());
-    PageTextEdit audioplayTextEdit;
-    audioplayTextEdit.setUsePageMode(true);
-    audioplayTextEdit.setPageSpacing(0);
-    audioplayTextEdit.setPageFormat(audioplayTemplate.pageSizeId());
-    audioplayTextEdit.setPageMarginsMm(audioplayTemplate.pageMargins());
-    AudioplayTextDocument audioplayDocument;
-    audioplayTextEdit.setDocument(&audioplayDocument);
-    const bool kCanChangeModel = false;
-    audioplayDocument.setModel(d->audioplayModel, kCanChangeModel);
-    QTextCursor audioplayCursor(&audioplayDocument);
-    auto textItemPage = [&audioplayTextEdit, &audioplayDocument,
-                         &audioplayCursor](TextModelTextItem* _item) {
-        audioplayCursor.setPosition(
-            audioplayDocument.itemPosition(audioplayDocument.model()->indexForItem(_item), true));
-        return audioplayTextEdit.cursorPage(audioplayCursor);
+    auto pagination = PaginationService::forModel(d->audioplayModel);
+    auto textItemPage = [pagination](TextModelTextItem* _item) {
+        return pagination->pageForItem(_item);
     };
 
     //
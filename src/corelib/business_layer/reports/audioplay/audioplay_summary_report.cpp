@@ -1,10 +1,11 @@
 #include "audioplay_summary_report.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/audioplay/text/audioplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/audioplay/audioplay_information_model.h>
 #include <business_layer/model/audioplay/text/audioplay_text_model.h>
-#include <business_layer/model/audioplay/text/audioplay_text_model_text_item.h>
+#include <business_layer/model/text/text_model_item.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/audioplay_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
@@ -86,71 +87,55 @@ void AudioplaySummaryReport::build(QAbstractItemModel* _model)
     //
     // Собираем статистику
     //
-    std::function<void(const TextModelItem*)> includeInReport;
-    includeInReport
-        = [&includeInReport, &paragraphsToCounters, &totalWords, &totalCharacters, &scenes,
-           &charactersToDialogues, &lastCharacter](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      includeInReport(childItem);
-                      break;
-                  }
-
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<AudioplayTextModelTextItem*>(childItem);
-                      //
-                      // ... счётчики
-                      //
-                      if (paragraphsToCounters.contains(textItem->paragraphType())) {
-                          auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
-                          ++paragraphCounters.occurrences;
-                          const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                          paragraphCounters.words += paragraphWords;
-                          totalWords += paragraphWords;
-                          totalCharacters.withSpaces += textItem->text().length();
-                          totalCharacters.withoutSpaces
-                              += textItem->text().length() - textItem->text().count(' ');
-                      }
-
-                      //
-                      // ... стата по объектам
-                      //
-                      switch (textItem->paragraphType()) {
-                      case TextParagraphType::SceneHeading: {
-                          scenes.append(TextHelper::smartToUpper(textItem->text()));
-                          break;
-                      }
-
-                      case TextParagraphType::Character: {
-                          lastCharacter = textItem->text();
-                          if (!charactersToDialogues.contains(lastCharacter)) {
-                              charactersToDialogues.insert(lastCharacter, 0);
-                          }
-                          break;
-                      }
-
-                      case TextParagraphType::Dialogue: {
-                          charactersToDialogues[lastCharacter] += 1;
-                          break;
-                      }
-
-                      default:
-                          break;
-                      }
-
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
     d->audioplayModel = static_cast<AudioplayTextModel*>(_model);
-    includeInReport(d->audioplayModel->itemForIndex({}));
+    const auto snapshot = d->audioplayModel->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
+
+        const auto paragraphType = snapshot.paragraphType(index);
+        const auto& text = snapshot.text(index);
+
+        //
+        // ... счётчики
+        //
+        if (paragraphsToCounters.contains(paragraphType)) {
+            auto& paragraphCounters = paragraphsToCounters[paragraphType];
+            ++paragraphCounters.occurrences;
+            const auto paragraphWords = TextHelper::wordsCount(text);
+            paragraphCounters.words += paragraphWords;
+            totalWords += paragraphWords;
+            totalCharacters.withSpaces += text.length();
+            totalCharacters.withoutSpaces += text.length() - text.count(' ');
+        }
+
+        //
+        // ... стата по объектам
+        //
+        switch (paragraphType) {
+        case TextParagraphType::SceneHeading: {
+            scenes.append(TextHelper::smartToUpper(text));
+            break;
+        }
+
+        case TextParagraphType::Character: {
+            lastCharacter = text;
+            if (!charactersToDialogues.contains(lastCharacter)) {
+                charactersToDialogues.insert(lastCharacter, 0);
+            }
+            break;
+        }
+
+        case TextParagraphType::Dialogue: {
+            charactersToDialogues[lastCharacter] += 1;
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
 
     //
     // Формируем отчёт
@@ -170,30 +155,14 @@ void AudioplaySummaryReport::build(QAbstractItemModel* _model)
     //
     {
         d->duration = d->audioplayModel->duration();
-        d->pagesCount = [this] {
-            const auto& audioplayTemplate = TemplatesFacade::audioplayTemplate(
-                d->audioplayModel->informationModel()->templateId());
-
-            PageTextEdit textEdit;
-            textEdit.setUsePageMode(true);
-            textEdit.setPageSpacing(0);
-            textEdit.setPageFormat(audioplayTemplate.pageSizeId());
-            textEdit.setPageMarginsMm(audioplayTemplate.pageMargins());
-            AudioplayTextDocument audioplayDocument;
-            textEdit.setDocument(&audioplayDocument);
-
-            const bool kCanChangeModel = false;
-            audioplayDocument.setModel(d->audioplayModel, kCanChangeModel);
-
-            return audioplayDocument.pageCount();
-        }();
+        d->pagesCount = PaginationService::forModel(d->audioplayModel)->pageCount();
         d->wordsCount = totalWords;
         d->charactersCount = totalCharacters;
         //
         // ... иформация по тексту
         //
         if (d->textInfoModel.isNull()) {
-            d->textInfoModel.reset(new QStandardItemModel);
+            d->textInfoModel.reset(createModel());
         } else {
             d->textInfoModel->clear();
         }
@@ -254,7 +223,7 @@ void AudioplaySummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->charactersInfoModel.isNull()) {
-            d->charactersInfoModel.reset(new QStandardItemModel);
+            d->charactersInfoModel.reset(createModel());
         } else {
             d->charactersInfoModel->clear();
         }
@@ -2,7 +2,8 @@
 
 #include <business_layer/document/comic_book/text/comic_book_text_document.h>
 #include <business_layer/model/comic_book/text/comic_book_text_model.h>
-#include <business_layer/model/text/text_model_text_item.h>
+#include <business_layer/model/text/text_model_item.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/comic_book_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
@@ -107,62 +108,47 @@ void ComicBookSummaryReport::build(QAbstractItemModel* _model)
     //
     // Собираем статистику
     //
-    std::function<void(const TextModelItem*)> includeInReport;
-    includeInReport = [&totalPages, &totalPanels, &includeInReport, &paragraphsToCounters,
-                       &totalWords, &totalCharacters](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                includeInReport(childItem);
-                break;
-            }
+    auto comicBookModel = static_cast<ComicBookTextModel*>(_model);
+    const auto snapshot = comicBookModel->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<TextModelTextItem*>(childItem);
-                //
-                // ... счётчики
-                //
-                if (paragraphsToCounters.contains(textItem->paragraphType())) {
-                    auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
-                    ++paragraphCounters.occurrences;
-                    const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                    paragraphCounters.words += paragraphWords;
-                    totalWords += paragraphWords;
-                    totalCharacters.withSpaces += textItem->text().length();
-                    totalCharacters.withoutSpaces
-                        += textItem->text().length() - textItem->text().count(' ');
-                }
-
-                //
-                // ... стата по объектам
-                //
-                switch (textItem->paragraphType()) {
-                case TextParagraphType::PageHeading: {
-                    ++totalPages;
-                    break;
-                }
-
-                case TextParagraphType::PanelHeading: {
-                    ++totalPanels;
-                    break;
-                }
-
-                default:
-                    break;
-                }
-
-                break;
-            }
+        const auto paragraphType = snapshot.paragraphType(index);
+        const auto& text = snapshot.text(index);
 
-            default:
-                break;
-            }
+        //
+        // ... счётчики
+        //
+        if (paragraphsToCounters.contains(paragraphType)) {
+            auto& paragraphCounters = paragraphsToCounters[paragraphType];
+            ++paragraphCounters.occurrences;
+            const auto paragraphWords = TextHelper::wordsCount(text);
+            paragraphCounters.words += paragraphWords;
+            totalWords += paragraphWords;
+            totalCharacters.withSpaces += text.length();
+            totalCharacters.withoutSpaces += text.length() - text.count(' ');
         }
-    };
-    auto comicBookModel = static_cast<ComicBookTextModel*>(_model);
-    includeInReport(comicBookModel->itemForIndex({}));
+
+        //
+        // ... стата по объектам
+        //
+        switch (paragraphType) {
+        case TextParagraphType::PageHeading: {
+            ++totalPages;
+            break;
+        }
+
+        case TextParagraphType::PanelHeading: {
+            ++totalPanels;
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
 
     //
     // Формируем отчёт
@@ -189,7 +175,7 @@ void ComicBookSummaryReport::build(QAbstractItemModel* _model)
         // ... иформация по тексту
         //
         if (d->textInfoModel.isNull()) {
-            d->textInfoModel.reset(new QStandardItemModel);
+            d->textInfoModel.reset(createModel());
         } else {
             d->textInfoModel->clear();
         }
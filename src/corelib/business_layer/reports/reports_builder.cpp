@@ -0,0 +1,358 @@
+#include "reports_builder.h"
+
+#include <business_layer/model/abstract_image_wrapper.h>
+#include <business_layer/model/abstract_model.h>
+#include <business_layer/model/characters/character_model.h>
+#include <business_layer/model/characters/characters_model.h>
+#include <business_layer/model/locations/location_model.h>
+#include <business_layer/model/locations/locations_model.h>
+#include <domain/document_object.h>
+#include <domain/objects_builder.h>
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <vector>
+
+
+namespace BusinessLayer {
+
+namespace {
+
+/**
+ * @brief Загрузчик изображений для моделей снимка
+ * @note Отчёты изображения не используют, поэтому модели снимка не обращаются за ними в базу
+ */
+class SnapshotImageWrapper : public AbstractImageWrapper
+{
+public:
+    QPixmap load(const QUuid& _uuid) const override
+    {
+        Q_UNUSED(_uuid)
+        return {};
+    }
+    QPixmap loadThumbnail(const QUuid& _uuid, int _size) const override
+    {
+        Q_UNUSED(_uuid)
+        Q_UNUSED(_size)
+        return {};
+    }
+    QUuid save(const QPixmap& _image) override
+    {
+        Q_UNUSED(_image)
+        return {};
+    }
+    void save(const QUuid& _uuid, const QPixmap& _image) override
+    {
+        Q_UNUSED(_uuid)
+        Q_UNUSED(_image)
+    }
+    void save(const QUuid& _uuid, const QByteArray& _imageData) override
+    {
+        Q_UNUSED(_uuid)
+        Q_UNUSED(_imageData)
+    }
+    void remove(const QUuid& _uuid) override
+    {
+        Q_UNUSED(_uuid)
+    }
+};
+
+} // namespace
+
+
+class ReportsSnapshot::Implementation
+{
+public:
+    /**
+     * @brief Копии документов, загруженные в модели снимка
+     */
+    std::vector<std::unique_ptr<Domain::DocumentObject>> documents;
+
+    /**
+     * @brief Загрузчик изображений для моделей снимка
+     */
+    SnapshotImageWrapper imageWrapper;
+
+    /**
+     * @brief Модели, которыми владеет снимок
+     */
+    std::vector<AbstractModel*> models;
+
+    /**
+     * @brief Модель, по которой строятся отчёты
+     */
+    AbstractModel* model = nullptr;
+};
+
+
+// ****
+
+
+std::shared_ptr<ReportsSnapshot> ReportsSnapshot::create()
+{
+    return std::shared_ptr<ReportsSnapshot>(new ReportsSnapshot,
+                                            [](ReportsSnapshot* _snapshot) {
+                                                if (QThread::currentThread()
+                                                    == _snapshot->thread()) {
+                                                    delete _snapshot;
+                                                } else {
+                                                    _snapshot->deleteLater();
+                                                }
+                                            });
+}
+
+ReportsSnapshot::ReportsSnapshot()
+    : d(new Implementation)
+{
+}
+
+ReportsSnapshot::~ReportsSnapshot()
+{
+    //
+    // Модели ссылаются на документы и загрузчик изображений снимка, поэтому удаляем их раньше
+    //
+    qDeleteAll(d->models);
+}
+
+CharactersModel* ReportsSnapshot::copyCharacters(CharactersModel* _source)
+{
+    Q_ASSERT(_source);
+
+    return copy<CharactersModel>(_source, [this, _source](CharactersModel* _model) {
+        for (int row = 0; row < _source->rowCount(); ++row) {
+            _model->addCharacterModel(copy(_source->character(row)));
+        }
+    });
+}
+
+LocationsModel* ReportsSnapshot::copyLocations(LocationsModel* _source)
+{
+    Q_ASSERT(_source);
+
+    return copy<LocationsModel>(_source, [this, _source](LocationsModel* _model) {
+        for (int row = 0; row < _source->rowCount(); ++row) {
+            _model->addLocationModel(copy(_source->location(row)));
+        }
+    });
+}
+
+AbstractModel* ReportsSnapshot::model() const
+{
+    return d->model;
+}
+
+void ReportsSnapshot::setModel(AbstractModel* _model)
+{
+    d->model = _model;
+}
+
+Domain::DocumentObject* ReportsSnapshot::copyDocument(AbstractModel* _source)
+{
+    Q_ASSERT(_source);
+    Q_ASSERT(_source->document());
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    //
+    // Переносим в документ изменения модели, которые ещё ожидают отложенного сохранения
+    //
+    _source->savePendingChanges();
+
+    //
+    // ... содержимое документа разделяется с исходным до первого изменения, поэтому копия
+    //     обходится без копирования данных
+    //
+    const auto sourceDocument = _source->document();
+    auto document = Domain::ObjectsBuilder::createDocument(
+        {}, sourceDocument->uuid(), sourceDocument->type(), sourceDocument->content(), {});
+    d->documents.emplace_back(document);
+    return document;
+}
+
+void ReportsSnapshot::adopt(AbstractModel* _model)
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    d->models.push_back(_model);
+    _model->setImageWrapper(&d->imageWrapper);
+}
+
+
+// ****
+
+
+class ReportsBuilder::Implementation
+{
+public:
+    explicit Implementation(ReportsBuilder* _q);
+
+    /**
+     * @brief Запуск построения
+     */
+    struct Run {
+        /**
+         * @brief Флаг отмены, читаемый задачами из фоновых потоков
+         */
+        std::shared_ptr<std::atomic_bool> isCancelled = std::make_shared<std::atomic_bool>(false);
+
+        int tasksCount = 0;
+        int finishedTasksCount = 0;
+    };
+
+    using Watcher = QFutureWatcher<std::function<void()>>;
+
+    /**
+     * @brief Обработать завершившуюся задачу
+     * @note Задача может быть обработана раньше сигнала о завершении, при ожидании построения,
+     *       повторно она не обрабатывается
+     */
+    void finishTask(Watcher* _watcher);
+
+
+    ReportsBuilder* q = nullptr;
+
+    /**
+     * @brief Текущий запуск
+     */
+    std::shared_ptr<Run> currentRun;
+
+    /**
+     * @brief Наблюдатели за выполняющимися задачами и запуски, к которым они относятся
+     */
+    QVector<Watcher*> watchers;
+    QHash<Watcher*, std::shared_ptr<Run>> watchersRuns;
+};
+
+ReportsBuilder::Implementation::Implementation(ReportsBuilder* _q)
+    : q(_q)
+{
+}
+
+void ReportsBuilder::Implementation::finishTask(Watcher* _watcher)
+{
+    if (!watchers.removeOne(_watcher)) {
+        return;
+    }
+
+    const auto run = watchersRuns.take(_watcher);
+    _watcher->deleteLater();
+
+    ++run->finishedTasksCount;
+    const auto isRunFinished = run->finishedTasksCount == run->tasksCount;
+
+    //
+    // Результаты отменённого запуска отбрасываем
+    //
+    if (run->isCancelled->load() || currentRun != run) {
+        return;
+    }
+
+    const auto applyResult = _watcher->result();
+    if (applyResult) {
+        applyResult();
+    }
+
+    emit q->progressChanged(static_cast<qreal>(run->finishedTasksCount) / run->tasksCount);
+
+    if (isRunFinished) {
+        currentRun.reset();
+        emit q->built();
+    }
+}
+
+
+// ****
+
+
+ReportsBuilder::ReportsBuilder(QObject* _parent)
+    : QObject(_parent)
+    , d(new Implementation(this))
+{
+}
+
+ReportsBuilder::~ReportsBuilder()
+{
+    cancel();
+
+    //
+    // Задачи пишут в отчёты, которые удаляются вместе с владельцем построителя, поэтому
+    // дожидаемся их завершения
+    //
+    for (auto watcher : std::as_const(d->watchers)) {
+        watcher->waitForFinished();
+    }
+}
+
+void ReportsBuilder::build(const QVector<Task>& _tasks)
+{
+    cancel();
+
+    auto run = std::make_shared<Implementation::Run>();
+    run->tasksCount = _tasks.size();
+    d->currentRun = run;
+
+    if (_tasks.isEmpty()) {
+        d->currentRun.reset();
+        emit built();
+        return;
+    }
+
+    emit progressChanged(0.0);
+
+    for (const auto& task : _tasks) {
+        auto watcher = new Implementation::Watcher(this);
+        d->watchers.append(watcher);
+        d->watchersRuns.insert(watcher, run);
+        connect(watcher, &QFutureWatcherBase::finished, this,
+                [this, watcher] { d->finishTask(watcher); });
+
+        const auto isCancelled = run->isCancelled;
+        watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [task, isCancelled] {
+            if (isCancelled->load()) {
+                return std::function<void()>();
+            }
+            return task(*isCancelled);
+        }));
+    }
+}
+
+void ReportsBuilder::cancel()
+{
+    if (d->currentRun == nullptr) {
+        return;
+    }
+
+    d->currentRun->isCancelled->store(true);
+    d->currentRun.reset();
+}
+
+bool ReportsBuilder::isBuilding() const
+{
+    return d->currentRun != nullptr;
+}
+
+void ReportsBuilder::waitForFinished()
+{
+    const auto run = d->currentRun;
+    if (run == nullptr) {
+        return;
+    }
+
+    //
+    // Результаты применяем в порядке запуска задач, не дожидаясь сигналов об их завершении
+    //
+    const auto watchers = d->watchers;
+    for (auto watcher : watchers) {
+        if (d->watchersRuns.value(watcher) != run) {
+            continue;
+        }
+
+        watcher->waitForFinished();
+        d->finishTask(watcher);
+    }
+}
+
+} // namespace BusinessLayer
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <QObject>
+#include <QVector>
+
+#include <corelib_global.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Domain {
+class DocumentObject;
+}
+
+
+namespace BusinessLayer {
+
+class AbstractModel;
+class CharactersModel;
+class LocationsModel;
+
+/**
+ * @brief Копия моделей, по которой строятся отчёты в фоновых потоках
+ * @note Создаётся, собирается и удаляется в основном потоке, а в фоне используется только для
+ *       чтения, поэтому пользователь может продолжать редактировать исходные модели во время
+ *       построения
+ */
+class CORE_LIBRARY_EXPORT ReportsSnapshot : public QObject
+{
+public:
+    /**
+     * @brief Создать снимок
+     * @note Последняя ссылка на снимок может быть освобождена в фоновом потоке, поэтому сам
+     *       снимок всегда удаляется в основном
+     */
+    static std::shared_ptr<ReportsSnapshot> create();
+
+    ~ReportsSnapshot() override;
+
+    /**
+     * @brief Создать копию заданной модели с актуальным документом
+     * @param _setup - настройка копии, которую нужно выполнить до загрузки в неё документа
+     */
+    template<typename ModelType>
+    ModelType* copy(ModelType* _source, const std::function<void(ModelType*)>& _setup = {})
+    {
+        const auto document = copyDocument(_source);
+        auto copy = create<ModelType>();
+        if (_setup) {
+            _setup(copy);
+        }
+        copy->setDocument(document);
+        return copy;
+    }
+
+    /**
+     * @brief Скопировать модель персонажей вместе с моделями всех персонажей
+     */
+    CharactersModel* copyCharacters(CharactersModel* _source);
+
+    /**
+     * @brief Скопировать модель локаций вместе с моделями всех локаций
+     */
+    LocationsModel* copyLocations(LocationsModel* _source);
+
+    /**
+     * @brief Создать пустую модель, которой владеет снимок
+     */
+    template<typename ModelType>
+    ModelType* create()
+    {
+        auto model = new ModelType;
+        adopt(model);
+        return model;
+    }
+
+    /**
+     * @brief Модель, по которой строятся отчёты
+     * @note Модель должна быть полностью подготовлена к чтению из нескольких потоков до запуска
+     *       построения
+     */
+    AbstractModel* model() const;
+    void setModel(AbstractModel* _model);
+
+private:
+    ReportsSnapshot();
+
+    /**
+     * @brief Создать копию актуального документа модели
+     */
+    Domain::DocumentObject* copyDocument(AbstractModel* _source);
+
+    /**
+     * @brief Взять модель во владение снимка
+     */
+    void adopt(AbstractModel* _model);
+
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+/**
+ * @brief Построитель отчётов в пуле фоновых потоков
+ */
+class CORE_LIBRARY_EXPORT ReportsBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Задача построения
+     * @note Выполняется в фоновом потоке, периодически проверяя флаг отмены, и возвращает
+     *       функцию, которая применит результат в основном потоке
+     */
+    using Task = std::function<std::function<void()>(const std::atomic_bool& _isCancelled)>;
+
+    explicit ReportsBuilder(QObject* _parent = nullptr);
+    ~ReportsBuilder() override;
+
+    /**
+     * @brief Запустить построение, отменив незавершённое
+     */
+    void build(const QVector<Task>& _tasks);
+
+    /**
+     * @brief Отменить текущее построение
+     */
+    void cancel();
+
+    /**
+     * @brief Идёт ли построение в данный момент
+     */
+    bool isBuilding() const;
+
+    /**
+     * @brief Дождаться завершения текущего построения и применить его результаты
+     * @note Блокирует основной поток, поэтому нужен только тем, кому отчёт нужен немедленно,
+     *       остальным стоит дождаться сигнала о завершении построения
+     */
+    void waitForFinished();
+
+signals:
+    /**
+     * @brief Изменился прогресс построения (от 0.0 до 1.0)
+     */
+    void progressChanged(qreal _progress);
+
+    /**
+     * @brief Все отчёты построены и их результаты применены
+     */
+    void built();
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+/**
+ * @brief Отчёт вместе с копией моделей, по которой он построен
+ * @note Отчёты хранят указатели на модели, из которых строились, например для экспорта, поэтому
+ *       снимок живёт, пока используется построенный по нему отчёт
+ */
+template<typename ReportType>
+struct SnapshotReport {
+    std::shared_ptr<ReportType> report = std::make_shared<ReportType>();
+    std::shared_ptr<ReportsSnapshot> snapshot;
+
+    /**
+     * @brief Настройка параметров нового экземпляра отчёта
+     */
+    std::function<void(ReportType&)> setup;
+
+    /**
+     * @brief Сформировать задачу построения нового экземпляра отчёта по модели заданного снимка
+     * @note Отчёт должен жить дольше построителя, выполняющего задачу
+     */
+    ReportsBuilder::Task buildTask(const std::shared_ptr<ReportsSnapshot>& _snapshot)
+    {
+        return [this, setup = setup,
+                _snapshot](const std::atomic_bool& _isCancelled) -> std::function<void()> {
+            const auto model = _snapshot->model();
+            if (_isCancelled) {
+                return {};
+            }
+
+            auto report = std::make_shared<ReportType>();
+            if (setup) {
+                setup(*report);
+            }
+            report->build(model);
+            if (_isCancelled) {
+                return {};
+            }
+
+            return [this, report, _snapshot] {
+                this->report = report;
+                snapshot = _snapshot;
+            };
+        };
+    }
+};
+
+} // namespace BusinessLayer
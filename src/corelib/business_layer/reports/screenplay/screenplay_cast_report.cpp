@@ -5,7 +5,8 @@
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_block_parser.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
-#include <business_layer/model/screenplay/text/screenplay_text_model_text_item.h>
+#include <business_layer/model/text/text_model_item.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/screenplay_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
@@ -119,149 +120,133 @@ void ScreenplayCastReport::build(QAbstractItemModel* _model)
     //
     // Собираем статистику
     //
-    std::function<void(const TextModelItem*)> includeInReport;
-    includeInReport = [&includeInReport, &charactersData, &lastSceneNonspeakingCharacters,
-                       &lastSceneSpeakingCharacters, &charactersOrder, &lastSpeakingCharacter,
-                       &rxCharacterFinder](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                includeInReport(childItem);
-                break;
-            }
+    const auto snapshot = d->screenplayModel->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
+        const auto paragraphType = snapshot.paragraphType(index);
+        const auto& text = snapshot.text(index);
+
+        //
+        // ... стата по объектам
+        //
+        switch (paragraphType) {
+        case TextParagraphType::SceneHeading: {
+            //
+            // Началась новая сцена
+            //
+            lastSceneNonspeakingCharacters.clear();
+            lastSceneSpeakingCharacters.clear();
+            break;
+        }
+
+        case TextParagraphType::SceneCharacters: {
+            const auto sceneCharacters = ScreenplaySceneCharactersParser::characters(text);
+            for (const auto& character : sceneCharacters) {
+                lastSceneNonspeakingCharacters.insert(character);
                 //
-                // ... стата по объектам
+                // Первое упоминание персонажа - первая молчаливая сцена
                 //
-                switch (textItem->paragraphType()) {
-                case TextParagraphType::SceneHeading: {
-                    //
-                    // Началась новая сцена
-                    //
-                    lastSceneNonspeakingCharacters.clear();
-                    lastSceneSpeakingCharacters.clear();
-                    break;
+                if (!charactersData.contains(character)) {
+                    charactersData.insert(character, { 0, 0, 0, 1 });
+                    charactersOrder.append(character);
                 }
-
-                case TextParagraphType::SceneCharacters: {
-                    const auto sceneCharacters
-                        = ScreenplaySceneCharactersParser::characters(textItem->text());
-                    for (const auto& character : sceneCharacters) {
-                        lastSceneNonspeakingCharacters.insert(character);
-                        //
-                        // Первое упоминание персонажа - первая молчаливая сцена
-                        //
-                        if (!charactersData.contains(character)) {
-                            charactersData.insert(character, { 0, 0, 0, 1 });
-                            charactersOrder.append(character);
-                        }
-                        //
-                        // Не первое упоминание - плюс одна молчаливая сцена
-                        //
-                        else {
-                            ++charactersData[character].nonspeakingScenesCount;
-                        }
-                    }
-                    break;
+                //
+                // Не первое упоминание - плюс одна молчаливая сцена
+                //
+                else {
+                    ++charactersData[character].nonspeakingScenesCount;
                 }
+            }
+            break;
+        }
 
-                case TextParagraphType::Character: {
-                    const auto character = ScreenplayCharacterParser::name(textItem->text());
-                    if (character.isEmpty()) {
-                        break;
-                    }
+        case TextParagraphType::Character: {
+            const auto character = ScreenplayCharacterParser::name(text);
+            if (character.isEmpty()) {
+                break;
+            }
 
-                    if (!charactersData.contains(character)) {
-                        charactersData.insert(character, { 1, 1, 1, 0 });
-                        charactersOrder.append(character);
-                        lastSceneSpeakingCharacters.insert(character);
-                    } else {
-                        auto& characterData = charactersData[character];
-                        if (lastSceneNonspeakingCharacters.contains(character)) {
-                            lastSceneNonspeakingCharacters.remove(character);
-                            lastSceneSpeakingCharacters.insert(character);
-                            --characterData.nonspeakingScenesCount;
-                            ++characterData.speakingScenesCount;
-                        } else if (!lastSceneSpeakingCharacters.contains(character)) {
-                            lastSceneSpeakingCharacters.insert(character);
-                            ++characterData.speakingScenesCount;
-                        }
-                        ++characterData.totalDialogues;
-                    }
-                    lastSpeakingCharacter = character;
-                    break;
+            if (!charactersData.contains(character)) {
+                charactersData.insert(character, { 1, 1, 1, 0 });
+                charactersOrder.append(character);
+                lastSceneSpeakingCharacters.insert(character);
+            } else {
+                auto& characterData = charactersData[character];
+                if (lastSceneNonspeakingCharacters.contains(character)) {
+                    lastSceneNonspeakingCharacters.remove(character);
+                    lastSceneSpeakingCharacters.insert(character);
+                    --characterData.nonspeakingScenesCount;
+                    ++characterData.speakingScenesCount;
+                } else if (!lastSceneSpeakingCharacters.contains(character)) {
+                    lastSceneSpeakingCharacters.insert(character);
+                    ++characterData.speakingScenesCount;
                 }
+                ++characterData.totalDialogues;
+            }
+            lastSpeakingCharacter = character;
+            break;
+        }
 
-                case TextParagraphType::Dialogue:
-                case TextParagraphType::Lyrics: {
-                    if (lastSpeakingCharacter.isEmpty()) {
-                        break;
-                    }
+        case TextParagraphType::Dialogue:
+        case TextParagraphType::Lyrics: {
+            if (lastSpeakingCharacter.isEmpty()) {
+                break;
+            }
 
-                    auto& characterData = charactersData[lastSpeakingCharacter];
-                    characterData.totalWords += TextHelper::wordsCount(textItem->text());
-                    break;
-                }
+            auto& characterData = charactersData[lastSpeakingCharacter];
+            characterData.totalWords += TextHelper::wordsCount(text);
+            break;
+        }
 
-                case TextParagraphType::Action: {
-                    if (rxCharacterFinder.pattern().isEmpty()) {
-                        break;
-                    }
+        case TextParagraphType::Action: {
+            if (rxCharacterFinder.pattern().isEmpty()) {
+                break;
+            }
 
-                    auto match = rxCharacterFinder.match(textItem->text());
-                    while (match.hasMatch()) {
-                        const QString character = TextHelper::smartToUpper(match.captured(2));
-                        if (!charactersData.contains(character)) {
-                            charactersData.insert(character, { 0, 0, 0, 1 });
-                            charactersOrder.append(character);
-                            lastSceneNonspeakingCharacters.insert(character);
-                        } else {
-                            //
-                            // Если он ещё не добавлен в текущую сцену
-                            //
-                            if (!lastSceneNonspeakingCharacters.contains(character)
-                                && !lastSceneSpeakingCharacters.contains(character)) {
-                                lastSceneNonspeakingCharacters.insert(character);
-                                ++charactersData[character].nonspeakingScenesCount;
-                            }
-                        }
-
-                        //
-                        // Ищем дальше
-                        //
-                        match = rxCharacterFinder.match(textItem->text(), match.capturedEnd());
+            auto match = rxCharacterFinder.match(text);
+            while (match.hasMatch()) {
+                const QString character = TextHelper::smartToUpper(match.captured(2));
+                if (!charactersData.contains(character)) {
+                    charactersData.insert(character, { 0, 0, 0, 1 });
+                    charactersOrder.append(character);
+                    lastSceneNonspeakingCharacters.insert(character);
+                } else {
+                    //
+                    // Если он ещё не добавлен в текущую сцену
+                    //
+                    if (!lastSceneNonspeakingCharacters.contains(character)
+                        && !lastSceneSpeakingCharacters.contains(character)) {
+                        lastSceneNonspeakingCharacters.insert(character);
+                        ++charactersData[character].nonspeakingScenesCount;
                     }
-                    break;
-                }
-
-                default:
-                    break;
                 }
 
                 //
-                // Очищаем последнего говорящего персонажа, если ушли из реплики
+                // Ищем дальше
                 //
-                if (!lastSpeakingCharacter.isEmpty()
-                    && textItem->paragraphType() != TextParagraphType::Character
-                    && textItem->paragraphType() != TextParagraphType::Parenthetical
-                    && textItem->paragraphType() != TextParagraphType::Dialogue
-                    && textItem->paragraphType() != TextParagraphType::Lyrics) {
-                    lastSpeakingCharacter.clear();
-                }
-
-                break;
+                match = rxCharacterFinder.match(text, match.capturedEnd());
             }
+            break;
+        }
 
-            default:
-                break;
-            }
+        default:
+            break;
         }
-    };
-    includeInReport(d->screenplayModel->itemForIndex({}));
+
+        //
+        // Очищаем последнего говорящего персонажа, если ушли из реплики
+        //
+        if (!lastSpeakingCharacter.isEmpty()
+            && paragraphType != TextParagraphType::Character
+            && paragraphType != TextParagraphType::Parenthetical
+            && paragraphType != TextParagraphType::Dialogue
+            && paragraphType != TextParagraphType::Lyrics) {
+            lastSpeakingCharacter.clear();
+        }
+    }
 
     //
     // Формируем отчёт
@@ -340,7 +325,7 @@ void ScreenplayCastReport::build(QAbstractItemModel* _model)
     // Формируем таблицу
     //
     if (d->castModel.isNull()) {
-        d->castModel.reset(new QStandardItemModel);
+        d->castModel.reset(createModel());
     } else {
         d->castModel->clear();
     }
@@ -2,7 +2,7 @@
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
 #include <3rd_party/qtxlsxwriter/xlsxrichstring.h>
-#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_block_parser.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
@@ -99,25 +99,11 @@ void ScreenplayDialoguesReport::build(QAbstractItemModel* _model)
     QSet<QString> characters;
 
     //
-    // Подготовим текстовый документ, для определения страниц сцен
+    // Подготовим постраничную раскладку, для определения страниц сцен
     //
-    const auto& screenplayTemplate
-        = TemplatesFacade::screenplayTemplate(d->screenplayModel->informationModel()->templateId());
-    PageTextEdit screenplayTextEdit;
-    screenplayTextEdit.setUsePageMode(true);
-    screenplayTextEdit.setPageSpacing(0);
-    screenplayTextEdit.setPageFormat(screenplayTemplate.pageSizeId());
-    screenplayTextEdit.setPageMarginsMm(screenplayTemplate.pageMargins());
-    ScreenplayTextDocument screenplayDocument;
-    screenplayTextEdit.setDocument(&screenplayDocument);
-    const bool kCanChangeModel = false;
-    screenplayDocument.setModel(d->screenplayModel, kCanChangeModel);
-    QTextCursor screenplayCursor(&screenplayDocument);
-    auto textItemPage = [&screenplayTextEdit, &screenplayDocument,
-                         &screenplayCursor](TextModelTextItem* _item) {
-        screenplayCursor.setPosition(
-            screenplayDocument.itemPosition(screenplayDocument.model()->indexForItem(_item), true));
-        return screenplayTextEdit.cursorPage(screenplayCursor);
+    auto pagination = PaginationService::forModel(d->screenplayModel);
+    auto textItemPage = [pagination](TextModelTextItem* _item) {
+        return pagination->pageForItem(_item);
     };
 
     //
@@ -250,7 +236,7 @@ void ScreenplayDialoguesReport::build(QAbstractItemModel* _model)
     // ... наполняем таблицу
     //
     if (d->dialoguesModel.isNull()) {
-        d->dialoguesModel.reset(new QStandardItemModel);
+        d->dialoguesModel.reset(createModel());
     } else {
         d->dialoguesModel->clear();
     }
@@ -70,17 +70,17 @@ void ScreenplayGenderReport::build(QAbstractItemModel* _model)
     // Подготовим модели к наполнению
     //
     if (d->scenesInfoModel.isNull()) {
-        d->scenesInfoModel.reset(new QStandardItemModel);
+        d->scenesInfoModel.reset(createModel());
     } else {
         d->scenesInfoModel->clear();
     }
     if (d->dialoguesInfoModel.isNull()) {
-        d->dialoguesInfoModel.reset(new QStandardItemModel);
+        d->dialoguesInfoModel.reset(createModel());
     } else {
         d->dialoguesInfoModel->clear();
     }
     if (d->charactersInfoModel.isNull()) {
-        d->charactersInfoModel.reset(new QStandardItemModel);
+        d->charactersInfoModel.reset(createModel());
     } else {
         d->charactersInfoModel->clear();
     }
@@ -1,11 +1,12 @@
 #include "screenplay_summary_report.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/text/screenplay_text_block_parser.h>
 #include <business_layer/model/screenplay/text/screenplay_text_model.h>
-#include <business_layer/model/screenplay/text/screenplay_text_model_text_item.h>
+#include <business_layer/model/text/text_model_item.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <business_layer/templates/screenplay_template.h>
 #include <business_layer/templates/templates_facade.h>
 #include <ui/widgets/text_edit/page/page_text_edit.h>
@@ -116,98 +117,81 @@ void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
     //
     // Собираем статистику
     //
-    std::function<void(const TextModelItem*)> includeInReport;
-    includeInReport = [&includeInReport, &paragraphsToCounters, &totalWords, &totalCharacters,
-                       &scenes, &charactersToDialogues,
-                       &rxCharacterFinder](const TextModelItem* _item) {
-        for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-            auto childItem = _item->childAt(childIndex);
-            switch (childItem->type()) {
-            case TextModelItemType::Folder:
-            case TextModelItemType::Group: {
-                includeInReport(childItem);
-                break;
-            }
+    const auto snapshot = d->screenplayModel->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
 
-            case TextModelItemType::Text: {
-                auto textItem = static_cast<ScreenplayTextModelTextItem*>(childItem);
-                //
-                // ... счётчики
-                //
-                if (paragraphsToCounters.contains(textItem->paragraphType())) {
-                    auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
-                    ++paragraphCounters.occurrences;
-                    const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                    paragraphCounters.words += paragraphWords;
-                    totalWords += paragraphWords;
-                    totalCharacters.withSpaces += textItem->text().length();
-                    totalCharacters.withoutSpaces
-                        += textItem->text().length() - textItem->text().count(' ');
-                }
+        const auto paragraphType = snapshot.paragraphType(index);
+        const auto& text = snapshot.text(index);
 
-                //
-                // ... стата по объектам
-                //
-                switch (textItem->paragraphType()) {
-                case TextParagraphType::SceneHeading: {
-                    scenes.append(TextHelper::smartToUpper(textItem->text()));
-                    break;
-                }
-
-                case TextParagraphType::SceneCharacters: {
-                    const auto sceneCharacters
-                        = ScreenplaySceneCharactersParser::characters(textItem->text());
-                    for (const auto& character : sceneCharacters) {
-                        if (!charactersToDialogues.contains(character)) {
-                            charactersToDialogues.insert(character, 0);
-                        }
-                    }
-                    break;
-                }
+        //
+        // ... счётчики
+        //
+        if (paragraphsToCounters.contains(paragraphType)) {
+            auto& paragraphCounters = paragraphsToCounters[paragraphType];
+            ++paragraphCounters.occurrences;
+            const auto paragraphWords = TextHelper::wordsCount(text);
+            paragraphCounters.words += paragraphWords;
+            totalWords += paragraphWords;
+            totalCharacters.withSpaces += text.length();
+            totalCharacters.withoutSpaces += text.length() - text.count(' ');
+        }
 
-                case TextParagraphType::Character: {
-                    const auto character = ScreenplayCharacterParser::name(textItem->text());
-                    if (!charactersToDialogues.contains(character)) {
-                        charactersToDialogues.insert(character, 1);
-                    } else {
-                        ++charactersToDialogues[character];
-                    }
-                    break;
-                }
+        //
+        // ... стата по объектам
+        //
+        switch (paragraphType) {
+        case TextParagraphType::SceneHeading: {
+            scenes.append(TextHelper::smartToUpper(text));
+            break;
+        }
 
-                case TextParagraphType::Action: {
-                    if (rxCharacterFinder.pattern().isEmpty()) {
-                        break;
-                    }
-
-                    auto match = rxCharacterFinder.match(textItem->text());
-                    while (match.hasMatch()) {
-                        const QString character = TextHelper::smartToUpper(match.captured(2));
-                        if (!charactersToDialogues.contains(character)) {
-                            charactersToDialogues.insert(character, 0);
-                        }
-
-                        //
-                        // Ищем дальше
-                        //
-                        match = rxCharacterFinder.match(textItem->text(), match.capturedEnd());
-                    }
-                    break;
+        case TextParagraphType::SceneCharacters: {
+            const auto sceneCharacters = ScreenplaySceneCharactersParser::characters(text);
+            for (const auto& character : sceneCharacters) {
+                if (!charactersToDialogues.contains(character)) {
+                    charactersToDialogues.insert(character, 0);
                 }
+            }
+            break;
+        }
 
-                default:
-                    break;
-                }
+        case TextParagraphType::Character: {
+            const auto character = ScreenplayCharacterParser::name(text);
+            if (!charactersToDialogues.contains(character)) {
+                charactersToDialogues.insert(character, 1);
+            } else {
+                ++charactersToDialogues[character];
+            }
+            break;
+        }
 
+        case TextParagraphType::Action: {
+            if (rxCharacterFinder.pattern().isEmpty()) {
                 break;
             }
 
-            default:
-                break;
+            auto match = rxCharacterFinder.match(text);
+            while (match.hasMatch()) {
+                const QString character = TextHelper::smartToUpper(match.captured(2));
+                if (!charactersToDialogues.contains(character)) {
+                    charactersToDialogues.insert(character, 0);
+                }
+
+                //
+                // Ищем дальше
+                //
+                match = rxCharacterFinder.match(text, match.capturedEnd());
             }
+            break;
         }
-    };
-    includeInReport(d->screenplayModel->itemForIndex({}));
+
+        default:
+            break;
+        }
+    }
 
     //
     // Формируем отчёт
@@ -227,30 +211,14 @@ void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
     //
     {
         d->duration = d->screenplayModel->duration();
-        d->pagesCount = [this] {
-            const auto& screenplayTemplate = TemplatesFacade::screenplayTemplate(
-                d->screenplayModel->informationModel()->templateId());
-
-            PageTextEdit textEdit;
-            textEdit.setUsePageMode(true);
-            textEdit.setPageSpacing(0);
-            textEdit.setPageFormat(screenplayTemplate.pageSizeId());
-            textEdit.setPageMarginsMm(screenplayTemplate.pageMargins());
-            ScreenplayTextDocument screenplayDocument;
-            textEdit.setDocument(&screenplayDocument);
-
-            const bool kCanChangeModel = false;
-            screenplayDocument.setModel(d->screenplayModel, kCanChangeModel);
-
-            return screenplayDocument.pageCount();
-        }();
+        d->pagesCount = PaginationService::forModel(d->screenplayModel)->pageCount();
         d->wordsCount = totalWords;
         d->charactersCount = totalCharacters;
         //
         // ... иформация по тексту
         //
         if (d->textInfoModel.isNull()) {
-            d->textInfoModel.reset(new QStandardItemModel);
+            d->textInfoModel.reset(createModel());
         } else {
             d->textInfoModel->clear();
         }
@@ -312,7 +280,7 @@ void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->scenesInfoModel.isNull()) {
-            d->scenesInfoModel.reset(new QStandardItemModel);
+            d->scenesInfoModel.reset(createModel());
         } else {
             d->scenesInfoModel->clear();
         }
@@ -373,7 +341,7 @@ void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->locationsInfoModel.isNull()) {
-            d->locationsInfoModel.reset(new QStandardItemModel);
+            d->locationsInfoModel.reset(createModel());
         } else {
             d->locationsInfoModel->clear();
         }
@@ -433,7 +401,7 @@ void ScreenplaySummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->charactersInfoModel.isNull()) {
-            d->charactersInfoModel.reset(new QStandardItemModel);
+            d->charactersInfoModel.reset(createModel());
         } else {
             d->charactersInfoModel->clear();
         }
@@ -1,7 +1,7 @@
 #include "screenplay_series_location_report.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/series/screenplay_series_episodes_model.h>
 #include <business_layer/model/screenplay/series/screenplay_series_information_model.h>
@@ -82,7 +82,7 @@ void ScreenplaySeriesLocationReport::build(QAbstractItemModel* _model)
     // Подготовим модель к наполнению
     //
     if (d->locationModel.isNull()) {
-        d->locationModel.reset(new QStandardItemModel);
+        d->locationModel.reset(createModel());
     } else {
         d->locationModel->clear();
     }
@@ -156,25 +156,11 @@ void ScreenplaySeriesLocationReport::build(QAbstractItemModel* _model)
         const auto sceneNumberPrefix
             = needToAddEpisodeNumber ? QString("%1.").arg(episodeNumber++) : "";
         //
-        // Подготовим текстовый документ, для определения страниц сцен
+        // Подготовим постраничную раскладку, для определения страниц сцен
         //
-        const auto& screenplayTemplate
-            = TemplatesFacade::screenplayTemplate(episode->informationModel()->templateId());
-        PageTextEdit screenplayTextEdit;
-        screenplayTextEdit.setUsePageMode(true);
-        screenplayTextEdit.setPageSpacing(0);
-        screenplayTextEdit.setPageFormat(screenplayTemplate.pageSizeId());
-        screenplayTextEdit.setPageMarginsMm(screenplayTemplate.pageMargins());
-        ScreenplayTextDocument screenplayDocument;
-        screenplayTextEdit.setDocument(&screenplayDocument);
-        const bool kCanChangeModel = false;
-        screenplayDocument.setModel(episode, kCanChangeModel);
-        QTextCursor screenplayCursor(&screenplayDocument);
-        auto textItemPage = [&screenplayTextEdit, &screenplayDocument,
-                             &screenplayCursor](TextModelTextItem* _item) {
-            screenplayCursor.setPosition(screenplayDocument.itemPosition(
-                screenplayDocument.model()->indexForItem(_item), true));
-            return screenplayTextEdit.cursorPage(screenplayCursor);
+        auto pagination = PaginationService::forModel(episode);
+        auto textItemPage = [pagination](TextModelTextItem* _item) {
+            return pagination->pageForItem(_item);
         };
 
         //
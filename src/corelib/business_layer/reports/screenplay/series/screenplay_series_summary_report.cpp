@@ -1,7 +1,7 @@
 #include "screenplay_series_summary_report.h"
 
 #include <3rd_party/qtxlsxwriter/xlsxdocument.h>
-#include <business_layer/document/screenplay/text/screenplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/screenplay/screenplay_information_model.h>
 #include <business_layer/model/screenplay/series/screenplay_series_episodes_model.h>
 #include <business_layer/model/screenplay/series/screenplay_series_information_model.h>
@@ -240,23 +240,7 @@ void ScreenplaySeriesSummaryReport::build(QAbstractItemModel* _model)
         d->pagesCount = {};
         for (const auto episode : d->episodesModel->episodes()) {
             d->duration += episode->duration();
-            d->pagesCount += [episode] {
-                const auto& screenplayTemplate = TemplatesFacade::screenplayTemplate(
-                    episode->informationModel()->templateId());
-
-                PageTextEdit textEdit;
-                textEdit.setUsePageMode(true);
-                textEdit.setPageSpacing(0);
-                textEdit.setPageFormat(screenplayTemplate.pageSizeId());
-                textEdit.setPageMarginsMm(screenplayTemplate.pageMargins());
-                ScreenplayTextDocument screenplayDocument;
-                textEdit.setDocument(&screenplayDocument);
-
-                const bool kCanChangeModel = false;
-                screenplayDocument.setModel(episode, kCanChangeModel);
-
-                return screenplayDocument.pageCount();
-            }();
+            d->pagesCount += PaginationService::forModel(episode)->pageCount();
         }
         d->wordsCount = totalWords;
         d->charactersCount = totalCharacters;
@@ -264,7 +248,7 @@ void ScreenplaySeriesSummaryReport::build(QAbstractItemModel* _model)
         // ... иформация по тексту
         //
         if (d->textInfoModel.isNull()) {
-            d->textInfoModel.reset(new QStandardItemModel);
+            d->textInfoModel.reset(createModel());
         } else {
             d->textInfoModel->clear();
         }
@@ -326,7 +310,7 @@ void ScreenplaySeriesSummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->scenesInfoModel.isNull()) {
-            d->scenesInfoModel.reset(new QStandardItemModel);
+            d->scenesInfoModel.reset(createModel());
         } else {
             d->scenesInfoModel->clear();
         }
@@ -387,7 +371,7 @@ void ScreenplaySeriesSummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->locationsInfoModel.isNull()) {
-            d->locationsInfoModel.reset(new QStandardItemModel);
+            d->locationsInfoModel.reset(createModel());
         } else {
             d->locationsInfoModel->clear();
         }
@@ -447,7 +431,7 @@ void ScreenplaySeriesSummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->charactersInfoModel.isNull()) {
-            d->charactersInfoModel.reset(new QStandardItemModel);
+            d->charactersInfoModel.reset(createModel());
         } else {
             d->charactersInfoModel->clear();
         }
@@ -1,12 +1,10 @@
 #include "stageplay_summary_report.h"
 
-#include <business_layer/document/stageplay/text/stageplay_text_document.h>
+#include <business_layer/document/text/pagination_service.h>
 #include <business_layer/model/stageplay/stageplay_information_model.h>
 #include <business_layer/model/stageplay/text/stageplay_text_model.h>
-#include <business_layer/model/text/text_model_text_item.h>
-#include <business_layer/templates/stageplay_template.h>
-#include <business_layer/templates/templates_facade.h>
-#include <ui/widgets/text_edit/page/page_text_edit.h>
+#include <business_layer/model/text/text_model_item.h>
+#include <business_layer/model/text/text_model_snapshot.h>
 #include <utils/helpers/text_helper.h>
 
 #include <QCoreApplication>
@@ -112,71 +110,55 @@ void StageplaySummaryReport::build(QAbstractItemModel* _model)
     //
     // Собираем статистику
     //
-    std::function<void(const TextModelItem*)> includeInReport;
-    includeInReport
-        = [&includeInReport, &paragraphsToCounters, &totalWords, &totalCharacters, &scenes,
-           &charactersToDialogues, &lastCharacter](const TextModelItem* _item) {
-              for (int childIndex = 0; childIndex < _item->childCount(); ++childIndex) {
-                  auto childItem = _item->childAt(childIndex);
-                  switch (childItem->type()) {
-                  case TextModelItemType::Folder:
-                  case TextModelItemType::Group: {
-                      includeInReport(childItem);
-                      break;
-                  }
-
-                  case TextModelItemType::Text: {
-                      auto textItem = static_cast<TextModelTextItem*>(childItem);
-                      //
-                      // ... счётчики
-                      //
-                      if (paragraphsToCounters.contains(textItem->paragraphType())) {
-                          auto& paragraphCounters = paragraphsToCounters[textItem->paragraphType()];
-                          ++paragraphCounters.occurrences;
-                          const auto paragraphWords = TextHelper::wordsCount(textItem->text());
-                          paragraphCounters.words += paragraphWords;
-                          totalWords += paragraphWords;
-                          totalCharacters.withSpaces += textItem->text().length();
-                          totalCharacters.withoutSpaces
-                              += textItem->text().length() - textItem->text().count(' ');
-                      }
-
-                      //
-                      // ... стата по объектам
-                      //
-                      switch (textItem->paragraphType()) {
-                      case TextParagraphType::SceneHeading: {
-                          scenes.append(TextHelper::smartToUpper(textItem->text()));
-                          break;
-                      }
-
-                      case TextParagraphType::Character: {
-                          lastCharacter = textItem->text();
-                          if (!charactersToDialogues.contains(lastCharacter)) {
-                              charactersToDialogues.insert(lastCharacter, 0);
-                          }
-                          break;
-                      }
-
-                      case TextParagraphType::Dialogue: {
-                          charactersToDialogues[lastCharacter] += 1;
-                          break;
-                      }
-
-                      default:
-                          break;
-                      }
-
-                      break;
-                  }
-
-                  default:
-                      break;
-                  }
-              }
-          };
     auto stageplayModel = static_cast<StageplayTextModel*>(_model);
-    includeInReport(stageplayModel->itemForIndex({}));
+    const auto snapshot = stageplayModel->snapshot();
+    for (int index = 0; index < snapshot.size(); ++index) {
+        if (snapshot.type(index) != TextModelItemType::Text) {
+            continue;
+        }
+
+        const auto paragraphType = snapshot.paragraphType(index);
+        const auto& text = snapshot.text(index);
+
+        //
+        // ... счётчики
+        //
+        if (paragraphsToCounters.contains(paragraphType)) {
+            auto& paragraphCounters = paragraphsToCounters[paragraphType];
+            ++paragraphCounters.occurrences;
+            const auto paragraphWords = TextHelper::wordsCount(text);
+            paragraphCounters.words += paragraphWords;
+            totalWords += paragraphWords;
+            totalCharacters.withSpaces += text.length();
+            totalCharacters.withoutSpaces += text.length() - text.count(' ');
+        }
+
+        //
+        // ... стата по объектам
+        //
+        switch (paragraphType) {
+        case TextParagraphType::SceneHeading: {
+            scenes.append(TextHelper::smartToUpper(text));
+            break;
+        }
+
+        case TextParagraphType::Character: {
+            lastCharacter = text;
+            if (!charactersToDialogues.contains(lastCharacter)) {
+                charactersToDialogues.insert(lastCharacter, 0);
+            }
+            break;
+        }
+
+        case TextParagraphType::Dialogue: {
+            charactersToDialogues[lastCharacter] += 1;
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
 
     //
     // Формируем отчёт
@@ -195,30 +177,14 @@ void StageplaySummaryReport::build(QAbstractItemModel* _model)
     // ... сводка
     //
     {
-        d->pagesCount = [stageplayModel] {
-            const auto& stageplayTemplate = TemplatesFacade::stageplayTemplate(
-                stageplayModel->informationModel()->templateId());
-
-            PageTextEdit textEdit;
-            textEdit.setUsePageMode(true);
-            textEdit.setPageSpacing(0);
-            textEdit.setPageFormat(stageplayTemplate.pageSizeId());
-            textEdit.setPageMarginsMm(stageplayTemplate.pageMargins());
-            StageplayTextDocument stageplayDocument;
-            textEdit.setDocument(&stageplayDocument);
-
-            const bool kCanChangeModel = false;
-            stageplayDocument.setModel(stageplayModel, kCanChangeModel);
-
-            return stageplayDocument.pageCount();
-        }();
+        d->pagesCount = PaginationService::forModel(stageplayModel)->pageCount();
         d->wordsCount = totalWords;
         d->charactersCount = totalCharacters;
         //
         // ... иформация по тексту
         //
         if (d->textInfoModel.isNull()) {
-            d->textInfoModel.reset(new QStandardItemModel);
+            d->textInfoModel.reset(createModel());
         } else {
             d->textInfoModel->clear();
         }
@@ -279,7 +245,7 @@ void StageplaySummaryReport::build(QAbstractItemModel* _model)
         // Формируем таблицу
         //
         if (d->charactersInfoModel.isNull()) {
-            d->charactersInfoModel.reset(new QStandardItemModel);
+            d->charactersInfoModel.reset(createModel());
         } else {
             d->charactersInfoModel->clear();
         }
@@ -179,6 +179,7 @@ SOURCES += \
     business_layer/document/stageplay/text/stageplay_text_corrector.cpp \
     business_layer/document/stageplay/text/stageplay_text_document.cpp \
     business_layer/document/text/abstract_text_corrector.cpp \
+    business_layer/document/text/pagination_service.cpp \
     business_layer/document/text/text_block_data.cpp \
     business_layer/document/text/text_cursor.cpp \
     business_layer/document/text/text_document.cpp \
@@ -290,6 +291,7 @@ SOURCES += \
     business_layer/model/novel/text/novel_text_model_text_item.cpp \
     business_layer/model/presentation/presentation_model.cpp \
     business_layer/model/project/project_information_model.cpp \
+    business_layer/model/project/project_models_facade.cpp \
     business_layer/model/recycle_bin/recycle_bin_model.cpp \
     business_layer/model/screenplay/screenplay_dictionaries_model.cpp \
     business_layer/model/screenplay/screenplay_information_model.cpp \
@@ -324,6 +326,7 @@ SOURCES += \
     business_layer/model/text/text_model_folder_item.cpp \
     business_layer/model/text/text_model_group_item.cpp \
     business_layer/model/text/text_model_item.cpp \
+    business_layer/model/text/text_model_snapshot.cpp \
     business_layer/model/text/text_model_splitter_item.cpp \
     business_layer/model/text/text_model_text_item.cpp \
     business_layer/model/text/text_model_xml_writer.cpp \
@@ -345,6 +348,7 @@ SOURCES += \
     business_layer/reports/audioplay/audioplay_summary_report.cpp \
     business_layer/reports/comic_book/comic_book_summary_report.cpp \
     business_layer/reports/novel/novel_summary_report.cpp \
+    business_layer/reports/reports_builder.cpp \
     business_layer/reports/screenplay/screenplay_cast_report.cpp \
     business_layer/reports/screenplay/screenplay_dialogues_report.cpp \
     business_layer/reports/screenplay/screenplay_gender_report.cpp \
@@ -375,6 +379,7 @@ SOURCES += \
     data_layer/storage/document_image_storage.cpp \
     data_layer/storage/document_raw_data_storage.cpp \
     data_layer/storage/document_storage.cpp \
+    data_layer/storage/search_index_storage.cpp \
     data_layer/storage/settings_storage.cpp \
     data_layer/storage/storage_facade.cpp \
     domain/document_change_object.cpp \
@@ -416,6 +421,7 @@ SOURCES += \
     ui/modules/promo_widget/module_promo_widget.cpp \
     ui/modules/script_text_edit/script_text_edit.cpp \
     ui/modules/search_toolbar/search_manager.cpp \
+    ui/modules/search_toolbar/search_results_model.cpp \
     ui/modules/search_toolbar/search_toolbar.cpp \
     ui/widgets/animations/click_animation.cpp \
     ui/widgets/app_bar/app_bar.cpp \
@@ -520,6 +526,7 @@ SOURCES += \
     utils/tools/alphanum_comparer.cpp \
     utils/tools/backup_builder.cpp \
     utils/tools/debouncer.cpp \
+    utils/tools/memory_pool.cpp \
     utils/tools/model_index_path.cpp \
     utils/tools/run_once.cpp \
     utils/validators/email_validator.cpp
@@ -539,6 +546,7 @@ HEADERS += \
     business_layer/document/stageplay/text/stageplay_text_corrector.h \
     business_layer/document/stageplay/text/stageplay_text_document.h \
     business_layer/document/text/abstract_text_corrector.h \
+    business_layer/document/text/pagination_service.h \
     business_layer/document/text/text_block_data.h \
     business_layer/document/text/text_cursor.h \
     business_layer/document/text/text_document.h \
@@ -669,6 +677,7 @@ HEADERS += \
     business_layer/model/novel/text/novel_text_model_text_item.h \
     business_layer/model/presentation/presentation_model.h \
     business_layer/model/project/project_information_model.h \
+    business_layer/model/project/project_models_facade.h \
     business_layer/model/recycle_bin/recycle_bin_model.h \
     business_layer/model/screenplay/screenplay_dictionaries_model.h \
     business_layer/model/screenplay/screenplay_information_model.h \
@@ -703,6 +712,7 @@ HEADERS += \
     business_layer/model/text/text_model_folder_item.h \
     business_layer/model/text/text_model_group_item.h \
     business_layer/model/text/text_model_item.h \
+    business_layer/model/text/text_model_snapshot.h \
     business_layer/model/text/text_model_splitter_item.h \
     business_layer/model/text/text_model_text_item.h \
     business_layer/model/text/text_model_xml.h \
@@ -726,6 +736,7 @@ HEADERS += \
     business_layer/reports/audioplay/audioplay_summary_report.h \
     business_layer/reports/comic_book/comic_book_summary_report.h \
     business_layer/reports/novel/novel_summary_report.h \
+    business_layer/reports/reports_builder.h \
     business_layer/reports/screenplay/screenplay_cast_report.h \
     business_layer/reports/screenplay/screenplay_dialogues_report.h \
     business_layer/reports/screenplay/screenplay_gender_report.h \
@@ -757,6 +768,7 @@ HEADERS += \
     data_layer/storage/document_image_storage.h \
     data_layer/storage/document_raw_data_storage.h \
     data_layer/storage/document_storage.h \
+    data_layer/storage/search_index_storage.h \
     data_layer/storage/settings_storage.h \
     data_layer/storage/storage_facade.h \
     domain/document_change_object.h \
@@ -800,6 +812,7 @@ HEADERS += \
     ui/modules/promo_widget/module_promo_widget.h \
     ui/modules/script_text_edit/script_text_edit.h \
     ui/modules/search_toolbar/search_manager.h \
+    ui/modules/search_toolbar/search_results_model.h \
     ui/modules/search_toolbar/search_toolbar.h \
     ui/widgets/animations/click_animation.h \
     ui/widgets/app_bar/app_bar.h \
@@ -912,6 +925,7 @@ HEADERS += \
     utils/tools/alphanum_comparer.h \
     utils/tools/backup_builder.h \
     utils/tools/debouncer.h \
+    utils/tools/memory_pool.h \
     utils/tools/model_index_path.h \
     utils/tools/once.h \
     utils/tools/run_once.h \
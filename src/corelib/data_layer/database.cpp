@@ -2,11 +2,21 @@
 
 #include <QApplication>
 #include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QQueue>
+#include <QRegularExpression>
+#include <QSet>
 #include <QSqlDatabase>
+#include <QSqlError>
 #include <QSqlQuery>
 #include <QSqlRecord>
+#include <QStorageInfo>
 #include <QStringList>
+#include <QThread>
 #include <QVariant>
+#include <QWaitCondition>
 
 namespace DatabaseLayer {
 
@@ -41,6 +51,206 @@ static QString s_lastError;
  */
 static int s_openedTransactions = 0;
 
+/**
+ * @brief Параметры работы с файлом проекта
+ */
+static Database::StorageProfile s_storageProfile;
+
+/**
+ * @brief Номер текущего соединения с базой данных
+ */
+static int s_connectionNumber = 0;
+
+/**
+ * @brief Находится ли файл там, где журнал упреждающей записи небезопасен
+ * @note Журнал требует разделяемой памяти и блокировок, которые не работают на сетевых дисках, а
+ *       сервисы синхронизации могут выгрузить основной файл без журнала, поэтому для таких мест
+ *       используется обычный журнал отката с полной синхронизацией
+ */
+static bool isUnsafeLocation(const QString& _databaseName)
+{
+    if (_databaseName.isEmpty() || _databaseName == ":memory:") {
+        return false;
+    }
+
+    const QFileInfo fileInfo(_databaseName);
+    const auto path = QDir::fromNativeSeparators(fileInfo.absoluteFilePath());
+    if (path.startsWith("//")) {
+        return true;
+    }
+
+    const QStorageInfo storage(fileInfo.absolutePath());
+    const auto fileSystemType = QString::fromLatin1(storage.fileSystemType()).toLower();
+    const QStringList networkFileSystems = {
+        "nfs", "nfs4", "cifs", "smbfs", "smb2", "smb3", "afpfs", "webdav", "davfs", "fuse.sshfs",
+    };
+    if (networkFileSystems.contains(fileSystemType)
+        || QDir::fromNativeSeparators(QString::fromLocal8Bit(storage.device())).startsWith("//")) {
+        return true;
+    }
+
+    const QStringList syncedFolders = {
+        "/Dropbox/",      "/OneDrive",   "/Google Drive/", "/GoogleDrive/", "/Mobile Documents/",
+        "/iCloud Drive/", "/Yandex.Disk", "/YandexDisk",   "/pCloud Drive/", "/Nextcloud/",
+        "/ownCloud/",
+    };
+    for (const auto& folder : syncedFolders) {
+        if (path.contains(folder, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Получить параметры работы с заданным файлом
+ */
+static Database::StorageProfile storageProfileFor(const QString& _databaseName)
+{
+    auto profile = s_storageProfile;
+    if (isUnsafeLocation(_databaseName)) {
+        profile.useWriteAheadLog = false;
+        profile.isFullSynchronous = true;
+        profile.mmapSize = 0;
+    }
+    return profile;
+}
+
+/**
+ * @brief Применить параметры работы к соединению
+ */
+static void applyStorageProfile(QSqlDatabase& _database)
+{
+    const auto profile = storageProfileFor(_database.databaseName());
+    QSqlQuery query(_database);
+    query.exec(
+        QString("PRAGMA journal_mode = %1").arg(profile.useWriteAheadLog ? "WAL" : "DELETE"));
+    query.exec(
+        QString("PRAGMA synchronous = %1").arg(profile.isFullSynchronous ? "FULL" : "NORMAL"));
+    //
+    // Отрицательное значение задаёт размер кэша в килобайтах, а не в страницах
+    //
+    query.exec(QString("PRAGMA cache_size = -%1").arg(profile.cacheSize));
+    query.exec(QString("PRAGMA mmap_size = %1").arg(profile.mmapSize));
+    query.exec("PRAGMA temp_store = MEMORY");
+}
+
+/**
+ * @brief Запрос на запись вместе со значениями параметров
+ */
+struct WriteQuery {
+    QString statement;
+    QVariantList values;
+
+    /**
+     * @brief Обработчик успешной записи запроса
+     */
+    std::function<void()> writtenCallback;
+};
+
+/**
+ * @brief Пакет запросов на запись, выполняемых одной транзакцией
+ */
+struct WriteBatch {
+    QString databaseName;
+    QVector<WriteQuery> queries;
+    std::function<void()> callback;
+
+    /**
+     * @brief Таблицы, которые изменяются запросами пакета
+     */
+    QSet<QString> tables;
+
+    /**
+     * @brief Текст ошибки записи, если она произошла
+     */
+    QString error;
+};
+
+/**
+ * @brief Идёт ли накопление запросов на запись и накопленные запросы
+ */
+static bool s_isAsyncWriting = false;
+static QVector<WriteQuery> s_asyncWriteQueries;
+
+/**
+ * @brief Количество транзакций, открытых во время накопления запросов
+ * @note Накопленные запросы и так выполняются одной транзакцией в фоновом потоке, поэтому такие
+ *       транзакции в основном соединении не открываются
+ */
+static int s_asyncTransactions = 0;
+
+/**
+ * @brief Запросы пакетов, запись которых не удалась, для повтора вместе со следующим пакетом
+ */
+static QVector<WriteQuery> s_failedWriteQueries;
+
+/**
+ * @brief Поток фоновой записи
+ */
+static QThread* s_asyncWriter = nullptr;
+
+/**
+ * @brief Очереди пакетов на запись и записанных пакетов, разделяемые с потоком записи
+ */
+static QMutex s_asyncWriterMutex;
+static QWaitCondition s_asyncWriterCondition;
+static QQueue<WriteBatch> s_batchesToWrite;
+static QQueue<WriteBatch> s_writtenBatches;
+static bool s_isAsyncWriterStopRequested = false;
+static bool s_isAsyncWriterFailed = false;
+
+/**
+ * @brief Выполнить пакет запросов одной транзакцией
+ * @return Текст ошибки, если запись не удалась
+ */
+static QString writeBatch(QSqlDatabase& _database, const WriteBatch& _batch)
+{
+    if (!_database.transaction()) {
+        return _database.lastError().text();
+    }
+
+    QSqlQuery query(_database);
+    for (const auto& writeQuery : _batch.queries) {
+        query.prepare(writeQuery.statement);
+        for (const auto& value : writeQuery.values) {
+            query.addBindValue(value);
+        }
+        if (!query.exec()) {
+            const auto error = query.lastError().text();
+            _database.rollback();
+            return error;
+        }
+    }
+
+    if (!_database.commit()) {
+        const auto error = _database.lastError().text();
+        _database.rollback();
+        return error;
+    }
+
+    return {};
+}
+
+/**
+ * @brief Определить таблицы, которые затрагивает запрос на запись
+ * @note Таблицы из вложенных выборок тоже попадают в список, что лишь делает ожидание записи
+ *       более осторожным
+ */
+static QSet<QString> statementTables(const QString& _statement)
+{
+    static const QRegularExpression kTableExpression(
+        "\\b(?:INTO|UPDATE|FROM)\\s+\"?(\\w+)", QRegularExpression::CaseInsensitiveOption);
+
+    QSet<QString> tables;
+    auto match = kTableExpression.globalMatch(_statement);
+    while (match.hasNext()) {
+        tables.insert(match.next().captured(1).toLower());
+    }
+    return tables;
+}
+
 /**
  * @brief Получить ключ хранения номера версии приложения
  */
@@ -106,9 +316,15 @@ void Database::setLastError(const QString& _error)
 void Database::setCurrentFile(const QString& _databaseFileName)
 {
     //
-    // Если использовалась база данных, то удалим старое соединение
+    // Если использовалась база данных, то удалим старое соединение, сохранив запросы, которые не
+    // удалось записать, на случай повторного открытия того же файла
     //
+    stopAsyncWriter();
+    const auto failedWriteQueries = s_databaseName == _databaseFileName
+        ? s_failedWriteQueries
+        : QVector<WriteQuery>();
     closeCurrentFile();
+    s_failedWriteQueries = failedWriteQueries;
 
     //
     // Установим текущее имя базы данных
@@ -126,11 +342,27 @@ void Database::setCurrentFile(const QString& _databaseFileName)
 
 void Database::closeCurrentFile()
 {
+    //
+    // Дописываем все отправленные пакеты, а запросы, которые записать не удалось, сбрасываем
+    //
+    stopAsyncWriter();
+    s_failedWriteQueries.clear();
+
     if (QSqlDatabase::contains(s_connectionName)) {
+        //
+        // Переносим журнал в основной файл, чтобы закрытый проект был одним файлом
+        //
+        checkpoint();
+        QSqlDatabase::database(s_connectionName).close();
         QSqlDatabase::removeDatabase(s_connectionName);
     }
 }
 
+void Database::setStorageProfile(const StorageProfile& _profile)
+{
+    s_storageProfile = _profile;
+}
+
 QString Database::currentFile()
 {
     return instanse().databaseName();
@@ -141,12 +373,58 @@ QSqlQuery Database::query()
     return QSqlQuery(instanse());
 }
 
+int Database::connectionNumber()
+{
+    instanse();
+    return s_connectionNumber;
+}
+
+void Database::waitForPendingWrites(const QString& _table)
+{
+    const auto table = _table.toLower();
+    auto hasPendingWrites = [&table] {
+        if (table.isEmpty()) {
+            return !s_batchesToWrite.isEmpty();
+        }
+
+        for (const auto& batch : std::as_const(s_batchesToWrite)) {
+            if (batch.tables.contains(table)) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    QMutexLocker locker(&s_asyncWriterMutex);
+    while (hasPendingWrites()) {
+        s_asyncWriterCondition.wait(&s_asyncWriterMutex);
+    }
+}
+
+void Database::checkpoint()
+{
+    if (!storageProfileFor(s_databaseName).useWriteAheadLog) {
+        return;
+    }
+
+    waitForPendingWrites();
+    auto query = Database::query();
+    query.exec("PRAGMA wal_checkpoint(TRUNCATE)");
+}
+
 void Database::transaction()
 {
+    if (s_isAsyncWriting && s_openedTransactions == 0) {
+        ++s_asyncTransactions;
+        return;
+    }
+
     //
-    // Для первого запроса открываем транзакцию
+    // Для первого запроса открываем транзакцию, дождавшись фоновой записи, чтобы изменения в
+    // основном соединении не обгоняли уже отправленные на запись
     //
     if (s_openedTransactions == 0) {
+        waitForPendingWrites();
         instanse().transaction();
     }
 
@@ -158,6 +436,11 @@ void Database::transaction()
 
 void Database::commit()
 {
+    if (s_asyncTransactions > 0) {
+        --s_asyncTransactions;
+        return;
+    }
+
     //
     // Уменьшаем счётчик транзакций
     //
@@ -173,6 +456,14 @@ void Database::commit()
 
 void Database::rollback()
 {
+    //
+    // ... запросы, накопленные для фоновой записи, откатываются вместе со всем пакетом
+    //
+    if (s_asyncTransactions > 0) {
+        --s_asyncTransactions;
+        return;
+    }
+
     //
     // Уменьшаем счётчик транзакций
     //
@@ -186,14 +477,216 @@ void Database::rollback()
     }
 }
 
+void Database::beginAsyncWriting()
+{
+    Q_ASSERT(!s_isAsyncWriting);
+
+    s_isAsyncWriting = true;
+    s_asyncWriteQueries.clear();
+}
+
+void Database::endAsyncWriting(const std::function<void()>& _callback)
+{
+    Q_ASSERT(s_isAsyncWriting);
+
+    s_isAsyncWriting = false;
+    Q_ASSERT(s_asyncTransactions == 0);
+
+    //
+    // Если запись предыдущего пакета не удалась, то дожидаемся завершения остальных пакетов,
+    // чтобы повторить их запросы в исходном порядке перед запросами нового пакета
+    //
+    bool isAsyncWriterFailed = false;
+    {
+        QMutexLocker locker(&s_asyncWriterMutex);
+        isAsyncWriterFailed = s_isAsyncWriterFailed;
+    }
+    if (isAsyncWriterFailed) {
+        waitForAsyncWriting();
+        QMutexLocker locker(&s_asyncWriterMutex);
+        s_isAsyncWriterFailed = false;
+    }
+
+    WriteBatch batch;
+    batch.databaseName = s_databaseName;
+    batch.queries = s_failedWriteQueries + s_asyncWriteQueries;
+    batch.callback = _callback;
+    for (const auto& query : std::as_const(batch.queries)) {
+        batch.tables.unite(statementTables(query.statement));
+    }
+    s_failedWriteQueries.clear();
+    s_asyncWriteQueries.clear();
+
+    //
+    // Если писать нечего, то сразу уведомляем о завершении
+    //
+    if (batch.queries.isEmpty()) {
+        if (batch.callback) {
+            batch.callback();
+        }
+        return;
+    }
+
+    //
+    // Запускаем поток записи, если он ещё не запущен
+    //
+    if (s_asyncWriter == nullptr) {
+        s_isAsyncWriterStopRequested = false;
+        s_asyncWriter = QThread::create(&Database::runAsyncWriter);
+        s_asyncWriter->start();
+    }
+
+    QMutexLocker locker(&s_asyncWriterMutex);
+    s_batchesToWrite.enqueue(batch);
+    s_asyncWriterCondition.wakeAll();
+}
+
+bool Database::isAsyncWriting()
+{
+    return s_isAsyncWriting;
+}
+
+void Database::appendAsyncWrite(const QString& _statement, const QVariantList& _values,
+                                const std::function<void()>& _writtenCallback)
+{
+    Q_ASSERT(s_isAsyncWriting);
+
+    s_asyncWriteQueries.append({ _statement, _values, _writtenCallback });
+}
+
+void Database::waitForAsyncWriting()
+{
+    waitForPendingWrites();
+    processWrittenBatches();
+}
+
 void Database::vacuum()
 {
+    waitForPendingWrites();
     auto query = Database::query();
     query.exec("VACUUM");
 }
 
+void Database::incrementalVacuum()
+{
+    waitForPendingWrites();
+    auto query = Database::query();
+    query.exec("PRAGMA incremental_vacuum");
+}
+
 // ****
 
+void Database::processWrittenBatches()
+{
+    QQueue<WriteBatch> writtenBatches;
+    {
+        QMutexLocker locker(&s_asyncWriterMutex);
+        writtenBatches.swap(s_writtenBatches);
+    }
+
+    for (const auto& batch : std::as_const(writtenBatches)) {
+        if (!batch.error.isEmpty()) {
+            setLastError(batch.error);
+            s_failedWriteQueries.append(batch.queries);
+        } else {
+            for (const auto& query : batch.queries) {
+                if (query.writtenCallback) {
+                    query.writtenCallback();
+                }
+            }
+        }
+        if (batch.callback) {
+            batch.callback();
+        }
+    }
+}
+
+void Database::runAsyncWriter()
+{
+    const QString connectionName = "local_database_writer";
+
+    {
+        QSqlDatabase database;
+        forever {
+            WriteBatch batch;
+            bool isAsyncWriterFailed = false;
+            {
+                QMutexLocker locker(&s_asyncWriterMutex);
+                while (s_batchesToWrite.isEmpty() && !s_isAsyncWriterStopRequested) {
+                    s_asyncWriterCondition.wait(&s_asyncWriterMutex);
+                }
+                if (s_batchesToWrite.isEmpty()) {
+                    break;
+                }
+                batch = s_batchesToWrite.head();
+                isAsyncWriterFailed = s_isAsyncWriterFailed;
+            }
+
+            //
+            // Открываем собственное соединение с базой данных, т.к. соединения нельзя
+            // использовать в потоках, отличных от создавшего их
+            //
+            if (!database.isValid()) {
+                database = QSqlDatabase::addDatabase(s_sqlDriver, connectionName);
+            }
+            if (database.databaseName() != batch.databaseName || !database.isOpen()) {
+                database.close();
+                database.setDatabaseName(batch.databaseName);
+                database.open();
+                applyStorageProfile(database);
+            }
+
+            //
+            // Если не удалось записать один из предыдущих пакетов, то последующие не пишем,
+            // чтобы при повторе запросы применились в исходном порядке
+            //
+            batch.error = isAsyncWriterFailed
+                ? QStringLiteral("Previous changes were not written")
+                : writeBatch(database, batch);
+
+            {
+                QMutexLocker locker(&s_asyncWriterMutex);
+                if (!batch.error.isEmpty()) {
+                    s_isAsyncWriterFailed = true;
+                }
+                s_batchesToWrite.dequeue();
+                s_writtenBatches.enqueue(batch);
+                s_asyncWriterCondition.wakeAll();
+            }
+
+            //
+            // Уведомляем основной поток о завершении записи
+            //
+            QMetaObject::invokeMethod(
+                qApp, [] { processWrittenBatches(); }, Qt::QueuedConnection);
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void Database::stopAsyncWriter()
+{
+    if (s_asyncWriter == nullptr) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&s_asyncWriterMutex);
+        s_isAsyncWriterStopRequested = true;
+        s_asyncWriterCondition.wakeAll();
+    }
+    s_asyncWriter->wait();
+    delete s_asyncWriter;
+    s_asyncWriter = nullptr;
+
+    {
+        QMutexLocker locker(&s_asyncWriterMutex);
+        s_isAsyncWriterFailed = false;
+    }
+    processWrittenBatches();
+}
+
 QSqlDatabase Database::instanse()
 {
     QSqlDatabase database;
@@ -215,6 +708,13 @@ void Database::open(QSqlDatabase& _database, const QString& _connectionName,
     _database = QSqlDatabase::addDatabase(s_sqlDriver, _connectionName);
     _database.setDatabaseName(_databaseName);
     _database.open();
+    ++s_connectionNumber;
+
+    //
+    // Настраиваем соединение, режим журнала хранится в самом файле, так что существующие файлы
+    // переводятся в заданный режим при первом же открытии
+    //
+    applyStorageProfile(_database);
 
     Database::States states = checkState(_database);
 
@@ -281,6 +781,13 @@ Database::States Database::checkState(QSqlDatabase& _database)
 void Database::createTables(QSqlDatabase& _database)
 {
     QSqlQuery query(_database);
+
+    //
+    // Режим освобождения страниц задаётся до создания таблиц, чтобы место, освободившееся после
+    // сжатия истории изменений, можно было вернуть без полного пересоздания файла
+    //
+    query.exec("PRAGMA auto_vacuum = INCREMENTAL");
+
     _database.transaction();
 
     //
@@ -320,9 +827,89 @@ void Database::createTables(QSqlDatabase& _database)
                "is_synced INTEGER NOT NULL DEFAULT(0) "
                ")");
 
+    //
+    // Таблица с контрольными точками истории документов, от которых воспроизводится история при
+    // её сжатии
+    //
+    query.exec("CREATE TABLE documents_checkpoints "
+               "("
+               "fk_document_uuid TEXT PRIMARY KEY NOT NULL, "
+               "fk_change_id INTEGER NOT NULL, "
+               "content BLOB NOT NULL "
+               ")");
+
+    //
+    // Таблица с уменьшенными копиями изображений, общими для изображений с одинаковым содержимым
+    //
+    query.exec("CREATE TABLE images_thumbnails "
+               "("
+               "content_hash TEXT NOT NULL, "
+               "size INTEGER NOT NULL, "
+               "content BLOB NOT NULL, "
+               "PRIMARY KEY (content_hash, size) "
+               ")");
+
+    //
+    // Таблица с хэшами содержимого изображений, по которой определяется, используются ли ещё
+    // уменьшенные копии
+    //
+    query.exec("CREATE TABLE images_hashes "
+               "("
+               "fk_document_uuid TEXT PRIMARY KEY NOT NULL, "
+               "content_hash TEXT NOT NULL "
+               ")");
+    query.exec("CREATE INDEX images_hashes_content_hash_idx ON images_hashes (content_hash)");
+
+    createSearchIndexTables(query);
+
     _database.commit();
 }
 
+void Database::createSearchIndexTables(QSqlQuery& _query)
+{
+    //
+    // Абзацы проиндексированных документов, одинаковые абзацы одного документа хранятся отдельными
+    // строками, чтобы при правке текста можно было удалить ровно столько копий, сколько пропало
+    //
+    _query.exec("CREATE TABLE IF NOT EXISTS search_paragraphs "
+                "("
+                "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                "fk_document_uuid TEXT NOT NULL, "
+                "text TEXT NOT NULL "
+                ")");
+
+    //
+    // Документы, которые уже были проиндексированы, в том числе и не содержащие текста
+    //
+    _query.exec("CREATE TABLE IF NOT EXISTS search_documents "
+                "("
+                "uuid TEXT PRIMARY KEY "
+                ")");
+
+    //
+    // Инвертированный индекс по словам абзацев, сам текст в нём не дублируется, а берётся из
+    // таблицы абзацев, регистр букв индекс не учитывает, а префиксы из двух и трёх букв хранит
+    // отдельно, чтобы поиск по началу слова не перебирал весь словарь
+    //
+    _query.exec("CREATE VIRTUAL TABLE IF NOT EXISTS search_index USING fts5"
+                "("
+                "text, "
+                "content = 'search_paragraphs', "
+                "content_rowid = 'id', "
+                "tokenize = 'unicode61 remove_diacritics 0', "
+                "prefix = '2 3' "
+                ")");
+    _query.exec("CREATE TRIGGER IF NOT EXISTS search_paragraphs_after_insert "
+                "AFTER INSERT ON search_paragraphs BEGIN "
+                "INSERT INTO search_index (rowid, text) VALUES (new.id, new.text); "
+                "END");
+    _query.exec("CREATE TRIGGER IF NOT EXISTS search_paragraphs_after_delete "
+                "AFTER DELETE ON search_paragraphs BEGIN "
+                "INSERT INTO search_index (search_index, rowid, text) "
+                "VALUES ('delete', old.id, old.text); "
+                "END");
+}
+
 void Database::createIndexes(QSqlDatabase& _database)
 {
     QSqlQuery query(_database);
@@ -331,11 +918,17 @@ void Database::createIndexes(QSqlDatabase& _database)
     //
     // Таблица с изменениями документов
     //
-    query.exec("CREATE INDEX documents_changes_fk_document_uuid_idx "
-               "ON documents_changes (fk_document_uuid)");
+    query.exec("CREATE INDEX documents_changes_fk_document_uuid_id_idx "
+               "ON documents_changes (fk_document_uuid, id)");
     query.exec("CREATE INDEX documents_changes_date_time_idx "
                "ON documents_changes (date_time)");
 
+    //
+    // Таблица с абзацами для полнотекстового поиска
+    //
+    query.exec("CREATE INDEX search_paragraphs_fk_document_uuid_idx "
+               "ON search_paragraphs (fk_document_uuid)");
+
     _database.commit();
 }
 
@@ -460,6 +1053,17 @@ void Database::updateDatabase(QSqlDatabase& _database)
                 updateDatabaseTo_0_6_2(_database);
             }
         }
+        //
+        // 0.8.x
+        //
+        if (versionMajor < 0 || versionMinor <= 8) {
+            //
+            // 0.8.0
+            //
+            if (versionMajor < 0 || versionMinor < 8 || versionBuild <= 0) {
+                updateDatabaseTo_0_8_1(_database);
+            }
+        }
     }
 
     //
@@ -607,4 +1211,62 @@ void Database::updateDatabaseTo_0_6_2(QSqlDatabase& _database)
     _database.commit();
 }
 
+void Database::updateDatabaseTo_0_8_1(QSqlDatabase& _database)
+{
+    QSqlQuery q_updater(_database);
+
+    _database.transaction();
+
+    //
+    // Заменяем индекс изменений по документу на составной, чтобы постраничная загрузка
+    // истории изменений документа выполнялась по индексу без сортировки
+    //
+    q_updater.exec("DROP INDEX IF EXISTS documents_changes_fk_document_uuid_idx");
+    q_updater.exec("CREATE INDEX IF NOT EXISTS documents_changes_fk_document_uuid_id_idx "
+                   "ON documents_changes (fk_document_uuid, id)");
+
+    //
+    // Добавляем таблицу с контрольными точками истории изменений
+    //
+    q_updater.exec("CREATE TABLE IF NOT EXISTS documents_checkpoints "
+                   "("
+                   "fk_document_uuid TEXT PRIMARY KEY NOT NULL, "
+                   "fk_change_id INTEGER NOT NULL, "
+                   "content BLOB NOT NULL "
+                   ")");
+
+    //
+    // Добавляем таблицу с уменьшенными копиями изображений
+    //
+    q_updater.exec("CREATE TABLE IF NOT EXISTS images_thumbnails "
+                   "("
+                   "content_hash TEXT NOT NULL, "
+                   "size INTEGER NOT NULL, "
+                   "content BLOB NOT NULL, "
+                   "PRIMARY KEY (content_hash, size) "
+                   ")");
+    q_updater.exec("CREATE TABLE IF NOT EXISTS images_hashes "
+                   "("
+                   "fk_document_uuid TEXT PRIMARY KEY NOT NULL, "
+                   "content_hash TEXT NOT NULL "
+                   ")");
+    q_updater.exec("CREATE INDEX IF NOT EXISTS images_hashes_content_hash_idx "
+                   "ON images_hashes (content_hash)");
+
+    //
+    // Добавляем полнотекстовый индекс, документы попадут в него при первой загрузке проекта
+    //
+    createSearchIndexTables(q_updater);
+    q_updater.exec("CREATE INDEX IF NOT EXISTS search_paragraphs_fk_document_uuid_idx "
+                   "ON search_paragraphs (fk_document_uuid)");
+
+    _database.commit();
+
+    //
+    // NOTE: Режим постепенного освобождения страниц не включаем, т.к. для существующего файла он
+    //       вступает в силу только после полного пересоздания файла, которое блокирует открытие
+    //       проекта, а страницы, освободившиеся после сжатия истории, переиспользуются и так
+    //
+}
+
 } // namespace DatabaseLayer
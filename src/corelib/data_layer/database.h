@@ -1,9 +1,11 @@
 #pragma once
 
-#include <QtGlobal>
+#include <QVariantList>
 
 #include <corelib_global.h>
 
+#include <functional>
+
 class QString;
 class QSqlQuery;
 class QSqlDatabase;
@@ -14,6 +16,42 @@ namespace DatabaseLayer {
 class CORE_LIBRARY_EXPORT Database
 {
 public:
+    /**
+     * @brief Параметры работы SQLite с файлом проекта
+     */
+    struct StorageProfile {
+        /**
+         * @brief Использовать ли журнал упреждающей записи, чтобы чтение не блокировалось записью
+         * @note Для файлов на сетевых дисках журнал нужно отключать
+         */
+        bool useWriteAheadLog = true;
+
+        /**
+         * @brief Синхронизировать ли с диском каждую транзакцию, иначе только контрольные точки
+         *        журнала, что сохраняет целостность файла, но может потерять последнюю транзакцию
+         *        при отключении питания
+         */
+        bool isFullSynchronous = false;
+
+        /**
+         * @brief Размер кэша страниц в килобайтах
+         */
+        int cacheSize = 16 * 1024;
+
+        /**
+         * @brief Размер отображаемой в память части файла в байтах
+         */
+        qint64 mmapSize = 64 * 1024 * 1024;
+    };
+
+    /**
+     * @brief Задать параметры работы с файлом проекта
+     * @note Применяются при следующем открытии файла. Для файлов на сетевых дисках и в папках
+     *       сервисов синхронизации журнал упреждающей записи и отложенная синхронизация
+     *       отключаются независимо от заданных параметров
+     */
+    static void setStorageProfile(const StorageProfile& _profile);
+
     /**
      * @brief Можно ли открыть заданный файл
      */
@@ -51,11 +89,36 @@ public:
 
     /**
      * @brief Получить объект для выполнения запросов в БД
+     * @note Чтение не дожидается фоновой записи, поэтому если нужно увидеть ещё не записанные
+     *       изменения таблицы, то перед чтением следует дождаться записи пакетов, которые её
+     *       затрагивают, а перед записью в основном соединении - записи всех пакетов, чтобы
+     *       сохранить порядок изменений
      */
     static QSqlQuery query();
 
+    /**
+     * @brief Номер текущего соединения с базой данных, меняется при каждом его открытии
+     * @note Используется для сброса подготовленных в рамках соединения запросов
+     */
+    static int connectionNumber();
+
+    /**
+     * @brief Дождаться записи отправленных в фоновый поток пакетов, которые изменяют заданную
+     *        таблицу, а если таблица не задана, то всех пакетов
+     * @note В отличие от waitForAsyncWriting() обработчики завершения записи будут вызваны
+     *       позднее в основном цикле событий
+     */
+    static void waitForPendingWrites(const QString& _table = {});
+
+    /**
+     * @brief Перенести изменения из журнала упреждающей записи в основной файл базы данных
+     */
+    static void checkpoint();
+
     /**
      * @brief Запустить транзакцию, если ещё не запущена
+     * @note Во время накопления запросов для фоновой записи ничего не делает, т.к. весь пакет
+     *       и так будет записан одной транзакцией
      */
     static void transaction();
 
@@ -69,11 +132,49 @@ public:
      */
     static void rollback();
 
+    /**
+     * @brief Начать накопление запросов на запись для их выполнения в фоновом потоке
+     * @note Пока накопление запущено, запросы отображателей на вставку, обновление и удаление
+     *       объектов не выполняются сразу, а запоминаются вместе со значениями параметров
+     */
+    static void beginAsyncWriting();
+
+    /**
+     * @brief Отправить накопленные запросы на запись в фоновый поток, где они будут выполнены
+     *        одной транзакцией в отдельном соединении с базой данных
+     * @param _callback Обработчик завершения записи, вызывается в основном потоке
+     * @note Если запись не удалась, то текст ошибки будет доступен в обработчике через lastError(),
+     *       а неудавшиеся запросы будут повторены перед запросами следующего пакета
+     */
+    static void endAsyncWriting(const std::function<void()>& _callback);
+
+    /**
+     * @brief Идёт ли в данный момент накопление запросов на запись
+     */
+    static bool isAsyncWriting();
+
+    /**
+     * @brief Добавить запрос на запись в накапливаемый пакет
+     * @param _writtenCallback Обработчик успешной записи запроса, вызывается в основном потоке
+     */
+    static void appendAsyncWrite(const QString& _statement, const QVariantList& _values,
+                                 const std::function<void()>& _writtenCallback = {});
+
+    /**
+     * @brief Дождаться завершения записи всех отправленных пакетов и вызвать их обработчики
+     */
+    static void waitForAsyncWriting();
+
     /**
      * @brief Сжать базу данных
      */
     static void vacuum();
 
+    /**
+     * @brief Вернуть файловой системе освободившиеся страницы базы данных без её полного сжатия
+     */
+    static void incrementalVacuum();
+
     /**
      * @brief Состояния базы данных
      */
@@ -92,6 +193,21 @@ public:
     Q_DECLARE_FLAGS(States, State)
 
 private:
+    /**
+     * @brief Вызвать обработчики пакетов, запись которых завершена
+     */
+    static void processWrittenBatches();
+
+    /**
+     * @brief Цикл потока фоновой записи
+     */
+    static void runAsyncWriter();
+
+    /**
+     * @brief Остановить поток фоновой записи, дождавшись записи всех пакетов
+     */
+    static void stopAsyncWriter();
+
     /**
      * @brief Получить объект текущей базы данных
      */
@@ -105,6 +221,7 @@ private:
     static Database::States checkState(QSqlDatabase& _database);
     static void createTables(QSqlDatabase& _database);
     static void createIndexes(QSqlDatabase& _database);
+    static void createSearchIndexTables(QSqlQuery& _query);
     static void createEnums(QSqlDatabase& _database);
 
     static void updateDatabase(QSqlDatabase& _database);
@@ -112,6 +229,7 @@ private:
     static void updateDatabaseTo_0_1_3(QSqlDatabase& _database);
     static void updateDatabaseTo_0_2_4(QSqlDatabase& _database);
     static void updateDatabaseTo_0_6_2(QSqlDatabase& _database);
+    static void updateDatabaseTo_0_8_1(QSqlDatabase& _database);
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Database::States)
@@ -10,6 +10,8 @@
 #include <QSqlRecord>
 #include <QVariant>
 
+#include <functional>
+
 using DatabaseLayer::Database;
 using Domain::DomainObject;
 using Domain::Identifier;
@@ -25,6 +27,8 @@ void AbstractMapper::clear()
         value = nullptr;
     }
     m_loadedObjectsMap.clear();
+    m_preparedQueries.clear();
+    m_preparedQueriesUsage.clear();
 }
 
 DomainObject* AbstractMapper::abstractFind(const Identifier& _id)
@@ -39,10 +43,18 @@ DomainObject* AbstractMapper::abstractFind(const Identifier& _id)
     return result;
 }
 
-QVector<Domain::DomainObject*> AbstractMapper::abstractFind(const QString& _filter)
+QVector<Domain::DomainObject*> AbstractMapper::abstractFind(const QString& _filter,
+                                                            const QVariantList& _filterValues)
 {
-    QSqlQuery query = Database::query();
-    query.prepare(findAllStatement() + _filter);
+    //
+    // Выборка по условию должна найти и объекты, которые ещё только записываются
+    //
+    Database::waitForPendingWrites(tableName());
+
+    auto& query = preparedQuery(findAllStatement() + _filter);
+    for (int index = 0; index < _filterValues.size(); ++index) {
+        query.bindValue(index, _filterValues.at(index));
+    }
     query.exec();
     QVector<Domain::DomainObject*> result;
     while (query.next()) {
@@ -50,6 +62,7 @@ QVector<Domain::DomainObject*> AbstractMapper::abstractFind(const QString& _filt
         DomainObject* domainObject = load(record);
         result.append(domainObject);
     }
+    query.finish();
     return result;
 }
 
@@ -71,23 +84,10 @@ bool AbstractMapper::abstractInsert(DomainObject* _object)
     QVariantList insertValues;
     QString insertQueryString = insertStatement(_object, insertValues);
 
-    //
-    // Сформируем запрос на добавление данных в базу
-    //
-    QSqlQuery insertQuery = Database::query();
-    insertQuery.prepare(insertQueryString);
-    for (const QVariant& value : std::as_const(insertValues)) {
-        insertQuery.addBindValue(value);
-    }
-
     //
     // Добавим данные в базу
     //
-    const auto isInsertSuccesful = executeSql(insertQuery);
-    if (isInsertSuccesful) {
-        _object->markChangesStored();
-    }
-    return isInsertSuccesful;
+    return executeWrite(insertQueryString, insertValues, _object);
 }
 
 bool AbstractMapper::abstractUpdate(DomainObject* _object)
@@ -110,23 +110,10 @@ bool AbstractMapper::abstractUpdate(DomainObject* _object)
     QVariantList updateValues;
     const QString updateQueryString = updateStatement(_object, updateValues);
 
-    //
-    // Сформируем запрос на обновление данных в базе
-    //
-    QSqlQuery updateQuery = Database::query();
-    updateQuery.prepare(updateQueryString);
-    for (const QVariant& value : std::as_const(updateValues)) {
-        updateQuery.addBindValue(value);
-    }
-
     //
     // Обновим данные в базе
     //
-    const bool isUpdateSuccesful = executeSql(updateQuery);
-    if (isUpdateSuccesful) {
-        _object->markChangesStored();
-    }
-    return isUpdateSuccesful;
+    return executeWrite(updateQueryString, updateValues, _object);
 }
 
 bool AbstractMapper::abstractDelete(DomainObject* _object)
@@ -137,19 +124,10 @@ bool AbstractMapper::abstractDelete(DomainObject* _object)
     QVariantList deleteValues;
     QString deleteQueryString = deleteStatement(_object, deleteValues);
 
-    //
-    // Сформируем запрос на удаление данных из базы
-    //
-    QSqlQuery deleteQuery = Database::query();
-    deleteQuery.prepare(deleteQueryString);
-    for (const QVariant& value : std::as_const(deleteValues)) {
-        deleteQuery.addBindValue(value);
-    }
-
     //
     // Удалим данные из базы
     //
-    const bool isDeleteSuccesful = executeSql(deleteQuery);
+    const bool isDeleteSuccesful = executeWrite(deleteQueryString, deleteValues);
     if (isDeleteSuccesful) {
         //
         // Удалим объекст из списка загруженных
@@ -161,6 +139,54 @@ bool AbstractMapper::abstractDelete(DomainObject* _object)
     return isDeleteSuccesful;
 }
 
+void AbstractMapper::abstractUnload(DomainObject* _object)
+{
+    m_loadedObjectsMap.erase(_object->id());
+    delete _object;
+}
+
+bool AbstractMapper::executeWrite(const QString& _statement, const QVariantList& _values,
+                                  DomainObject* _storedObject)
+{
+    //
+    // Если идёт накопление запросов для фоновой записи, то лишь запоминаем запрос, т.к. значения
+    // параметров неизменяемы, то это и есть снимок данных объекта на текущий момент
+    //
+    if (Database::isAsyncWriting()) {
+        std::function<void()> writtenCallback;
+        if (_storedObject != nullptr) {
+            //
+            // ... объект проверяем по списку загруженных, т.к. к моменту записи он мог быть
+            //     удалён, а если он успел измениться, то сохранён лишь его предыдущий снимок
+            //
+            writtenCallback = [this, id = _storedObject->id(), object = _storedObject,
+                               revision = _storedObject->changesRevision()] {
+                const auto objectIter = m_loadedObjectsMap.find(id);
+                if (objectIter != m_loadedObjectsMap.end() && objectIter->second == object
+                    && object->changesRevision() == revision) {
+                    object->markChangesStored();
+                }
+            };
+        }
+        Database::appendAsyncWrite(_statement, _values, writtenCallback);
+        return true;
+    }
+
+    //
+    // В противном случае сразу выполняем запрос, дождавшись записи уже отправленных пакетов
+    //
+    Database::waitForPendingWrites();
+    auto& query = preparedQuery(_statement);
+    for (int index = 0; index < _values.size(); ++index) {
+        query.bindValue(index, _values.at(index));
+    }
+    const auto isWritten = executeSql(query);
+    if (isWritten && _storedObject != nullptr) {
+        _storedObject->markChangesStored();
+    }
+    return isWritten;
+}
+
 bool AbstractMapper::executeSql(QSqlQuery& _sqlQuery)
 {
     const bool isExecutionSuccesful = _sqlQuery.exec();
@@ -180,13 +206,46 @@ bool AbstractMapper::executeSql(QSqlQuery& _sqlQuery)
     return false;
 }
 
+QSqlQuery& AbstractMapper::preparedQuery(const QString& _statement)
+{
+    //
+    // Запросы подготавливаются в рамках соединения, поэтому при его смене сбрасываем кэш
+    //
+    const auto connectionNumber = Database::connectionNumber();
+    if (m_preparedQueriesConnectionNumber != connectionNumber) {
+        m_preparedQueries.clear();
+        m_preparedQueriesUsage.clear();
+        m_preparedQueriesConnectionNumber = connectionNumber;
+    }
+
+    auto queryIter = m_preparedQueries.find(_statement);
+    if (queryIter == m_preparedQueries.end()) {
+        //
+        // Освобождаем место под новый запрос, вытесняя наиболее давно использованные
+        //
+        constexpr int kMaxPreparedQueries = 64;
+        while (m_preparedQueries.size() >= kMaxPreparedQueries) {
+            m_preparedQueries.remove(m_preparedQueriesUsage.takeFirst());
+        }
+
+        auto query = Database::query();
+        query.prepare(_statement);
+        queryIter = m_preparedQueries.insert(_statement, query);
+    } else {
+        m_preparedQueriesUsage.removeOne(_statement);
+    }
+    m_preparedQueriesUsage.append(_statement);
+    return queryIter.value();
+}
+
 DomainObject* AbstractMapper::loadObjectFromDatabase(const Identifier& _id)
 {
-    QSqlQuery query = Database::query();
-    query.prepare(findStatement(_id));
+    auto& query = preparedQuery(findStatement());
+    query.bindValue(0, _id.value());
     query.exec();
     query.next();
     const QSqlRecord record = query.record();
+    query.finish();
     DomainObject* result = load(record);
     return result;
 }
@@ -197,11 +256,13 @@ Identifier AbstractMapper::findNextIdentifier()
         //
         // Если нет ещё последнего индекса по таблице, загрузим его
         //
+        Database::waitForPendingWrites(tableName());
         QSqlQuery query = Database::query();
         query.prepare(findLastOneStatement());
         query.exec();
         query.next();
         const QSqlRecord record = query.record();
+        query.finish();
         load(record);
 
         m_isLastIdentifierLoaded = true;
@@ -2,14 +2,16 @@
 
 #include <domain/identifier.h>
 
+#include <QHash>
+#include <QList>
 #include <QMap>
+#include <QSqlQuery>
 
 namespace Domain {
 class DomainObject;
 }
 
 class QSqlRecord;
-class QSqlQuery;
 
 
 namespace DataMappingLayer {
@@ -25,10 +27,18 @@ public:
     /**
      * @brief Очистить все загруженные ранее данные
      */
-    void clear();
+    virtual void clear();
 
 protected:
-    virtual QString findStatement(const Domain::Identifier& _id) const = 0;
+    /**
+     * @brief Таблица, в которой хранятся объекты
+     */
+    virtual QString tableName() const = 0;
+
+    /**
+     * @brief Выражение поиска объекта с идентификатором, заданным параметром запроса
+     */
+    virtual QString findStatement() const = 0;
     virtual QString findAllStatement() const = 0;
     virtual QString findLastOneStatement() const = 0;
     virtual QString insertStatement(Domain::DomainObject* _object, QVariantList& _values) const = 0;
@@ -49,16 +59,38 @@ protected:
 
 protected:
     Domain::DomainObject* abstractFind(const Domain::Identifier& _id);
-    QVector<Domain::DomainObject*> abstractFind(const QString& _filter);
+    QVector<Domain::DomainObject*> abstractFind(const QString& _filter,
+                                                const QVariantList& _filterValues = {});
     bool abstractInsert(Domain::DomainObject* _object);
     bool abstractUpdate(Domain::DomainObject* _object);
     bool abstractDelete(Domain::DomainObject* _object);
 
+    /**
+     * @brief Выгрузить объект из списка загруженных и удалить его, не трогая данные в БД
+     */
+    void abstractUnload(Domain::DomainObject* _object);
+
+    /**
+     * @brief Выполнить запрос на запись с заданными значениями параметров
+     * @param _storedObject Объект, который нужно пометить сохранённым после записи
+     * @note Если идёт накопление запросов для фоновой записи, то запрос будет выполнен позже, а
+     *       объект будет помечен сохранённым только после успешной записи и только если он не
+     *       был изменён, или удалён за это время
+     */
+    bool executeWrite(const QString& _statement, const QVariantList& _values,
+                      Domain::DomainObject* _storedObject = nullptr);
+
     /**
      * @brief Выполнить запрос
      */
     bool executeSql(QSqlQuery& _sqlQuery);
 
+    /**
+     * @brief Получить подготовленный запрос с заданным выражением из кэша текущего соединения
+     * @note Значения параметров задаются заново перед каждым выполнением запроса
+     */
+    QSqlQuery& preparedQuery(const QString& _statement);
+
 protected:
     /**
      * @brief Скрываем конструктор от публичного доступа
@@ -91,6 +123,15 @@ private:
      * @brief Загруженные объекты из базы данных
      */
     std::map<Domain::Identifier, Domain::DomainObject*> m_loadedObjectsMap;
+
+    /**
+     * @brief Подготовленные запросы и номер соединения, в рамках которого они подготовлены
+     * @note Запросы с фильтрами формируются динамически, поэтому кэш ограничен по размеру и при
+     *       переполнении из него вытесняются давно не использованные запросы
+     */
+    QHash<QString, QSqlQuery> m_preparedQueries;
+    QList<QString> m_preparedQueriesUsage;
+    int m_preparedQueriesConnectionNumber = 0;
 };
 
 } // namespace DataMappingLayer
@@ -7,6 +7,8 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 
+#include <limits>
+
 using Domain::DocumentChangeObject;
 using Domain::DomainObject;
 using Domain::Identifier;
@@ -18,42 +20,18 @@ namespace {
 const QString kColumns = " id, fk_document_uuid, uuid, undo_patch, redo_patch, date_time, "
                          "user_name, user_email, is_synced ";
 const QString kTableName = " documents_changes ";
+const QString kCheckpointsTableName = " documents_checkpoints ";
 const QString kDateTimeFormat = "yyyy-MM-dd hh:mm:ss:zzz";
-QString uuidFilter(const QUuid& _uuid)
-{
-    return QString(" WHERE uuid = '%1' ").arg(_uuid.toString());
-}
-QString documentFilter(const QUuid& _documentUuid)
-{
-    return QString(" WHERE fk_document_uuid = '%1'").arg(_documentUuid.toString());
-}
-QString documentFilter(const QUuid& _documentUuid, int _changeIndex)
-{
-    //
-    // Игнорируем самое первое изменнеие документа, т.к. это добавление стандартной разметки
-    // элемента в пустой документ
-    //
-    return QString(" WHERE fk_document_uuid = '%1'"
-                   " AND id not in (SELECT id FROM %3 WHERE fk_document_uuid = '%1' ORDER BY id "
-                   "ASC LIMIT 0, 1) "
-                   " ORDER BY id DESC LIMIT %2, 1")
-        .arg(_documentUuid.toString())
-        .arg(_changeIndex)
-        .arg(kTableName);
-}
-QString unsyncedFilter(const QUuid& _documentUuid)
-{
-    return QString(" WHERE fk_document_uuid = '%1' AND is_synced = 0")
-        .arg(_documentUuid.toString());
-}
-QString unsyncedFilter()
-{
-    return QString(" WHERE is_synced = 0 GROUP BY fk_document_uuid");
-}
+const int kIndexPageSize = 500;
+const QString kUuidFilter = " WHERE uuid = ? ";
+const QString kDocumentFilter = " WHERE fk_document_uuid = ? ";
+const QString kUnsyncedDocumentFilter = " WHERE fk_document_uuid = ? AND is_synced = 0 ";
+const QString kUnsyncedFilter = " WHERE is_synced = 0 GROUP BY fk_document_uuid ";
 } // namespace
 
 bool DataMappingLayer::DocumentChangeMapper::isEmpty()
 {
+    DatabaseLayer::Database::waitForPendingWrites(tableName());
     QSqlQuery query = DatabaseLayer::Database::query();
     query.prepare(QString("SELECT COUNT(*) FROM %1").arg(kTableName));
 
@@ -71,7 +49,7 @@ DocumentChangeObject* DocumentChangeMapper::find(const Domain::Identifier& _id)
 
 DocumentChangeObject* DocumentChangeMapper::find(const QUuid& _uuid)
 {
-    const auto domainObjects = abstractFind(uuidFilter(_uuid));
+    const auto domainObjects = abstractFind(kUuidFilter, { _uuid.toString() });
     if (domainObjects.isEmpty()) {
         return nullptr;
     }
@@ -82,17 +60,28 @@ DocumentChangeObject* DocumentChangeMapper::find(const QUuid& _uuid)
 Domain::DocumentChangeObject* DocumentChangeMapper::find(const QUuid& _documentUuid,
                                                          int _changeIndex)
 {
-    const auto domainObjects = abstractFind(documentFilter(_documentUuid, _changeIndex));
-    if (domainObjects.isEmpty()) {
+    if (_changeIndex < 0) {
         return nullptr;
     }
 
-    return static_cast<DocumentChangeObject*>(domainObjects.first());
+    //
+    // Догружаем идентификаторы изменений, пока не дойдём до изменения с заданным индексом
+    //
+    auto& index = m_documentsChangesIndexes[_documentUuid];
+    while (_changeIndex >= index.size() && !index.isComplete) {
+        loadNextPage(_documentUuid, index);
+    }
+    if (_changeIndex >= index.size()) {
+        return nullptr;
+    }
+
+    return find(Identifier(index.id(_changeIndex)));
 }
 
 QVector<Domain::DocumentChangeObject*> DocumentChangeMapper::findAll(const QUuid& _documentUuid)
 {
-    const auto domainObjects = abstractFind(documentFilter(_documentUuid));
+    const auto domainObjects
+        = abstractFind(kDocumentFilter + " ORDER BY id", { _documentUuid.toString() });
     if (domainObjects.isEmpty()) {
         return {};
     }
@@ -107,7 +96,8 @@ QVector<Domain::DocumentChangeObject*> DocumentChangeMapper::findAll(const QUuid
 QVector<Domain::DocumentChangeObject*> DocumentChangeMapper::findAllUnsynced(
     const QUuid& _documentUuid)
 {
-    const auto domainObjects = abstractFind(unsyncedFilter(_documentUuid));
+    const auto domainObjects
+        = abstractFind(kUnsyncedDocumentFilter, { _documentUuid.toString() });
     if (domainObjects.isEmpty()) {
         return {};
     }
@@ -121,7 +111,7 @@ QVector<Domain::DocumentChangeObject*> DocumentChangeMapper::findAllUnsynced(
 
 QVector<QUuid> DocumentChangeMapper::unsyncedDocuments()
 {
-    const auto domainObjects = abstractFind(unsyncedFilter());
+    const auto domainObjects = abstractFind(kUnsyncedFilter);
     if (domainObjects.isEmpty()) {
         return {};
     }
@@ -133,9 +123,123 @@ QVector<QUuid> DocumentChangeMapper::unsyncedDocuments()
     return documents;
 }
 
+QVector<Domain::DocumentChangeObject*> DocumentChangeMapper::findPage(const QUuid& _documentUuid,
+                                                                     int _beforeId, int _count)
+{
+    const auto domainObjects
+        = abstractFind(kDocumentFilter + " AND id < ? ORDER BY id DESC LIMIT ?",
+                       { _documentUuid.toString(), _beforeId, _count });
+    if (domainObjects.isEmpty()) {
+        return {};
+    }
+
+    QVector<Domain::DocumentChangeObject*> changes;
+    for (auto domainObject : domainObjects) {
+        changes.append(static_cast<DocumentChangeObject*>(domainObject));
+    }
+    return changes;
+}
+
+QVector<Domain::DocumentChangeObject*> DocumentChangeMapper::findPageAfter(
+    const QUuid& _documentUuid, int _afterId, int _count)
+{
+    const auto domainObjects = abstractFind(kDocumentFilter + " AND id > ? ORDER BY id LIMIT ?",
+                                            { _documentUuid.toString(), _afterId, _count });
+    if (domainObjects.isEmpty()) {
+        return {};
+    }
+
+    QVector<Domain::DocumentChangeObject*> changes;
+    for (auto domainObject : domainObjects) {
+        changes.append(static_cast<DocumentChangeObject*>(domainObject));
+    }
+    return changes;
+}
+
+QVector<QUuid> DocumentChangeMapper::compactableDocuments(const QDateTime& _before,
+                                                          int _minChangesCount)
+{
+    //
+    // Дата изменения хранится в UTC в формате, сортировка которого совпадает с хронологической,
+    // поэтому первые десять символов задают день изменения
+    //
+    DatabaseLayer::Database::waitForPendingWrites(tableName());
+    auto& query = preparedQuery(
+        QString("SELECT fk_document_uuid FROM %1 "
+                "WHERE is_synced = 1 AND date_time < ? "
+                "GROUP BY fk_document_uuid "
+                "HAVING COUNT(*) - COUNT(DISTINCT substr(date_time, 1, 10)) >= ?")
+            .arg(kTableName));
+    query.bindValue(0, _before.toString(kDateTimeFormat));
+    query.bindValue(1, _minChangesCount);
+
+    executeSql(query);
+
+    QVector<QUuid> documents;
+    while (query.next()) {
+        documents.append(QUuid::fromString(query.value(0).toString()));
+    }
+    query.finish();
+    return documents;
+}
+
+DocumentChangeMapper::Checkpoint DocumentChangeMapper::checkpoint(const QUuid& _documentUuid)
+{
+    DatabaseLayer::Database::waitForPendingWrites(kCheckpointsTableName.trimmed());
+    auto& query = preparedQuery(
+        QString("SELECT fk_change_id, content FROM %1 WHERE fk_document_uuid = ?")
+            .arg(kCheckpointsTableName));
+    query.bindValue(0, _documentUuid.toString());
+
+    executeSql(query);
+
+    Checkpoint checkpoint;
+    if (query.next()) {
+        checkpoint.changeId = query.value(0).toInt();
+        checkpoint.content = qUncompress(query.value(1).toByteArray());
+    }
+    query.finish();
+    return checkpoint;
+}
+
+bool DocumentChangeMapper::saveCheckpoint(const QUuid& _documentUuid,
+                                          const Checkpoint& _checkpoint)
+{
+    return executeWrite(QString("INSERT OR REPLACE INTO %1 "
+                                "(fk_document_uuid, fk_change_id, content) VALUES (?, ?, ?)")
+                            .arg(kCheckpointsTableName),
+                        { _documentUuid.toString(), _checkpoint.changeId,
+                          qCompress(_checkpoint.content) });
+}
+
+bool DocumentChangeMapper::removeCheckpoint(const QUuid& _documentUuid)
+{
+    return executeWrite(
+        QString("DELETE FROM %1 WHERE fk_document_uuid = ?").arg(kCheckpointsTableName),
+        { _documentUuid.toString() });
+}
+
 bool DocumentChangeMapper::insert(DocumentChangeObject* _object)
 {
-    return abstractInsert(_object);
+    const auto isInserted = abstractInsert(_object);
+    if (!isInserted) {
+        return false;
+    }
+
+    //
+    // Если индекс изменений документа уже загружен, дополняем его новым изменением
+    //
+    const auto indexIter = m_documentsChangesIndexes.find(_object->documentUuid());
+    if (indexIter != m_documentsChangesIndexes.end()) {
+        auto& index = indexIter.value();
+        if (index.isComplete && index.firstChangeId == 0) {
+            index.firstChangeId = _object->id().value();
+        } else {
+            index.newIds.append(_object->id().value());
+        }
+    }
+
+    return true;
 }
 
 bool DocumentChangeMapper::update(DocumentChangeObject* _object)
@@ -145,23 +249,100 @@ bool DocumentChangeMapper::update(DocumentChangeObject* _object)
 
 bool DocumentChangeMapper::remove(DocumentChangeObject* _object)
 {
+    //
+    // Удаление изменений происходит редко, поэтому просто сбрасываем индекс документа,
+    // чтобы он был загружен заново при следующем обращении
+    //
+    m_documentsChangesIndexes.remove(_object->documentUuid());
     return abstractDelete(_object);
 }
 
 void DocumentChangeMapper::removeAll()
 {
+    DatabaseLayer::Database::waitForPendingWrites();
     QSqlQuery query = DatabaseLayer::Database::query();
     query.prepare(QString("DELETE FROM %1").arg(kTableName));
 
     executeSql(query);
+
+    //
+    // ... без истории контрольные точки теряют смысл
+    //
+    query.prepare(QString("DELETE FROM %1").arg(kCheckpointsTableName));
+
+    executeSql(query);
+
+    m_documentsChangesIndexes.clear();
+}
+
+void DocumentChangeMapper::unload(DocumentChangeObject* _object)
+{
+    abstractUnload(_object);
+}
+
+void DocumentChangeMapper::clear()
+{
+    AbstractMapper::clear();
+    m_documentsChangesIndexes.clear();
 }
 
-QString DocumentChangeMapper::findStatement(const Domain::Identifier& _id) const
+void DocumentChangeMapper::loadNextPage(const QUuid& _documentUuid, DocumentChangesIndex& _index)
 {
-    QString findStatement
-        = QString("SELECT " + kColumns + " FROM " + kTableName + " WHERE id = %1 ")
-              .arg(_id.value());
-    return findStatement;
+    //
+    // Загружаем идентификаторы изменений, которые старше последнего загруженного,
+    // такой запрос полностью обслуживается индексом (fk_document_uuid, id)
+    //
+    DatabaseLayer::Database::waitForPendingWrites(tableName());
+    auto& query = preparedQuery(QString("SELECT id FROM %1 WHERE fk_document_uuid = ? AND id < ? "
+                                        "ORDER BY id DESC LIMIT ?")
+                                    .arg(kTableName));
+    query.bindValue(0, _documentUuid.toString());
+    query.bindValue(1, _index.loadedIds.isEmpty() ? std::numeric_limits<int>::max()
+                                                  : _index.loadedIds.constLast());
+    query.bindValue(2, kIndexPageSize);
+    if (!executeSql(query)) {
+        _index.isComplete = true;
+        return;
+    }
+
+    //
+    // Изменения, добавленные после создания индекса, в выборку попасть не должны
+    //
+    const int newIdsFrom = _index.newIds.isEmpty() ? 0 : _index.newIds.constFirst();
+    int loadedCount = 0;
+    while (query.next()) {
+        ++loadedCount;
+        const auto id = query.value(0).toInt();
+        if (newIdsFrom != 0 && id >= newIdsFrom) {
+            continue;
+        }
+        _index.loadedIds.append(id);
+    }
+    query.finish();
+    if (loadedCount == kIndexPageSize) {
+        return;
+    }
+
+    //
+    // Если загружены все изменения, то исключаем самое первое изменение документа, т.к. это
+    // добавление стандартной разметки элемента в пустой документ
+    //
+    _index.isComplete = true;
+    if (!_index.loadedIds.isEmpty()) {
+        _index.firstChangeId = _index.loadedIds.takeLast();
+    } else if (!_index.newIds.isEmpty()) {
+        _index.firstChangeId = _index.newIds.takeFirst();
+    }
+}
+
+QString DocumentChangeMapper::tableName() const
+{
+    return kTableName.trimmed();
+}
+
+QString DocumentChangeMapper::findStatement() const
+{
+    return "SELECT " + kColumns + " FROM " + kTableName + " WHERE id = ? ";
 }
 
 QString DocumentChangeMapper::findAllStatement() const
@@ -239,6 +420,20 @@ QString DocumentChangeMapper::deleteStatement(Domain::DomainObject* _object,
     return deleteStatement;
 }
 
+int DocumentChangeMapper::DocumentChangesIndex::id(int _changeIndex) const
+{
+    if (_changeIndex < newIds.size()) {
+        return newIds.at(newIds.size() - _changeIndex - 1);
+    }
+
+    return loadedIds.at(_changeIndex - newIds.size());
+}
+
+int DocumentChangeMapper::DocumentChangesIndex::size() const
+{
+    return newIds.size() + loadedIds.size();
+}
+
 Domain::DomainObject* DocumentChangeMapper::doLoad(const Domain::Identifier& _id,
                                                    const QSqlRecord& _record)
 {
@@ -2,6 +2,11 @@
 
 #include "abstract_mapper.h"
 
+#include <QHash>
+#include <QUuid>
+
+class QDateTime;
+
 namespace Domain {
 class DocumentChangeObject;
 }
@@ -24,13 +29,57 @@ public:
 
     QVector<QUuid> unsyncedDocuments();
 
+    /**
+     * @brief Изменения документа, которые старше изменения с заданным идентификатором, от новых к
+     *        старым, не более заданного количества
+     */
+    QVector<Domain::DocumentChangeObject*> findPage(const QUuid& _documentUuid, int _beforeId,
+                                                    int _count);
+
+    /**
+     * @brief Изменения документа, которые новее изменения с заданным идентификатором, от старых к
+     *        новым, не более заданного количества
+     */
+    QVector<Domain::DocumentChangeObject*> findPageAfter(const QUuid& _documentUuid, int _afterId,
+                                                         int _count);
+
+    /**
+     * @brief Документы, у которых при объединении изменений по дням уйдёт не меньше заданного
+     *        количества изменений
+     */
+    QVector<QUuid> compactableDocuments(const QDateTime& _before, int _minChangesCount);
+
+    /**
+     * @brief Контрольная точка истории документа: содержимое документа сразу после изменения с
+     *        заданным идентификатором
+     * @note Если контрольной точки нет, то идентификатор изменения нулевой
+     */
+    struct Checkpoint {
+        int changeId = 0;
+        QByteArray content;
+    };
+    Checkpoint checkpoint(const QUuid& _documentUuid);
+    bool saveCheckpoint(const QUuid& _documentUuid, const Checkpoint& _checkpoint);
+    bool removeCheckpoint(const QUuid& _documentUuid);
+
     bool insert(Domain::DocumentChangeObject* _object);
     bool update(Domain::DocumentChangeObject* _object);
     bool remove(Domain::DocumentChangeObject* _object);
     void removeAll();
 
+    /**
+     * @brief Выгрузить изменение из списка загруженных, не удаляя его из БД
+     */
+    void unload(Domain::DocumentChangeObject* _object);
+
+    /**
+     * @brief Очистить все загруженные ранее данные, включая индексы изменений документов
+     */
+    void clear() override;
+
 protected:
-    QString findStatement(const Domain::Identifier& _id) const override;
+    QString tableName() const override;
+    QString findStatement() const override;
     QString findAllStatement() const override;
     QString findLastOneStatement() const override;
     QString insertStatement(Domain::DomainObject* _object,
@@ -44,6 +93,53 @@ protected:
     Domain::DomainObject* doLoad(const Domain::Identifier& _id, const QSqlRecord& _record) override;
     void doLoad(Domain::DomainObject* _object, const QSqlRecord& _record) override;
 
+private:
+    /**
+     * @brief Индекс идентификаторов изменений документа от новых к старым
+     * @note Загружается постранично по мере углубления в историю изменений
+     */
+    struct DocumentChangesIndex {
+        /**
+         * @brief Идентификатор изменения по его индексу, начиная с последнего
+         */
+        int id(int _changeIndex) const;
+
+        /**
+         * @brief Количество известных изменений
+         */
+        int size() const;
+
+        /**
+         * @brief Идентификаторы загруженных из БД изменений, от новых к старым
+         */
+        QVector<int> loadedIds;
+
+        /**
+         * @brief Идентификаторы изменений, добавленных после создания индекса, от старых к новым
+         */
+        QVector<int> newIds;
+
+        /**
+         * @brief Загружены ли все изменения документа
+         */
+        bool isComplete = false;
+
+        /**
+         * @brief Идентификатор самого первого изменения документа, которое не участвует в отмене
+         */
+        int firstChangeId = 0;
+    };
+
+    /**
+     * @brief Загрузить следующую страницу идентификаторов изменений документа
+     */
+    void loadNextPage(const QUuid& _documentUuid, DocumentChangesIndex& _index);
+
+    /**
+     * @brief Индексы изменений документов
+     */
+    QHash<QUuid, DocumentChangesIndex> m_documentsChangesIndexes;
+
 private:
     DocumentChangeMapper() = default;
     friend class MapperFacade;
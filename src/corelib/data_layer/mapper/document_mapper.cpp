@@ -16,53 +16,79 @@ namespace DataMappingLayer {
 
 namespace {
 const QString kColumns = " id, uuid, type, content, synced_at ";
+const QString kMetadataColumns = " id, uuid, type, synced_at ";
 const QString kTableName = " documents ";
 const QString kDateTimeFormat = "yyyy-MM-dd hh:mm:ss:zzz";
-QString uuidFilter(const QUuid& _uuid)
-{
-    return QString(" WHERE uuid = '%1' ").arg(_uuid.toString());
-}
-QString typeFilter(Domain::DocumentObjectType _type)
-{
-    return QString(" WHERE type = %1 ").arg(static_cast<int>(_type));
-}
+const QString kUuidFilter = " WHERE uuid = ? ";
+const QString kTypeFilter = " WHERE type = ? ";
 } // namespace
 
 
+void DocumentMapper::clear()
+{
+    AbstractMapper::clear();
+    m_documentsByUuid.clear();
+    m_isAllDocumentsLoaded = false;
+}
+
 DocumentObject* DocumentMapper::find(const Identifier& _id)
 {
-    return static_cast<DocumentObject*>(abstractFind(_id));
+    auto domainObject = abstractFind(_id);
+    registerDocument(domainObject);
+    return static_cast<DocumentObject*>(domainObject);
 }
 
 DocumentObject* DocumentMapper::find(const QUuid& _uuid)
 {
-    const auto domainObjects = abstractFind(uuidFilter(_uuid));
+    //
+    // Уже загруженный документ отдаём из карты, не обращаясь к базе
+    //
+    if (const auto documentIter = m_documentsByUuid.constFind(_uuid);
+        documentIter != m_documentsByUuid.cend()) {
+        if (documentIter.value()->uuid() == _uuid) {
+            return documentIter.value();
+        }
+
+        //
+        // ... идентификатор документа мог смениться, тогда забываем устаревшую запись
+        //
+        m_documentsByUuid.erase(documentIter);
+    }
+
+    if (m_isAllDocumentsLoaded) {
+        return nullptr;
+    }
+
+    const auto domainObjects = abstractFind(kUuidFilter, { _uuid.toString() });
     if (domainObjects.isEmpty()) {
         return nullptr;
     }
 
+    registerDocument(domainObjects.first());
     return static_cast<DocumentObject*>(domainObjects.first());
 }
 
 Domain::DocumentObject* DocumentMapper::findFirst(Domain::DocumentObjectType _type)
 {
-    const auto domainObjects = abstractFind(typeFilter(_type));
+    const auto domainObjects = abstractFind(kTypeFilter, { static_cast<int>(_type) });
     if (domainObjects.isEmpty()) {
         return nullptr;
     }
 
+    registerDocument(domainObjects.first());
     return static_cast<DocumentObject*>(domainObjects.first());
 }
 
 QVector<Domain::DocumentObject*> DocumentMapper::findAll(Domain::DocumentObjectType _type)
 {
-    const auto domainObjects = abstractFind(typeFilter(_type));
+    const auto domainObjects = abstractFind(kTypeFilter, { static_cast<int>(_type) });
     if (domainObjects.isEmpty()) {
         return {};
     }
 
     QVector<Domain::DocumentObject*> documentObjects;
     for (auto domainObject : domainObjects) {
+        registerDocument(domainObject);
         documentObjects.append(static_cast<DocumentObject*>(domainObject));
     }
     return documentObjects;
@@ -71,43 +97,84 @@ QVector<Domain::DocumentObject*> DocumentMapper::findAll(Domain::DocumentObjectT
 QVector<Domain::DocumentObject*> DocumentMapper::findAll()
 {
     const auto domainObjects = abstractFind("");
+    m_isAllDocumentsLoaded = true;
     if (domainObjects.isEmpty()) {
         return {};
     }
 
     QVector<Domain::DocumentObject*> documentObjects;
     for (auto domainObject : domainObjects) {
+        registerDocument(domainObject);
         documentObjects.append(static_cast<DocumentObject*>(domainObject));
     }
     return documentObjects;
 }
 
+QByteArray DocumentMapper::loadContent(const Domain::Identifier& _id)
+{
+    auto& query = preparedQuery("SELECT content FROM " + kTableName + " WHERE id = ? ");
+    query.bindValue(0, _id.value());
+
+    executeSql(query);
+
+    const auto content = query.next() ? query.value(0).toByteArray() : QByteArray();
+    query.finish();
+    return content;
+}
+
 bool DocumentMapper::insert(DocumentObject* _object)
 {
-    return abstractInsert(_object);
+    //
+    // Объект попадает в список загруженных даже если запись не удалась, поэтому и в карту его
+    // добавляем в любом случае
+    //
+    const auto isInserted = abstractInsert(_object);
+    registerDocument(_object);
+    return isInserted;
 }
 
 bool DocumentMapper::update(DocumentObject* _object)
 {
+    //
+    // Идентификатор документа мог смениться, поэтому обновляем его запись в карте
+    //
+    registerDocument(_object);
     return abstractUpdate(_object);
 }
 
 bool DocumentMapper::remove(DocumentObject* _object)
 {
-    return abstractDelete(_object);
+    const auto uuid = _object->uuid();
+    const auto isRemoved = abstractDelete(_object);
+    if (isRemoved) {
+        m_documentsByUuid.remove(uuid);
+    }
+    return isRemoved;
+}
+
+void DocumentMapper::registerDocument(DomainObject* _object)
+{
+    if (_object == nullptr) {
+        return;
+    }
+
+    auto document = static_cast<DocumentObject*>(_object);
+    m_documentsByUuid.insert(document->uuid(), document);
 }
 
-QString DocumentMapper::findStatement(const Identifier& _id) const
+QString DocumentMapper::tableName() const
 {
-    QString findStatement
-        = QString("SELECT " + kColumns + " FROM " + kTableName + " WHERE id = %1 ")
-              .arg(_id.value());
-    return findStatement;
+    return kTableName.trimmed();
+}
+
+QString DocumentMapper::findStatement() const
+{
+    return "SELECT " + kMetadataColumns + " FROM " + kTableName + " WHERE id = ? ";
 }
 
 QString DocumentMapper::findAllStatement() const
 {
-    return "SELECT " + kColumns + " FROM  " + kTableName;
+    return "SELECT " + kMetadataColumns + " FROM  " + kTableName;
 }
 
 QString DocumentMapper::findLastOneStatement() const
@@ -139,18 +206,27 @@ QString DocumentMapper::insertStatement(DomainObject* _object, QVariantList& _in
 
 QString DocumentMapper::updateStatement(DomainObject* _object, QVariantList& _updateValues) const
 {
+    const auto documentObject = static_cast<DocumentObject*>(_object);
+
+    //
+    // Если содержимое документа не загружалось, значит оно не изменилось и его не нужно
+    // перезаписывать
+    //
     const QString updateStatement = QString("UPDATE " + kTableName
                                             + " SET uuid = ?, "
                                               " type = ?, "
-                                              " content = ?, "
-                                              " synced_at = ? "
+                                            + (documentObject->isContentLoaded()
+                                                   ? " content = ?, "
+                                                   : "")
+                                            + " synced_at = ? "
                                               " WHERE id = ? ");
 
-    const auto documentObject = static_cast<DocumentObject*>(_object);
     _updateValues.clear();
     _updateValues.append(documentObject->uuid().toString());
     _updateValues.append(static_cast<int>(documentObject->type()));
-    _updateValues.append(documentObject->content());
+    if (documentObject->isContentLoaded()) {
+        _updateValues.append(documentObject->content());
+    }
     _updateValues.append(documentObject->syncedAt().isValid()
                              ? documentObject->syncedAt().toString(kDateTimeFormat)
                              : QVariant());
@@ -173,11 +249,15 @@ DomainObject* DocumentMapper::doLoad(const Identifier& _id, const QSqlRecord& _r
 {
     const auto uuid = QUuid::fromString(_record.value("uuid").toString());
     const auto type = static_cast<DocumentObjectType>(_record.value("type").toInt());
-    const auto content = _record.value("content").toByteArray();
     const auto syncedAt
         = QDateTime::fromString(_record.value("synced_at").toString(), kDateTimeFormat);
 
-    return Domain::ObjectsBuilder::createDocument(_id, uuid, type, content, syncedAt);
+    auto document = Domain::ObjectsBuilder::createDocument(_id, uuid, type, {}, syncedAt);
+    //
+    // ... содержимое загружается только при первом обращении к нему
+    //
+    document->setContentLoader([this, _id] { return loadContent(_id); });
+    return document;
 }
 
 void DocumentMapper::doLoad(DomainObject* _object, const QSqlRecord& _record)
@@ -193,8 +273,10 @@ void DocumentMapper::doLoad(DomainObject* _object, const QSqlRecord& _record)
     const DocumentObjectType type = static_cast<DocumentObjectType>(_record.value("type").toInt());
     documentObject->setType(type);
 
-    const auto content = _record.value("content").toByteArray();
-    documentObject->setContent(content);
+    //
+    // Содержимое не перезагружаем, т.к. оно изменяется только через сам объект, а если ещё
+    // не было загружено, то будет загружено при первом обращении
+    //
 
     const auto syncedAt
         = QDateTime::fromString(_record.value("synced_at").toString(), kDateTimeFormat);
@@ -2,6 +2,8 @@
 
 #include "abstract_mapper.h"
 
+#include <QUuid>
+
 namespace Domain {
 class DocumentObject;
 enum class DocumentObjectType;
@@ -16,18 +18,30 @@ namespace DataMappingLayer {
 class DocumentMapper : public AbstractMapper
 {
 public:
+    /**
+     * @brief Очистить загруженные документы вместе с их картой по идентификаторам
+     */
+    void clear() override;
+
     Domain::DocumentObject* find(const Domain::Identifier& _id);
     Domain::DocumentObject* find(const QUuid& _uuid);
     Domain::DocumentObject* findFirst(Domain::DocumentObjectType _type);
     QVector<Domain::DocumentObject*> findAll(Domain::DocumentObjectType _type);
     QVector<Domain::DocumentObject*> findAll();
 
+    /**
+     * @brief Загрузить содержимое документа
+     * @note Документы загружаются без содержимого, оно подгружается при первом обращении к нему
+     */
+    QByteArray loadContent(const Domain::Identifier& _id);
+
     bool insert(Domain::DocumentObject* _object);
     bool update(Domain::DocumentObject* _object);
     bool remove(Domain::DocumentObject* _object);
 
 protected:
-    QString findStatement(const Domain::Identifier& _id) const override;
+    QString tableName() const override;
+    QString findStatement() const override;
     QString findAllStatement() const override;
     QString findLastOneStatement() const override;
     QString insertStatement(Domain::DomainObject* _object,
@@ -44,6 +58,23 @@ protected:
 private:
     DocumentMapper() = default;
     friend class MapperFacade;
+
+    /**
+     * @brief Запомнить загруженные документы в карте по их идентификаторам
+     */
+    void registerDocument(Domain::DomainObject* _object);
+
+    /**
+     * @brief Загруженные документы по их уникальным идентификаторам, чтобы повторный поиск
+     *        документа обходился без запросов к базе
+     */
+    QHash<QUuid, Domain::DocumentObject*> m_documentsByUuid;
+
+    /**
+     * @brief Были ли загружены все документы проекта, если да, то документа, которого нет
+     *        в карте, нет и в базе
+     */
+    bool m_isAllDocumentsLoaded = false;
 };
 
 } // namespace DataMappingLayer
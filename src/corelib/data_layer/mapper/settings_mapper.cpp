@@ -11,6 +11,7 @@ namespace DataMappingLayer {
 
 void SettingsMapper::setValue(const QString& _key, const QString& _value)
 {
+    DatabaseLayer::Database::waitForPendingWrites();
     QSqlQuery q_loader = DatabaseLayer::Database::query();
     q_loader.prepare("INSERT INTO system_variables VALUES (?, ?)");
     q_loader.addBindValue(_key);
@@ -20,6 +21,7 @@ void SettingsMapper::setValue(const QString& _key, const QString& _value)
 
 QString SettingsMapper::value(const QString& _key)
 {
+    DatabaseLayer::Database::waitForPendingWrites("system_variables");
     QSqlQuery q_loader = DatabaseLayer::Database::query();
     q_loader.prepare("SELECT value FROM system_variables WHERE variable = ?");
     q_loader.addBindValue(_key);
@@ -5,17 +5,286 @@
 #include <data_layer/mapper/mapper_facade.h>
 #include <domain/document_change_object.h>
 #include <domain/objects_builder.h>
+#include <utils/logging.h>
 #include <utils/shugar.h>
 
+#include <QDateTime>
+
+#include <limits>
+
 
 namespace DataStorageLayer {
 
+namespace {
+
+/**
+ * @brief Количество изменений, загружаемых за раз при обходе истории документа
+ */
+constexpr int kChangesPageSize = 200;
+
+/**
+ * @brief Выгрузить обработанное изменение
+ * @note Несинхронизированные изменения могут понадобиться при синхронизации
+ */
+void unloadProcessedChange(Domain::DocumentChangeObject* _change)
+{
+    if (_change->isSynced()) {
+        DataMappingLayer::MapperFacade::documentChangeMapper()->unload(_change);
+    }
+}
+
+} // namespace
+
 class DocumentChangeStorage::Implementation
 {
 public:
+    /**
+     * @brief Объединить изменения, воспроизводя историю вперёд от контрольной точки
+     * @return Удалось ли воспроизвести историю, если нет, то контрольная точка удаляется
+     */
+    bool compactForward(const QUuid& _documentUuid,
+                        const DataMappingLayer::DocumentChangeMapper::Checkpoint& _checkpoint,
+                        const QDateTime& _before, const ApplyPatches& _applyPatches,
+                        const MakePatch& _makePatch, bool& _isCompacted);
+
+    /**
+     * @brief Объединить изменения, откатывая историю назад от текущего содержимого
+     */
+    bool compactBackward(const QUuid& _documentUuid, const QByteArray& _content,
+                         const QDateTime& _before, const ApplyPatches& _applyPatches,
+                         const MakePatch& _makePatch);
+
+    /**
+     * @brief Заменить последовательные изменения документа одним изменением с заданными патчами
+     * @note Сохраняется последнее из изменений, а остальные удаляются вместе с объектами
+     */
+    void squash(const QVector<Domain::DocumentChangeObject*>& _changes,
+                const QByteArray& _undoPatch, const QByteArray& _redoPatch);
+
+
     QVector<Domain::DocumentChangeObject*> newDocumentChanges;
 };
 
+bool DocumentChangeStorage::Implementation::compactForward(
+    const QUuid& _documentUuid,
+    const DataMappingLayer::DocumentChangeMapper::Checkpoint& _checkpoint,
+    const QDateTime& _before, const ApplyPatches& _applyPatches, const MakePatch& _makePatch,
+    bool& _isCompacted)
+{
+    auto mapper = DataMappingLayer::MapperFacade::documentChangeMapper();
+
+    //
+    // Контрольная точка должна ссылаться на сохранившееся изменение документа
+    //
+    const auto checkpointChange = mapper->find(Domain::Identifier(_checkpoint.changeId));
+    if (checkpointChange == nullptr || checkpointChange->documentUuid() != _documentUuid) {
+        mapper->removeCheckpoint(_documentUuid);
+        return false;
+    }
+    unloadProcessedChange(checkpointChange);
+
+    //
+    // Историю загружаем постранично от старых изменений к новым, а обработанные изменения сразу
+    // выгружаем
+    //
+    QVector<Domain::DocumentChangeObject*> changes;
+    int lastLoadedChangeId = _checkpoint.changeId;
+    bool isAllChangesLoaded = false;
+    auto loadChanges = [&] {
+        while (!isAllChangesLoaded && changes.isEmpty()) {
+            const auto page
+                = mapper->findPageAfter(_documentUuid, lastLoadedChangeId, kChangesPageSize);
+            isAllChangesLoaded = page.size() < kChangesPageSize;
+            if (!page.isEmpty()) {
+                lastLoadedChangeId = page.constLast()->id().value();
+            }
+            changes.append(page);
+        }
+    };
+
+    //
+    // Идём от контрольной точки вперёд, пока изменения попадают под сжатие, накладывая изменения
+    // каждого дня разом и заменяя их одним изменением
+    //
+    auto checkpoint = _checkpoint;
+    bool isReplayed = true;
+    loadChanges();
+    while (!changes.isEmpty()) {
+        const auto change = changes.constFirst();
+        if (!change->isSynced() || change->dateTime() >= _before) {
+            break;
+        }
+
+        QVector<Domain::DocumentChangeObject*> squashedChanges;
+        QVector<QByteArray> redoPatches;
+        const auto squashedDate = change->dateTime().date();
+        while (!changes.isEmpty() && changes.constFirst()->isSynced()
+               && changes.constFirst()->dateTime().date() == squashedDate) {
+            squashedChanges.append(changes.takeFirst());
+            redoPatches.append(squashedChanges.constLast()->redoPatch());
+            loadChanges();
+        }
+
+        const auto squashedContent = _applyPatches(checkpoint.content, redoPatches);
+        if (squashedContent.isEmpty()) {
+            for (auto squashedChange : std::as_const(squashedChanges)) {
+                unloadProcessedChange(squashedChange);
+            }
+            isReplayed = false;
+            break;
+        }
+        if (squashedChanges.size() > 1) {
+            squash(squashedChanges, _makePatch(squashedContent, checkpoint.content),
+                   _makePatch(checkpoint.content, squashedContent));
+            _isCompacted = true;
+            squashedChanges = { squashedChanges.constLast() };
+        }
+        checkpoint = { squashedChanges.constLast()->id().value(), squashedContent };
+        unloadProcessedChange(squashedChanges.constLast());
+    }
+    for (auto change : std::as_const(changes)) {
+        unloadProcessedChange(change);
+    }
+
+    //
+    // Если история не воспроизвелась, то контрольная точка не соответствует ей, поэтому удаляем
+    // её, чтобы она была построена заново от текущего содержимого
+    //
+    if (!isReplayed) {
+        Log::warning("Can't replay changes history of document %1 from checkpoint",
+                     _documentUuid.toString());
+        mapper->removeCheckpoint(_documentUuid);
+        return false;
+    }
+
+    if (checkpoint.changeId != _checkpoint.changeId) {
+        mapper->saveCheckpoint(_documentUuid, checkpoint);
+    }
+    return true;
+}
+
+bool DocumentChangeStorage::Implementation::compactBackward(const QUuid& _documentUuid,
+                                                            const QByteArray& _content,
+                                                            const QDateTime& _before,
+                                                            const ApplyPatches& _applyPatches,
+                                                            const MakePatch& _makePatch)
+{
+    auto mapper = DataMappingLayer::MapperFacade::documentChangeMapper();
+
+    //
+    // Историю загружаем постранично от новых изменений к старым, догружая очередную страницу
+    // так, чтобы за текущим изменением всегда было видно, есть ли ещё более старые, а
+    // обработанные изменения сразу выгружаем
+    //
+    QVector<Domain::DocumentChangeObject*> changes;
+    int lastLoadedChangeId = std::numeric_limits<int>::max();
+    bool isAllChangesLoaded = false;
+    auto loadChanges = [&] {
+        while (!isAllChangesLoaded && changes.size() < 2) {
+            const auto page
+                = mapper->findPage(_documentUuid, lastLoadedChangeId, kChangesPageSize);
+            isAllChangesLoaded = page.size() < kChangesPageSize;
+            if (!page.isEmpty()) {
+                lastLoadedChangeId = page.constLast()->id().value();
+            }
+            changes.append(page);
+        }
+    };
+
+    //
+    // Идём от последнего изменения к первому, восстанавливая содержимое документа на момент
+    // каждого изменения, и заменяем последовательные изменения одного дня одним изменением
+    // NOTE: самое первое изменение документа не трогаем, т.к. оно не участвует в отмене
+    //
+    bool isCompacted = false;
+    DataMappingLayer::DocumentChangeMapper::Checkpoint checkpoint;
+    auto content = _content;
+    loadChanges();
+    while (changes.size() > 1 && !content.isEmpty()) {
+        const auto change = changes.constFirst();
+        if (!change->isSynced() || change->dateTime() >= _before) {
+            content = _applyPatches(content, { change->undoPatch() });
+            unloadProcessedChange(changes.takeFirst());
+            loadChanges();
+            continue;
+        }
+
+        QVector<Domain::DocumentChangeObject*> squashedChanges;
+        QVector<QByteArray> undoPatches;
+        const auto squashedDate = change->dateTime().date();
+        while (changes.size() > 1 && changes.constFirst()->isSynced()
+               && changes.constFirst()->dateTime().date() == squashedDate) {
+            squashedChanges.prepend(changes.constFirst());
+            undoPatches.append(changes.constFirst()->undoPatch());
+            changes.removeFirst();
+            loadChanges();
+        }
+
+        const auto squashedContent = _applyPatches(content, undoPatches);
+        if (squashedContent.isEmpty()) {
+            Log::warning("Can't compact changes history of document %1",
+                         _documentUuid.toString());
+            for (auto squashedChange : std::as_const(squashedChanges)) {
+                unloadProcessedChange(squashedChange);
+            }
+            break;
+        }
+        if (squashedChanges.size() > 1) {
+            squash(squashedChanges, _makePatch(content, squashedContent),
+                   _makePatch(squashedContent, content));
+            isCompacted = true;
+            //
+            // ... после объединения в памяти остаётся лишь последнее из изменений
+            //
+            squashedChanges = { squashedChanges.constLast() };
+        }
+        //
+        // ... следующее сжатие начнётся с самого нового из сжатых дней
+        //
+        if (checkpoint.changeId == 0) {
+            checkpoint = { squashedChanges.constLast()->id().value(), content };
+        }
+        for (auto squashedChange : std::as_const(squashedChanges)) {
+            unloadProcessedChange(squashedChange);
+        }
+        content = squashedContent;
+    }
+    for (auto change : std::as_const(changes)) {
+        unloadProcessedChange(change);
+    }
+
+    if (checkpoint.changeId != 0) {
+        mapper->saveCheckpoint(_documentUuid, checkpoint);
+    }
+    return isCompacted;
+}
+
+void DocumentChangeStorage::Implementation::squash(
+    const QVector<Domain::DocumentChangeObject*>& _changes, const QByteArray& _undoPatch,
+    const QByteArray& _redoPatch)
+{
+    if (_changes.size() < 2) {
+        return;
+    }
+
+    DatabaseLayer::Database::transaction();
+
+    auto lastChange = _changes.constLast();
+    lastChange->setUndoPatch(_undoPatch);
+    lastChange->setRedoPatch(_redoPatch);
+    auto mapper = DataMappingLayer::MapperFacade::documentChangeMapper();
+    auto isSquashed = mapper->update(lastChange);
+    for (int index = 0; isSquashed && index < _changes.size() - 1; ++index) {
+        isSquashed = mapper->remove(_changes[index]);
+    }
+
+    if (isSquashed) {
+        DatabaseLayer::Database::commit();
+    } else {
+        DatabaseLayer::Database::rollback();
+    }
+}
+
 
 // ****
 
@@ -117,6 +386,63 @@ QVector<Domain::DocumentChangeObject*> DocumentChangeStorage::unsyncedDocumentCh
     return changes;
 }
 
+QVector<Domain::DocumentChangeObject*> DocumentChangeStorage::documentChangesPage(
+    const QUuid& _documentUuid, int _beforeId, int _count)
+{
+    return DataMappingLayer::MapperFacade::documentChangeMapper()->findPage(_documentUuid,
+                                                                            _beforeId, _count);
+}
+
+void DocumentChangeStorage::unloadDocumentChanges(
+    const QVector<Domain::DocumentChangeObject*>& _changes)
+{
+    for (auto change : _changes) {
+        DataMappingLayer::MapperFacade::documentChangeMapper()->unload(change);
+    }
+}
+
+QVector<QUuid> DocumentChangeStorage::compactableDocuments(const QDateTime& _before,
+                                                           int _minChangesCount)
+{
+    auto documents = DataMappingLayer::MapperFacade::documentChangeMapper()->compactableDocuments(
+        _before, _minChangesCount);
+
+    //
+    // Пока есть несохранённые изменения, содержимое документа не соответствует сохранённой истории
+    //
+    for (const auto change : std::as_const(d->newDocumentChanges)) {
+        documents.removeAll(change->documentUuid());
+    }
+    return documents;
+}
+
+bool DocumentChangeStorage::compactDocumentChanges(const QUuid& _documentUuid,
+                                                   const QByteArray& _content,
+                                                   const QDateTime& _before,
+                                                   const ApplyPatches& _applyPatches,
+                                                   const MakePatch& _makePatch)
+{
+    if (_content.isEmpty()) {
+        return false;
+    }
+
+    //
+    // Воспроизводить историю от контрольной точки дешевле, чем откатывать её от текущего
+    // содержимого, т.к. проходятся только изменения, сделанные после предыдущего сжатия
+    //
+    bool isCompacted = false;
+    const auto checkpoint
+        = DataMappingLayer::MapperFacade::documentChangeMapper()->checkpoint(_documentUuid);
+    if (checkpoint.changeId != 0
+        && d->compactForward(_documentUuid, checkpoint, _before, _applyPatches, _makePatch,
+                             isCompacted)) {
+        return isCompacted;
+    }
+
+    return d->compactBackward(_documentUuid, _content, _before, _applyPatches, _makePatch)
+        || isCompacted;
+}
+
 void DocumentChangeStorage::store()
 {
     DatabaseLayer::Database::transaction();
@@ -4,6 +4,8 @@
 
 #include <corelib_global.h>
 
+#include <functional>
+
 class QDateTime;
 class QUuid;
 
@@ -59,6 +61,43 @@ public:
      */
     QVector<Domain::DocumentChangeObject*> unsyncedDocumentChanges(const QUuid& _documentUuid);
 
+    /**
+     * @brief Сохранённые изменения документа, которые старше изменения с заданным
+     *        идентификатором, от новых к старым, не более заданного количества
+     */
+    QVector<Domain::DocumentChangeObject*> documentChangesPage(const QUuid& _documentUuid,
+                                                               int _beforeId, int _count);
+
+    /**
+     * @brief Выгрузить из памяти изменения, которые больше не нужны
+     * @note Изменения остаются в БД и будут загружены заново при следующем обращении
+     */
+    void unloadDocumentChanges(const QVector<Domain::DocumentChangeObject*>& _changes);
+
+    /**
+     * @brief Документы, у которых объединение изменений по дням избавит не меньше чем от заданного
+     *        количества изменений
+     */
+    QVector<QUuid> compactableDocuments(const QDateTime& _before, int _minChangesCount);
+
+    /**
+     * @brief Объединить по дням синхронизированные изменения документа, сделанные до заданного
+     *        момента
+     * @param _content Текущее содержимое документа
+     * @param _applyPatches Наложить патчи на содержимое, пустой результат означает, что какой-то
+     *        из патчей не наложился
+     * @param _makePatch Сформировать патч для перехода между версиями документа
+     * @return Были ли объединены изменения
+     * @note История воспроизводится вперёд от контрольной точки, сохранённой при предыдущем
+     *       сжатии, а если её нет, то откатывается назад от текущего содержимого, после чего
+     *       контрольная точка запоминается на последнем обработанном изменении
+     */
+    using ApplyPatches = std::function<QByteArray(const QByteArray&, const QVector<QByteArray>&)>;
+    using MakePatch = std::function<QByteArray(const QByteArray&, const QByteArray&)>;
+    bool compactDocumentChanges(const QUuid& _documentUuid, const QByteArray& _content,
+                                const QDateTime& _before, const ApplyPatches& _applyPatches,
+                                const MakePatch& _makePatch);
+
     /**
      * @brief Сохранить несохранённые изменения сценарии
      */
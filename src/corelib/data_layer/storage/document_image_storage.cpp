@@ -1,17 +1,128 @@
 #include "document_image_storage.h"
 
+#include <data_layer/database.h>
 #include <data_layer/storage/document_storage.h>
 #include <data_layer/storage/storage_facade.h>
 #include <domain/document_object.h>
 #include <utils/helpers/image_helper.h>
 
+#include <QBuffer>
 #include <QCache>
+#include <QCryptographicHash>
+#include <QFutureWatcher>
 #include <QHash>
+#include <QImageReader>
 #include <QPixmap>
+#include <QSet>
+#include <QSqlQuery>
+#include <QtConcurrentRun>
 
 
 namespace DataStorageLayer {
 
+namespace {
+
+/**
+ * @brief Размеры уменьшенных копий изображений, сохраняемых в базе
+ */
+const QVector<int> kThumbnailSizes = { 256, 1024 };
+
+/**
+ * @brief Максимальный объём кэшей изображений и уменьшенных копий в килобайтах
+ */
+const int kImagesCacheMaxCost = 256 * 1024;
+const int kThumbnailsCacheMaxCost = 64 * 1024;
+
+/**
+ * @brief Качество сохраняемых уменьшенных копий
+ */
+const int kThumbnailQuality = 85;
+
+/**
+ * @brief Объём занимаемой изображением памяти в килобайтах
+ */
+int imageCost(const QPixmap& _image)
+{
+    return qMax(1, _image.width() * _image.height() * _image.depth() / 8 / 1024);
+}
+
+/**
+ * @brief Хэш содержимого изображения, по которому одинаковые изображения разных документов
+ *        используют общие кэш и уменьшенные копии
+ */
+QByteArray contentHash(const QByteArray& _content)
+{
+    return QCryptographicHash::hash(_content, QCryptographicHash::Sha1).toHex();
+}
+
+/**
+ * @brief Размер уменьшенной копии, подходящей для отображения изображения в заданном размере,
+ *        либо ноль, если нужен оригинал
+ */
+int thumbnailSizeFor(int _size)
+{
+    for (const auto size : kThumbnailSizes) {
+        if (_size <= size) {
+            return size;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Декодировать изображение, сразу уменьшая его до заданного размера
+ * @note Может вызываться в фоновом потоке, поэтому работаем с QImage, а не QPixmap
+ */
+QImage decodeImage(const QByteArray& _content, int _size)
+{
+    QBuffer buffer;
+    buffer.setData(_content);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(true);
+    const auto imageSize = reader.size();
+    if (_size > 0 && imageSize.isValid()
+        && (imageSize.width() > _size || imageSize.height() > _size)) {
+        reader.setScaledSize(imageSize.scaled(_size, _size, Qt::KeepAspectRatio));
+    }
+    return reader.read();
+}
+
+/**
+ * @brief Закодировать уменьшенную копию для сохранения в базе
+ */
+QByteArray encodeThumbnail(const QImage& _thumbnail)
+{
+    QByteArray thumbnailData;
+    QBuffer thumbnailDataBuffer(&thumbnailData);
+    thumbnailDataBuffer.open(QIODevice::WriteOnly);
+    _thumbnail.save(&thumbnailDataBuffer, _thumbnail.hasAlphaChannel() ? "PNG" : "JPG",
+                    kThumbnailQuality);
+    return thumbnailData;
+}
+
+/**
+ * @brief Выполнить запрос на запись, если запущена фоновая запись, то запрос будет выполнен
+ *        в её пакете
+ */
+void executeWrite(const QString& _statement, const QVariantList& _values)
+{
+    if (DatabaseLayer::Database::isAsyncWriting()) {
+        DatabaseLayer::Database::appendAsyncWrite(_statement, _values);
+        return;
+    }
+
+    DatabaseLayer::Database::waitForPendingWrites();
+    auto query = DatabaseLayer::Database::query();
+    query.prepare(_statement);
+    for (const auto& value : _values) {
+        query.addBindValue(value);
+    }
+    query.exec();
+}
+
+} // namespace
+
 class DocumentImageStorage::Implementation
 {
 public:
@@ -22,13 +133,72 @@ public:
      */
     void notifyImageRequested(const QUuid& _uuid) const;
 
+    /**
+     * @brief Определить хэш содержимого изображения, загрузив его документ при необходимости
+     * @return Пустой хэш, если изображения пока нет в базе
+     */
+    QByteArray imageHash(const QUuid& _uuid) const;
+
+    /**
+     * @brief Запомнить хэш содержимого изображения, чтобы сохранить его в базу
+     */
+    void setImageHash(const QUuid& _uuid, const QByteArray& _hash) const;
+
+    /**
+     * @brief Загрузить сохранённую в базе уменьшенную копию
+     */
+    QByteArray loadStoredThumbnail(const QByteArray& _hash, int _size) const;
+
+    /**
+     * @brief Построить уменьшенную копию в фоновом потоке
+     */
+    void buildThumbnail(const QUuid& _uuid, const QByteArray& _hash, int _size,
+                        int _requestedSize) const;
+
 
     DocumentImageStorage* q = nullptr;
 
     /**
-     * @brief Кэш загруженных изображений
+     * @brief Хэши содержимого загруженных изображений
      */
-    mutable QCache<QUuid, QPixmap> cachedImages;
+    mutable QHash<QUuid, QByteArray> imageHashes;
+
+    /**
+     * @brief Хэши содержимого изображений, ещё не сохранённые в базу
+     */
+    mutable QHash<QUuid, QByteArray> newImageHashes;
+
+    /**
+     * @brief Изображения, которых пока нет в базе
+     */
+    mutable QSet<QUuid> missingImages;
+
+    /**
+     * @brief Кэш загруженных изображений по хэшу содержимого
+     */
+    mutable QCache<QByteArray, QPixmap> cachedImages;
+
+    /**
+     * @brief Кэш уменьшенных копий по хэшу содержимого и размеру
+     */
+    using ThumbnailKey = QPair<QByteArray, int>;
+    mutable QCache<ThumbnailKey, QPixmap> cachedThumbnails;
+
+    /**
+     * @brief Строящиеся уменьшенные копии и ожидающие их запросы (изображение и размер)
+     */
+    mutable QHash<ThumbnailKey, QVector<QPair<QUuid, int>>> thumbnailsInProgress;
+
+    /**
+     * @brief Построенные уменьшенные копии, ещё не сохранённые в базу
+     */
+    mutable QHash<ThumbnailKey, QByteArray> newThumbnails;
+
+    /**
+     * @brief Номер проекта, для которого строятся уменьшенные копии, чтобы не сохранять
+     *        копии, построенные для ранее открытого проекта
+     */
+    int projectNumber = 0;
 
     /**
      * @brief Список новых изображений
@@ -43,6 +213,8 @@ public:
 
 DocumentImageStorage::Implementation::Implementation(DocumentImageStorage* _q)
     : q(_q)
+    , cachedImages(kImagesCacheMaxCost)
+    , cachedThumbnails(kThumbnailsCacheMaxCost)
 {
 }
 
@@ -52,6 +224,103 @@ void DocumentImageStorage::Implementation::notifyImageRequested(const QUuid& _uu
         q, [this, _uuid] { emit q->imageRequested(_uuid); }, Qt::QueuedConnection);
 }
 
+QByteArray DocumentImageStorage::Implementation::imageHash(const QUuid& _uuid) const
+{
+    if (const auto hash = imageHashes.value(_uuid); !hash.isEmpty()) {
+        return hash;
+    }
+
+    const auto imageDocument = StorageFacade::documentStorage()->document(_uuid);
+    if (imageDocument == nullptr) {
+        return {};
+    }
+
+    const auto hash = contentHash(imageDocument->content());
+    setImageHash(_uuid, hash);
+    return hash;
+}
+
+void DocumentImageStorage::Implementation::setImageHash(const QUuid& _uuid,
+                                                        const QByteArray& _hash) const
+{
+    auto hashIter = imageHashes.find(_uuid);
+    if (hashIter != imageHashes.end() && hashIter.value() == _hash) {
+        return;
+    }
+
+    imageHashes.insert(_uuid, _hash);
+    newImageHashes.insert(_uuid, _hash);
+}
+
+QByteArray DocumentImageStorage::Implementation::loadStoredThumbnail(const QByteArray& _hash,
+                                                                     int _size) const
+{
+    auto query = DatabaseLayer::Database::query();
+    query.prepare("SELECT content FROM images_thumbnails WHERE content_hash = ? AND size = ?");
+    query.addBindValue(QString::fromLatin1(_hash));
+    query.addBindValue(_size);
+    if (!query.exec() || !query.next()) {
+        return {};
+    }
+    return query.value(0).toByteArray();
+}
+
+void DocumentImageStorage::Implementation::buildThumbnail(const QUuid& _uuid,
+                                                          const QByteArray& _hash, int _size,
+                                                          int _requestedSize) const
+{
+    const ThumbnailKey thumbnailKey{ _hash, _size };
+    auto& waitingRequests = thumbnailsInProgress[thumbnailKey];
+    waitingRequests.append({ _uuid, _requestedSize });
+    if (waitingRequests.size() > 1) {
+        return;
+    }
+
+    //
+    // Данные берём в основном потоке, т.к. работа с базой и документами не потокобезопасна,
+    // а декодирование выполняем в фоне
+    //
+    auto content = loadStoredThumbnail(_hash, _size);
+    const auto isStored = !content.isEmpty();
+    if (!isStored) {
+        const auto imageDocument = StorageFacade::documentStorage()->document(_uuid);
+        content = imageDocument != nullptr ? imageDocument->content() : QByteArray();
+    }
+
+    struct Thumbnail {
+        QImage image;
+        QByteArray content;
+    };
+    auto watcher = new QFutureWatcher<Thumbnail>(q);
+    QObject::connect(watcher, &QFutureWatcher<Thumbnail>::finished, q,
+                     [this, watcher, thumbnailKey, projectNumber = projectNumber] {
+                         watcher->deleteLater();
+                         const auto thumbnail = watcher->result();
+                         const auto requests = thumbnailsInProgress.take(thumbnailKey);
+                         if (thumbnail.image.isNull()) {
+                             return;
+                         }
+
+                         const auto image = QPixmap::fromImage(thumbnail.image);
+                         cachedThumbnails.insert(thumbnailKey, new QPixmap(image),
+                                                 imageCost(image));
+                         if (!thumbnail.content.isEmpty() && projectNumber == this->projectNumber) {
+                             newThumbnails.insert(thumbnailKey, thumbnail.content);
+                         }
+                         for (const auto& request : requests) {
+                             emit q->thumbnailLoaded(request.first, request.second, image);
+                         }
+                     });
+    watcher->setFuture(QtConcurrent::run([content, isStored, _size] {
+        Thumbnail thumbnail;
+        thumbnail.image = decodeImage(content, isStored ? 0 : _size);
+        if (!isStored && !thumbnail.image.isNull()) {
+            thumbnail.content = encodeThumbnail(thumbnail.image);
+        }
+        return thumbnail;
+    }));
+}
+
 
 // ****
 
@@ -74,11 +343,12 @@ QPixmap DocumentImageStorage::load(const QUuid& _uuid) const
         return imageIter.value();
     }
 
-    if (d->cachedImages.contains(_uuid)) {
-        auto cachedImage = d->cachedImages[_uuid];
-        if (cachedImage == nullptr) {
-            return {};
-        }
+    if (d->missingImages.contains(_uuid)) {
+        return {};
+    }
+
+    const auto hash = d->imageHashes.value(_uuid);
+    if (auto cachedImage = d->cachedImages.object(hash); cachedImage != nullptr) {
         return *cachedImage;
     }
 
@@ -91,22 +361,77 @@ QPixmap DocumentImageStorage::load(const QUuid& _uuid) const
     //
     d->notifyImageRequested(_uuid);
     //
-    // ... если изображения пока нет в базе, то поставим в кэш заглушку для него
+    // ... если изображения пока нет в базе, то запомним это, чтобы не искать его повторно
     //
     if (imageDocument == nullptr) {
-        d->cachedImages.insert(_uuid, {});
+        d->missingImages.insert(_uuid);
         return {};
     }
 
     Q_ASSERT(imageDocument->type() == Domain::DocumentObjectType::ImageData);
 
     //
-    // NOTE: тут грузим вручную, а не через Imagehelper т.к. в кэш нужен именно указатель
+    // ... одинаковые изображения разных документов декодируем и храним в кэше один раз
     //
-    QPixmap* image = new QPixmap;
-    image->loadFromData(imageDocument->content());
-    d->cachedImages.insert(_uuid, image);
-    return *image;
+    const auto imageHash = contentHash(imageDocument->content());
+    d->setImageHash(_uuid, imageHash);
+    if (auto cachedImage = d->cachedImages.object(imageHash); cachedImage != nullptr) {
+        return *cachedImage;
+    }
+
+    const auto image = QPixmap::fromImage(decodeImage(imageDocument->content(), 0));
+    d->cachedImages.insert(imageHash, new QPixmap(image), imageCost(image));
+    return image;
+}
+
+QPixmap DocumentImageStorage::loadThumbnail(const QUuid& _uuid, int _size) const
+{
+    const auto thumbnailSize = thumbnailSizeFor(_size);
+    if (_uuid.isNull() || thumbnailSize == 0) {
+        return load(_uuid);
+    }
+
+    auto scaled = [thumbnailSize](const QPixmap& _image) {
+        if (_image.width() <= thumbnailSize && _image.height() <= thumbnailSize) {
+            return _image;
+        }
+        return _image.scaled(thumbnailSize, thumbnailSize, Qt::KeepAspectRatio,
+                             Qt::SmoothTransformation);
+    };
+
+    //
+    // Новые изображения уже находятся в памяти
+    //
+    if (auto imageIter = d->newImages.find(_uuid); imageIter != d->newImages.end()) {
+        return scaled(imageIter.value());
+    }
+
+    //
+    // Если изображения пока нет в базе, то загружаем его обычным способом, чтобы оно было
+    // запрошено у внешнего сервиса
+    //
+    const auto hash = d->missingImages.contains(_uuid) ? QByteArray() : d->imageHash(_uuid);
+    if (hash.isEmpty()) {
+        return load(_uuid);
+    }
+
+    const Implementation::ThumbnailKey thumbnailKey{ hash, thumbnailSize };
+    if (auto cachedThumbnail = d->cachedThumbnails.object(thumbnailKey);
+        cachedThumbnail != nullptr) {
+        return *cachedThumbnail;
+    }
+
+    //
+    // Если оригинал уже декодирован, то просто уменьшаем его
+    //
+    if (auto cachedImage = d->cachedImages.object(hash); cachedImage != nullptr) {
+        const auto thumbnail = scaled(*cachedImage);
+        d->cachedThumbnails.insert(thumbnailKey, new QPixmap(thumbnail), imageCost(thumbnail));
+        return thumbnail;
+    }
+
+    d->buildThumbnail(_uuid, hash, thumbnailSize, _size);
+    return {};
 }
 
 QUuid DocumentImageStorage::save(const QPixmap& _image)
@@ -126,6 +451,7 @@ QUuid DocumentImageStorage::save(const QPixmap& _image)
     auto document = StorageFacade::documentStorage()->createDocument(
         uuid, Domain::DocumentObjectType::ImageData);
     document->setContent(ImageHelper::bytesFromImage(_image));
+    d->setImageHash(uuid, contentHash(document->content()));
     //
     // ... уведомляем о добавленном изображении
     //
@@ -151,11 +477,10 @@ void DocumentImageStorage::save(const QUuid& _uuid, const QByteArray& _imageData
     const auto image = ImageHelper::imageFromBytes(_imageData);
     d->newImages.insert(_uuid, image);
     //
-    // ... уберём заглушку из кэша, если она там была
+    // ... уберём заглушку из кэша, если она там была, и обновим хэш содержимого
     //
-    if (d->cachedImages.contains(_uuid)) {
-        d->cachedImages.remove(_uuid);
-    }
+    d->missingImages.remove(_uuid);
+    d->setImageHash(_uuid, contentHash(_imageData));
     //
     // ... положим в хранилище, если ещё не был сохранён
     //
@@ -186,6 +511,7 @@ void DocumentImageStorage::remove(const QUuid& _uuid)
     if (!d->newImages.remove(_uuid)) {
         d->imagesToRemove.append(_uuid);
     }
+    d->newImageHashes.remove(_uuid);
     emit imageRemoved(_uuid);
 }
 
@@ -196,6 +522,10 @@ void DocumentImageStorage::clear()
     // тот же проект, в противном же случае айдишники картинок будут уникальны в любом случае
     //
 
+    ++d->projectNumber;
+    d->missingImages.clear();
+    d->newThumbnails.clear();
+    d->newImageHashes.clear();
     d->newImages.clear();
     d->imagesToRemove.clear();
 }
@@ -210,12 +540,49 @@ void DocumentImageStorage::saveChanges()
     }
     d->newImages.clear();
 
+    //
+    // Хэши сохраняем до удаления изображений, чтобы при удалении учитывать и изображения,
+    // добавленные в этом же пакете записи
+    //
+    for (auto hashIter = d->newImageHashes.begin(); hashIter != d->newImageHashes.end();
+         ++hashIter) {
+        executeWrite("INSERT OR REPLACE INTO images_hashes (fk_document_uuid, content_hash) "
+                     "VALUES (?, ?)",
+                     { hashIter.key().toString(), QString::fromLatin1(hashIter.value()) });
+    }
+    d->newImageHashes.clear();
+
+    for (auto thumbnailIter = d->newThumbnails.begin(); thumbnailIter != d->newThumbnails.end();
+         ++thumbnailIter) {
+        executeWrite("INSERT OR REPLACE INTO images_thumbnails (content_hash, size, content) "
+                     "VALUES (?, ?, ?)",
+                     { QString::fromLatin1(thumbnailIter.key().first), thumbnailIter.key().second,
+                       thumbnailIter.value() });
+    }
+    d->newThumbnails.clear();
+
     while (!d->imagesToRemove.isEmpty()) {
-        const auto isRemoved = StorageFacade::documentStorage()->removeDocument(
-            StorageFacade::documentStorage()->document(d->imagesToRemove.takeFirst()));
+        const auto uuid = d->imagesToRemove.takeFirst();
+        const auto imageDocument = StorageFacade::documentStorage()->document(uuid);
+        if (imageDocument == nullptr) {
+            continue;
+        }
+
+        //
+        // ... вместе с изображением удаляем и его уменьшенные копии, но только если то же
+        //     изображение не используется в других документах, проверка выполняется в потоке
+        //     записи после всех предыдущих запросов пакета, так что учитывает и новые изображения
+        //
+        const auto hash = QString::fromLatin1(contentHash(imageDocument->content()));
+        executeWrite("DELETE FROM images_hashes WHERE fk_document_uuid = ?", { uuid.toString() });
+        executeWrite("DELETE FROM images_thumbnails WHERE content_hash = ? AND NOT EXISTS "
+                     "(SELECT 1 FROM images_hashes WHERE content_hash = ?)",
+                     { hash, hash });
+        const auto isRemoved = StorageFacade::documentStorage()->removeDocument(imageDocument);
         if (!isRemoved) {
             return;
         }
+        d->imageHashes.remove(uuid);
     }
 }
 
@@ -28,6 +28,14 @@ public:
      */
     QPixmap load(const QUuid& _uuid) const override;
 
+    /**
+     * @brief Получить уменьшенную копию изображения
+     *        - из кэша
+     *        - из сохранённых в базе уменьшенных копий
+     *        - построить из оригинала в фоновом потоке
+     */
+    QPixmap loadThumbnail(const QUuid& _uuid, int _size) const override;
+
     /**
      * @brief Сохранить новое изображение
      */
@@ -50,7 +58,8 @@ public:
     void clear();
 
     /**
-     * @brief Сохранить все новые изображения, ещё не сохранённые в базу данных
+     * @brief Сохранить все новые изображения и их уменьшенные копии, ещё не сохранённые в базу
+     *        данных
      */
     void saveChanges();
 
@@ -2,6 +2,8 @@
 
 #include <data_layer/mapper/document_mapper.h>
 #include <data_layer/mapper/mapper_facade.h>
+#include <data_layer/storage/search_index_storage.h>
+#include <data_layer/storage/storage_facade.h>
 #include <domain/document_object.h>
 #include <domain/objects_builder.h>
 
@@ -144,6 +146,11 @@ bool DocumentStorage::removeDocument(Domain::DocumentObject* _document)
         return false;
     }
 
+    //
+    // Вместе с документом удаляем и его абзацы из полнотекстового индекса
+    //
+    StorageFacade::searchIndexStorage()->removeDocument(_document->uuid());
+
     if (d->notSavedDocuments.contains(_document->uuid())) {
         d->notSavedDocuments.remove(_document->uuid());
         delete _document;
@@ -0,0 +1,237 @@
+#include "search_index_storage.h"
+
+#include <data_layer/database.h>
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QSqlQuery>
+#include <QVariant>
+
+
+namespace DataStorageLayer {
+
+namespace {
+
+/**
+ * @brief Выполнить запрос на запись, если запущена фоновая запись, то запрос будет выполнен
+ *        в её пакете
+ */
+void executeWrite(const QString& _statement, const QVariantList& _values)
+{
+    if (DatabaseLayer::Database::isAsyncWriting()) {
+        DatabaseLayer::Database::appendAsyncWrite(_statement, _values);
+        return;
+    }
+
+    DatabaseLayer::Database::waitForPendingWrites();
+    auto query = DatabaseLayer::Database::query();
+    query.prepare(_statement);
+    for (const auto& value : _values) {
+        query.addBindValue(value);
+    }
+    query.exec();
+}
+
+/**
+ * @brief Сформировать выражение полнотекстового поиска из пользовательского запроса
+ * @note Запрос разбивается на слова так же, как и текст при индексации, а каждое слово берётся
+ *       в кавычки, чтобы символы из запроса не воспринимались как операторы поиска
+ */
+QString searchExpression(const QString& _query, SearchIndexStorage::SearchFlags _flags)
+{
+    static const QRegularExpression kWordsSeparator("[^\\p{L}\\p{N}]+");
+    const auto words = _query.split(kWordsSeparator, Qt::SkipEmptyParts);
+    if (words.isEmpty()) {
+        return {};
+    }
+
+    const auto prefixMark
+        = _flags.testFlag(SearchIndexStorage::PrefixSearch) ? QLatin1String("*") : QLatin1String();
+    if (_flags.testFlag(SearchIndexStorage::PhraseSearch)) {
+        return QString("\"%1\"%2").arg(words.join(' '), prefixMark);
+    }
+
+    QStringList terms;
+    for (const auto& word : words) {
+        terms.append(QString("\"%1\"").arg(word));
+    }
+    terms.last().append(prefixMark);
+    return terms.join(' ');
+}
+
+} // namespace
+
+class SearchIndexStorage::Implementation
+{
+public:
+    /**
+     * @brief Загрузить список проиндексированных документов, если он ещё не был загружен
+     */
+    void loadIndexedDocuments();
+
+    /**
+     * @brief Количество копий каждого из абзацев документа, лежащих в индексе
+     */
+    QHash<QString, int> indexedParagraphs(const QUuid& _documentUuid) const;
+
+
+    /**
+     * @brief Загружен ли список проиндексированных документов
+     */
+    bool isIndexedDocumentsLoaded = false;
+
+    /**
+     * @brief Проиндексированные документы
+     */
+    QSet<QUuid> indexedDocuments;
+};
+
+void SearchIndexStorage::Implementation::loadIndexedDocuments()
+{
+    if (isIndexedDocumentsLoaded) {
+        return;
+    }
+
+    DatabaseLayer::Database::waitForPendingWrites("search_documents");
+    auto query = DatabaseLayer::Database::query();
+    query.exec("SELECT uuid FROM search_documents");
+    while (query.next()) {
+        indexedDocuments.insert(QUuid::fromString(query.value(0).toString()));
+    }
+    isIndexedDocumentsLoaded = true;
+}
+
+QHash<QString, int> SearchIndexStorage::Implementation::indexedParagraphs(
+    const QUuid& _documentUuid) const
+{
+    QHash<QString, int> paragraphs;
+    DatabaseLayer::Database::waitForPendingWrites("search_paragraphs");
+    auto query = DatabaseLayer::Database::query();
+    query.prepare("SELECT text FROM search_paragraphs WHERE fk_document_uuid = ?");
+    query.addBindValue(_documentUuid.toString());
+    query.exec();
+    while (query.next()) {
+        ++paragraphs[query.value(0).toString()];
+    }
+    return paragraphs;
+}
+
+
+// ****
+
+
+SearchIndexStorage::~SearchIndexStorage() = default;
+
+bool SearchIndexStorage::isDocumentIndexed(const QUuid& _documentUuid)
+{
+    d->loadIndexedDocuments();
+    return d->indexedDocuments.contains(_documentUuid);
+}
+
+void SearchIndexStorage::updateDocument(const QUuid& _documentUuid,
+                                        const QVector<QString>& _paragraphs)
+{
+    if (_documentUuid.isNull()) {
+        return;
+    }
+
+    //
+    // Определяем, сколько копий каждого абзаца нужно добавить, или удалить, обычно при правке
+    // текста меняется лишь пара абзацев, поэтому и запросов на запись получается немного
+    //
+    auto paragraphsDelta = d->indexedParagraphs(_documentUuid);
+    for (auto& count : paragraphsDelta) {
+        count = -count;
+    }
+    for (const auto& paragraph : _paragraphs) {
+        if (paragraph.trimmed().isEmpty()) {
+            continue;
+        }
+
+        ++paragraphsDelta[paragraph];
+    }
+
+    const auto documentUuid = _documentUuid.toString();
+    DatabaseLayer::Database::transaction();
+    for (auto iter = paragraphsDelta.begin(); iter != paragraphsDelta.end(); ++iter) {
+        if (iter.value() < 0) {
+            executeWrite("DELETE FROM search_paragraphs WHERE id IN "
+                         "(SELECT id FROM search_paragraphs "
+                         "WHERE fk_document_uuid = ? AND text = ? LIMIT ?)",
+                         { documentUuid, iter.key(), -iter.value() });
+            continue;
+        }
+
+        for (int copy = 0; copy < iter.value(); ++copy) {
+            executeWrite("INSERT INTO search_paragraphs (fk_document_uuid, text) VALUES (?, ?)",
+                         { documentUuid, iter.key() });
+        }
+    }
+
+    d->loadIndexedDocuments();
+    if (!d->indexedDocuments.contains(_documentUuid)) {
+        executeWrite("INSERT OR IGNORE INTO search_documents (uuid) VALUES (?)", { documentUuid });
+        d->indexedDocuments.insert(_documentUuid);
+    }
+    DatabaseLayer::Database::commit();
+}
+
+void SearchIndexStorage::removeDocument(const QUuid& _documentUuid)
+{
+    const auto documentUuid = _documentUuid.toString();
+    DatabaseLayer::Database::transaction();
+    executeWrite("DELETE FROM search_paragraphs WHERE fk_document_uuid = ?", { documentUuid });
+    executeWrite("DELETE FROM search_documents WHERE uuid = ?", { documentUuid });
+    DatabaseLayer::Database::commit();
+
+    d->indexedDocuments.remove(_documentUuid);
+}
+
+QVector<SearchIndexResult> SearchIndexStorage::find(const QString& _query, SearchFlags _flags,
+                                                    qint64 _afterId, int _limit)
+{
+    const auto expression = searchExpression(_query, _flags);
+    if (expression.isEmpty() || _limit <= 0) {
+        return {};
+    }
+
+    //
+    // Результаты выдаются порциями в порядке добавления абзацев в индекс, следующая порция
+    // начинается сразу за последним найденным абзацем, поэтому её выборка идёт по индексу без
+    // пропуска уже выданных строк
+    //
+    auto query = DatabaseLayer::Database::query();
+    query.prepare("SELECT search_paragraphs.id, search_paragraphs.fk_document_uuid, "
+                  "search_paragraphs.text "
+                  "FROM search_index "
+                  "JOIN search_paragraphs ON search_paragraphs.id = search_index.rowid "
+                  "WHERE search_index MATCH ? AND search_index.rowid > ? "
+                  "ORDER BY search_index.rowid "
+                  "LIMIT ?");
+    query.addBindValue(expression);
+    query.addBindValue(_afterId);
+    query.addBindValue(_limit);
+    query.exec();
+
+    QVector<SearchIndexResult> results;
+    while (query.next()) {
+        results.append({ query.value(0).toLongLong(),
+                         QUuid::fromString(query.value(1).toString()),
+                         query.value(2).toString() });
+    }
+    return results;
+}
+
+void SearchIndexStorage::clear()
+{
+    d->isIndexedDocumentsLoaded = false;
+    d->indexedDocuments.clear();
+}
+
+SearchIndexStorage::SearchIndexStorage()
+    : d(new Implementation)
+{
+}
+
+} // namespace DataStorageLayer
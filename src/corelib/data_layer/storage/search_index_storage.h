@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QScopedPointer>
+#include <QUuid>
+#include <QVector>
+
+#include <corelib_global.h>
+
+
+namespace DataStorageLayer {
+
+/**
+ * @brief Найденный в индексе абзац
+ */
+struct CORE_LIBRARY_EXPORT SearchIndexResult {
+    /**
+     * @brief Идентификатор абзаца в индексе, по нему продолжается постраничная выдача
+     */
+    qint64 id = 0;
+
+    /**
+     * @brief Документ, в котором найден абзац
+     */
+    QUuid documentUuid;
+
+    /**
+     * @brief Текст абзаца
+     */
+    QString text;
+};
+
+/**
+ * @brief Хранилище полнотекстового индекса документов проекта
+ * @note Индекс хранится в базе проекта и содержит абзацы документов, поиск по словам не учитывает
+ *       регистр букв
+ */
+class CORE_LIBRARY_EXPORT SearchIndexStorage
+{
+public:
+    /**
+     * @brief Параметры поиска
+     */
+    enum SearchFlag {
+        NoSearchFlags = 0x0,
+        //
+        // Последнее слово запроса может быть началом слова в тексте
+        //
+        PrefixSearch = 0x1,
+        //
+        // Слова запроса должны идти в тексте подряд и в том же порядке
+        //
+        PhraseSearch = 0x2,
+    };
+    Q_DECLARE_FLAGS(SearchFlags, SearchFlag)
+
+public:
+    ~SearchIndexStorage();
+
+    /**
+     * @brief Был ли документ уже проиндексирован
+     */
+    bool isDocumentIndexed(const QUuid& _documentUuid);
+
+    /**
+     * @brief Обновить абзацы документа в индексе
+     * @note В базу записывается только разница с тем, что уже лежит в индексе
+     */
+    void updateDocument(const QUuid& _documentUuid, const QVector<QString>& _paragraphs);
+
+    /**
+     * @brief Удалить документ из индекса
+     */
+    void removeDocument(const QUuid& _documentUuid);
+
+    /**
+     * @brief Найти абзацы, соответствующие запросу
+     * @param _afterId - идентификатор последнего абзаца предыдущей порции результатов
+     * @param _limit - максимальное количество результатов в порции
+     */
+    QVector<SearchIndexResult> find(const QString& _query, SearchFlags _flags, qint64 _afterId,
+                                    int _limit);
+
+    /**
+     * @brief Очистить хранилище
+     */
+    void clear();
+
+private:
+    SearchIndexStorage();
+    friend class StorageFacade;
+
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace DataStorageLayer
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(DataStorageLayer::SearchIndexStorage::SearchFlags)
@@ -103,6 +103,8 @@ SettingsStorage::Implementation::Implementation()
                          QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)
                              + "/starc/backups");
     defaultValues.insert(kApplicationBackupsQtyKey, 7);
+    defaultValues.insert(kApplicationChangesHistoryCompactionAgeKey, 30);
+    defaultValues.insert(kApplicationLoadedDocumentsMemoryLimitKey, 256);
     defaultValues.insert(kApplicationShowDocumentsPagesKey, true);
     defaultValues.insert(kApplicationUseTypewriterSoundKey, false);
     defaultValues.insert(kApplicationUseSpellCheckerKey, false);
@@ -61,6 +61,12 @@ const QString kApplicationSaveBackupsKey = kApplicationGroupKey + "/save-backups
 const QString kApplicationBackupsFolderKey = kApplicationGroupKey + "/backups-folder";
 // максимальное кол-во бекапов для сохранения
 const QString kApplicationBackupsQtyKey = kApplicationGroupKey + "/backups-qty";
+// возраст в днях, старше которого синхронизированные изменения документов объединяются по дням
+const QString kApplicationChangesHistoryCompactionAgeKey
+    = kApplicationGroupKey + "/changes-history-compaction-age";
+// объём в мегабайтах, при превышении которого неиспользуемые модели документов выгружаются
+const QString kApplicationLoadedDocumentsMemoryLimitKey
+    = kApplicationGroupKey + "/loaded-documents-memory-limit";
 // показывать ли страницы текстовых документов
 const QString kApplicationShowDocumentsPagesKey = kApplicationGroupKey + "/show-documents-pages";
 // включены ли звуки печатной машинки при наборе текста
@@ -2,6 +2,7 @@
 
 #include "document_change_storage.h"
 #include "document_storage.h"
+#include "search_index_storage.h"
 #include "settings_storage.h"
 
 
@@ -11,6 +12,7 @@ void StorageFacade::clearStorages()
 {
     documentChangeStorage()->clear();
     documentStorage()->clear();
+    searchIndexStorage()->clear();
 }
 
 DocumentChangeStorage* StorageFacade::documentChangeStorage()
@@ -31,6 +33,15 @@ DocumentStorage* StorageFacade::documentStorage()
     return s_documentStorage;
 }
 
+SearchIndexStorage* StorageFacade::searchIndexStorage()
+{
+    if (s_searchIndexStorage == nullptr) {
+        s_searchIndexStorage = new SearchIndexStorage;
+    }
+
+    return s_searchIndexStorage;
+}
+
 SettingsStorage* StorageFacade::settingsStorage()
 {
     if (s_settingsStorage == nullptr) {
@@ -41,6 +52,7 @@ SettingsStorage* StorageFacade::settingsStorage()
 
 DocumentChangeStorage* StorageFacade::s_documentChangeStorage = nullptr;
 DocumentStorage* StorageFacade::s_documentStorage = nullptr;
+SearchIndexStorage* StorageFacade::s_searchIndexStorage = nullptr;
 SettingsStorage* StorageFacade::s_settingsStorage = nullptr;
 
 } // namespace DataStorageLayer
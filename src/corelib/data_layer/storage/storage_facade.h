@@ -9,6 +9,7 @@ namespace DataStorageLayer {
 
 class DocumentChangeStorage;
 class DocumentStorage;
+class SearchIndexStorage;
 class SettingsStorage;
 
 /**
@@ -32,6 +33,11 @@ public:
      */
     static DocumentStorage* documentStorage();
 
+    /**
+     * @brief Получить хранилище полнотекстового индекса документов проекта
+     */
+    static SearchIndexStorage* searchIndexStorage();
+
     /**
      * @brief Получить хранилище настроек
      */
@@ -40,6 +46,7 @@ public:
 private:
     static DocumentChangeStorage* s_documentChangeStorage;
     static DocumentStorage* s_documentStorage;
+    static SearchIndexStorage* s_searchIndexStorage;
     static SettingsStorage* s_settingsStorage;
 };
 
@@ -179,11 +179,26 @@ void DocumentObject::setType(DocumentObjectType _type)
 
 const QByteArray& DocumentObject::content() const
 {
+    if (!m_isContentLoaded) {
+        m_content = m_contentLoader();
+        m_isContentLoaded = true;
+    }
+
     return m_content;
 }
 
 void DocumentObject::setContent(const QByteArray& _content)
 {
+    //
+    // Если содержимое ещё не загружено, то сравнивать новое содержимое не с чем
+    //
+    if (!m_isContentLoaded) {
+        m_content = _content;
+        m_isContentLoaded = true;
+        markChangesNotStored();
+        return;
+    }
+
     //
     // NOTE: Тут специально нет проверки, т.к. данные могут быть очень большими
     //
@@ -197,6 +212,31 @@ void DocumentObject::setContent(const QByteArray& _content)
     markChangesNotStored();
 }
 
+void DocumentObject::setContentLoader(const ContentLoader& _loader)
+{
+    m_contentLoader = _loader;
+    m_isContentLoaded = !m_contentLoader;
+    if (!m_isContentLoaded) {
+        m_content.clear();
+    }
+}
+
+bool DocumentObject::isContentLoaded() const
+{
+    return m_isContentLoaded;
+}
+
+bool DocumentObject::unloadContent()
+{
+    if (!m_contentLoader || !isChangesStored()) {
+        return false;
+    }
+
+    m_content = {};
+    m_isContentLoaded = false;
+    return true;
+}
+
 const QDateTime& DocumentObject::syncedAt() const
 {
     return m_syncedAt;
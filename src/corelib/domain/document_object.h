@@ -6,6 +6,8 @@
 #include <QPixmap>
 #include <QUuid>
 
+#include <functional>
+
 namespace Domain {
 
 /**
@@ -152,10 +154,29 @@ public:
 
     /**
      * @brief Содержимое документа
+     * @note Если содержимое ещё не загружено, то оно будет загружено при первом обращении
      */
     const QByteArray& content() const;
     void setContent(const QByteArray& _content);
 
+    /**
+     * @brief Задать загрузчик содержимого документа, которое ещё не было загружено
+     */
+    using ContentLoader = std::function<QByteArray()>;
+    void setContentLoader(const ContentLoader& _loader);
+
+    /**
+     * @brief Загружено ли содержимое документа
+     */
+    bool isContentLoaded() const;
+
+    /**
+     * @brief Выгрузить содержимое документа из памяти, если оно сохранено и может быть загружено
+     *        повторно
+     * @return Удалось ли выгрузить
+     */
+    bool unloadContent();
+
     /**
      * @brief Дата и время последней синхронизации
      */
@@ -180,7 +201,13 @@ private:
     /**
      * @brief Содержимое объекта
      */
-    QByteArray m_content;
+    mutable QByteArray m_content;
+
+    /**
+     * @brief Загрузчик содержимого и загружено ли оно
+     */
+    ContentLoader m_contentLoader;
+    mutable bool m_isContentLoaded = true;
 
     /**
      * @brief Дата время последней синхронизации содержимого документа
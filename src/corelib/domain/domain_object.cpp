@@ -31,6 +31,12 @@ void DomainObject::markChangesStored()
 void DomainObject::markChangesNotStored()
 {
     m_isChangesStored = false;
+    ++m_changesRevision;
+}
+
+int DomainObject::changesRevision() const
+{
+    return m_changesRevision;
 }
 
 } // namespace Domain
@@ -34,6 +34,12 @@ public:
      */
     void markChangesNotStored();
 
+    /**
+     * @brief Номер ревизии изменений объекта, увеличивается при каждом его изменении
+     * @note Позволяет понять, менялся ли объект, пока его снимок записывался в фоне
+     */
+    int changesRevision() const;
+
 private:
     /**
      * @brief Идентификатор объекта
@@ -44,6 +50,11 @@ private:
      * @brief Флаг изменений объекта
      */
     bool m_isChangesStored = false;
+
+    /**
+     * @brief Номер ревизии изменений
+     */
+    int m_changesRevision = 0;
 };
 
 // ****
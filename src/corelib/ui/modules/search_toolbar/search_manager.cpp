@@ -4,6 +4,8 @@
 
 #include <business_layer/document/text/text_block_data.h>
 #include <business_layer/document/text/text_cursor.h>
+#include <business_layer/document/text/text_document.h>
+#include <business_layer/model/text/text_model.h>
 #include <business_layer/model/text/text_model_group_item.h>
 #include <business_layer/model/text/text_model_text_item.h>
 #include <business_layer/templates/novel_template.h>
@@ -33,6 +35,12 @@ public:
     void findText(bool _backward);
     void findNumber();
 
+    /**
+     * @brief Заменить все вхождения искомого текста одним изменением модели
+     * @return false, если редактор работает не с текстовой моделью и заменять нужно по одному
+     */
+    bool replaceAll();
+
 
     /**
      * @brief Панель поиска
@@ -219,6 +227,70 @@ void SearchManager::Implementation::findNumber()
     }
 }
 
+bool SearchManager::Implementation::replaceAll()
+{
+    auto document = qobject_cast<TextDocument*>(textEdit->document());
+    if (document == nullptr || document->model() == nullptr) {
+        return false;
+    }
+
+    const QString searchText = toolbar->searchText();
+    if (searchText.isEmpty()) {
+        return true;
+    }
+
+    const QString replaceText = toolbar->replaceText();
+    const auto caseSensitive = toolbar->isCaseSensitive() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    const auto searchType = searchInType();
+
+    //
+    // Сначала находим все вхождения в видимых абзацах, чтобы замена не находила сама себя, если
+    // новый текст содержит искомый
+    //
+    QVector<QPair<TextModelTextItem*, QVector<TextModelTextItem::TextPart>>> matches;
+    for (auto block = document->begin(); block.isValid(); block = block.next()) {
+        if (!block.isVisible() || block.userData() == nullptr
+            || (searchType != TextParagraphType::Undefined
+                && TextBlockStyle::forBlock(block) != searchType)) {
+            continue;
+        }
+
+        const auto blockData = static_cast<TextBlockData*>(block.userData());
+        if (blockData->item() == nullptr || blockData->item()->type() != TextModelItemType::Text) {
+            continue;
+        }
+
+        const auto textItem = static_cast<TextModelTextItem*>(blockData->item());
+        QVector<TextModelTextItem::TextPart> parts;
+        for (int position = textItem->text().indexOf(searchText, 0, caseSensitive); position != -1;
+             position = textItem->text().indexOf(searchText, position + searchText.length(),
+                                                 caseSensitive)) {
+            parts.append({ position, static_cast<int>(searchText.length()) });
+        }
+        if (!parts.isEmpty()) {
+            matches.append({ textItem, parts });
+        }
+    }
+    if (matches.isEmpty()) {
+        return true;
+    }
+
+    //
+    // Меняем элементы модели напрямую, документ обновит свои блоки в рамках одной группы
+    // изменений, а модель сохранит всё одним изменением
+    //
+    auto model = document->model();
+    model->beginChangeRows();
+    for (const auto& [textItem, parts] : std::as_const(matches)) {
+        textItem->replaceText(parts, replaceText);
+        model->updateItem(textItem);
+    }
+    model->endChangeRows();
+    model->saveChanges();
+
+    return true;
+}
+
 
 // ****
 
@@ -263,6 +335,10 @@ SearchManager::SearchManager(QWidget* _parent, BaseTextEdit* _textEdit)
             return;
         }
 
+        if (d->replaceAll()) {
+            return;
+        }
+
         d->find();
         auto cursor = d->textEdit->textCursor();
         int firstCursorPosition = cursor.selectionStart();
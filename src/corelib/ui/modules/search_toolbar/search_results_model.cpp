@@ -0,0 +1,136 @@
+#include "search_results_model.h"
+
+#include <data_layer/storage/storage_facade.h>
+
+
+namespace BusinessLayer {
+
+namespace {
+
+/**
+ * @brief Количество результатов, загружаемых за один раз
+ */
+const int kResultsBatchSize = 100;
+
+} // namespace
+
+class SearchResultsModel::Implementation
+{
+public:
+    /**
+     * @brief Загрузить следующую порцию результатов
+     */
+    QVector<DataStorageLayer::SearchIndexResult> loadNextResults();
+
+
+    /**
+     * @brief Поисковый запрос и его параметры
+     */
+    QString query;
+    DataStorageLayer::SearchIndexStorage::SearchFlags flags;
+
+    /**
+     * @brief Загруженные результаты
+     */
+    QVector<DataStorageLayer::SearchIndexResult> results;
+
+    /**
+     * @brief Все ли результаты уже загружены
+     */
+    bool isAllResultsLoaded = true;
+};
+
+QVector<DataStorageLayer::SearchIndexResult> SearchResultsModel::Implementation::loadNextResults()
+{
+    const auto lastResultId = results.isEmpty() ? 0 : results.constLast().id;
+    const auto nextResults = DataStorageLayer::StorageFacade::searchIndexStorage()->find(
+        query, flags, lastResultId, kResultsBatchSize);
+    isAllResultsLoaded = nextResults.size() < kResultsBatchSize;
+    return nextResults;
+}
+
+
+// ****
+
+
+SearchResultsModel::SearchResultsModel(QObject* _parent)
+    : QAbstractListModel(_parent)
+    , d(new Implementation)
+{
+}
+
+SearchResultsModel::~SearchResultsModel() = default;
+
+void SearchResultsModel::setQuery(const QString& _query,
+                                  DataStorageLayer::SearchIndexStorage::SearchFlags _flags)
+{
+    beginResetModel();
+    d->query = _query;
+    d->flags = _flags;
+    d->results.clear();
+    d->results = d->loadNextResults();
+    endResetModel();
+}
+
+void SearchResultsModel::clear()
+{
+    beginResetModel();
+    d->query.clear();
+    d->results.clear();
+    d->isAllResultsLoaded = true;
+    endResetModel();
+}
+
+int SearchResultsModel::rowCount(const QModelIndex& _parent) const
+{
+    if (_parent.isValid()) {
+        return 0;
+    }
+
+    return d->results.size();
+}
+
+QVariant SearchResultsModel::data(const QModelIndex& _index, int _role) const
+{
+    if (!_index.isValid() || _index.row() >= d->results.size()) {
+        return {};
+    }
+
+    const auto& result = d->results.at(_index.row());
+    switch (_role) {
+    case Qt::DisplayRole: {
+        return result.text;
+    }
+
+    case DocumentUuidRole: {
+        return result.documentUuid;
+    }
+
+    default: {
+        return {};
+    }
+    }
+}
+
+bool SearchResultsModel::canFetchMore(const QModelIndex& _parent) const
+{
+    return !_parent.isValid() && !d->isAllResultsLoaded;
+}
+
+void SearchResultsModel::fetchMore(const QModelIndex& _parent)
+{
+    if (!canFetchMore(_parent)) {
+        return;
+    }
+
+    const auto nextResults = d->loadNextResults();
+    if (nextResults.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows({}, d->results.size(), d->results.size() + nextResults.size() - 1);
+    d->results.append(nextResults);
+    endInsertRows();
+}
+
+} // namespace BusinessLayer
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <data_layer/storage/search_index_storage.h>
+
+#include <QAbstractListModel>
+
+#include <corelib_global.h>
+
+
+namespace BusinessLayer {
+
+/**
+ * @brief Модель результатов поиска по всем документам проекта
+ * @note Результаты подгружаются из полнотекстового индекса порциями, по мере того, как
+ *       представление прокручивается к концу списка
+ */
+class CORE_LIBRARY_EXPORT SearchResultsModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Роли данных из модели
+     */
+    enum DataRole {
+        DocumentUuidRole = Qt::UserRole + 1,
+    };
+
+public:
+    explicit SearchResultsModel(QObject* _parent = nullptr);
+    ~SearchResultsModel() override;
+
+    /**
+     * @brief Задать поисковый запрос и загрузить первую порцию результатов
+     */
+    void setQuery(const QString& _query, DataStorageLayer::SearchIndexStorage::SearchFlags _flags);
+
+    /**
+     * @brief Очистить результаты поиска
+     */
+    void clear();
+
+    /**
+     * @brief Реализация модели списка
+     */
+    int rowCount(const QModelIndex& _parent = {}) const override;
+    QVariant data(const QModelIndex& _index, int _role) const override;
+    bool canFetchMore(const QModelIndex& _parent) const override;
+    void fetchMore(const QModelIndex& _parent) override;
+
+private:
+    class Implementation;
+    QScopedPointer<Implementation> d;
+};
+
+} // namespace BusinessLayer
@@ -2,20 +2,47 @@
 
 #include "spell_checker.h"
 
+#include <QFutureWatcher>
 #include <QRegularExpression>
+#include <QSet>
 #include <QTextDocument>
 #include <QTimer>
 
 
 namespace {
 const int kInvalidCursorPosition = -1;
-}
+
+/**
+ * @brief Количество абзацев, слова которых заранее проверяются в фоне
+ */
+const int kBlocksAheadCount = 100;
+} // namespace
 
 
 class SpellCheckHighlighter::Implementation
 {
 public:
     explicit Implementation(const SpellChecker& _checker);
+
+    /**
+     * @brief Слово абзаца
+     */
+    struct Word {
+        int position = 0;
+        QString text;
+    };
+
+    /**
+     * @brief Разбить текст на слова, которые нужно проверять
+     */
+    QVector<Word> words(const QString& _text) const;
+
+    /**
+     * @brief Получить результат проверки слова, если он уже известен
+     */
+    std::optional<bool> spellCheckResult(const QString& _word) const;
+
+
     /**
      * @brief Проверяющий орфографию
      */
@@ -43,6 +70,39 @@ public:
      * @brief Таймер перепроверки текущего абзаца после изменения положения курсора
      */
     QTimer recheckTimer;
+
+    /**
+     * @brief Слова, ожидающие проверки в фоновом потоке
+     */
+    QSet<QString> wordsToCheck;
+
+    /**
+     * @brief Абзацы, которые нужно перепроверить после очередной фоновой проверки
+     */
+    QVector<QTextBlock> blocksToRehighlight;
+
+    /**
+     * @brief Таймер запуска фоновой проверки накопившихся слов
+     */
+    QTimer checkWordsTimer;
+
+    /**
+     * @brief Абзацы, слова которых проверяются в данный момент, и язык, на котором идёт проверка
+     */
+    QVector<QTextBlock> checkingBlocks;
+    QString checkingLanguage;
+
+    /**
+     * @brief Наблюдатель за фоновой проверкой
+     */
+    QFutureWatcher<QHash<QString, bool>> checkWordsWatcher;
+
+    /**
+     * @brief Результаты последней фоновой проверки
+     * @note Используются при перепроверке абзацев, на случай если результаты уже были вытеснены из
+     *       кэша проверяющего
+     */
+    QHash<QString, bool> checkedWords;
 };
 
 SpellCheckHighlighter::Implementation::Implementation(const SpellChecker& _checker)
@@ -56,6 +116,61 @@ SpellCheckHighlighter::Implementation::Implementation(const SpellChecker& _check
 
     recheckTimer.setInterval(1600);
     recheckTimer.setSingleShot(true);
+
+    checkWordsTimer.setInterval(0);
+    checkWordsTimer.setSingleShot(true);
+}
+
+QVector<SpellCheckHighlighter::Implementation::Word> SpellCheckHighlighter::Implementation::words(
+    const QString& _text) const
+{
+    if (_text.simplified().isEmpty()) {
+        return {};
+    }
+
+    //
+    // Убираем пустоты из проверяемого текста
+    //
+    const static QRegularExpression notWord("([^\\w'’-]|·)+",
+                                            QRegularExpression::UseUnicodePropertiesOption);
+    //
+    // Собираем каждое слово
+    //
+    QVector<Word> words;
+    int wordPos = 0;
+    int notWordLength = 1;
+    int notWordPos = 0;
+    for (wordPos = 0; wordPos < _text.length(); wordPos = notWordPos + notWordLength) {
+        //
+        // Получим окончание слова
+        //
+        const auto match = notWord.match(_text, wordPos);
+        if (match.hasMatch()) {
+            notWordPos = match.capturedStart();
+            notWordLength = std::max(1, static_cast<int>(match.capturedLength()));
+        } else {
+            notWordPos = _text.length();
+        }
+
+        //
+        // Проверяем слова длинной более одного символа
+        //
+        if (notWordPos - wordPos > 1) {
+            words.append({ wordPos, _text.mid(wordPos, notWordPos - wordPos) });
+        }
+    }
+    return words;
+}
+
+std::optional<bool> SpellCheckHighlighter::Implementation::spellCheckResult(
+    const QString& _word) const
+{
+    const auto checkedWord = checkedWords.constFind(_word);
+    if (checkedWord != checkedWords.cend()) {
+        return checkedWord.value();
+    }
+
+    return spellChecker.cachedSpellCheckWord(_word);
 }
 
 
@@ -75,6 +190,44 @@ SpellCheckHighlighter::SpellCheckHighlighter(QTextDocument* _parent, const Spell
         d->cursorPosition = {};
         rehighlightBlock(blockToRecheck);
     });
+
+    //
+    // Накопившиеся непроверенные слова отправляем на проверку одним пакетом, а по её завершении
+    // перепроверяем абзацы, в которых они встречались
+    //
+    connect(&d->checkWordsTimer, &QTimer::timeout, this, [this] {
+        if (d->checkWordsWatcher.isRunning() || d->wordsToCheck.isEmpty()) {
+            return;
+        }
+
+        d->checkingBlocks = d->blocksToRehighlight;
+        d->blocksToRehighlight.clear();
+        d->checkingLanguage = d->spellChecker.spellingLanguage();
+        d->checkWordsWatcher.setFuture(
+            d->spellChecker.spellCheckWordsAsync(d->wordsToCheck.values()));
+        d->wordsToCheck.clear();
+    });
+    connect(&d->checkWordsWatcher, &QFutureWatcherBase::finished, this, [this] {
+        //
+        // Если пока шла проверка сменился язык, то её результаты уже не годятся
+        //
+        if (d->checkingLanguage == d->spellChecker.spellingLanguage()) {
+            d->checkedWords = d->checkWordsWatcher.result();
+        }
+
+        const auto blocks = d->checkingBlocks;
+        d->checkingBlocks.clear();
+        for (const auto& block : blocks) {
+            if (block.isValid() && block.document() == document()) {
+                rehighlightBlock(block);
+            }
+        }
+        d->checkedWords.clear();
+
+        if (!d->wordsToCheck.isEmpty()) {
+            d->checkWordsTimer.start();
+        }
+    });
 }
 
 SpellCheckHighlighter::~SpellCheckHighlighter() = default;
@@ -107,64 +260,82 @@ void SpellCheckHighlighter::setCursorPosition(int _position)
     d->recheckTimer.start();
 }
 
-void SpellCheckHighlighter::highlightBlock(const QString& _text)
+void SpellCheckHighlighter::checkBlocksAhead(const QTextBlock& _block)
 {
     if (!d->useSpellChecker) {
         return;
     }
 
-    if (_text.simplified().isEmpty()) {
+    auto block = _block;
+    for (int blockIndex = 0; blockIndex < kBlocksAheadCount && block.isValid(); ++blockIndex) {
+        //
+        // Слова блоков в верхнем регистре проверяются в том же регистре, что и при подсветке
+        //
+        const auto text = block.charFormat().fontCapitalization() == QFont::AllUppercase
+            ? block.text().toUpper()
+            : block.text();
+        for (const auto& word : d->words(text)) {
+            if (!d->spellCheckResult(word.text).has_value()) {
+                d->wordsToCheck.insert(word.text);
+            }
+        }
+
+        block = block.next();
+    }
+
+    if (!d->wordsToCheck.isEmpty() && !d->checkWordsTimer.isActive()) {
+        d->checkWordsTimer.start();
+    }
+}
+
+void SpellCheckHighlighter::highlightBlock(const QString& _text)
+{
+    if (!d->useSpellChecker) {
         return;
     }
 
-    //
-    // Убираем пустоты из проверяемого текста
-    //
-    const static QRegularExpression notWord("([^\\w'’-]|·)+",
-                                            QRegularExpression::UseUnicodePropertiesOption);
     //
     // Проверяем каждое слово
     //
-    int wordPos = 0;
-    int notWordLength = 1;
-    int notWordPos = 0;
-    for (wordPos = 0; wordPos < _text.length(); wordPos = notWordPos + notWordLength) {
+    bool hasUncheckedWords = false;
+    const auto words = d->words(_text);
+    for (const auto& word : words) {
         //
-        // Получим окончание слова
+        // Не проверяем слово, которое сейчас пишется
         //
-        const auto match = notWord.match(_text, wordPos);
-        if (match.hasMatch()) {
-            notWordPos = match.capturedStart();
-            notWordLength = std::max(1, static_cast<int>(match.capturedLength()));
-        } else {
-            notWordPos = _text.length();
+        if (word.position <= d->cursorPosition.inBlock
+            && word.position + word.text.length() > d->cursorPosition.inBlock) {
+            continue;
         }
 
         //
-        // Получим само слово
+        // Если слово ещё не проверялось, то отправляем его на проверку
         //
-        const QString wordToCheck = _text.mid(wordPos, notWordPos - wordPos);
+        const auto isCorrect = d->spellCheckResult(word.text);
+        if (!isCorrect.has_value()) {
+            d->wordsToCheck.insert(word.text);
+            hasUncheckedWords = true;
+            continue;
+        }
 
         //
-        // Проверяем слова длинной более одного символа
+        // Если слово не прошло проверку
         //
-        if (wordToCheck.length() > 1) {
-            int positionInText = wordPos;
-            //
-            // Не проверяем слово, которое сейчас пишется
-            //
-            if (positionInText <= d->cursorPosition.inBlock
-                && positionInText + wordToCheck.length() > d->cursorPosition.inBlock) {
-                continue;
-            }
+        if (!isCorrect.value()) {
+            setFormat(word.position, word.text.length(), d->misspeledCharFormat);
+        }
+    }
 
-            //
-            // Если слово не прошло проверку
-            //
-            if (!d->spellChecker.spellCheckWord(wordToCheck)) {
-                const int wordLength = wordToCheck.length();
-                setFormat(positionInText, wordLength, d->misspeledCharFormat);
-            }
+    //
+    // Если в абзаце остались непроверенные слова, то перепроверим его после фоновой проверки
+    //
+    if (hasUncheckedWords) {
+        if (d->blocksToRehighlight.isEmpty()
+            || d->blocksToRehighlight.constLast() != currentBlock()) {
+            d->blocksToRehighlight.append(currentBlock());
+        }
+        if (!d->checkWordsTimer.isActive()) {
+            d->checkWordsTimer.start();
         }
     }
 }
@@ -33,8 +33,15 @@ public:
      */
     void setCursorPosition(int position);
 
+    /**
+     * @brief Заранее проверить в фоне слова абзацев, начиная с заданного
+     */
+    void checkBlocksAhead(const QTextBlock& _block);
+
     /**
      * @brief Подсветить текст не прошедший проверку орфографии
+     * @note Применяются только уже известные результаты проверки, а непроверенные слова
+     *       отправляются на проверку в фоновый поток, после которой абзац перепроверяется
      */
     void highlightBlock(const QString& _text) override;
 
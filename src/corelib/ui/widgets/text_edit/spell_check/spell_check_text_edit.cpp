@@ -6,6 +6,7 @@
 #include <include/custom_events.h>
 #include <ui/design_system/design_system.h>
 #include <ui/widgets/context_menu/context_menu.h>
+#include <ui/widgets/text_edit/page/page_text_edit_scroll_bar.h>
 
 #include <QApplication>
 #include <QContextMenuEvent>
@@ -42,6 +43,11 @@ public:
      */
     SpellCheckPolicy policy = SpellCheckPolicy::Auto;
 
+    /**
+     * @brief Использовать ли ленивую подсветку ошибок
+     */
+    bool isLazyHighlighting = false;
+
     /**
      * @brief Последняя позиция курсора, при открытии контекстного меню
      */
@@ -69,6 +75,7 @@ SpellCheckHighlighter* SpellCheckTextEdit::Implementation::spellCheckHighlighter
 {
     if (m_spellCheckHighlighter.isNull()) {
         m_spellCheckHighlighter = new SpellCheckHighlighter(_document, spellChecker);
+        m_spellCheckHighlighter->setLazyHighlighting(isLazyHighlighting);
     }
     return m_spellCheckHighlighter;
 }
@@ -83,6 +90,28 @@ SpellCheckTextEdit::SpellCheckTextEdit(QWidget* _parent)
 {
     connect(this, &SpellCheckTextEdit::cursorPositionChanged, this,
             &SpellCheckTextEdit::rehighlighWithNewCursor);
+    //
+    // При прокрутке и изменении размеров документа сообщаем подсвечивающему видимую область, чтобы
+    // в первую очередь подсвечивались видимые абзацы, а также заранее проверяем в фоне слова
+    // абзацев, идущих следом за видимой областью
+    //
+    auto updateVisibleBlocks = [this](bool _checkBlocksAhead) {
+        if (!useSpellChecker()) {
+            return;
+        }
+
+        const auto firstVisibleBlock = cursorForPosition(viewport()->rect().topLeft()).block();
+        const auto lastVisibleBlock = cursorForPosition(viewport()->rect().bottomLeft()).block();
+        auto highlighter = d->spellCheckHighlighter(document());
+        highlighter->setVisibleBlocks(firstVisibleBlock, lastVisibleBlock);
+        if (_checkBlocksAhead) {
+            highlighter->checkBlocksAhead(lastVisibleBlock);
+        }
+    };
+    connect(verticalScrollBar(), &PageTextEditScrollBar::valueChanged, this,
+            [updateVisibleBlocks] { updateVisibleBlocks(true); });
+    connect(verticalScrollBar(), &PageTextEditScrollBar::rangeChanged, this,
+            [updateVisibleBlocks] { updateVisibleBlocks(false); });
 }
 
 SpellCheckTextEdit::~SpellCheckTextEdit() = default;
@@ -133,6 +162,12 @@ void SpellCheckTextEdit::setSpellCheckLanguage(const QString& _languageCode)
     d->spellCheckHighlighter(document())->rehighlight();
 }
 
+void SpellCheckTextEdit::setLazySpellCheckHighlighting(bool _lazy)
+{
+    d->isLazyHighlighting = _lazy;
+    d->spellCheckHighlighter(document())->setLazyHighlighting(_lazy);
+}
+
 void SpellCheckTextEdit::prepareToClear()
 {
     d->previousBlockUnderCursor = QTextBlock();
@@ -50,6 +50,12 @@ public:
      */
     void setSpellCheckLanguage(const QString& _languageCode);
 
+    /**
+     * @brief Включить/выключить ленивую подсветку ошибок, начиная с видимой области
+     * @note Предназначено для очень длинных документов
+     */
+    void setLazySpellCheckHighlighting(bool _lazy);
+
     /**
      * @brief Переопределяем для очистки собственных параметров, перед очисткой в  базовом классе
      */
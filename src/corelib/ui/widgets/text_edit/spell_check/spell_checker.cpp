@@ -2,11 +2,17 @@
 
 #include <hunspell/hunspell.hxx>
 
+#include <QCache>
 #include <QDir>
 #include <QFile>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
 #include <QStandardPaths>
 #include <QStringList>
 #include <QTextCodec>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 
 namespace {
@@ -14,6 +20,11 @@ namespace {
  * @brief Тип словаря
  */
 enum class SpellCheckerFileType { Affinity, Indexes, Dictionary };
+
+/**
+ * @brief Максимальное количество результатов проверки слов, хранимых для одного словаря
+ */
+const int kSpellCheckResultsCacheSize = 100000;
 } // namespace
 
 
@@ -40,6 +51,20 @@ public:
      */
     void addWordToChecker(const QString& _word) const;
 
+    /**
+     * @brief Проверить орфографию слова с использованием кэша результатов
+     * @note Вызывается только при заблокированном мьютексе
+     */
+    bool spellCheckWord(const QString& _word);
+
+    /**
+     * @brief Убрать из кэша результаты проверки всех форм слова, которые мог затронуть его
+     *        добавление в словарный запас
+     * @note Проверяющий принимает добавленное слово в любом регистре, а также в притяжательной
+     *       форме, поэтому удаляем все слова, начинающиеся с заданного без учёта регистра
+     */
+    void removeSpellCheckResults(QCache<QString, bool>* _results, const QString& _word) const;
+
 
     /**
      * @brief Текущий язык проверки орфографии
@@ -60,6 +85,30 @@ public:
      * @brief Путь к файлу со словарём пользователя
      */
     QString userDictionaryPath;
+
+    /**
+     * @brief Кэши результатов проверки слов для каждого из языков
+     */
+    QHash<QString, QSharedPointer<QCache<QString, bool>>> spellCheckResults;
+
+    /**
+     * @brief Языки, для которых в текущей сессии игнорировались слова
+     * @note Проигнорированные слова теряются при пересоздании проверяющего, поэтому вместе с ними
+     *       становится недействительным и кэш результатов проверки для такого языка
+     */
+    QSet<QString> languagesWithIgnoredWords;
+
+    /**
+     * @brief Мьютекс для доступа к проверяющему и к кэшам из разных потоков
+     */
+    QMutex mutex;
+
+    /**
+     * @brief Пул для фоновой проверки слов
+     * @note Проверяющий не умеет работать из нескольких потоков одновременно, поэтому используем
+     *       единственный поток
+     */
+    QThreadPool spellCheckPool;
 };
 
 SpellChecker::Implementation::Implementation()
@@ -70,6 +119,8 @@ SpellChecker::Implementation::Implementation()
         = appDataFolderPath + QDir::separator() + "hunspell";
     userDictionaryPath
         = hunspellDictionariesFolderPath + QDir::separator() + "user_dictionary.dict";
+
+    spellCheckPool.setMaxThreadCount(1);
 }
 
 QString SpellChecker::Implementation::hunspellFilePath(const QString& _fileName,
@@ -112,6 +163,72 @@ void SpellChecker::Implementation::addWordToChecker(const QString& _word) const
     checker->add(encodedWord.constData());
 }
 
+void SpellChecker::Implementation::removeSpellCheckResults(QCache<QString, bool>* _results,
+                                                           const QString& _word) const
+{
+    if (_results == nullptr) {
+        return;
+    }
+
+    const auto words = _results->keys();
+    for (const auto& word : words) {
+        if (word.startsWith(_word, Qt::CaseInsensitive)) {
+            _results->remove(word);
+        }
+    }
+}
+
+bool SpellChecker::Implementation::spellCheckWord(const QString& _word)
+{
+    //
+    // Если проверяющего орфографию не удалось настроить, то и проверять нет смысла
+    //
+    if (checker == nullptr || checkerTextCodec == nullptr) {
+        return false;
+    }
+
+    //
+    // Игнорируем двойной минус, т.к. это служебное обозначение в сценарной записи
+    //
+    if (_word == "--") {
+        return true;
+    }
+
+    //
+    // Если слово уже проверялось, то берём результат из кэша
+    //
+    auto& results = spellCheckResults[languageCode];
+    if (results.isNull()) {
+        results.reset(new QCache<QString, bool>(kSpellCheckResultsCacheSize));
+    }
+    if (const auto result = results->object(_word); result != nullptr) {
+        return *result;
+    }
+
+    //
+    // Собственно проверка
+    //
+    QString correctedWord = _word;
+    //
+    // Для слов заканчивающихся на s с апострофом убираем апостроф в конце, т.к. ханспел его не
+    // умеет
+    //
+    if (languageCode.startsWith("en")
+        && (correctedWord.endsWith("s'", Qt::CaseInsensitive)
+            || correctedWord.endsWith("s’", Qt::CaseInsensitive))) {
+        correctedWord.chop(1);
+    }
+
+    //
+    // Преобразуем слово в кодировку словаря и осуществим проверку
+    //
+    const auto encodedWordData = checkerTextCodec->fromUnicode(correctedWord);
+    const auto encodedWord = encodedWordData.constData();
+    const bool isCorrect = checker->spell(encodedWord);
+    results->insert(_word, new bool(isCorrect));
+    return isCorrect;
+}
+
 
 // ****
 
@@ -136,6 +253,8 @@ QString SpellChecker::spellingLanguage() const
 
 void SpellChecker::setSpellingLanguage(const QString& _languageCode)
 {
+    QMutexLocker locker(&d->mutex);
+
     if (d->languageCode == _languageCode && !d->checker.isNull()
         && d->checkerTextCodec != nullptr) {
         return;
@@ -176,6 +295,14 @@ void SpellChecker::setSpellingLanguage(const QString& _languageCode)
         return;
     }
 
+    //
+    // Если для языка игнорировались слова, то новый проверяющий о них уже не знает, поэтому
+    // сохранённые результаты проверки больше не годятся
+    //
+    if (d->languagesWithIgnoredWords.remove(_languageCode)) {
+        d->spellCheckResults.remove(_languageCode);
+    }
+
     //
     // Загружаем слова из пользовательского словаря
     //
@@ -193,44 +320,49 @@ void SpellChecker::setSpellingLanguage(const QString& _languageCode)
 
 bool SpellChecker::spellCheckWord(const QString& _word) const
 {
-    //
-    // Если проверяющего орфографию не удалось настроить, то и проверять нет смысла
-    //
+    QMutexLocker locker(&d->mutex);
+    return d->spellCheckWord(_word);
+}
+
+std::optional<bool> SpellChecker::cachedSpellCheckWord(const QString& _word) const
+{
+    QMutexLocker locker(&d->mutex);
+
     if (d->checker == nullptr || d->checkerTextCodec == nullptr) {
         return false;
     }
 
-    //
-    // Игнорируем двойной минус, т.к. это служебное обозначение в сценарной записи
-    //
     if (_word == "--") {
         return true;
     }
 
-    //
-    // Собственно проверка
-    //
-    QString correctedWord = _word;
-    //
-    // Для слов заканчивающихся на s с апострофом убираем апостроф в конце, т.к. ханспел его не
-    // умеет
-    //
-    if (d->languageCode.startsWith("en")
-        && (correctedWord.endsWith("s'", Qt::CaseInsensitive)
-            || correctedWord.endsWith("s’", Qt::CaseInsensitive))) {
-        correctedWord.chop(1);
+    const auto spellCheckResults = d->spellCheckResults.value(d->languageCode);
+    if (spellCheckResults.isNull() || !spellCheckResults->contains(_word)) {
+        return std::nullopt;
     }
 
-    //
-    // Преобразуем слово в кодировку словаря и осуществим проверку
-    //
-    const auto encodedWordData = d->checkerTextCodec->fromUnicode(correctedWord);
-    const auto encodedWord = encodedWordData.constData();
-    return d->checker->spell(encodedWord);
+    return *spellCheckResults->object(_word);
+}
+
+QFuture<QHash<QString, bool>> SpellChecker::spellCheckWordsAsync(const QStringList& _words) const
+{
+    return QtConcurrent::run(&d->spellCheckPool, [this, _words] {
+        QHash<QString, bool> results;
+        for (const auto& word : _words) {
+            //
+            // Блокируем проверяющего на каждое слово отдельно, чтобы не задерживать надолго
+            // обращения к нему из основного потока
+            //
+            results.insert(word, spellCheckWord(word));
+        }
+        return results;
+    });
 }
 
 QStringList SpellChecker::suggestionsForWord(const QString& _word) const
 {
+    QMutexLocker locker(&d->mutex);
+
     if (d->checker == nullptr || d->checkerTextCodec == nullptr) {
         return {};
     }
@@ -238,7 +370,7 @@ QStringList SpellChecker::suggestionsForWord(const QString& _word) const
     //
     // Проверяем необходимость получения списка вариантов
     //
-    if (spellCheckWord(_word)) {
+    if (d->spellCheckWord(_word)) {
         return {};
     }
 
@@ -269,19 +401,37 @@ QStringList SpellChecker::suggestionsForWord(const QString& _word) const
 
 void SpellChecker::ignoreWord(const QString& _word) const
 {
+    QMutexLocker locker(&d->mutex);
+
     //
     // Добавим слово в словарный запас проверяющего на текущую сессию
     //
     d->addWordToChecker(_word);
+
+    //
+    // ... и забудем результаты его проверки для текущего словаря
+    //
+    d->removeSpellCheckResults(d->spellCheckResults.value(d->languageCode).data(), _word);
+    d->languagesWithIgnoredWords.insert(d->languageCode);
 }
 
 void SpellChecker::addWordToDictionary(const QString& _word) const
 {
+    QMutexLocker locker(&d->mutex);
+
     //
     // Добавим слово в словарный запас проверяющего
     //
     d->addWordToChecker(_word);
 
+    //
+    // ... и забудем результаты его проверки для всех словарей, т.к. пользовательский словарь общий
+    //     для всех языков
+    //
+    for (const auto& results : std::as_const(d->spellCheckResults)) {
+        d->removeSpellCheckResults(results.data(), _word);
+    }
+
     //
     // Запишем слово в пользовательский словарь
     //
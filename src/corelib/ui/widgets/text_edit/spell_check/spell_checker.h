@@ -1,11 +1,14 @@
 #pragma once
 
+#include <QFuture>
 #include <QHash>
 #include <QScopedPointer>
 #include <QtContainerFwd>
 
 #include <corelib_global.h>
 
+#include <optional>
+
 class Hunspell;
 class QTextCodec;
 
@@ -17,6 +20,8 @@ class QTextCodec;
 
 /**
  * @brief Класс проверяющего орфографию
+ * @note Результаты проверки слов кэшируются отдельно для каждого словаря, а сам проверяющий может
+ *       использоваться из фонового потока
  */
 class CORE_LIBRARY_EXPORT SpellChecker
 {
@@ -47,6 +52,20 @@ public:
      */
     bool spellCheckWord(const QString& _word) const;
 
+    /**
+     * @brief Получить результат проверки орфографии слова из кэша, не обращаясь к словарю
+     * @param Слово для проверки
+     * @return Корректность орфографии в слове, либо пустое значение, если слово ещё не проверялось
+     */
+    std::optional<bool> cachedSpellCheckWord(const QString& _word) const;
+
+    /**
+     * @brief Проверить орфографию слов в фоновом потоке
+     * @param Слова для проверки
+     * @return Корректность орфографии для каждого из слов
+     */
+    QFuture<QHash<QString, bool>> spellCheckWordsAsync(const QStringList& _words) const;
+
     /**
      * @brief Получить список близких слов (вариантов исправления ошибки)
      * @param Некоректное слово, для которого ищется список
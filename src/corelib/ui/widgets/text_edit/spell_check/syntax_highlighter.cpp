@@ -3,6 +3,7 @@
 #include "qapplication.h"
 
 #include <qdebug.h>
+#include <qelapsedtimer.h>
 #include <qpointer.h>
 #include <qtextcursor.h>
 #include <qtextdocument.h>
@@ -11,6 +12,19 @@
 #include <qtimer.h>
 
 
+namespace {
+/**
+ * @brief Количество абзацев вокруг видимой области, которые подсвечиваются сразу
+ */
+const int kVisibleBlocksMargin = 20;
+
+/**
+ * @brief Время, отводимое на обработку одной порции очереди абзацев в простое, мс
+ */
+const int kPendingBlocksTimeSlice = 8;
+} // namespace
+
+
 void SyntaxHighlighterPrivate::applyFormatChanges()
 {
     bool formatsChanged = false;
@@ -125,6 +139,7 @@ void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock& block)
                "reFormatBlock() called recursively");
 
     currentBlock = block;
+    pendingBlocks.remove(block.fragmentIndex());
 
     formatChanges.fill(QTextCharFormat(), block.length() - 1);
     if (block.charFormat().fontCapitalization() == QFont::AllUppercase) {
@@ -140,6 +155,121 @@ void SyntaxHighlighterPrivate::reformatBlock(const QTextBlock& block)
     currentBlock = QTextBlock();
 }
 
+void SyntaxHighlighterPrivate::highlightPendingBlock(const QTextBlock& _block)
+{
+    if (!pendingBlocks.contains(_block.fragmentIndex())) {
+        return;
+    }
+
+    auto block = _block;
+    bool forceHighlightOfNextBlock = false;
+    do {
+        const int stateBeforeHighlight = block.userState();
+
+        reformatBlock(block);
+
+        forceHighlightOfNextBlock = (block.userState() != stateBeforeHighlight);
+
+        block = block.next();
+    } while (forceHighlightOfNextBlock && block.isValid());
+
+    formatChanges.clear();
+}
+
+void SyntaxHighlighterPrivate::highlightVisibleBlocks()
+{
+    if (!isLazyHighlighting || !doc || pendingBlocks.isEmpty()) {
+        return;
+    }
+
+    //
+    // Определим видимую область вместе с запасом вокруг неё, если она ещё не задана, то считаем
+    // видимым начало документа
+    //
+    auto firstBlock
+        = firstVisibleBlockCursor.isNull() || firstVisibleBlockCursor.document() != doc
+        ? doc->begin()
+        : firstVisibleBlockCursor.block();
+    auto lastBlock = lastVisibleBlockCursor.isNull() || lastVisibleBlockCursor.document() != doc
+        ? firstBlock
+        : lastVisibleBlockCursor.block();
+    for (int index = 0; index < kVisibleBlocksMargin && firstBlock.previous().isValid();
+         ++index) {
+        firstBlock = firstBlock.previous();
+    }
+    for (int index = 0; index < kVisibleBlocksMargin && lastBlock.next().isValid(); ++index) {
+        lastBlock = lastBlock.next();
+    }
+
+    //
+    // Подсвечиваем видимые абзацы сразу
+    //
+    inReformatBlocks = true;
+    QTextCursor cursor(doc);
+    cursor.beginEditBlock();
+    for (auto block = firstBlock; block.isValid(); block = block.next()) {
+        highlightPendingBlock(block);
+        if (block == lastBlock) {
+            break;
+        }
+    }
+    cursor.endEditBlock();
+    inReformatBlocks = false;
+
+    //
+    // ... а остальные ставим в очередь по удалённости от видимой области
+    //
+    nextBlockBelowCursor = QTextCursor(lastBlock);
+    isBelowFinished = !nextBlockBelowCursor.movePosition(QTextCursor::NextBlock);
+    nextBlockAboveCursor = QTextCursor(firstBlock);
+    isAboveFinished = !nextBlockAboveCursor.movePosition(QTextCursor::PreviousBlock);
+    if (!pendingBlocks.isEmpty()) {
+        pendingBlocksTimer.start();
+    }
+}
+
+void SyntaxHighlighterPrivate::highlightPendingBlocksPart()
+{
+    if (!doc) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    inReformatBlocks = true;
+    QTextCursor cursor(doc);
+    cursor.beginEditBlock();
+    bool isBelowTurn = true;
+    while (!pendingBlocks.isEmpty() && (!isBelowFinished || !isAboveFinished)
+           && timer.elapsed() < kPendingBlocksTimeSlice) {
+        //
+        // Чередуем абзацы ниже и выше видимой области, чтобы первыми обрабатывались ближайшие к ней
+        //
+        if ((isBelowTurn && !isBelowFinished) || isAboveFinished) {
+            highlightPendingBlock(nextBlockBelowCursor.block());
+            isBelowFinished = !nextBlockBelowCursor.movePosition(QTextCursor::NextBlock);
+        } else {
+            highlightPendingBlock(nextBlockAboveCursor.block());
+            isAboveFinished = !nextBlockAboveCursor.movePosition(QTextCursor::PreviousBlock);
+        }
+        isBelowTurn = !isBelowTurn;
+    }
+    cursor.endEditBlock();
+    inReformatBlocks = false;
+
+    //
+    // Если очередь пройдена целиком, то оставшиеся в ней индексы принадлежат уже удалённым абзацам
+    //
+    if (isBelowFinished && isAboveFinished) {
+        pendingBlocks.clear();
+    }
+
+    if (!pendingBlocks.isEmpty()) {
+        pendingBlocksTimer.start();
+    }
+}
+
 /*!
     \class QSyntaxHighlighter
     \reentrant
@@ -266,6 +396,11 @@ SyntaxHighlighter::~SyntaxHighlighter()
 */
 void SyntaxHighlighter::setDocument(QTextDocument* doc)
 {
+    d->pendingBlocksTimer.stop();
+    d->pendingBlocks.clear();
+    d->firstVisibleBlockCursor = {};
+    d->lastVisibleBlockCursor = {};
+
     if (d->doc) {
         disconnect(d->doc, &QTextDocument::contentsChange, d,
                    &SyntaxHighlighterPrivate::_q_reformatBlocks);
@@ -315,6 +450,20 @@ void SyntaxHighlighter::rehighlight()
     if (!d->doc)
         return;
 
+    //
+    // В ленивом режиме ставим в очередь все абзацы и сразу подсвечиваем только видимые
+    //
+    if (d->isLazyHighlighting) {
+        d->rehighlightPending = false;
+        d->pendingBlocks.clear();
+        d->pendingBlocks.reserve(d->doc->blockCount());
+        for (auto block = d->doc->begin(); block.isValid(); block = block.next()) {
+            d->pendingBlocks.insert(block.fragmentIndex());
+        }
+        d->highlightVisibleBlocks();
+        return;
+    }
+
     QTextCursor cursor(d->doc);
     d->rehighlight(cursor, QTextCursor::End);
 }
@@ -350,6 +499,41 @@ void SyntaxHighlighter::setChanged(bool _changed)
     d->isDocumentChangedFormLastEdit = _changed;
 }
 
+void SyntaxHighlighter::setLazyHighlighting(bool _lazy)
+{
+    if (d->isLazyHighlighting == _lazy) {
+        return;
+    }
+
+    d->isLazyHighlighting = _lazy;
+
+    //
+    // Если ленивый режим отключён, то подсвечиваем всё, что не успели подсветить в нём
+    //
+    if (!d->isLazyHighlighting && !d->pendingBlocks.isEmpty()) {
+        d->pendingBlocksTimer.stop();
+        d->pendingBlocks.clear();
+        rehighlight();
+    }
+}
+
+bool SyntaxHighlighter::isLazyHighlighting() const
+{
+    return d->isLazyHighlighting;
+}
+
+void SyntaxHighlighter::setVisibleBlocks(const QTextBlock& _firstBlock,
+                                         const QTextBlock& _lastBlock)
+{
+    if (!d->doc || _firstBlock.document() != d->doc || _lastBlock.document() != d->doc) {
+        return;
+    }
+
+    d->firstVisibleBlockCursor = QTextCursor(_firstBlock);
+    d->lastVisibleBlockCursor = QTextCursor(_lastBlock);
+    d->highlightVisibleBlocks();
+}
+
 /*!
     \fn void QSyntaxHighlighter::highlightBlock(const QString &text)
 
@@ -2,9 +2,11 @@
 
 #include <QObject>
 #include <QPointer>
+#include <QSet>
 #include <QTextCursor>
 #include <QTextDocument>
 #include <QTextObject>
+#include <QTimer>
 #include <QtCore/qglobal.h>
 
 #include <corelib_global.h>
@@ -37,6 +39,22 @@ public:
     bool isChanged() const;
     void setChanged(bool _changed);
 
+    /**
+     * @brief Включить/выключить ленивую подсветку
+     * @note В ленивом режиме при перепроверке всего документа сразу подсвечиваются только видимые
+     *       абзацы, а остальные обрабатываются небольшими порциями в простое, начиная с ближайших
+     *       к видимой области
+     */
+    void setLazyHighlighting(bool _lazy);
+    bool isLazyHighlighting() const;
+
+    /**
+     * @brief Задать видимую область документа
+     * @note В ленивом режиме абзацы видимой области подсвечиваются сразу, а очередь остальных
+     *       перестраивается от неё
+     */
+    void setVisibleBlocks(const QTextBlock& _firstBlock, const QTextBlock& _lastBlock);
+
 protected:
     virtual void highlightBlock(const QString& text) = 0;
 
@@ -76,6 +94,10 @@ public:
         , rehighlightPending(false)
         , inReformatBlocks(false)
     {
+        pendingBlocksTimer.setSingleShot(true);
+        pendingBlocksTimer.setInterval(0);
+        connect(&pendingBlocksTimer, &QTimer::timeout, this,
+                &SyntaxHighlighterPrivate::highlightPendingBlocksPart);
     }
 
     SyntaxHighlighter* q;
@@ -120,4 +142,50 @@ public:
      * @brief Изменялся ли документ с момента последней проверки
      */
     bool isDocumentChangedFormLastEdit = false;
+
+    /**
+     * @brief Подсветить абзац, если он ожидает подсветки, а также следующие за ним, если от него
+     *        зависит их подсветка
+     */
+    void highlightPendingBlock(const QTextBlock& _block);
+
+    /**
+     * @brief Подсветить ожидающие подсветки абзацы видимой области и перестроить от неё очередь
+     */
+    void highlightVisibleBlocks();
+
+    /**
+     * @brief Подсветить очередную порцию ожидающих подсветки абзацев
+     */
+    void highlightPendingBlocksPart();
+
+    /**
+     * @brief Включена ли ленивая подсветка
+     */
+    bool isLazyHighlighting = false;
+
+    /**
+     * @brief Абзацы, ожидающие подсветки (индексы их фрагментов в документе)
+     */
+    QSet<int> pendingBlocks;
+
+    /**
+     * @brief Границы видимой области
+     * @note Используем курсоры, т.к. в отличие от блоков они корректно отслеживают правки документа
+     */
+    QTextCursor firstVisibleBlockCursor;
+    QTextCursor lastVisibleBlockCursor;
+
+    /**
+     * @brief Очередные абзацы очереди ниже и выше видимой области
+     */
+    QTextCursor nextBlockBelowCursor;
+    QTextCursor nextBlockAboveCursor;
+    bool isBelowFinished = true;
+    bool isAboveFinished = true;
+
+    /**
+     * @brief Таймер обработки очереди в простое
+     */
+    QTimer pendingBlocksTimer;
 };
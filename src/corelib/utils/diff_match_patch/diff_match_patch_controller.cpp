@@ -2,33 +2,16 @@
 
 #include "diff_match_patch.h"
 
+#include <algorithm>
 
-namespace {
-
-/**
- * @brief Является ли строка тэгом
- */
-static bool isTag(const QString& _tag)
-{
-    return !_tag.isEmpty() && _tag.startsWith(QLatin1String("<"))
-        && _tag.endsWith(QLatin1String(">"));
-}
 
-/**
- * @brief Является ли тэг открывающим
- */
-static bool isOpenTag(const QString& _tag)
-{
-    return isTag(_tag) && !_tag.contains(QLatin1String("/"));
-}
+namespace {
 
 /**
- * @brief Является ли тэг закрывающим
+ * @brief Первый символ из зарезервированной секции кодов юникода U+E000–U+F8FF, используемый для
+ *        замены тэгов
  */
-static bool isCloseTag(const QString& _tag)
-{
-    return isTag(_tag) && _tag.contains(QLatin1String("/"));
-}
+constexpr ushort kFirstTagCharacter = 0xE000;
 
 } // namespace
 
@@ -56,7 +39,7 @@ public:
     /**
      * @brief Сформировать патч между двумя xml-текстами
      */
-    QString makePatchXml(const QString& _xml1, const QString& _xml2);
+    QString makePatchXml(const QString& _xml1, const QString& _xml2, int _position = 0);
 
     /**
      * @brief Применить патч для простого текста
@@ -68,8 +51,34 @@ public:
      */
     QString applyPatchXml(const QString& _xml, const QString& _patch);
 
+    /**
+     * @brief Является ли символ заменой открывающего или закрывающего тэга
+     */
+    bool isOpenTag(QChar _character) const;
+    bool isCloseTag(QChar _character) const;
+
+    /**
+     * @brief Пройти по xml, вызывая обработчик для каждого тэга из карты
+     * @param _tagHandler Принимает позицию тэга, его длину и служебный символ для замены
+     */
+    template<typename TagHandler>
+    void forEachTag(const QString& _xml, TagHandler _tagHandler) const;
+
 
+    /**
+     * @brief Карта тэгов и заменяющих их служебных символов
+     */
     QHash<QString, QChar> tagsMap;
+
+    /**
+     * @brief Тэги в порядке служебных символов, открывающий тэг идёт перед закрывающим
+     */
+    QVector<QString> tags;
+
+    /**
+     * @brief Длина самого длинного тэга
+     */
+    int maximumTagLength = 0;
 };
 
 DiffMatchPatchController::Implementation::Implementation(const QVector<QString>& _tags)
@@ -78,35 +87,79 @@ DiffMatchPatchController::Implementation::Implementation(const QVector<QString>&
     // Используем зарезервированную секцию кодов юникода U+E000–U+F8FF,
     // для генерации служебных символов для карты тэгов
     //
-    uint characterIndex = 0xE000;
-    auto nextCharacter = [&characterIndex] { return QChar(characterIndex++); };
-
-    //
-    // Добавить заданный тэг в карту служебных символов
-    //
-    auto addTag = [this, nextCharacter](const QString& _tag) {
-        tagsMap.insert("<" + _tag + ">", nextCharacter());
-        tagsMap.insert("</" + _tag + ">", nextCharacter());
+    auto addTag = [this](const QString& _tag) {
+        tagsMap.insert(_tag, QChar(kFirstTagCharacter + tags.size()));
+        tags.append(_tag);
+        maximumTagLength = std::max(maximumTagLength, static_cast<int>(_tag.length()));
     };
     for (const auto& tag : _tags) {
-        addTag(tag);
+        addTag("<" + tag + ">");
+        addTag("</" + tag + ">");
     }
 }
 
-QString DiffMatchPatchController::Implementation::xmlToPlain(const QString& _xml)
+bool DiffMatchPatchController::Implementation::isOpenTag(QChar _character) const
+{
+    const int tagIndex = _character.unicode() - kFirstTagCharacter;
+    return tagIndex >= 0 && tagIndex < tags.size() && tagIndex % 2 == 0;
+}
+
+bool DiffMatchPatchController::Implementation::isCloseTag(QChar _character) const
 {
-    QString plain = _xml;
-    for (auto iter = tagsMap.begin(); iter != tagsMap.end(); ++iter) {
-        plain.replace(iter.key(), iter.value());
+    const int tagIndex = _character.unicode() - kFirstTagCharacter;
+    return tagIndex >= 0 && tagIndex < tags.size() && tagIndex % 2 == 1;
+}
+
+template<typename TagHandler>
+void DiffMatchPatchController::Implementation::forEachTag(const QString& _xml,
+                                                          TagHandler _tagHandler) const
+{
+    int tagStart = -1;
+    for (int index = 0; index < _xml.length(); ++index) {
+        const auto character = _xml.at(index);
+        if (character == QLatin1Char('<')) {
+            tagStart = index;
+        } else if (character == QLatin1Char('>') && tagStart != -1) {
+            const int tagLength = index - tagStart + 1;
+            if (tagLength <= maximumTagLength) {
+                const auto tagIter = tagsMap.constFind(_xml.mid(tagStart, tagLength));
+                if (tagIter != tagsMap.constEnd()) {
+                    _tagHandler(tagStart, tagLength, tagIter.value());
+                }
+            }
+            tagStart = -1;
+        }
     }
+}
+
+QString DiffMatchPatchController::Implementation::xmlToPlain(const QString& _xml)
+{
+    //
+    // Заменяем все тэги за один проход по тексту
+    //
+    QString plain;
+    plain.reserve(_xml.length());
+    int copyFrom = 0;
+    forEachTag(_xml, [&plain, &copyFrom, &_xml](int _tagStart, int _tagLength, QChar _character) {
+        plain.append(_xml.constData() + copyFrom, _tagStart - copyFrom);
+        plain.append(_character);
+        copyFrom = _tagStart + _tagLength;
+    });
+    plain.append(_xml.constData() + copyFrom, _xml.length() - copyFrom);
     return plain;
 }
 
 QString DiffMatchPatchController::Implementation::plainToXml(const QString& _plain)
 {
-    QString xml = _plain;
-    for (auto iter = tagsMap.begin(); iter != tagsMap.end(); ++iter) {
-        xml.replace(iter.value(), iter.key());
+    QString xml;
+    xml.reserve(_plain.length() * 2);
+    for (const auto character : _plain) {
+        const int tagIndex = character.unicode() - kFirstTagCharacter;
+        if (tagIndex >= 0 && tagIndex < tags.size()) {
+            xml.append(tags.at(tagIndex));
+        } else {
+            xml.append(character);
+        }
     }
     return xml;
 }
@@ -119,9 +172,22 @@ QString DiffMatchPatchController::Implementation::makePatchPlain(const QString&
 }
 
 QString DiffMatchPatchController::Implementation::makePatchXml(const QString& _xml1,
-                                                               const QString& _xml2)
+                                                               const QString& _xml2, int _position)
 {
-    return plainToXml(makePatchPlain(xmlToPlain(_xml1), xmlToPlain(_xml2)));
+    if (_position == 0) {
+        return plainToXml(makePatchPlain(xmlToPlain(_xml1), xmlToPlain(_xml2)));
+    }
+
+    //
+    // Формируем патч для фрагмента и смещаем его в позицию фрагмента внутри документа
+    //
+    diff_match_patch dmp;
+    auto patches = dmp.patch_make(xmlToPlain(_xml1), xmlToPlain(_xml2));
+    for (auto& patch : patches) {
+        patch.start1 += _position;
+        patch.start2 += _position;
+    }
+    return plainToXml(dmp.patch_toText(patches));
 }
 
 QString DiffMatchPatchController::Implementation::applyPatchPlain(const QString& _plain,
@@ -154,6 +220,27 @@ QByteArray DiffMatchPatchController::makePatch(const QString& _lhs, const QStrin
     return d->makePatchXml(_lhs, _rhs).toUtf8();
 }
 
+QByteArray DiffMatchPatchController::makePatch(const QString& _lhs, const QString& _rhs,
+                                               int _position) const
+{
+    return d->makePatchXml(_lhs, _rhs, _position).toUtf8();
+}
+
+int DiffMatchPatchController::plainLength(const QString& _xml) const
+{
+    //
+    // Каждый тэг из карты в плоском тексте заменяется одним символом, поэтому вместо замены
+    // достаточно за один проход вычесть из длины xml длины найденных тэгов
+    //
+    int length = _xml.length();
+    d->forEachTag(_xml, [&length](int _tagStart, int _tagLength, QChar _character) {
+        Q_UNUSED(_tagStart)
+        Q_UNUSED(_character)
+        length -= _tagLength - 1;
+    });
+    return length;
+}
+
 QByteArray DiffMatchPatchController::applyPatch(const QByteArray& _content,
                                                 const QByteArray& _patch) const
 {
@@ -235,7 +322,7 @@ QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> DiffMa
         //
         // Идём до открывающего тега
         //
-        if (isOpenTag(d->tagsMap.key(oldXmlPlain.at(oldStartPosForXmlPlain)))) {
+        if (d->isOpenTag(oldXmlPlain.at(oldStartPosForXmlPlain))) {
             break;
         }
     }
@@ -244,7 +331,7 @@ QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> DiffMa
         //
         // Идём до закрывающего тэга, он находится в конце строки
         //
-        if (isCloseTag(d->tagsMap.key(oldXmlPlain.at(oldEndPosForXml)))) {
+        if (d->isCloseTag(oldXmlPlain.at(oldEndPosForXml))) {
             ++oldEndPosForXml;
             break;
         }
@@ -261,7 +348,7 @@ QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> DiffMa
         //
         // Идём до открывающего тега
         //
-        if (isOpenTag(d->tagsMap.key(newXmlPlain.at(newStartPosForXmlPlain)))) {
+        if (d->isOpenTag(newXmlPlain.at(newStartPosForXmlPlain))) {
             break;
         }
     }
@@ -270,7 +357,7 @@ QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> DiffMa
         //
         // Идём до закрывающего тэга, он находится в конце строки
         //
-        if (isCloseTag(d->tagsMap.key(newXmlPlain.at(newEndPosForXml)))) {
+        if (d->isCloseTag(newXmlPlain.at(newEndPosForXml))) {
             ++newEndPosForXml;
             break;
         }
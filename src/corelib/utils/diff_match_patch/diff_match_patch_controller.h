@@ -3,6 +3,8 @@
 #include <QScopedPointer>
 #include <QString>
 
+#include <corelib_global.h>
+
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
 template<typename, typename>
 struct QPair;
@@ -12,7 +14,7 @@ struct QPair;
 /**
  * @brief Управляющий классом сравнения данных документов
  */
-class DiffMatchPatchController final
+class CORE_LIBRARY_EXPORT DiffMatchPatchController final
 {
 public:
     explicit DiffMatchPatchController(const QVector<QString>& _tags);
@@ -23,6 +25,18 @@ public:
      */
     QByteArray makePatch(const QString& _lhs, const QString& _rhs) const;
 
+    /**
+     * @brief Сформировать патч для изменённого фрагмента документа
+     * @param _position Позиция фрагмента в документе в координатах патча
+     * @note Текст до и после фрагмента должен совпадать в обоих вариантах документа
+     */
+    QByteArray makePatch(const QString& _lhs, const QString& _rhs, int _position) const;
+
+    /**
+     * @brief Определить длину xml в координатах патча
+     */
+    int plainLength(const QString& _xml) const;
+
     /**
      * @brief Применить патч
      */
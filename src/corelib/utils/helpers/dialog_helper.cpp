@@ -34,6 +34,12 @@ QString DialogHelper::starcProjectFilter()
                       ExtensionHelper::starc());
 }
 
+QString DialogHelper::starcBackupDeltaFilter()
+{
+    return makeFilter(QApplication::translate("DialogHelper", "Story Architect project backup"),
+                      ExtensionHelper::starcBackupDelta());
+}
+
 QString DialogHelper::starcTemplateFilter()
 {
     return makeFilter(QApplication::translate("DialogHelper", "Story Architect template"),
@@ -122,11 +128,13 @@ QString DialogHelper::filtersForOpenProject()
     QString filters = makeFilter(QApplication::translate("DialogHelper", "All supported files"),
                                  {
                                      ExtensionHelper::starc(),
+                                     ExtensionHelper::starcBackupDelta(),
                                      ExtensionHelper::fountain(),
                                      ExtensionHelper::plainText(),
                                  });
     for (const auto& filter : {
              starcProjectFilter(),
+             starcBackupDeltaFilter(),
              fountainFilter(),
              plainTextFilter(),
          }) {
@@ -13,6 +13,11 @@ QString ExtensionHelper::starct()
     return QLatin1String("starct");
 }
 
+QString ExtensionHelper::starcBackupDelta()
+{
+    return QLatin1String("starc.delta");
+}
+
 QString ExtensionHelper::kitScenarist()
 {
     return QLatin1String("kitsp");
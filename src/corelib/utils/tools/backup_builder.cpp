@@ -4,11 +4,323 @@
 
 #include <QDate>
 #include <QDir>
+#include <QMap>
+#include <QRegularExpression>
+#include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QString>
+#include <QUuid>
+#include <QVariant>
 
 #include <set>
 
 
+namespace {
+
+/**
+ * @brief Расширение файлов резервных копий, хранящих обратную разность
+ */
+const QString kDeltaSuffix = QStringLiteral(".delta");
+
+/**
+ * @brief Префикс таблиц разности с ключами строк, появившихся в более новой копии, за ним следует
+ *        имя исходной таблицы
+ * @note Точка не встречается в именах таблиц проекта, поэтому имена не пересекаются
+ */
+const QString kAddedKeysTablePrefix = QStringLiteral("backup_added_keys.");
+
+/**
+ * @brief Соединение с файлом базы данных в рамках текущего потока
+ */
+class Connection
+{
+public:
+    explicit Connection(const QString& _databasePath)
+        : m_name(QString("backup_builder_%1").arg(QUuid::createUuid().toString()))
+    {
+        m_database = QSqlDatabase::addDatabase("QSQLITE", m_name);
+        m_database.setDatabaseName(_databasePath);
+        m_database.open();
+    }
+    ~Connection()
+    {
+        m_database.close();
+        m_database = {};
+        QSqlDatabase::removeDatabase(m_name);
+    }
+
+    bool isOpen() const
+    {
+        return m_database.isOpen();
+    }
+
+    QSqlQuery query() const
+    {
+        return QSqlQuery(m_database);
+    }
+
+    /**
+     * @brief Выполнить запрос с параметрами
+     */
+    bool exec(const QString& _statement, const QVariantList& _values = {}) const
+    {
+        auto query = this->query();
+        query.prepare(_statement);
+        for (const auto& value : _values) {
+            query.addBindValue(value);
+        }
+        return query.exec();
+    }
+
+private:
+    const QString m_name;
+    QSqlDatabase m_database;
+};
+
+/**
+ * @brief Экранировать имя таблицы или столбца для использования в запросе
+ */
+QString quoted(const QString& _identifier)
+{
+    return QString("\"%1\"").arg(QString(_identifier).replace('"', "\"\""));
+}
+
+/**
+ * @brief Список пользовательских таблиц заданной схемы
+ * @note Виртуальные таблицы полнотекстового поиска и их служебные таблицы не учитываются, т.к.
+ *       у них нет первичного ключа, а их содержимое поддерживается триггерами исходных таблиц
+ */
+QStringList tables(const Connection& _connection, const QString& _schema)
+{
+    QStringList result;
+    auto query = _connection.query();
+    query.exec(QString("SELECT name FROM %1.sqlite_master AS master "
+                       "WHERE type = 'table' AND name NOT LIKE 'sqlite_%' "
+                       "AND sql NOT LIKE 'CREATE VIRTUAL TABLE%' "
+                       "AND NOT EXISTS (SELECT 1 FROM %1.sqlite_master AS virtual "
+                       "WHERE virtual.type = 'table' "
+                       "AND virtual.sql LIKE 'CREATE VIRTUAL TABLE%' "
+                       "AND substr(master.name, 1, length(virtual.name) + 1) "
+                       "= virtual.name || '_') "
+                       "ORDER BY name")
+                   .arg(_schema));
+    while (query.next()) {
+        result.append(query.value(0).toString());
+    }
+    return result;
+}
+
+/**
+ * @brief Столбцы таблицы и её первичный ключ
+ */
+struct TableColumns {
+    bool operator==(const TableColumns& _other) const
+    {
+        return columns == _other.columns && primaryKey == _other.primaryKey;
+    }
+    bool operator!=(const TableColumns& _other) const
+    {
+        return !(*this == _other);
+    }
+
+    /**
+     * @brief Список столбцов в порядке их следования в таблице
+     */
+    QStringList columns;
+
+    /**
+     * @brief Столбцы первичного ключа в порядке их следования в ключе, если таблица без
+     *        первичного ключа, то список будет пустым
+     */
+    QStringList primaryKey;
+};
+
+/**
+ * @brief Получить столбцы таблицы
+ */
+TableColumns tableColumns(const Connection& _connection, const QString& _schema,
+                          const QString& _table)
+{
+    TableColumns result;
+    QMap<int, QString> primaryKey;
+    auto query = _connection.query();
+    query.exec(QString("PRAGMA %1.table_info(%2)").arg(_schema, quoted(_table)));
+    while (query.next()) {
+        const auto column = query.value("name").toString();
+        result.columns.append(column);
+        //
+        // ... номер столбца в составном ключе начинается с единицы
+        //
+        if (const auto keyIndex = query.value("pk").toInt(); keyIndex > 0) {
+            primaryKey.insert(keyIndex, column);
+        }
+    }
+    result.primaryKey = primaryKey.values();
+    return result;
+}
+
+/**
+ * @brief Список столбцов, экранированных для использования в запросе
+ */
+QString quoted(const QStringList& _columns)
+{
+    QStringList result;
+    for (const auto& column : _columns) {
+        result.append(quoted(column));
+    }
+    return result.join(", ");
+}
+
+/**
+ * @brief Проверить, есть ли строки в заданной таблице
+ */
+bool hasRows(const Connection& _connection, const QString& _table)
+{
+    auto query = _connection.query();
+    query.exec(QString("SELECT EXISTS (SELECT 1 FROM %1)").arg(_table));
+    return query.next() && query.value(0).toBool();
+}
+
+/**
+ * @brief Результат построения обратной разности
+ */
+enum class DeltaResult {
+    Failed,
+    Empty,
+    Created,
+};
+
+/**
+ * @brief Построить обратную разность - строки более старой копии, отличающиеся от строк более
+ *        новой, и ключи строк, которых в старой копии ещё не было
+ */
+DeltaResult makeReverseDelta(const QString& _olderPath, const QString& _newerPath,
+                             const QString& _deltaPath)
+{
+    QFile::remove(_deltaPath);
+
+    Connection connection(_deltaPath);
+    if (!connection.isOpen() || !connection.exec("ATTACH ? AS older", { _olderPath })
+        || !connection.exec("ATTACH ? AS newer", { _newerPath })) {
+        return DeltaResult::Failed;
+    }
+
+    //
+    // Разность строится только для копий с одинаковой структурой
+    //
+    const auto olderTables = tables(connection, "older");
+    if (olderTables.isEmpty() || olderTables != tables(connection, "newer")) {
+        return DeltaResult::Failed;
+    }
+
+    bool isEmpty = true;
+    bool isSucceed = connection.exec("BEGIN");
+    for (const auto& table : olderTables) {
+        if (!isSucceed) {
+            break;
+        }
+
+        const auto columns = tableColumns(connection, "older", table);
+        if (columns.primaryKey.isEmpty() || columns != tableColumns(connection, "newer", table)) {
+            isSucceed = false;
+            break;
+        }
+
+        //
+        // Сохраняем строки старой копии, которые отличаются от новой, и ключи строк новой копии,
+        // которых в старой ещё не было, ключи сравниваются целиком, т.к. могут быть составными
+        //
+        const auto quotedTable = quoted(table);
+        const auto addedKeysTable = quoted(kAddedKeysTablePrefix + table);
+        const auto primaryKey = quoted(columns.primaryKey);
+        isSucceed
+            = connection.exec(QString("CREATE TABLE main.%1 AS SELECT * FROM older.%1 "
+                                      "EXCEPT SELECT * FROM newer.%1")
+                                  .arg(quotedTable))
+            && connection.exec(QString("CREATE TABLE main.%1 AS SELECT %2 FROM newer.%3 "
+                                       "EXCEPT SELECT %2 FROM older.%3")
+                                   .arg(addedKeysTable, primaryKey, quotedTable));
+        if (!isSucceed) {
+            break;
+        }
+
+        if (hasRows(connection, "main." + quotedTable)
+            || hasRows(connection, "main." + addedKeysTable)) {
+            isEmpty = false;
+        }
+    }
+    if (isSucceed) {
+        isSucceed = connection.exec("COMMIT");
+    } else {
+        connection.exec("ROLLBACK");
+    }
+    connection.exec("DETACH older");
+    connection.exec("DETACH newer");
+
+    if (!isSucceed) {
+        return DeltaResult::Failed;
+    }
+    return isEmpty ? DeltaResult::Empty : DeltaResult::Created;
+}
+
+/**
+ * @brief Применить обратную разность к копии, чтобы получить копию предыдущего поколения
+ */
+bool applyReverseDelta(const QString& _targetPath, const QString& _deltaPath)
+{
+    Connection connection(_targetPath);
+    if (!connection.isOpen() || !connection.exec("ATTACH ? AS delta", { _deltaPath })) {
+        return false;
+    }
+
+    bool isSucceed = connection.exec("BEGIN");
+    const auto deltaTables = tables(connection, "delta");
+    for (const auto& table : deltaTables) {
+        if (!isSucceed) {
+            break;
+        }
+        if (table.startsWith(kAddedKeysTablePrefix)) {
+            continue;
+        }
+
+        const auto columns = tableColumns(connection, "main", table);
+        if (columns.primaryKey.isEmpty()) {
+            isSucceed = false;
+            break;
+        }
+
+        //
+        // Удаляем строки, которых в предыдущем поколении ещё не было, и заменяем изменённые, при
+        // этом замена идёт удалением и вставкой, чтобы триггеры поддержали поисковый индекс
+        //
+        const auto quotedTable = quoted(table);
+        const auto primaryKey = quoted(columns.primaryKey);
+        const auto deleteStatement
+            = QString("DELETE FROM main.%1 WHERE (%2) IN (SELECT %2 FROM delta.%3)");
+        isSucceed = connection.exec(deleteStatement.arg(quotedTable, primaryKey,
+                                                        quoted(kAddedKeysTablePrefix + table)))
+            && connection.exec(deleteStatement.arg(quotedTable, primaryKey, quotedTable))
+            && connection.exec(
+                QString("INSERT INTO main.%1 SELECT * FROM delta.%1").arg(quotedTable));
+    }
+    isSucceed = isSucceed && connection.exec("COMMIT");
+    if (!isSucceed) {
+        connection.exec("ROLLBACK");
+    }
+    connection.exec("DETACH delta");
+
+    return isSucceed;
+}
+
+} // namespace
+
+
+bool BackupBuilder::snapshot(const QString& _filePath, const QString& _snapshotPath)
+{
+    Connection connection(_filePath);
+    return connection.isOpen() && connection.exec("VACUUM INTO ?", { _snapshotPath });
+}
+
 void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
                          const QString& _newName, int _maximumBackups)
 {
@@ -41,16 +353,18 @@ void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
     // Создаём копию
     //
     const auto rightNow = QDateTime::currentDateTime();
+    const QString backupFileName = backupFileNameFor(rightNow);
     const QString tmpBackupFileName
         = QString("%1%2.tmp.%3").arg(backupPath, backupBaseName, fileInfo.completeSuffix());
+    QFile::remove(tmpBackupFileName);
     //
-    // ... копируем файл во временную резервную копию
+    // ... снимаем копию базы данных во временную резервную копию, а если SQLite не умеет этого
+    //     делать, то просто копируем файл
     //
-    if (QFile::copy(_filePath, tmpBackupFileName)) {
+    if (snapshot(_filePath, tmpBackupFileName) || QFile::copy(_filePath, tmpBackupFileName)) {
         //
         // ... если скопировать удалось, переименовываем временную копию
         //
-        const QString backupFileName = backupFileNameFor(rightNow);
         QFile::remove(backupFileName);
         QFile::rename(tmpBackupFileName, backupFileName);
     }
@@ -58,10 +372,11 @@ void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
     //
     // Формируем список имеющихся резервных копий
     //
-    auto nameFilter = QString("%1_*.%2").arg(TextHelper::toRxEscaped(backupBaseName),
-                                             fileInfo.completeSuffix());
+    const auto nameFilter = QString("%1_*.%2").arg(TextHelper::toRxEscaped(backupBaseName),
+                                                   fileInfo.completeSuffix());
     QVector<QString> backups;
-    const auto files = QDir(_backupDir).entryInfoList({ nameFilter }, QDir::Files);
+    const auto files
+        = QDir(_backupDir).entryInfoList({ nameFilter, nameFilter + kDeltaSuffix }, QDir::Files);
     for (const auto& file : files) {
         backups.append(file.absoluteFilePath());
     }
@@ -71,10 +386,99 @@ void BackupBuilder::save(const QString& _filePath, const QString& _backupDir,
     std::sort(backups.begin(), backups.end(), std::greater<QString>());
 
     //
-    // Удаляем старые
+    // Заменяем предыдущую полную копию обратной разностью с новой, а если копии совпадают, то
+    // удаляем предыдущую вовсе
+    //
+    if (_maximumBackups > 1 && backups.size() > 1
+        && QFileInfo(backups.constFirst()) == QFileInfo(backupFileName)
+        && !backups.at(1).endsWith(kDeltaSuffix)) {
+        const auto previousBackup = backups.at(1);
+        const auto deltaFileName = previousBackup + kDeltaSuffix;
+        switch (makeReverseDelta(previousBackup, backupFileName, deltaFileName)) {
+        case DeltaResult::Created: {
+            QFile::remove(previousBackup);
+            backups[1] = deltaFileName;
+            break;
+        }
+
+        case DeltaResult::Empty: {
+            QFile::remove(deltaFileName);
+            QFile::remove(previousBackup);
+            backups.removeAt(1);
+            break;
+        }
+
+        case DeltaResult::Failed: {
+            QFile::remove(deltaFileName);
+            break;
+        }
+        }
+    }
+
+    //
+    // Удаляем старые, т.к. разности ссылаются только на более новые копии, то удаление самых
+    // старых не мешает восстанавливать оставшиеся
     //
     while (backups.size() > _maximumBackups) {
         const auto backupToRemove = backups.takeLast();
         QFile::remove(backupToRemove);
     }
 }
+
+bool BackupBuilder::restore(const QString& _backupPath, const QString& _targetPath)
+{
+    QFile::remove(_targetPath);
+
+    if (!_backupPath.endsWith(kDeltaSuffix)) {
+        return QFile::copy(_backupPath, _targetPath);
+    }
+
+    //
+    // Определяем имя проекта и расширение, чтобы найти все поколения копий
+    //
+    const QFileInfo backupInfo(_backupPath);
+    const QRegularExpression backupNameRx(QString("^(.*)_\\d{4}(_\\d{2}){5}\\.(.+)%1$")
+                                              .arg(QRegularExpression::escape(kDeltaSuffix)));
+    const auto match = backupNameRx.match(backupInfo.fileName());
+    if (!match.hasMatch()) {
+        return false;
+    }
+    const auto nameFilter = QString("%1_*.%2").arg(TextHelper::toRxEscaped(match.captured(1)),
+                                                   match.captured(3));
+    QVector<QString> backups;
+    const auto files = backupInfo.dir().entryInfoList({ nameFilter, nameFilter + kDeltaSuffix },
+                                                      QDir::Files, QDir::Name);
+    for (const auto& file : files) {
+        backups.append(file.absoluteFilePath());
+    }
+    std::sort(backups.begin(), backups.end());
+
+    //
+    // Собираем цепочку разностей от заданной копии до ближайшей более новой полной копии
+    //
+    QVector<QString> deltas;
+    QString fullBackup;
+    for (auto backupIndex = backups.indexOf(backupInfo.absoluteFilePath());
+         backupIndex >= 0 && backupIndex < backups.size(); ++backupIndex) {
+        const auto& backup = backups.at(backupIndex);
+        if (!backup.endsWith(kDeltaSuffix)) {
+            fullBackup = backup;
+            break;
+        }
+        deltas.prepend(backup);
+    }
+    if (fullBackup.isEmpty() || !QFile::copy(fullBackup, _targetPath)) {
+        return false;
+    }
+
+    //
+    // Откатываем полную копию назад по разностям, начиная с самой новой
+    //
+    for (const auto& delta : std::as_const(deltas)) {
+        if (!applyReverseDelta(_targetPath, delta)) {
+            QFile::remove(_targetPath);
+            return false;
+        }
+    }
+    return true;
+}
@@ -7,13 +7,32 @@ class QString;
 
 /**
  * @brief Класс для организации создания резервных копий
+ * @note Последняя резервная копия всегда является полноценным файлом проекта, а предыдущие
+ *       хранятся в виде обратных разностей (*.delta) - только тех строк, которые отличаются от
+ *       более новой копии, восстановить такую копию можно при помощи restore(), что и
+ *       происходит при её открытии в приложении
  */
 namespace BackupBuilder {
 
+/**
+ * @brief Снять согласованную копию проекта в заданный файл
+ * @note Копия снимается из отдельного соединения с базой данных, поэтому в неё попадают и
+ *       изменения, которые ещё лежат в журнале, а сам файл проекта остаётся нетронутым
+ */
+CORE_LIBRARY_EXPORT extern bool snapshot(const QString& _filePath, const QString& _snapshotPath);
+
 /**
  * @brief Сохранить бэкап
+ * @note Копия снимается из отдельного соединения с базой данных, поэтому файл проекта может
+ *       изменяться во время её создания
  */
 CORE_LIBRARY_EXPORT extern void save(const QString& _filePath, const QString& _backupDir,
                                      const QString& _newName, int _maximumBackups);
 
+/**
+ * @brief Восстановить проект из резервной копии в заданный файл
+ * @return Удалось ли восстановить
+ */
+CORE_LIBRARY_EXPORT extern bool restore(const QString& _backupPath, const QString& _targetPath);
+
 } // namespace BackupBuilder
@@ -0,0 +1,224 @@
+#include "memory_pool.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+
+namespace {
+
+/**
+ * @brief Шаг классов размеров ячеек, заодно он же и выравнивание ячеек
+ */
+constexpr std::size_t kSizeClassStep = 16;
+
+/**
+ * @brief Размер ячейки самого крупного класса
+ */
+constexpr std::size_t kMaxCellSize = 256;
+
+/**
+ * @brief Размер блока памяти, из которого нарезаются ячейки
+ * @note Блоки выравниваются по своему размеру, поэтому блок ячейки находится по её адресу
+ */
+constexpr std::size_t kChunkSize = 64 * 1024;
+
+/**
+ * @brief Ячейка, находящаяся в списке свободных
+ */
+struct FreeCell {
+    FreeCell* next = nullptr;
+};
+
+/**
+ * @brief Заголовок блока памяти, за которым идут его ячейки
+ */
+struct Chunk {
+    /**
+     * @brief Список свободных ячеек блока
+     */
+    FreeCell* freeCells = nullptr;
+
+    /**
+     * @brief Количество занятых ячеек
+     */
+    std::size_t usedCells = 0;
+
+    /**
+     * @brief Соседи в списке блоков пула, в которых есть свободные ячейки
+     */
+    Chunk* previous = nullptr;
+    Chunk* next = nullptr;
+};
+
+/**
+ * @brief Смещение первой ячейки от начала блока
+ */
+constexpr std::size_t kFirstCellOffset
+    = (sizeof(Chunk) + kSizeClassStep - 1) / kSizeClassStep * kSizeClassStep;
+
+/**
+ * @brief Пул ячеек одного размера
+ */
+struct CellsPool {
+    std::mutex mutex;
+
+    /**
+     * @brief Блоки, в которых есть свободные ячейки
+     * @note Заполненные блоки пул не отслеживает, они возвращаются в список при освобождении
+     *       первой же ячейки
+     */
+    Chunk* availableChunks = nullptr;
+
+    /**
+     * @brief Добавить блок в начало списка блоков со свободными ячейками
+     */
+    void link(Chunk* _chunk)
+    {
+        _chunk->previous = nullptr;
+        _chunk->next = availableChunks;
+        if (availableChunks != nullptr) {
+            availableChunks->previous = _chunk;
+        }
+        availableChunks = _chunk;
+    }
+
+    /**
+     * @brief Убрать блок из списка блоков со свободными ячейками
+     */
+    void unlink(Chunk* _chunk)
+    {
+        if (_chunk->previous != nullptr) {
+            _chunk->previous->next = _chunk->next;
+        } else {
+            availableChunks = _chunk->next;
+        }
+        if (_chunk->next != nullptr) {
+            _chunk->next->previous = _chunk->previous;
+        }
+        _chunk->previous = nullptr;
+        _chunk->next = nullptr;
+    }
+};
+
+/**
+ * @brief Пулы для каждого из классов размеров
+ * @note Пулы живут до завершения приложения, чтобы объекты из них можно было удалять и при
+ *       уничтожении статических данных
+ */
+std::array<CellsPool, kMaxCellSize / kSizeClassStep>& pools()
+{
+    static auto pools = new std::array<CellsPool, kMaxCellSize / kSizeClassStep>;
+    return *pools;
+}
+
+/**
+ * @brief Индекс класса размеров, в который попадает объект заданного размера
+ */
+std::size_t sizeClass(std::size_t _size)
+{
+    return (_size + kSizeClassStep - 1) / kSizeClassStep - 1;
+}
+
+/**
+ * @brief Блок, в котором находится ячейка
+ */
+Chunk* chunkFor(void* _cell)
+{
+    return reinterpret_cast<Chunk*>(reinterpret_cast<std::uintptr_t>(_cell) & ~(kChunkSize - 1));
+}
+
+/**
+ * @brief Выделить новый блок и нарезать его на ячейки заданного размера
+ */
+Chunk* createChunk(std::size_t _cellSize)
+{
+    auto memory = static_cast<char*>(::operator new(kChunkSize, std::align_val_t(kChunkSize)));
+    auto chunk = new (memory) Chunk;
+    const auto cellsCount = (kChunkSize - kFirstCellOffset) / _cellSize;
+    for (std::size_t cell = cellsCount; cell > 0; --cell) {
+        auto freeCell = new (memory + kFirstCellOffset + (cell - 1) * _cellSize) FreeCell;
+        freeCell->next = chunk->freeCells;
+        chunk->freeCells = freeCell;
+    }
+    return chunk;
+}
+
+/**
+ * @brief Вернуть блок системе
+ */
+void destroyChunk(Chunk* _chunk)
+{
+    _chunk->~Chunk();
+    ::operator delete(_chunk, std::align_val_t(kChunkSize));
+}
+
+} // namespace
+
+
+void* MemoryPool::allocate(std::size_t _size)
+{
+    if (_size == 0 || _size > kMaxCellSize) {
+        return ::operator new(_size);
+    }
+
+    const auto cellsClass = sizeClass(_size);
+    auto& pool = pools()[cellsClass];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    //
+    // Если свободных ячеек не осталось ни в одном блоке, то выделяем новый блок
+    //
+    if (pool.availableChunks == nullptr) {
+        pool.link(createChunk((cellsClass + 1) * kSizeClassStep));
+    }
+
+    auto chunk = pool.availableChunks;
+    auto cell = chunk->freeCells;
+    chunk->freeCells = cell->next;
+    ++chunk->usedCells;
+    //
+    // ... заполненный блок убираем из списка, до тех пор пока в нём не освободится ячейка
+    //
+    if (chunk->freeCells == nullptr) {
+        pool.unlink(chunk);
+    }
+    return cell;
+}
+
+void MemoryPool::deallocate(void* _pointer, std::size_t _size)
+{
+    if (_pointer == nullptr) {
+        return;
+    }
+
+    if (_size == 0 || _size > kMaxCellSize) {
+        ::operator delete(_pointer);
+        return;
+    }
+
+    auto& pool = pools()[sizeClass(_size)];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto chunk = chunkFor(_pointer);
+    const auto wasFull = chunk->freeCells == nullptr;
+    auto freeCell = new (_pointer) FreeCell;
+    freeCell->next = chunk->freeCells;
+    chunk->freeCells = freeCell;
+    --chunk->usedCells;
+
+    if (wasFull) {
+        pool.link(chunk);
+        return;
+    }
+
+    //
+    // Опустевший блок возвращаем системе, но последний блок со свободными ячейками оставляем,
+    // чтобы поочерёдные создание и удаление объекта не выделяли блок каждый раз заново
+    //
+    const auto isLastAvailableChunk = chunk->previous == nullptr && chunk->next == nullptr;
+    if (chunk->usedCells == 0 && !isLastAvailableChunk) {
+        pool.unlink(chunk);
+        destroyChunk(chunk);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <corelib_global.h>
+
+#include <cstddef>
+
+
+/**
+ * @brief Пул памяти для множества мелких объектов одного размера
+ * @note Память выделяется крупными блоками и нарезается на ячейки нескольких классов размеров,
+ *       освобождённые ячейки переиспользуются для новых объектов, а блоки, в которых не осталось
+ *       занятых ячеек, возвращаются системе. Объекты крупнее максимального класса размеров
+ *       выделяются в обычной куче
+ */
+class CORE_LIBRARY_EXPORT MemoryPool
+{
+public:
+    /**
+     * @brief Выделить память под объект заданного размера
+     */
+    static void* allocate(std::size_t _size);
+
+    /**
+     * @brief Вернуть в пул память объекта заданного размера
+     */
+    static void deallocate(void* _pointer, std::size_t _size);
+};
+
+
+/**
+ * @brief Базовый класс для объектов, память под которые выделяется в пуле
+ * @note Размер передаётся и в оператор удаления, поэтому наследники с виртуальным деструктором
+ *       корректно возвращают память в пул своего размера
+ */
+class CORE_LIBRARY_EXPORT PoolAllocated
+{
+public:
+    static void* operator new(std::size_t _size)
+    {
+        return MemoryPool::allocate(_size);
+    }
+
+    static void operator delete(void* _pointer, std::size_t _size)
+    {
+        MemoryPool::deallocate(_pointer, _size);
+    }
+};
@@ -0,0 +1,507 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+
+/**
+ * @brief Упорядоченный словарь с целочисленными ключами, позволяющий за логарифмическое время
+ *        сдвинуть ключи всех элементов начиная с заданного
+ * @note Реализован на основе декартова дерева, в узлах которого хранятся отложенные сдвиги ключей
+ *       поддеревьев, а также поддерживает обратный поиск ключа по значению
+ */
+template<typename T>
+class ShiftableMap
+{
+    struct Node {
+        int key = 0;
+        T value;
+        unsigned priority = 0;
+
+        /**
+         * @brief Отложенный сдвиг ключей дочерних поддеревьев
+         */
+        int childrenShift = 0;
+
+        Node* left = nullptr;
+        Node* right = nullptr;
+        Node* parent = nullptr;
+    };
+
+public:
+    /**
+     * @brief Итератор по элементам словаря в порядке возрастания ключей
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<int, T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        /**
+         * @brief Обёртка для доступа к полям пары через оператор ->
+         */
+        struct Proxy {
+            value_type pair;
+            const value_type* operator->() const
+            {
+                return &pair;
+            }
+        };
+
+        iterator() = default;
+
+        value_type operator*() const
+        {
+            return { ShiftableMap::keyOf(m_node), m_node->value };
+        }
+        Proxy operator->() const
+        {
+            return { operator*() };
+        }
+
+        iterator& operator++()
+        {
+            m_node = ShiftableMap::nextNode(m_node);
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            auto copy = *this;
+            operator++();
+            return copy;
+        }
+
+        bool operator==(const iterator& _other) const
+        {
+            return m_node == _other.m_node;
+        }
+        bool operator!=(const iterator& _other) const
+        {
+            return m_node != _other.m_node;
+        }
+
+    private:
+        explicit iterator(Node* _node)
+            : m_node(_node)
+        {
+        }
+
+        Node* m_node = nullptr;
+
+        friend class ShiftableMap;
+    };
+
+
+    ShiftableMap() = default;
+    ShiftableMap(const ShiftableMap&) = delete;
+    ShiftableMap& operator=(const ShiftableMap&) = delete;
+    ~ShiftableMap()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Итераторы по элементам
+     */
+    iterator begin() const
+    {
+        auto node = m_root;
+        while (node != nullptr && node->left != nullptr) {
+            node = node->left;
+        }
+        return iterator(node);
+    }
+    iterator end() const
+    {
+        return iterator();
+    }
+
+    /**
+     * @brief Количество элементов
+     */
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /**
+     * @brief Очистить словарь
+     */
+    void clear()
+    {
+        deleteTree(m_root);
+        m_root = nullptr;
+        m_size = 0;
+        m_valuesIndex.clear();
+        m_isValuesIndexValid = true;
+    }
+
+    /**
+     * @brief Первый элемент с ключом не меньше заданного
+     */
+    iterator lower_bound(int _key) const
+    {
+        Node* result = nullptr;
+        int shift = 0;
+        auto node = m_root;
+        while (node != nullptr) {
+            if (node->key + shift >= _key) {
+                result = node;
+                shift += node->childrenShift;
+                node = node->left;
+            } else {
+                shift += node->childrenShift;
+                node = node->right;
+            }
+        }
+        return iterator(result);
+    }
+
+    /**
+     * @brief Найти элемент по ключу
+     */
+    iterator find(int _key) const
+    {
+        const auto iter = lower_bound(_key);
+        if (iter.m_node == nullptr || keyOf(iter.m_node) != _key) {
+            return end();
+        }
+        return iter;
+    }
+
+    /**
+     * @brief Получить значение по ключу, либо значение по умолчанию, если ключа нет
+     */
+    T value(int _key, const T& _defaultValue = T()) const
+    {
+        const auto iter = find(_key);
+        return iter.m_node != nullptr ? iter.m_node->value : _defaultValue;
+    }
+
+    /**
+     * @brief Найти элемент с заданным значением
+     */
+    iterator findValue(const T& _value) const
+    {
+        if (!m_isValuesIndexValid) {
+            rebuildValuesIndex();
+        }
+
+        const auto iter = m_valuesIndex.find(_value);
+        if (iter == m_valuesIndex.end()) {
+            return end();
+        }
+        return iterator(iter->second.node);
+    }
+
+    /**
+     * @brief Добавить элемент, если элемента с таким ключом ещё нет
+     */
+    std::pair<iterator, bool> emplace(int _key, const T& _value)
+    {
+        const auto existingIter = find(_key);
+        if (existingIter != end()) {
+            return { existingIter, false };
+        }
+
+        auto node = new Node;
+        node->key = _key;
+        node->value = _value;
+        node->priority = m_random();
+
+        Node* left = nullptr;
+        Node* right = nullptr;
+        split(m_root, _key, left, right);
+        m_root = merge(merge(left, node), right);
+        m_root->parent = nullptr;
+        ++m_size;
+
+        indexValue(node);
+
+        return { iterator(node), true };
+    }
+
+    /**
+     * @brief Добавить элемент, либо заменить значение элемента с заданным ключом
+     */
+    std::pair<iterator, bool> insert_or_assign(int _key, const T& _value)
+    {
+        const auto iter = find(_key);
+        if (iter == end()) {
+            return emplace(_key, _value);
+        }
+
+        unindexValue(iter.m_node);
+        iter.m_node->value = _value;
+        indexValue(iter.m_node);
+        return { iter, false };
+    }
+
+    /**
+     * @brief Удалить элемент
+     * @return Итератор на следующий за удалённым элемент
+     */
+    iterator erase(iterator _iter)
+    {
+        auto node = _iter.m_node;
+        if (node == nullptr) {
+            return end();
+        }
+
+        const auto next = nextNode(node);
+        const auto key = keyOf(node);
+
+        Node* left = nullptr;
+        Node* middle = nullptr;
+        Node* right = nullptr;
+        split(m_root, key, left, middle);
+        split(middle, key + 1, middle, right);
+        Q_ASSERT(middle == node);
+        m_root = merge(left, right);
+        if (m_root != nullptr) {
+            m_root->parent = nullptr;
+        }
+        --m_size;
+
+        unindexValue(node);
+        delete node;
+
+        return iterator(next);
+    }
+    iterator erase(iterator _from, iterator _to)
+    {
+        while (_from != _to) {
+            _from = erase(_from);
+        }
+        return _to;
+    }
+    std::size_t erase(int _key)
+    {
+        const auto iter = find(_key);
+        if (iter == end()) {
+            return 0;
+        }
+
+        erase(iter);
+        return 1;
+    }
+
+    /**
+     * @brief Сдвинуть ключи всех элементов начиная с заданного на заданную дистанцию
+     * @note Сдвиг не должен менять порядок элементов, т.е. элементы, на место которых сдвигаются
+     *       ключи, должны быть удалены заранее
+     */
+    void shift(int _fromKey, int _distance)
+    {
+        if (_distance == 0 || m_root == nullptr) {
+            return;
+        }
+
+        Node* left = nullptr;
+        Node* right = nullptr;
+        split(m_root, _fromKey, left, right);
+        if (right != nullptr) {
+            right->key += _distance;
+            right->childrenShift += _distance;
+        }
+        m_root = merge(left, right);
+        m_root->parent = nullptr;
+    }
+
+private:
+    /**
+     * @brief Ключ узла с учётом отложенных сдвигов всех его предков
+     */
+    static int keyOf(const Node* _node)
+    {
+        int key = _node->key;
+        for (auto parent = _node->parent; parent != nullptr; parent = parent->parent) {
+            key += parent->childrenShift;
+        }
+        return key;
+    }
+
+    /**
+     * @brief Следующий по порядку узел
+     */
+    static Node* nextNode(Node* _node)
+    {
+        if (_node == nullptr) {
+            return nullptr;
+        }
+
+        if (_node->right != nullptr) {
+            auto node = _node->right;
+            while (node->left != nullptr) {
+                node = node->left;
+            }
+            return node;
+        }
+
+        auto node = _node;
+        while (node->parent != nullptr && node->parent->right == node) {
+            node = node->parent;
+        }
+        return node->parent;
+    }
+
+    /**
+     * @brief Применить отложенный сдвиг узла к его детям
+     */
+    static void push(Node* _node)
+    {
+        if (_node->childrenShift == 0) {
+            return;
+        }
+
+        for (auto child : { _node->left, _node->right }) {
+            if (child != nullptr) {
+                child->key += _node->childrenShift;
+                child->childrenShift += _node->childrenShift;
+            }
+        }
+        _node->childrenShift = 0;
+    }
+
+    /**
+     * @brief Разделить дерево на узлы с ключами меньше заданного и все остальные
+     */
+    static void split(Node* _node, int _key, Node*& _left, Node*& _right)
+    {
+        if (_node == nullptr) {
+            _left = nullptr;
+            _right = nullptr;
+            return;
+        }
+
+        push(_node);
+        if (_node->key < _key) {
+            split(_node->right, _key, _node->right, _right);
+            if (_node->right != nullptr) {
+                _node->right->parent = _node;
+            }
+            _left = _node;
+        } else {
+            split(_node->left, _key, _left, _node->left);
+            if (_node->left != nullptr) {
+                _node->left->parent = _node;
+            }
+            _right = _node;
+        }
+        _node->parent = nullptr;
+    }
+
+    /**
+     * @brief Объединить деревья, все ключи левого из которых меньше ключей правого
+     */
+    static Node* merge(Node* _left, Node* _right)
+    {
+        if (_left == nullptr) {
+            return _right;
+        }
+        if (_right == nullptr) {
+            return _left;
+        }
+
+        if (_left->priority > _right->priority) {
+            push(_left);
+            _left->right = merge(_left->right, _right);
+            _left->right->parent = _left;
+            return _left;
+        } else {
+            push(_right);
+            _right->left = merge(_left, _right->left);
+            _right->left->parent = _right;
+            return _right;
+        }
+    }
+
+    /**
+     * @brief Удалить поддерево
+     */
+    static void deleteTree(Node* _node)
+    {
+        if (_node == nullptr) {
+            return;
+        }
+
+        deleteTree(_node->left);
+        deleteTree(_node->right);
+        delete _node;
+    }
+
+    /**
+     * @brief Работа с индексом значений
+     * @note Если одно значение хранится в нескольких элементах, то индекс указывает на один из
+     *       них, а после удаления такого элемента индекс перестраивается при следующем поиске
+     */
+    void indexValue(Node* _node)
+    {
+        if (!m_isValuesIndexValid) {
+            return;
+        }
+
+        auto& indexItem = m_valuesIndex[_node->value];
+        if (indexItem.node == nullptr) {
+            indexItem.node = _node;
+        }
+        ++indexItem.count;
+    }
+    void unindexValue(Node* _node)
+    {
+        if (!m_isValuesIndexValid) {
+            return;
+        }
+
+        const auto iter = m_valuesIndex.find(_node->value);
+        if (iter == m_valuesIndex.end()) {
+            return;
+        }
+
+        auto& indexItem = iter->second;
+        if (indexItem.count == 1) {
+            m_valuesIndex.erase(iter);
+        } else if (indexItem.node == _node) {
+            m_isValuesIndexValid = false;
+        } else {
+            --indexItem.count;
+        }
+    }
+    void rebuildValuesIndex() const
+    {
+        m_valuesIndex.clear();
+        for (auto node = begin().m_node; node != nullptr; node = nextNode(node)) {
+            auto& indexItem = m_valuesIndex[node->value];
+            if (indexItem.node == nullptr) {
+                indexItem.node = node;
+            }
+            ++indexItem.count;
+        }
+        m_isValuesIndexValid = true;
+    }
+
+private:
+    Node* m_root = nullptr;
+    std::size_t m_size = 0;
+    std::minstd_rand m_random;
+
+    struct ValuesIndexItem {
+        Node* node = nullptr;
+        int count = 0;
+    };
+    mutable std::unordered_map<T, ValuesIndexItem> m_valuesIndex;
+    mutable bool m_isValuesIndexValid = true;
+};
@@ -6,6 +6,8 @@ SUBDIRS += \
     corelib \
     core/management_layer/plugins \
     core \
+    cli \
+    tests \
    # testapp \
    # starcaiapp \
    # starcservices \
@@ -0,0 +1,26 @@
+TEMPLATE = app
+TARGET = tst_backup_builder
+
+CONFIG += c++1z console testcase
+CONFIG -= app_bundle
+QT += core sql testlib
+
+DESTDIR = ../../_build/tests/
+
+INCLUDEPATH += ../..
+
+#
+# Подключаем библиотеку corelib
+#
+mac {
+    CORELIBDIR = ../../_build/starcapp.app/Contents/Frameworks
+} else {
+    CORELIBDIR = ../../_build
+}
+LIBS += -L$$CORELIBDIR/ -lcorelib
+INCLUDEPATH += $$PWD/../../corelib
+DEPENDPATH += $$PWD/../../corelib
+#
+
+SOURCES += \
+    tst_backup_builder.cpp
@@ -0,0 +1,170 @@
+#include <utils/tools/backup_builder.h>
+
+#include <QDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QUuid>
+#include <QVariant>
+
+
+namespace {
+
+/**
+ * @brief Схема проекта с таблицами, которые требуют особой обработки при построении разности:
+ *        составным первичным ключом и полнотекстовым индексом с его служебными таблицами
+ */
+const QStringList kSchema = {
+    "CREATE TABLE system_variables "
+    "(variable TEXT PRIMARY KEY ON CONFLICT REPLACE, value TEXT NOT NULL)",
+    "CREATE TABLE images_thumbnails "
+    "(content_hash TEXT NOT NULL, size INTEGER NOT NULL, content BLOB NOT NULL, "
+    "PRIMARY KEY (content_hash, size))",
+    "CREATE TABLE search_paragraphs "
+    "(id INTEGER PRIMARY KEY AUTOINCREMENT, fk_document_uuid TEXT NOT NULL, text TEXT NOT NULL)",
+    "CREATE VIRTUAL TABLE search_index USING fts5"
+    "(text, content = 'search_paragraphs', content_rowid = 'id', "
+    "tokenize = 'unicode61 remove_diacritics 0', prefix = '2 3')",
+    "CREATE TRIGGER search_paragraphs_after_insert AFTER INSERT ON search_paragraphs BEGIN "
+    "INSERT INTO search_index (rowid, text) VALUES (new.id, new.text); END",
+    "CREATE TRIGGER search_paragraphs_after_delete AFTER DELETE ON search_paragraphs BEGIN "
+    "INSERT INTO search_index (search_index, rowid, text) VALUES ('delete', old.id, old.text); "
+    "END",
+};
+
+/**
+ * @brief Выполнить запросы в заданном файле базы данных
+ */
+bool execute(const QString& _databasePath, const QStringList& _statements)
+{
+    const auto connectionName = QUuid::createUuid().toString();
+    bool isSucceed = true;
+    {
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(_databasePath);
+        isSucceed = database.open();
+        QSqlQuery query(database);
+        for (const auto& statement : _statements) {
+            if (!isSucceed) {
+                break;
+            }
+            isSucceed = query.exec(statement);
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return isSucceed;
+}
+
+/**
+ * @brief Получить результат запроса в виде списка строк
+ */
+QStringList select(const QString& _databasePath, const QString& _statement)
+{
+    const auto connectionName = QUuid::createUuid().toString();
+    QStringList result;
+    {
+        auto database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(_databasePath);
+        database.open();
+        QSqlQuery query(database);
+        query.exec(_statement);
+        while (query.next()) {
+            QStringList values;
+            for (int column = 0; column < query.record().count(); ++column) {
+                values.append(query.value(column).toString());
+            }
+            result.append(values.join('|'));
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    return result;
+}
+
+} // namespace
+
+
+class BackupBuilderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Предыдущая копия заменяется разностью, из которой восстанавливается в точности,
+     *        включая строки с составным ключом и поисковый индекс
+     */
+    void reverseDeltaRestoresPreviousBackup();
+};
+
+void BackupBuilderTest::reverseDeltaRestoresPreviousBackup()
+{
+    QTemporaryDir folder;
+    QVERIFY(folder.isValid());
+    const auto projectPath = folder.filePath("project.starc");
+    const auto backupsPath = folder.filePath("backups");
+
+    QVERIFY(execute(projectPath,
+                    QStringList(kSchema)
+                        << "INSERT INTO system_variables VALUES ('application-version', '0.8.0')"
+                        << "INSERT INTO images_thumbnails VALUES ('hash', 64, x'00')"
+                        << "INSERT INTO images_thumbnails VALUES ('hash', 128, x'01')"
+                        << "INSERT INTO search_paragraphs (fk_document_uuid, text) "
+                           "VALUES ('document', 'first paragraph')"
+                        << "INSERT INTO search_paragraphs (fk_document_uuid, text) "
+                           "VALUES ('document', 'old paragraph')"));
+    const auto tables = QStringList{ "system_variables", "images_thumbnails", "search_paragraphs" };
+    auto tableRows = [](const QString& _databasePath, const QString& _table) {
+        return select(_databasePath, QString("SELECT * FROM %1 ORDER BY 1, 2").arg(_table));
+    };
+    QHash<QString, QStringList> previousRows;
+    for (const auto& table : tables) {
+        previousRows[table] = tableRows(projectPath, table);
+    }
+
+    BackupBuilder::save(projectPath, backupsPath, {}, 3);
+
+    //
+    // Имена копий формируются с точностью до секунды, поэтому следующая копия снимается позже
+    //
+    QTest::qWait(1100);
+    QVERIFY(execute(projectPath,
+                    {
+                        "INSERT INTO system_variables VALUES ('application-version', '0.8.1')",
+                        "DELETE FROM images_thumbnails WHERE size = 128",
+                        "INSERT INTO images_thumbnails VALUES ('hash', 256, x'02')",
+                        "DELETE FROM search_paragraphs WHERE text = 'old paragraph'",
+                        "INSERT INTO search_paragraphs (fk_document_uuid, text) "
+                        "VALUES ('document', 'new paragraph')",
+                    }));
+    BackupBuilder::save(projectPath, backupsPath, {}, 3);
+
+    const auto deltas = QDir(backupsPath).entryList({ "*.starc.delta" }, QDir::Files);
+    const auto fullBackups = QDir(backupsPath).entryList({ "*.starc" }, QDir::Files);
+    QCOMPARE(deltas.size(), 1);
+    QCOMPARE(fullBackups.size(), 1);
+
+    const auto restoredPath = folder.filePath("restored.starc");
+    QVERIFY(BackupBuilder::restore(QDir(backupsPath).absoluteFilePath(deltas.constFirst()),
+                                   restoredPath));
+    for (const auto& table : tables) {
+        QCOMPARE(tableRows(restoredPath, table), previousRows.value(table));
+    }
+
+    //
+    // Поисковый индекс должен соответствовать восстановленным абзацам
+    //
+    QCOMPARE(select(restoredPath, "SELECT rowid FROM search_index WHERE search_index MATCH 'old'")
+                 .size(),
+             1);
+    QVERIFY(select(restoredPath, "SELECT rowid FROM search_index WHERE search_index MATCH 'new'")
+                .isEmpty());
+    QVERIFY(execute(restoredPath,
+                    { "INSERT INTO search_index (search_index) VALUES ('integrity-check')" }));
+}
+
+QTEST_GUILESS_MAIN(BackupBuilderTest)
+
+#include "tst_backup_builder.moc"
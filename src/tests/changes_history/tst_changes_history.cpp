@@ -0,0 +1,346 @@
+#include <data_layer/database.h>
+#include <data_layer/storage/document_change_storage.h>
+#include <data_layer/storage/document_storage.h>
+#include <data_layer/storage/storage_facade.h>
+#include <domain/document_change_object.h>
+#include <domain/document_object.h>
+#include <utils/diff_match_patch/diff_match_patch_controller.h>
+
+#include <QFileInfo>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QUuid>
+#include <QVariant>
+
+#include <limits>
+
+
+namespace {
+
+/**
+ * @brief Количество дней правок и правок в каждом из дней
+ */
+constexpr int kDaysCount = 60;
+constexpr int kChangesPerDay = 50;
+
+/**
+ * @brief Формат даты изменения в базе
+ */
+const QString kDateTimeFormat = "yyyy-MM-dd hh:mm:ss:zzz";
+
+/**
+ * @brief Управляющий патчами для тестового документа
+ */
+const DiffMatchPatchController& dmpController()
+{
+    static const DiffMatchPatchController controller({ "document", "p" });
+    return controller;
+}
+
+/**
+ * @brief Наложить патчи так же, как это делает модель документа
+ */
+QByteArray applyPatches(const QByteArray& _content, const QVector<QByteArray>& _patches)
+{
+    auto content = _content;
+    for (const auto& patch : _patches) {
+        auto patchedContent = dmpController().applyPatch(content, patch);
+        if (patchedContent == content) {
+            return {};
+        }
+        content.swap(patchedContent);
+    }
+    return content;
+}
+
+QByteArray makePatch(const QByteArray& _from, const QByteArray& _to)
+{
+    return dmpController().makePatch(_from, _to);
+}
+
+/**
+ * @brief Содержимое документа с заданным количеством абзацев
+ */
+QByteArray documentContent(int _paragraphsCount)
+{
+    QByteArray content = "<?xml version=\"1.0\"?>\n<document>\n";
+    for (int paragraph = 0; paragraph < _paragraphsCount; ++paragraph) {
+        content += QString("<p>Paragraph %1 of the document with some text in it</p>\n")
+                       .arg(paragraph)
+                       .toUtf8();
+    }
+    content += "</document>";
+    return content;
+}
+
+/**
+ * @brief Выполнить запрос к открытому проекту и получить первое значение результата
+ */
+QVariant selectValue(const QString& _statement)
+{
+    auto query = DatabaseLayer::Database::query();
+    query.exec(_statement);
+    return query.next() ? query.value(0) : QVariant();
+}
+
+} // namespace
+
+
+class ChangesHistoryBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Создать проект с документом, у которого длинная синхронизированная история
+     */
+    void initTestCase();
+
+    /**
+     * @brief Открытие проекта с загрузкой документа и всей его истории до сжатия
+     */
+    void openBeforeCompaction();
+
+    /**
+     * @brief Первое сжатие откатывает историю от текущего содержимого и ставит контрольную точку
+     */
+    void compactFromContent();
+
+    /**
+     * @brief Следующее сжатие воспроизводит только новые изменения от контрольной точки
+     */
+    void compactFromCheckpoint();
+
+    /**
+     * @brief Открытие проекта с загрузкой документа и всей его истории после сжатия
+     */
+    void openAfterCompaction();
+
+    void cleanupTestCase();
+
+private:
+    /**
+     * @brief Добавить в документ изменения за заданные дни, помеченные синхронизированными
+     */
+    void appendChanges(int _fromDay, int _toDay);
+
+    /**
+     * @brief Открыть проект, загрузить документ и всю его историю, и закрыть проект
+     */
+    void openProject();
+
+    /**
+     * @brief Проверить, что история, откаченная от текущего содержимого, приводит к первой версии
+     *        документа
+     */
+    void verifyHistory();
+
+    /**
+     * @brief Открыть и закрыть проект
+     */
+    void open();
+    void close();
+
+    QTemporaryDir m_folder;
+    QString m_projectPath;
+    QUuid m_documentUuid;
+    QByteArray m_content;
+    int m_paragraphsCount = 0;
+    qint64 m_sizeBeforeCompaction = 0;
+};
+
+void ChangesHistoryBenchmark::initTestCase()
+{
+    QVERIFY(m_folder.isValid());
+    m_projectPath = m_folder.filePath("project.starc");
+    m_documentUuid = QUuid::createUuid();
+
+    open();
+    auto document = DataStorageLayer::StorageFacade::documentStorage()->createDocument(
+        m_documentUuid, Domain::DocumentObjectType::SimpleText);
+    m_content = documentContent(0);
+    document->setContent(m_content);
+    DataStorageLayer::StorageFacade::documentStorage()->saveDocument(document);
+    DataStorageLayer::StorageFacade::documentChangeStorage()->appendDocumentChange(
+        m_documentUuid, QUuid::createUuid(), makePatch(m_content, {}), makePatch({}, m_content),
+        "user@example.com", "User");
+    DataStorageLayer::StorageFacade::documentChangeStorage()->store();
+    close();
+
+    appendChanges(0, kDaysCount);
+
+    m_sizeBeforeCompaction = QFileInfo(m_projectPath).size();
+    qInfo("Project file size before compaction: %lld bytes", m_sizeBeforeCompaction);
+}
+
+void ChangesHistoryBenchmark::openBeforeCompaction()
+{
+    QBENCHMARK {
+        openProject();
+    }
+}
+
+void ChangesHistoryBenchmark::compactFromContent()
+{
+    open();
+    const auto before = QDateTime::currentDateTimeUtc().addDays(-10);
+    bool isCompacted = false;
+    QBENCHMARK_ONCE {
+        isCompacted
+            = DataStorageLayer::StorageFacade::documentChangeStorage()->compactDocumentChanges(
+                m_documentUuid, m_content, before, applyPatches, makePatch);
+    }
+    QVERIFY(isCompacted);
+    QVERIFY(selectValue("SELECT fk_change_id FROM documents_checkpoints").toInt() > 0);
+    DatabaseLayer::Database::incrementalVacuum();
+    close();
+
+    verifyHistory();
+}
+
+void ChangesHistoryBenchmark::compactFromCheckpoint()
+{
+    appendChanges(kDaysCount, kDaysCount + 5);
+
+    open();
+    const auto checkpointChangeId
+        = selectValue("SELECT fk_change_id FROM documents_checkpoints").toInt();
+    const auto before = QDateTime::currentDateTimeUtc().addDays(-10);
+    bool isCompacted = false;
+    QBENCHMARK_ONCE {
+        isCompacted
+            = DataStorageLayer::StorageFacade::documentChangeStorage()->compactDocumentChanges(
+                m_documentUuid, m_content, before, applyPatches, makePatch);
+    }
+    QVERIFY(isCompacted);
+    QVERIFY(selectValue("SELECT fk_change_id FROM documents_checkpoints").toInt()
+            > checkpointChangeId);
+    DatabaseLayer::Database::incrementalVacuum();
+    close();
+
+    verifyHistory();
+}
+
+void ChangesHistoryBenchmark::openAfterCompaction()
+{
+    qInfo("Project file size after compaction: %lld bytes (%lld bytes before)",
+          QFileInfo(m_projectPath).size(), m_sizeBeforeCompaction);
+
+    QBENCHMARK {
+        openProject();
+    }
+}
+
+void ChangesHistoryBenchmark::cleanupTestCase()
+{
+    DatabaseLayer::Database::closeCurrentFile();
+}
+
+void ChangesHistoryBenchmark::appendChanges(int _fromDay, int _toDay)
+{
+    open();
+    auto document = DataStorageLayer::StorageFacade::documentStorage()->document(m_documentUuid);
+    QVERIFY(document != nullptr);
+    for (int day = _fromDay; day < _toDay; ++day) {
+        for (int change = 0; change < kChangesPerDay; ++change) {
+            const auto content = documentContent(++m_paragraphsCount);
+            DataStorageLayer::StorageFacade::documentChangeStorage()->appendDocumentChange(
+                m_documentUuid, QUuid::createUuid(), makePatch(content, m_content),
+                makePatch(m_content, content), "user@example.com", "User");
+            m_content = content;
+        }
+    }
+    document->setContent(m_content);
+    DataStorageLayer::StorageFacade::documentStorage()->saveDocument(document);
+    DataStorageLayer::StorageFacade::documentChangeStorage()->store();
+
+    //
+    // Раскладываем новые изменения по дням, начиная за сто дней до текущего момента, и помечаем
+    // их синхронизированными
+    //
+    const auto firstDay = QDateTime::currentDateTimeUtc().addDays(-100);
+    auto query = DatabaseLayer::Database::query();
+    query.prepare("SELECT id FROM documents_changes WHERE fk_document_uuid = ? AND is_synced = 0 "
+                  "ORDER BY id");
+    query.addBindValue(m_documentUuid.toString());
+    query.exec();
+    QVector<int> ids;
+    while (query.next()) {
+        ids.append(query.value(0).toInt());
+    }
+    //
+    // ... самое первое изменение документа относим к первому дню
+    //
+    const int skippedChanges = ids.size() - (_toDay - _fromDay) * kChangesPerDay;
+    DatabaseLayer::Database::transaction();
+    for (int index = 0; index < ids.size(); ++index) {
+        const int changeIndex = std::max(0, index - skippedChanges);
+        const auto dateTime = firstDay.addDays(_fromDay + changeIndex / kChangesPerDay)
+                                  .addSecs(changeIndex % kChangesPerDay);
+        query.prepare("UPDATE documents_changes SET is_synced = 1, date_time = ? WHERE id = ?");
+        query.addBindValue(dateTime.toString(kDateTimeFormat));
+        query.addBindValue(ids.at(index));
+        QVERIFY(query.exec());
+    }
+    DatabaseLayer::Database::commit();
+    close();
+}
+
+void ChangesHistoryBenchmark::openProject()
+{
+    open();
+    auto document = DataStorageLayer::StorageFacade::documentStorage()->document(m_documentUuid);
+    QVERIFY(document != nullptr);
+    QCOMPARE(document->content(), m_content);
+
+    int lastLoadedChangeId = std::numeric_limits<int>::max();
+    int changesCount = 0;
+    while (true) {
+        constexpr int kPageSize = 200;
+        const auto page = DataStorageLayer::StorageFacade::documentChangeStorage()
+                              ->documentChangesPage(m_documentUuid, lastLoadedChangeId, kPageSize);
+        changesCount += page.size();
+        if (page.size() < kPageSize) {
+            break;
+        }
+        lastLoadedChangeId = page.constLast()->id().value();
+    }
+    QVERIFY(changesCount > 0);
+    close();
+}
+
+void ChangesHistoryBenchmark::verifyHistory()
+{
+    open();
+    QVector<QByteArray> undoPatches;
+    auto query = DatabaseLayer::Database::query();
+    query.exec("SELECT undo_patch FROM documents_changes ORDER BY id DESC");
+    while (query.next()) {
+        undoPatches.append(qUncompress(query.value(0).toByteArray()));
+    }
+    query.finish();
+    close();
+
+    //
+    // Самое первое изменение не откатываем, т.к. это добавление разметки в пустой документ
+    //
+    QVERIFY(undoPatches.size() > 1);
+    undoPatches.removeLast();
+    QCOMPARE(applyPatches(m_content, undoPatches), documentContent(0));
+}
+
+void ChangesHistoryBenchmark::open()
+{
+    DatabaseLayer::Database::setCurrentFile(m_projectPath);
+}
+
+void ChangesHistoryBenchmark::close()
+{
+    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
+}
+
+QTEST_GUILESS_MAIN(ChangesHistoryBenchmark)
+
+#include "tst_changes_history.moc"
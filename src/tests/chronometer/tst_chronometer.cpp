@@ -0,0 +1,134 @@
+#include <business_layer/chronometry/chronometer.h>
+#include <business_layer/templates/text_template.h>
+
+#include <QStandardPaths>
+#include <QTest>
+
+#include <chrono>
+
+
+namespace {
+
+/**
+ * @brief Количество абзацев в тестовом сценарии
+ */
+constexpr int kParagraphsCount = 4000;
+
+/**
+ * @brief Абзац сценария
+ */
+struct Paragraph {
+    BusinessLayer::TextParagraphType type;
+    QString text;
+};
+
+} // namespace
+
+
+class ChronometerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Сформировать абзацы сценария с разными текстами
+     */
+    void initTestCase();
+
+    /**
+     * @brief Первый подсчёт хронометража всех абзацев, когда ни один текст ещё не раскладывался
+     */
+    void countFirstTime();
+
+    /**
+     * @brief Повторный подсчёт хронометража всех абзацев
+     */
+    void recount();
+
+    /**
+     * @brief Подсчёт после смены длительности страницы в параметрах хронометража
+     */
+    void recountWithChangedOptions();
+
+private:
+    /**
+     * @brief Суммарная длительность всех абзацев
+     */
+    std::chrono::milliseconds duration(const BusinessLayer::ChronometerOptions& _options) const;
+
+    QVector<Paragraph> m_paragraphs;
+    BusinessLayer::ChronometerOptions m_options;
+    std::chrono::milliseconds m_firstDuration{ 0 };
+};
+
+void ChronometerBenchmark::initTestCase()
+{
+    //
+    // Шаблоны копируются в каталог данных приложения, поэтому не трогаем настоящий
+    //
+    QStandardPaths::setTestModeEnabled(true);
+
+    m_options.type = BusinessLayer::ChronometerType::Page;
+
+    for (int index = 0; index < kParagraphsCount / 4; ++index) {
+        m_paragraphs.append({ BusinessLayer::TextParagraphType::SceneHeading,
+                              QString("INT. ROOM NUMBER %1 - DAY").arg(index) });
+        m_paragraphs.append({ BusinessLayer::TextParagraphType::Action,
+                              QString("Somebody walks into room number %1 and looks around. It is "
+                                      "quiet and nothing happens for a while, so they sit down.")
+                                  .arg(index) });
+        m_paragraphs.append({ BusinessLayer::TextParagraphType::Character, "SOMEBODY" });
+        m_paragraphs.append({ BusinessLayer::TextParagraphType::Dialogue,
+                              QString("Hello there, is anybody home? I have been waiting for %1 "
+                                      "minutes already.")
+                                  .arg(index) });
+    }
+}
+
+void ChronometerBenchmark::countFirstTime()
+{
+    QBENCHMARK_ONCE {
+        m_firstDuration = duration(m_options);
+    }
+    QVERIFY(m_firstDuration.count() > 0);
+}
+
+void ChronometerBenchmark::recount()
+{
+    std::chrono::milliseconds recounted{ 0 };
+    QBENCHMARK {
+        recounted = duration(m_options);
+    }
+    QCOMPARE(recounted.count(), m_firstDuration.count());
+}
+
+void ChronometerBenchmark::recountWithChangedOptions()
+{
+    auto options = m_options;
+    options.page.seconds = m_options.page.seconds * 2;
+
+    std::chrono::milliseconds recounted{ 0 };
+    QBENCHMARK {
+        recounted = duration(options);
+    }
+    //
+    // Длительность каждого абзаца округляется вверх, поэтому сумма может разойтись на количество
+    // абзацев
+    //
+    QVERIFY(qAbs(recounted.count() - m_firstDuration.count() * 2) <= kParagraphsCount);
+}
+
+std::chrono::milliseconds ChronometerBenchmark::duration(
+    const BusinessLayer::ChronometerOptions& _options) const
+{
+    std::chrono::milliseconds result{ 0 };
+    for (const auto& paragraph : m_paragraphs) {
+        result += BusinessLayer::ScreenplayChronometer::duration(paragraph.type, paragraph.text,
+                                                                 {}, _options);
+    }
+    return result;
+}
+
+QTEST_MAIN(ChronometerBenchmark)
+
+#include "tst_chronometer.moc"
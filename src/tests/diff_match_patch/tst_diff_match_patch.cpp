@@ -0,0 +1,165 @@
+#include <utils/diff_match_patch/diff_match_patch_controller.h>
+
+#include <QTest>
+
+
+namespace {
+
+/**
+ * @brief Количество сцен в тестовом сценарии
+ */
+constexpr int kScenesCount = 1000;
+
+/**
+ * @brief Теги тестового сценария в том же виде, в каком их объявляют текстовые модели
+ */
+const QVector<QString> kTags = {
+    "document", "scene",     "content",       "scene_heading", "action", "character",
+    "dialogue", "transition", "parenthetical", "v",             "bm",     "fms",
+    "fm",       "rms",       "rm",            "c",
+};
+
+/**
+ * @brief Сформировать сцену с заданным номером
+ */
+QString scene(int _number, const QString& _dialogue = {})
+{
+    return QString("<scene uuid=\"{%1}\">\n<content>\n"
+                   "<scene_heading><v><![CDATA[INT. ROOM NUMBER %1 - DAY]]></v></scene_heading>\n"
+                   "<action><v><![CDATA[Somebody walks into the room and looks around, it is "
+                   "quiet and nothing happens for a while.]]></v></action>\n"
+                   "<character><v><![CDATA[SOMEBODY]]></v></character>\n"
+                   "<dialogue><v><![CDATA[%2]]></v><fms><fm from=\"0\" length=\"5\" bold=\"true\"/>"
+                   "</fms></dialogue>\n"
+                   "</content>\n</scene>\n")
+        .arg(_number)
+        .arg(_dialogue.isEmpty() ? QString("Hello there, is anybody home?") : _dialogue);
+}
+
+/**
+ * @brief Сформировать сценарий, в котором у сцены с заданным номером изменена реплика
+ */
+QString screenplay(int _changedScene = -1)
+{
+    QString xml = "<?xml version=\"1.0\"?>\n<document mime-type=\"application/x-starc\">\n";
+    for (int number = 0; number < kScenesCount; ++number) {
+        xml += scene(number,
+                     number == _changedScene ? QString("Hello there, anybody home at all?")
+                                             : QString());
+    }
+    xml += "</document>\n";
+    return xml;
+}
+
+} // namespace
+
+
+class DiffMatchPatchBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    /**
+     * @brief Длина всего документа в координатах патча
+     */
+    void plainLength();
+
+    /**
+     * @brief Патч по документу целиком для правки в его конце
+     */
+    void makePatchForWholeDocument();
+
+    /**
+     * @brief Патч по изменённому фрагменту документа для той же правки
+     */
+    void makePatchForFragment();
+
+    /**
+     * @brief Наложение патча на документ
+     */
+    void applyPatch();
+
+    /**
+     * @brief Определение изменённых патчем фрагментов документа
+     */
+    void changedXml();
+
+private:
+    DiffMatchPatchController m_controller{ kTags };
+    QString m_before;
+    QString m_after;
+    QByteArray m_patch;
+};
+
+void DiffMatchPatchBenchmark::initTestCase()
+{
+    m_before = screenplay();
+    m_after = screenplay(kScenesCount - 10);
+    m_patch = m_controller.makePatch(m_before, m_after);
+    QVERIFY(!m_patch.isEmpty());
+}
+
+void DiffMatchPatchBenchmark::plainLength()
+{
+    int length = 0;
+    QBENCHMARK {
+        length = m_controller.plainLength(m_before);
+    }
+    QVERIFY(length > 0);
+    QVERIFY(length < m_before.size());
+}
+
+void DiffMatchPatchBenchmark::makePatchForWholeDocument()
+{
+    QByteArray patch;
+    QBENCHMARK {
+        patch = m_controller.makePatch(m_before, m_after);
+    }
+    QCOMPARE(m_controller.applyPatch(m_before.toUtf8(), patch), m_after.toUtf8());
+}
+
+void DiffMatchPatchBenchmark::makePatchForFragment()
+{
+    //
+    // Фрагмент - изменённая сцена, всё что до неё совпадает в обоих вариантах документа
+    //
+    const auto changedScene = kScenesCount - 10;
+    const auto oldFragment = scene(changedScene);
+    const auto fragmentPosition = m_before.indexOf(oldFragment);
+    QVERIFY(fragmentPosition > 0);
+    const auto newFragment = m_after.mid(
+        fragmentPosition, oldFragment.size() + m_after.size() - m_before.size());
+
+    QByteArray patch;
+    QBENCHMARK {
+        const auto patchPosition = m_controller.plainLength(m_before.left(fragmentPosition));
+        patch = m_controller.makePatch(oldFragment, newFragment, patchPosition);
+    }
+    QCOMPARE(m_controller.applyPatch(m_before.toUtf8(), patch), m_after.toUtf8());
+}
+
+void DiffMatchPatchBenchmark::applyPatch()
+{
+    const auto before = m_before.toUtf8();
+    QByteArray after;
+    QBENCHMARK {
+        after = m_controller.applyPatch(before, m_patch);
+    }
+    QCOMPARE(after, m_after.toUtf8());
+}
+
+void DiffMatchPatchBenchmark::changedXml()
+{
+    QPair<DiffMatchPatchController::Change, DiffMatchPatchController::Change> changes;
+    QBENCHMARK {
+        changes = m_controller.changedXml(m_before, m_patch);
+    }
+    QVERIFY(changes.first.xml.contains("Hello there, is anybody home?"));
+    QVERIFY(changes.second.xml.contains("Hello there, anybody home at all?"));
+}
+
+QTEST_GUILESS_MAIN(DiffMatchPatchBenchmark)
+
+#include "tst_diff_match_patch.moc"
@@ -0,0 +1,26 @@
+TEMPLATE = app
+TARGET = tst_document_lookup
+
+CONFIG += c++1z console testcase
+CONFIG -= app_bundle
+QT += core gui sql testlib
+
+DESTDIR = ../../_build/tests/
+
+INCLUDEPATH += ../..
+
+#
+# Подключаем библиотеку corelib
+#
+mac {
+    CORELIBDIR = ../../_build/starcapp.app/Contents/Frameworks
+} else {
+    CORELIBDIR = ../../_build
+}
+LIBS += -L$$CORELIBDIR/ -lcorelib
+INCLUDEPATH += $$PWD/../../corelib
+DEPENDPATH += $$PWD/../../corelib
+#
+
+SOURCES += \
+    tst_document_lookup.cpp
@@ -0,0 +1,145 @@
+#include <data_layer/database.h>
+#include <data_layer/storage/document_storage.h>
+#include <data_layer/storage/storage_facade.h>
+#include <domain/document_object.h>
+
+#include <QTemporaryDir>
+#include <QTest>
+#include <QUuid>
+
+
+namespace {
+
+/**
+ * @brief Количество документов в тестовом проекте
+ */
+constexpr int kDocumentsCount = 2000;
+
+} // namespace
+
+
+class DocumentLookupBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Создать проект с большим количеством документов и переоткрыть его
+     */
+    void initTestCase();
+
+    /**
+     * @brief Первый поиск каждого документа, который загружает его из базы
+     */
+    void findNotLoaded();
+
+    /**
+     * @brief Повторный поиск уже загруженных документов
+     */
+    void findLoaded();
+
+    /**
+     * @brief Поиск отсутствующих документов после загрузки всех документов проекта
+     */
+    void findMissing();
+
+    /**
+     * @brief Документ находится по новому идентификатору и не находится по старому после его смены
+     */
+    void findAfterUuidChange();
+
+    void cleanupTestCase();
+
+private:
+    QTemporaryDir m_folder;
+    QString m_projectPath;
+    QVector<QUuid> m_uuids;
+    QVector<Domain::DocumentObject*> m_documents;
+};
+
+void DocumentLookupBenchmark::initTestCase()
+{
+    QVERIFY(m_folder.isValid());
+    m_projectPath = m_folder.filePath("project.starc");
+
+    DatabaseLayer::Database::setCurrentFile(m_projectPath);
+    DatabaseLayer::Database::transaction();
+    for (int index = 0; index < kDocumentsCount; ++index) {
+        const auto uuid = QUuid::createUuid();
+        auto document = DataStorageLayer::StorageFacade::documentStorage()->createDocument(
+            uuid, Domain::DocumentObjectType::SimpleText);
+        document->setContent(QString("<document>%1</document>").arg(index).toUtf8());
+        QVERIFY(DataStorageLayer::StorageFacade::documentStorage()->saveDocument(document));
+        m_uuids.append(uuid);
+    }
+    DatabaseLayer::Database::commit();
+
+    //
+    // Переоткрываем проект, чтобы ни один документ не был загружен
+    //
+    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
+    DatabaseLayer::Database::setCurrentFile(m_projectPath);
+}
+
+void DocumentLookupBenchmark::findNotLoaded()
+{
+    QBENCHMARK_ONCE {
+        for (const auto& uuid : std::as_const(m_uuids)) {
+            m_documents.append(DataStorageLayer::StorageFacade::documentStorage()->document(uuid));
+        }
+    }
+    QCOMPARE(m_documents.size(), kDocumentsCount);
+    QVERIFY(!m_documents.contains(nullptr));
+}
+
+void DocumentLookupBenchmark::findLoaded()
+{
+    QBENCHMARK {
+        for (int index = 0; index < m_uuids.size(); ++index) {
+            const auto document
+                = DataStorageLayer::StorageFacade::documentStorage()->document(m_uuids.at(index));
+            QCOMPARE(document, m_documents.at(index));
+        }
+    }
+}
+
+void DocumentLookupBenchmark::findMissing()
+{
+    QCOMPARE(DataStorageLayer::StorageFacade::documentStorage()->documents().size(),
+             kDocumentsCount);
+
+    QVector<QUuid> missingUuids;
+    for (int index = 0; index < kDocumentsCount; ++index) {
+        missingUuids.append(QUuid::createUuid());
+    }
+    QBENCHMARK {
+        for (const auto& uuid : std::as_const(missingUuids)) {
+            QVERIFY(DataStorageLayer::StorageFacade::documentStorage()->document(uuid) == nullptr);
+        }
+    }
+}
+
+void DocumentLookupBenchmark::findAfterUuidChange()
+{
+    const auto oldUuid = m_uuids.constFirst();
+    const auto newUuid = QUuid::createUuid();
+    auto document = DataStorageLayer::StorageFacade::documentStorage()->document(oldUuid);
+    QVERIFY(document != nullptr);
+
+    DataStorageLayer::StorageFacade::documentStorage()->updateDocumentUuid(oldUuid, newUuid);
+    QVERIFY(DataStorageLayer::StorageFacade::documentStorage()->saveDocument(document));
+
+    QCOMPARE(DataStorageLayer::StorageFacade::documentStorage()->document(newUuid), document);
+    QVERIFY(DataStorageLayer::StorageFacade::documentStorage()->document(oldUuid) == nullptr);
+}
+
+void DocumentLookupBenchmark::cleanupTestCase()
+{
+    DataStorageLayer::StorageFacade::clearStorages();
+    DatabaseLayer::Database::closeCurrentFile();
+}
+
+QTEST_GUILESS_MAIN(DocumentLookupBenchmark)
+
+#include "tst_document_lookup.moc"
@@ -0,0 +1,17 @@
+TEMPLATE = app
+TARGET = tst_shiftable_map
+
+CONFIG += c++1z console testcase
+CONFIG -= app_bundle
+QT += core testlib
+
+DESTDIR = ../../_build/tests/
+
+#
+# Словарь со сдвигами полностью реализован в заголовке, поэтому подключаем только его каталог
+#
+INCLUDEPATH += $$PWD/../../corelib
+#
+
+SOURCES += \
+    tst_shiftable_map.cpp
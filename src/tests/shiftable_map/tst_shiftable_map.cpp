@@ -0,0 +1,169 @@
+#include <utils/tools/shiftable_map.h>
+
+#include <QTest>
+
+#include <iterator>
+#include <map>
+#include <random>
+
+
+namespace {
+
+/**
+ * @brief Количество блоков в документе и длина каждого из них
+ */
+constexpr int kBlocksCount = 5000;
+constexpr int kBlockLength = 40;
+
+/**
+ * @brief Количество правок, каждая из которых сдвигает позиции всех блоков после начала документа
+ */
+constexpr int kEditsCount = 1000;
+
+/**
+ * @brief Сдвинуть позиции блоков в std::map так, как это делал текстовый документ до перехода на
+ *        словарь со сдвигами
+ */
+void shiftStdMap(std::map<int, int>& _map, std::map<int, int>::iterator _from, int _distance)
+{
+    if (_from == _map.end() || _distance <= 0) {
+        return;
+    }
+
+    auto reversed = [](std::map<int, int>::iterator _iter) {
+        return std::prev(std::make_reverse_iterator(_iter));
+    };
+    for (auto iter = _map.rbegin(); iter != std::make_reverse_iterator(_from); ++iter) {
+        auto itemToUpdate = _map.extract(iter->first);
+        itemToUpdate.key() = itemToUpdate.key() + _distance;
+        iter = reversed(_map.insert(std::move(itemToUpdate)).position);
+    }
+}
+
+} // namespace
+
+
+class ShiftableMapBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Набор текста в начале документа со сдвигом позиций через std::map
+     */
+    void typeAtStartWithStdMap();
+
+    /**
+     * @brief Набор текста в начале документа со сдвигом позиций через словарь со сдвигами
+     */
+    void typeAtStartWithShiftableMap();
+
+    /**
+     * @brief Поиск позиций блоков по их значениям после сдвигов
+     */
+    void findPositionsByValue();
+
+    /**
+     * @brief Случайные вставки, удаления и сдвиги дают тот же результат, что и в std::map
+     */
+    void compareWithStdMap();
+};
+
+void ShiftableMapBenchmark::typeAtStartWithStdMap()
+{
+    std::map<int, int> map;
+    for (int block = 0; block < kBlocksCount; ++block) {
+        map.emplace(block * kBlockLength, block);
+    }
+
+    QBENCHMARK_ONCE {
+        for (int edit = 0; edit < kEditsCount; ++edit) {
+            shiftStdMap(map, std::next(map.begin()), 1);
+        }
+    }
+    QCOMPARE(map.rbegin()->first, (kBlocksCount - 1) * kBlockLength + kEditsCount);
+}
+
+void ShiftableMapBenchmark::typeAtStartWithShiftableMap()
+{
+    ShiftableMap<int> map;
+    for (int block = 0; block < kBlocksCount; ++block) {
+        map.emplace(block * kBlockLength, block);
+    }
+
+    QBENCHMARK_ONCE {
+        for (int edit = 0; edit < kEditsCount; ++edit) {
+            map.shift(1, 1);
+        }
+    }
+    QCOMPARE(map.find((kBlocksCount - 1) * kBlockLength + kEditsCount)->second,
+             kBlocksCount - 1);
+}
+
+void ShiftableMapBenchmark::findPositionsByValue()
+{
+    ShiftableMap<int> map;
+    for (int block = 0; block < kBlocksCount; ++block) {
+        map.emplace(block * kBlockLength, block);
+    }
+    map.shift(1, kEditsCount);
+
+    QBENCHMARK {
+        for (int block = 1; block < kBlocksCount; ++block) {
+            const auto iter = map.findValue(block);
+            Q_ASSERT(iter->first == block * kBlockLength + kEditsCount);
+            Q_UNUSED(iter)
+        }
+    }
+}
+
+void ShiftableMapBenchmark::compareWithStdMap()
+{
+    std::mt19937 random(42);
+    std::map<int, int> expected;
+    ShiftableMap<int> map;
+    int nextValue = 0;
+    for (int step = 0; step < 20000; ++step) {
+        const int key = static_cast<int>(random() % 100000);
+        switch (random() % 3) {
+        case 0: {
+            if (expected.emplace(key, nextValue).second) {
+                QVERIFY(map.emplace(key, nextValue).second);
+            }
+            ++nextValue;
+            break;
+        }
+
+        case 1: {
+            QCOMPARE(map.erase(key), expected.erase(key));
+            break;
+        }
+
+        case 2: {
+            //
+            // Сдвигаем только вправо, так порядок элементов не меняется
+            //
+            const int distance = static_cast<int>(random() % 10) + 1;
+            std::map<int, int> shifted;
+            for (const auto& [itemKey, itemValue] : expected) {
+                shifted.emplace(itemKey >= key ? itemKey + distance : itemKey, itemValue);
+            }
+            expected.swap(shifted);
+            map.shift(key, distance);
+            break;
+        }
+        }
+    }
+
+    QCOMPARE(map.size(), expected.size());
+    auto expectedIter = expected.cbegin();
+    for (auto iter = map.begin(); iter != map.end(); ++iter, ++expectedIter) {
+        QCOMPARE(iter->first, expectedIter->first);
+        QCOMPARE(iter->second, expectedIter->second);
+        QCOMPARE(map.findValue(expectedIter->second)->first, expectedIter->first);
+    }
+}
+
+QTEST_GUILESS_MAIN(ShiftableMapBenchmark)
+
+#include "tst_shiftable_map.moc"
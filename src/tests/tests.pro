@@ -0,0 +1,10 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    backup_builder \
+    changes_history \
+    chronometer \
+    diff_match_patch \
+    document_lookup \
+    shiftable_map \
+    text_model_memory
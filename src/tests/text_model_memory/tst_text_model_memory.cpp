@@ -0,0 +1,179 @@
+#include <business_layer/model/simple_text/simple_text_model.h>
+#include <business_layer/model/text/text_model_text_item.h>
+#include <domain/document_object.h>
+#include <domain/objects_builder.h>
+
+#include <QFile>
+#include <QTest>
+#include <QUuid>
+
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+/**
+ * @brief Количество абзацев в тестовом документе
+ */
+constexpr int kParagraphsCount = 20000;
+
+/**
+ * @brief Количество одновременно загруженных моделей при замере памяти
+ */
+constexpr int kModelsCount = 10;
+
+/**
+ * @brief Пиковый объём памяти процесса в килобайтах
+ */
+qint64 peakRssKb()
+{
+#ifdef Q_OS_UNIX
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef Q_OS_MAC
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Текущий объём памяти процесса в килобайтах
+ * @note Доступен только в линуксе, в остальных системах возвращается ноль
+ */
+qint64 currentRssKb()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const auto values = statm.readAll().split(' ');
+    if (values.size() < 2) {
+        return 0;
+    }
+    return values.at(1).toLongLong() * sysconf(_SC_PAGESIZE) / 1024;
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+
+class TextModelMemoryBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    /**
+     * @brief Сформировать содержимое документа с большим количеством абзацев
+     */
+    void initTestCase();
+
+    /**
+     * @brief Загрузка документа в модель
+     */
+    void loadDocument();
+
+    /**
+     * @brief Пиковый объём памяти при загрузке нескольких моделей и объём после их удаления
+     */
+    void peakMemory();
+
+private:
+    std::unique_ptr<Domain::DocumentObject> createDocument() const;
+
+    QByteArray m_content;
+};
+
+void TextModelMemoryBenchmark::initTestCase()
+{
+    //
+    // Берём разметку пустого документа у самой модели и размножаем в ней абзац с текстом
+    //
+    BusinessLayer::SimpleTextModel model;
+    std::unique_ptr<Domain::DocumentObject> document(Domain::ObjectsBuilder::createDocument(
+        {}, QUuid::createUuid(), Domain::DocumentObjectType::SimpleText, {}, {}));
+    model.setDocument(document.get());
+    model.reassignContent();
+
+    auto textItem
+        = dynamic_cast<BusinessLayer::TextModelTextItem*>(model.itemForIndex(model.index(0, 0)));
+    QVERIFY(textItem != nullptr);
+    const auto emptyParagraph = textItem->toXml();
+    const auto emptyContent = document->content();
+    const auto paragraphPosition = emptyContent.indexOf(emptyParagraph);
+    QVERIFY(paragraphPosition >= 0);
+
+    textItem->setText("A paragraph of the document with a sentence or two of text in it, just "
+                      "long enough to look like a real one.");
+    const auto paragraph = textItem->toXml();
+
+    m_content = emptyContent.left(paragraphPosition);
+    m_content.reserve(m_content.size() + paragraph.size() * kParagraphsCount);
+    for (int index = 0; index < kParagraphsCount; ++index) {
+        m_content += paragraph;
+    }
+    m_content += emptyContent.mid(paragraphPosition + emptyParagraph.size());
+
+    model.setDocument(nullptr);
+}
+
+void TextModelMemoryBenchmark::loadDocument()
+{
+    const auto document = createDocument();
+    QBENCHMARK {
+        BusinessLayer::SimpleTextModel model;
+        model.setDocument(document.get());
+        QVERIFY(model.rowCount() > 0);
+        model.setDocument(nullptr);
+    }
+}
+
+void TextModelMemoryBenchmark::peakMemory()
+{
+    const auto rssBefore = currentRssKb();
+
+    std::vector<std::unique_ptr<Domain::DocumentObject>> documents;
+    std::vector<std::unique_ptr<BusinessLayer::SimpleTextModel>> models;
+    for (int index = 0; index < kModelsCount; ++index) {
+        documents.push_back(createDocument());
+        models.push_back(std::make_unique<BusinessLayer::SimpleTextModel>());
+        models.back()->setDocument(documents.back().get());
+    }
+    const auto rssLoaded = currentRssKb();
+
+    for (auto& model : models) {
+        model->setDocument(nullptr);
+    }
+    models.clear();
+    documents.clear();
+    const auto rssAfter = currentRssKb();
+
+    qInfo("Peak RSS: %lld KiB", peakRssKb());
+    qInfo("RSS before loading: %lld KiB, with %d models loaded: %lld KiB, after removing them: "
+          "%lld KiB",
+          rssBefore, kModelsCount, rssLoaded, rssAfter);
+}
+
+std::unique_ptr<Domain::DocumentObject> TextModelMemoryBenchmark::createDocument() const
+{
+    return std::unique_ptr<Domain::DocumentObject>(Domain::ObjectsBuilder::createDocument(
+        {}, QUuid::createUuid(), Domain::DocumentObjectType::SimpleText, m_content, {}));
+}
+
+QTEST_MAIN(TextModelMemoryBenchmark)
+
+#include "tst_text_model_memory.moc"